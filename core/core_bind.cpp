@@ -1029,10 +1029,11 @@ Error File::open_encrypted_pass(const String &p_path, ModeFlags p_mode_flags, co
 	return OK;
 }
 
-Error File::open_compressed(const String &p_path, ModeFlags p_mode_flags, CompressionMode p_compress_mode) {
+Error File::open_compressed(const String &p_path, ModeFlags p_mode_flags, CompressionMode p_compress_mode, int p_block_size) {
+	ERR_FAIL_COND_V_MSG(p_block_size <= 0, ERR_INVALID_PARAMETER, "Block size must be greater than 0.");
 	FileAccessCompressed *fac = memnew(FileAccessCompressed);
 
-	fac->configure("GCPF", (Compression::Mode)p_compress_mode);
+	fac->configure("GCPF", (Compression::Mode)p_compress_mode, p_block_size);
 
 	Error err = fac->_open(p_path, p_mode_flags);
 
@@ -1350,7 +1351,7 @@ uint64_t File::get_modified_time(const String &p_file) const {
 void File::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("open_encrypted", "path", "mode_flags", "key"), &File::open_encrypted);
 	ClassDB::bind_method(D_METHOD("open_encrypted_with_pass", "path", "mode_flags", "pass"), &File::open_encrypted_pass);
-	ClassDB::bind_method(D_METHOD("open_compressed", "path", "mode_flags", "compression_mode"), &File::open_compressed, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("open_compressed", "path", "mode_flags", "compression_mode", "block_size"), &File::open_compressed, DEFVAL(0), DEFVAL(FileAccessCompressed::DEFAULT_BLOCK_SIZE));
 
 	ClassDB::bind_method(D_METHOD("open", "path", "flags"), &File::open);
 	ClassDB::bind_method(D_METHOD("flush"), &File::flush);
@@ -110,6 +110,9 @@ public:
 	virtual real_t get_real() const;
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const; ///< get an array of bytes
+	// Zero-copy version of get_buffer(), for files backed by memory. Returns nullptr without moving
+	// if that's not the case or fewer bytes are left. The pointer is valid until the file is closed.
+	virtual const uint8_t *get_mapped_buffer(uint64_t p_length) const { return nullptr; }
 	virtual String get_line() const;
 	virtual String get_token() const;
 	virtual Vector<String> get_csv_line(const String &p_delim = ",") const;
@@ -42,10 +42,96 @@ void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_
 		}
 	}
 
+	ERR_FAIL_COND_MSG(p_block_size == 0, "Compressed file block size must be greater than 0.");
+
 	cmode = p_mode;
 	block_size = p_block_size;
 }
 
+void FileAccessCompressed::set_read_ahead(uint32_t p_blocks) {
+	ERR_FAIL_COND_MSG(f, "Read-ahead must be set before opening the file.");
+	read_ahead = p_blocks;
+}
+
+void FileAccessCompressed::PrefetchBlock::run() {
+	Compression::decompress(data.ptrw(), data.size(), compressed.ptr(), compressed.size(), mode);
+}
+
+void FileAccessCompressed::_start_prefetch(uint32_t p_blocks) const {
+	// Decompressing on the calling thread is as fast when nothing can run in parallel.
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (prefetch || p_blocks == 0 || read_block_count < 2 || !pool || pool->get_thread_count() == 0) {
+		return;
+	}
+	prefetch_count = p_blocks;
+	prefetch = memnew_arr(PrefetchBlock, prefetch_count);
+}
+
+void FileAccessCompressed::_read_block(uint32_t p_block) const {
+	read_block = p_block;
+	read_block_size = p_block == read_block_count - 1 ? read_total % block_size : block_size;
+
+	PrefetchBlock *slot = prefetch ? &prefetch[p_block % prefetch_count] : nullptr;
+	if (slot && slot->queued && slot->block == p_block) {
+		WorkerThreadPool::get_singleton()->wait(&slot->group);
+		slot->queued = false;
+		SWAP(buffer, slot->data);
+		read_ptr = buffer.ptrw();
+	} else {
+		f->seek(read_blocks[p_block].offset);
+		f->get_buffer(comp_buffer.ptrw(), read_blocks[p_block].csize);
+		Compression::decompress(buffer.ptrw(), block_size, comp_buffer.ptr(), read_blocks[p_block].csize, cmode);
+	}
+
+	if (prefetch) {
+		// Only the block that takes the freed slot is new, unless this was a seek.
+		for (uint32_t i = 1; i <= prefetch_count; i++) {
+			_queue_prefetch(p_block + i);
+		}
+	}
+}
+
+void FileAccessCompressed::_queue_prefetch(uint32_t p_block) const {
+	if (p_block >= read_block_count) {
+		return;
+	}
+
+	PrefetchBlock &slot = prefetch[p_block % prefetch_count];
+	if (slot.queued) {
+		if (slot.block == p_block) {
+			return;
+		}
+		// Left over from before a seek.
+		WorkerThreadPool::get_singleton()->wait(&slot.group);
+	}
+
+	// The base file isn't thread safe, so the compressed data is read here.
+	slot.block = p_block;
+	slot.mode = cmode;
+	slot.compressed.resize(read_blocks[p_block].csize);
+	slot.data.resize(block_size);
+	f->seek(read_blocks[p_block].offset);
+	f->get_buffer(slot.compressed.ptrw(), read_blocks[p_block].csize);
+
+	slot.queued = true;
+	WorkerThreadPool::get_singleton()->add_task(&slot, WorkerThreadPool::PRIORITY_HIGH, &slot.group);
+}
+
+void FileAccessCompressed::_finish_prefetch() {
+	if (!prefetch) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < prefetch_count; i++) {
+		if (prefetch[i].queued) {
+			WorkerThreadPool::get_singleton()->wait(&prefetch[i].group);
+		}
+	}
+	memdelete_arr(prefetch);
+	prefetch = nullptr;
+	prefetch_count = 0;
+}
+
 #define WRITE_FIT(m_bytes)                                  \
 	{                                                       \
 		if (write_pos + (m_bytes) > write_max) {            \
@@ -82,14 +168,12 @@ Error FileAccessCompressed::open_after_magic(FileAccess *p_base) {
 	comp_buffer.resize(max_bs);
 	buffer.resize(block_size);
 	read_ptr = buffer.ptrw();
-	f->get_buffer(comp_buffer.ptrw(), read_blocks[0].csize);
 	at_end = false;
 	read_eof = false;
 	read_block_count = bc;
-	read_block_size = read_blocks.size() == 1 ? read_total : block_size;
 
-	Compression::decompress(buffer.ptrw(), read_block_size, comp_buffer.ptr(), read_blocks[0].csize, cmode);
-	read_block = 0;
+	_start_prefetch(read_ahead);
+	_read_block(0);
 	read_pos = 0;
 
 	return OK;
@@ -177,6 +261,7 @@ void FileAccessCompressed::close() {
 		buffer.clear();
 
 	} else {
+		_finish_prefetch();
 		comp_buffer.clear();
 		buffer.clear();
 		read_blocks.clear();
@@ -207,11 +292,7 @@ void FileAccessCompressed::seek(uint64_t p_position) {
 			read_eof = false;
 			uint32_t block_idx = p_position / block_size;
 			if (block_idx != read_block) {
-				read_block = block_idx;
-				f->seek(read_blocks[read_block].offset);
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+				_read_block(block_idx);
 			}
 
 			read_pos = p_position % block_size;
@@ -272,9 +353,7 @@ uint8_t FileAccessCompressed::get_8() const {
 
 		if (read_block < read_block_count) {
 			//read another block of compressed data
-			f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-			Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-			read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+			_read_block(read_block);
 			read_pos = 0;
 
 		} else {
@@ -296,26 +375,35 @@ uint64_t FileAccessCompressed::get_buffer(uint8_t *p_dst, uint64_t p_length) con
 		return 0;
 	}
 
-	for (uint64_t i = 0; i < p_length; i++) {
-		p_dst[i] = read_ptr[read_pos];
-		read_pos++;
-		if (read_pos >= read_block_size) {
-			read_block++;
+	if (!prefetch && p_length > 2 * (uint64_t)block_size) {
+		// Likely a sequential read of the whole file, decompress ahead from now on.
+		_start_prefetch(SEQUENTIAL_READ_AHEAD);
+		if (prefetch) {
+			for (uint32_t i = 1; i <= prefetch_count; i++) {
+				_queue_prefetch(read_block + i);
+			}
+		}
+	}
 
-			if (read_block < read_block_count) {
+	uint64_t copied = 0;
+	while (copied < p_length) {
+		uint64_t to_copy = MIN(p_length - copied, (uint64_t)(read_block_size - read_pos));
+		memcpy(p_dst + copied, read_ptr + read_pos, to_copy);
+		copied += to_copy;
+		read_pos += to_copy;
+
+		if (read_pos >= read_block_size) {
+			if (read_block + 1 < read_block_count) {
 				//read another block of compressed data
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+				_read_block(read_block + 1);
 				read_pos = 0;
 
 			} else {
-				read_block--;
 				at_end = true;
-				if (i < p_length - 1) {
+				if (copied < p_length) {
 					read_eof = true;
 				}
-				return i;
+				return copied;
 			}
 		}
 	}
@@ -33,6 +33,7 @@
 
 #include "core/io/compression.h"
 #include "core/io/file_access.h"
+#include "core/os/worker_thread_pool.h"
 
 class FileAccessCompressed : public FileAccess {
 	Compression::Mode cmode = Compression::MODE_ZSTD;
@@ -50,8 +51,30 @@ class FileAccessCompressed : public FileAccess {
 		uint64_t offset;
 	};
 
+	// While reading, the blocks following the current one are decompressed
+	// on the WorkerThreadPool. Block b goes to slot b % read_ahead.
+	struct PrefetchBlock : public WorkerThreadPool::Task {
+		Compression::Mode mode = Compression::MODE_ZSTD;
+		uint32_t block = 0;
+		bool queued = false;
+		Vector<uint8_t> compressed;
+		Vector<uint8_t> data;
+		WorkerThreadPool::Group group;
+
+		virtual void run() override;
+	};
+
+	uint32_t read_ahead = DEFAULT_READ_AHEAD;
+	mutable uint32_t prefetch_count = 0;
+	mutable PrefetchBlock *prefetch = nullptr;
+
+	void _start_prefetch(uint32_t p_blocks) const;
+	void _read_block(uint32_t p_block) const;
+	void _queue_prefetch(uint32_t p_block) const;
+	void _finish_prefetch();
+
 	mutable Vector<uint8_t> comp_buffer;
-	uint8_t *read_ptr = nullptr;
+	mutable uint8_t *read_ptr = nullptr;
 	mutable uint32_t read_block = 0;
 	uint32_t read_block_count = 0;
 	mutable uint32_t read_block_size = 0;
@@ -64,7 +87,15 @@ class FileAccessCompressed : public FileAccess {
 	FileAccess *f = nullptr;
 
 public:
-	void configure(const String &p_magic, Compression::Mode p_mode = Compression::MODE_ZSTD, uint32_t p_block_size = 4096);
+	enum {
+		DEFAULT_BLOCK_SIZE = 4096,
+		DEFAULT_READ_AHEAD = 0,
+		// Used from the first read that spans more than two blocks.
+		SEQUENTIAL_READ_AHEAD = 4,
+	};
+
+	void configure(const String &p_magic, Compression::Mode p_mode = Compression::MODE_ZSTD, uint32_t p_block_size = DEFAULT_BLOCK_SIZE);
+	void set_read_ahead(uint32_t p_blocks); // Before opening, 0 only reads ahead once reads get large.
 
 	Error open_after_magic(FileAccess *p_base);
 
@@ -153,6 +153,16 @@ uint64_t FileAccessMemory::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 	return read;
 }
 
+const uint8_t *FileAccessMemory::get_mapped_buffer(uint64_t p_length) const {
+	if (!data || p_length > length - MIN(pos, length)) {
+		return nullptr;
+	}
+
+	const uint8_t *ptr = &data[pos];
+	pos += p_length;
+	return ptr;
+}
+
 Error FileAccessMemory::get_error() const {
 	return pos >= length ? ERR_FILE_EOF : OK;
 }
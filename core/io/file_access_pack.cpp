@@ -30,13 +30,18 @@
 
 #include "file_access_pack.h"
 
+#include "core/config/project_settings.h"
 #include "core/io/file_access_encrypted.h"
+#include "core/io/marshalls.h"
 #include "core/object/script_language.h"
+#include "core/os/os.h"
 #include "core/version.h"
 
 #include <stdio.h>
 
 Error PackedData::add_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) {
+	current_layer = layer_count++;
+
 	for (int i = 0; i < sources.size(); i++) {
 		if (sources[i]->try_open_pack(p_path, p_replace_files, p_offset)) {
 			return OK;
@@ -60,36 +65,158 @@ void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64
 		pf.md5[i] = p_md5[i];
 	}
 	pf.src = p_src;
+	pf.layer = current_layer;
+	pf.replace = p_replace_files;
 
 	if (!exists || p_replace_files) {
 		files[pmd5] = pf;
 	}
 
 	if (!exists) {
-		//search for dir
-		String p = p_path.replace_first("res://", "");
-		PackedDir *cd = root;
-
-		if (p.find("/") != -1) { //in a subdir
-
-			Vector<String> ds = p.get_base_dir().split("/");
-
-			for (int j = 0; j < ds.size(); j++) {
-				if (!cd->subdirs.has(ds[j])) {
-					PackedDir *pd = memnew(PackedDir);
-					pd->name = ds[j];
-					pd->parent = cd;
-					cd->subdirs[pd->name] = pd;
-					cd = pd;
-				} else {
-					cd = cd->subdirs[ds[j]];
-				}
+		_add_dir_path(p_path);
+	}
+}
+
+void PackedData::_add_dir_path(const String &p_path) {
+	//search for dir
+	String p = p_path.replace_first("res://", "");
+	PackedDir *cd = root;
+
+	if (p.find("/") != -1) { //in a subdir
+
+		Vector<String> ds = p.get_base_dir().split("/");
+
+		for (int j = 0; j < ds.size(); j++) {
+			if (!cd->subdirs.has(ds[j])) {
+				PackedDir *pd = memnew(PackedDir);
+				pd->name = ds[j];
+				pd->parent = cd;
+				cd->subdirs[pd->name] = pd;
+				cd = pd;
+			} else {
+				cd = cd->subdirs[ds[j]];
 			}
 		}
-		String filename = p_path.get_file();
-		// Don't add as a file if the path points to a directory
-		if (!filename.is_empty()) {
-			cd->files.insert(filename);
+	}
+	String filename = p_path.get_file();
+	// Don't add as a file if the path points to a directory
+	if (!filename.is_empty()) {
+		cd->files.insert(filename);
+	}
+}
+
+bool PackedData::add_index(const String &p_pkg_path, const uint8_t *p_index, uint64_t p_index_size, const Vector<uint8_t> &p_data, uint64_t p_file_base, PackSource *p_src, bool p_replace_files) {
+	const uint8_t *index = p_data.is_empty() ? p_index : p_data.ptr();
+	uint64_t index_size = p_data.is_empty() ? p_index_size : p_data.size();
+	ERR_FAIL_COND_V(!index || index_size < INDEX_HEADER_SIZE, false);
+
+	uint32_t file_count = decode_uint32(index);
+	uint32_t paths_size = decode_uint32(index + 4);
+	ERR_FAIL_COND_V_MSG(INDEX_HEADER_SIZE + (uint64_t)file_count * INDEX_ENTRY_SIZE + paths_size > index_size, false, "Pack index is truncated: " + p_pkg_path + ".");
+
+	PackIndex *pi = memnew(PackIndex);
+	pi->pack = p_pkg_path;
+	pi->src = p_src;
+	pi->layer = current_layer;
+	pi->replace_files = p_replace_files;
+	pi->file_base = p_file_base;
+	pi->data = p_data;
+	// Point into our own copy of the data, if any.
+	index = pi->data.is_empty() ? p_index : pi->data.ptr();
+	pi->file_count = file_count;
+	pi->entries = index + INDEX_HEADER_SIZE;
+	pi->paths = (const char *)(pi->entries + (uint64_t)file_count * INDEX_ENTRY_SIZE);
+	pi->paths_size = paths_size;
+	indexes.push_back(pi);
+
+	return true;
+}
+
+const uint8_t *PackedData::PackIndex::find(uint64_t p_path_md5_a, uint64_t p_path_md5_b) const {
+	uint32_t lo = 0;
+	uint32_t hi = file_count;
+	while (lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		const uint8_t *entry = entries + (uint64_t)mid * INDEX_ENTRY_SIZE;
+		uint64_t a = decode_uint64(entry);
+		uint64_t b = decode_uint64(entry + 8);
+		if (a == p_path_md5_a && b == p_path_md5_b) {
+			return entry;
+		}
+		if (a < p_path_md5_a || (a == p_path_md5_a && b < p_path_md5_b)) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return nullptr;
+}
+
+bool PackedData::_find_file(const String &p_path, PackedFile &r_file) const {
+	PathMD5 pmd5(p_path.md5_buffer());
+	const Map<PathMD5, PackedFile>::Element *E = files.find(pmd5);
+
+	if (indexes.is_empty()) {
+		if (!E) {
+			return false;
+		}
+		r_file = E->get();
+		return r_file.offset != 0; // Zero if it was erased.
+	}
+
+	// Go through the packs in the order they were added, as if all their files were in the map.
+	bool found = false;
+	for (int i = 0; i <= indexes.size(); i++) {
+		if (E && (i == indexes.size() || indexes[i]->layer > E->get().layer)) {
+			if (!found || E->get().replace) {
+				r_file = E->get();
+				found = true;
+			}
+			E = nullptr;
+		}
+		if (i == indexes.size()) {
+			break;
+		}
+
+		const PackIndex *pi = indexes[i];
+		if (found && !pi->replace_files) {
+			continue;
+		}
+		const uint8_t *entry = pi->find(pmd5.a, pmd5.b);
+		if (!entry) {
+			continue;
+		}
+
+		r_file.pack = pi->pack;
+		r_file.offset = pi->file_base + decode_uint64(entry + 16);
+		r_file.size = decode_uint64(entry + 24);
+		memcpy(r_file.md5, entry + 32, 16);
+		r_file.src = pi->src;
+		r_file.encrypted = decode_uint32(entry + 48) & PACK_FILE_ENCRYPTED;
+		r_file.layer = pi->layer;
+		r_file.replace = pi->replace_files;
+		found = true;
+	}
+
+	return found && r_file.offset != 0;
+}
+
+void PackedData::_add_index_dirs() {
+	MutexLock lock(index_dirs_mutex);
+
+	for (int i = 0; i < indexes.size(); i++) {
+		PackIndex *pi = indexes[i];
+		if (pi->dirs_added) {
+			continue;
+		}
+		pi->dirs_added = true;
+
+		for (uint32_t j = 0; j < pi->file_count; j++) {
+			uint32_t path_ofs = decode_uint32(pi->entries + (uint64_t)j * INDEX_ENTRY_SIZE + 52);
+			ERR_CONTINUE(path_ofs >= pi->paths_size);
+			String path;
+			path.parse_utf8(pi->paths + path_ofs, strnlen(pi->paths + path_ofs, pi->paths_size - path_ofs));
+			_add_dir_path(path);
 		}
 	}
 }
@@ -117,6 +244,9 @@ void PackedData::_free_packed_dirs(PackedDir *p_dir) {
 }
 
 PackedData::~PackedData() {
+	for (int i = 0; i < indexes.size(); i++) {
+		memdelete(indexes[i]);
+	}
 	for (int i = 0; i < sources.size(); i++) {
 		memdelete(sources[i]);
 	}
@@ -125,6 +255,50 @@ PackedData::~PackedData() {
 
 //////////////////////////////////////////////////////////////////
 
+void PackIndexWriter::add_file(const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, uint32_t p_flags) {
+	Entry e;
+	Vector<uint8_t> path_md5 = p_path.md5_buffer();
+	memcpy(&e.path_md5_a, &path_md5[0], 8);
+	memcpy(&e.path_md5_b, &path_md5[8], 8);
+	e.ofs = p_ofs;
+	e.size = p_size;
+	memcpy(e.md5, p_md5, 16);
+	e.flags = p_flags;
+	e.path = p_path.utf8();
+	entries.push_back(e);
+}
+
+void PackIndexWriter::store(FileAccess *p_file) {
+	entries.sort();
+
+	uint32_t paths_size = 0;
+	for (int i = 0; i < entries.size(); i++) {
+		paths_size += entries[i].path.length() + 1;
+	}
+
+	p_file->store_32(entries.size());
+	p_file->store_32(paths_size);
+
+	uint32_t path_ofs = 0;
+	for (int i = 0; i < entries.size(); i++) {
+		const Entry &e = entries[i];
+		p_file->store_64(e.path_md5_a);
+		p_file->store_64(e.path_md5_b);
+		p_file->store_64(e.ofs);
+		p_file->store_64(e.size);
+		p_file->store_buffer(e.md5, 16);
+		p_file->store_32(e.flags);
+		p_file->store_32(path_ofs);
+		path_ofs += e.path.length() + 1;
+	}
+
+	for (int i = 0; i < entries.size(); i++) {
+		p_file->store_buffer((const uint8_t *)entries[i].path.get_data(), entries[i].path.length() + 1);
+	}
+}
+
+//////////////////////////////////////////////////////////////////
+
 bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) {
 	FileAccess *f = FileAccess::open(p_path, FileAccess::READ);
 	if (!f) {
@@ -186,13 +360,52 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 
 	bool enc_directory = (pack_flags & PACK_DIR_ENCRYPTED);
 
-	for (int i = 0; i < 16; i++) {
+	uint64_t index_ofs = f->get_64();
+	for (int i = 0; i < 14; i++) {
 		//reserved
 		f->get_32();
 	}
 
 	int file_count = f->get_32();
 
+	_map_pack(p_path);
+
+	if ((pack_flags & PACK_INDEXED) && !enc_directory && index_ofs != 0) {
+		uint64_t dir_ofs = f->get_position();
+
+		// Use the index where it lies instead of adding every file of the directory.
+		const MappedPack *mapped = mapped_packs.getptr(p_path);
+		bool added = false;
+		if (mapped && index_ofs + p_offset + PackedData::INDEX_HEADER_SIZE <= mapped->size) {
+			added = PackedData::get_singleton()->add_index(p_path, mapped->data + index_ofs + p_offset, mapped->size - index_ofs - p_offset, Vector<uint8_t>(), file_base + p_offset, this, p_replace_files);
+		} else if (!mapped) {
+			f->seek(index_ofs + p_offset);
+			uint32_t index_files = f->get_32();
+			uint32_t paths_size = f->get_32();
+			// Bound by what's left of the file before allocating, like the mapped case.
+			uint64_t body_size = (uint64_t)index_files * PackedData::INDEX_ENTRY_SIZE + paths_size;
+			uint64_t position = f->get_position();
+			uint64_t length = f->get_length();
+			Vector<uint8_t> index;
+			if (position <= length && body_size <= length - position && body_size <= INT32_MAX - PackedData::INDEX_HEADER_SIZE && index.resize(PackedData::INDEX_HEADER_SIZE + body_size) == OK) {
+				encode_uint32(index_files, index.ptrw());
+				encode_uint32(paths_size, index.ptrw() + 4);
+				if (f->get_buffer(index.ptrw() + PackedData::INDEX_HEADER_SIZE, body_size) == body_size) {
+					added = PackedData::get_singleton()->add_index(p_path, nullptr, 0, index, file_base + p_offset, this, p_replace_files);
+				}
+			}
+		}
+
+		if (added) {
+			f->close();
+			memdelete(f);
+			return true;
+		}
+
+		WARN_PRINT("Invalid pack index, reading the directory instead: " + p_path + ".");
+		f->seek(dir_ofs);
+	}
+
 	if (enc_directory) {
 		FileAccessEncrypted *fae = memnew(FileAccessEncrypted);
 		if (!fae) {
@@ -238,13 +451,49 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 
 	f->close();
 	memdelete(f);
+
 	return true;
 }
 
+void PackedSourcePCK::_map_pack(const String &p_path) {
+	// The pack may have changed on disk since it was mapped, so its offsets only apply to a new mapping.
+	MappedPack *previous = mapped_packs.getptr(p_path);
+	if (previous) {
+		replaced_packs.push_back(*previous);
+		mapped_packs.erase(p_path);
+	}
+
+	String os_path = p_path.begins_with("user://") ? ProjectSettings::get_singleton()->globalize_path(p_path) : p_path;
+	if (os_path.begins_with("res://")) {
+		return; // Pack inside another pack, can't be mapped.
+	}
+
+	MappedPack mapped;
+	if (OS::get_singleton()->map_file(os_path, mapped.data, mapped.size) == OK) {
+		print_verbose("Memory mapped pack: " + p_path);
+		mapped_packs[p_path] = mapped;
+	}
+}
+
 FileAccess *PackedSourcePCK::get_file(const String &p_path, PackedData::PackedFile *p_file) {
+	const MappedPack *mapped = mapped_packs.getptr(p_file->pack);
+	if (mapped && !p_file->encrypted && p_file->offset + p_file->size <= mapped->size) {
+		return memnew(FileAccessPack(p_path, *p_file, mapped->data));
+	}
 	return memnew(FileAccessPack(p_path, *p_file));
 }
 
+PackedSourcePCK::~PackedSourcePCK() {
+	const String *K = nullptr;
+	while ((K = mapped_packs.next(K))) {
+		const MappedPack &mapped = mapped_packs[*K];
+		OS::get_singleton()->unmap_file(mapped.data, mapped.size);
+	}
+	for (int i = 0; i < replaced_packs.size(); i++) {
+		OS::get_singleton()->unmap_file(replaced_packs[i].data, replaced_packs[i].size);
+	}
+}
+
 //////////////////////////////////////////////////////////////////
 
 Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
@@ -253,11 +502,14 @@ Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
 }
 
 void FileAccessPack::close() {
-	f->close();
+	if (f) {
+		f->close();
+	}
+	data = nullptr;
 }
 
 bool FileAccessPack::is_open() const {
-	return f->is_open();
+	return f ? f->is_open() : data != nullptr;
 }
 
 void FileAccessPack::seek(uint64_t p_position) {
@@ -267,7 +519,9 @@ void FileAccessPack::seek(uint64_t p_position) {
 		eof = false;
 	}
 
-	f->seek(off + p_position);
+	if (f) {
+		f->seek(off + p_position);
+	}
 	pos = p_position;
 }
 
@@ -293,6 +547,10 @@ uint8_t FileAccessPack::get_8() const {
 		return 0;
 	}
 
+	if (data) {
+		return data[pos++];
+	}
+
 	pos++;
 	return f->get_8();
 }
@@ -310,19 +568,35 @@ uint64_t FileAccessPack::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 		to_read = (int64_t)pf.size - (int64_t)pos;
 	}
 
-	pos += p_length;
-
 	if (to_read <= 0) {
+		pos += p_length;
 		return 0;
 	}
-	f->get_buffer(p_dst, to_read);
+	if (data) {
+		memcpy(p_dst, data + pos, to_read);
+	} else {
+		f->get_buffer(p_dst, to_read);
+	}
+	pos += p_length;
 
 	return to_read;
 }
 
+const uint8_t *FileAccessPack::get_mapped_buffer(uint64_t p_length) const {
+	if (!data || eof || p_length > pf.size - MIN(pos, pf.size)) {
+		return nullptr;
+	}
+
+	const uint8_t *ptr = data + pos;
+	pos += p_length;
+	return ptr;
+}
+
 void FileAccessPack::set_big_endian(bool p_big_endian) {
 	FileAccess::set_big_endian(p_big_endian);
-	f->set_big_endian(p_big_endian);
+	if (f) {
+		f->set_big_endian(p_big_endian);
+	}
 }
 
 Error FileAccessPack::get_error() const {
@@ -348,9 +622,18 @@ bool FileAccessPack::file_exists(const String &p_name) {
 	return false;
 }
 
-FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file) :
-		pf(p_file),
-		f(FileAccess::open(pf.pack, FileAccess::READ)) {
+FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const uint8_t *p_mapped_pack) :
+		pf(p_file) {
+	pos = 0;
+	eof = false;
+
+	if (p_mapped_pack) {
+		data = p_mapped_pack + pf.offset;
+		off = pf.offset;
+		return;
+	}
+
+	f = FileAccess::open(pf.pack, FileAccess::READ);
 	ERR_FAIL_COND_MSG(!f, "Can't open pack-referenced file '" + String(pf.pack) + "'.");
 
 	f->seek(pf.offset);
@@ -376,8 +659,6 @@ FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFil
 		f = fae;
 		off = 0;
 	}
-	pos = 0;
-	eof = false;
 }
 
 FileAccessPack::~FileAccessPack() {
@@ -556,5 +837,6 @@ String DirAccessPack::get_filesystem_type() const {
 }
 
 DirAccessPack::DirAccessPack() {
+	PackedData::get_singleton()->_add_index_dirs();
 	current = PackedData::get_singleton()->root;
 }
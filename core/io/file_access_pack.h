@@ -33,7 +33,9 @@
 
 #include "core/io/dir_access.h"
 #include "core/io/file_access.h"
+#include "core/os/mutex.h"
 #include "core/string/print_string.h"
+#include "core/templates/hash_map.h"
 #include "core/templates/list.h"
 #include "core/templates/map.h"
 #include "core/templates/set.h"
@@ -44,7 +46,8 @@
 #define PACK_FORMAT_VERSION 2
 
 enum PackFlags {
-	PACK_DIR_ENCRYPTED = 1 << 0
+	PACK_DIR_ENCRYPTED = 1 << 0,
+	PACK_INDEXED = 1 << 1, // An index follows the directory, its offset is stored in the first reserved header fields.
 };
 
 enum PackFileFlags {
@@ -66,6 +69,8 @@ public:
 		uint8_t md5[16];
 		PackSource *src;
 		bool encrypted;
+		uint32_t layer = 0; // Which add_pack() call added it, to resolve files found in several packs.
+		bool replace = false;
 	};
 
 private:
@@ -101,6 +106,30 @@ private:
 
 	Map<PathMD5, PackedFile> files;
 
+	// Files from indexed packs aren't added to the map above, they are looked up in place
+	// in the index, which is either memory mapped or read with a single allocation.
+	// Their directories are only added to the tree when a DirAccessPack is created.
+	struct PackIndex {
+		String pack;
+		PackSource *src = nullptr;
+		uint32_t layer = 0;
+		bool replace_files = false;
+		uint64_t file_base = 0;
+		uint32_t file_count = 0;
+		const uint8_t *entries = nullptr;
+		const char *paths = nullptr;
+		uint32_t paths_size = 0;
+		Vector<uint8_t> data;
+		bool dirs_added = false;
+
+		const uint8_t *find(uint64_t p_path_md5_a, uint64_t p_path_md5_b) const;
+	};
+
+	Vector<PackIndex *> indexes;
+	BinaryMutex index_dirs_mutex;
+	uint32_t layer_count = 0;
+	uint32_t current_layer = 0;
+
 	Vector<PackSource *> sources;
 
 	PackedDir *root;
@@ -109,10 +138,20 @@ private:
 	bool disabled = false;
 
 	void _free_packed_dirs(PackedDir *p_dir);
+	void _add_dir_path(const String &p_path);
+	void _add_index_dirs();
+	bool _find_file(const String &p_path, PackedFile &r_file) const;
 
 public:
+	enum {
+		INDEX_HEADER_SIZE = 8,
+		INDEX_ENTRY_SIZE = 56,
+	};
+
 	void add_pack_source(PackSource *p_source);
 	void add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted = false); // for PackSource
+	// For PackSource, adds every file of an index written by PackIndexWriter. Takes p_data if not empty, else p_index must stay valid.
+	bool add_index(const String &p_pkg_path, const uint8_t *p_index, uint64_t p_index_size, const Vector<uint8_t> &p_data, uint64_t p_file_base, PackSource *p_src, bool p_replace_files);
 
 	void set_disabled(bool p_disabled) { disabled = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled() const { return disabled; }
@@ -130,6 +169,31 @@ public:
 	~PackedData();
 };
 
+// Builds the index of a pack with PACK_INDEXED set: a header with the file count
+// and path table size, the files sorted by path MD5 so they can be binary searched
+// where they lie, then the paths, for directory listing.
+class PackIndexWriter {
+	struct Entry {
+		uint64_t path_md5_a = 0;
+		uint64_t path_md5_b = 0;
+		uint64_t ofs = 0;
+		uint64_t size = 0;
+		uint8_t md5[16] = {};
+		uint32_t flags = 0;
+		CharString path;
+
+		bool operator<(const Entry &p_entry) const {
+			return path_md5_a == p_entry.path_md5_a ? path_md5_b < p_entry.path_md5_b : path_md5_a < p_entry.path_md5_a;
+		}
+	};
+
+	Vector<Entry> entries;
+
+public:
+	void add_file(const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, uint32_t p_flags);
+	void store(FileAccess *p_file);
+};
+
 class PackSource {
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) = 0;
@@ -138,9 +202,23 @@ public:
 };
 
 class PackedSourcePCK : public PackSource {
+	// Packs are memory mapped where the OS supports it, so opening a file
+	// from them needs no system call and reading it no extra copy.
+	struct MappedPack {
+		const uint8_t *data = nullptr;
+		uint64_t size = 0;
+	};
+
+	HashMap<String, MappedPack> mapped_packs;
+	Vector<MappedPack> replaced_packs; // Files opened before a pack was loaded again may still use these.
+
+	void _map_pack(const String &p_path);
+
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset);
 	virtual FileAccess *get_file(const String &p_path, PackedData::PackedFile *p_file);
+
+	virtual ~PackedSourcePCK();
 };
 
 class FileAccessPack : public FileAccess {
@@ -150,7 +228,8 @@ class FileAccessPack : public FileAccess {
 	mutable bool eof;
 	uint64_t off;
 
-	FileAccess *f;
+	const uint8_t *data = nullptr; // Start of the file, when reading from a mapped pack.
+	FileAccess *f = nullptr;
 	virtual Error _open(const String &p_path, int p_mode_flags);
 	virtual uint64_t _get_modified_time(const String &p_file) { return 0; }
 	virtual uint32_t _get_unix_permissions(const String &p_file) { return 0; }
@@ -170,6 +249,7 @@ public:
 	virtual uint8_t get_8() const;
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const;
+	virtual const uint8_t *get_mapped_buffer(uint64_t p_length) const;
 
 	virtual void set_big_endian(bool p_big_endian);
 
@@ -182,25 +262,22 @@ public:
 
 	virtual bool file_exists(const String &p_name);
 
-	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file);
+	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const uint8_t *p_mapped_pack = nullptr);
 	~FileAccessPack();
 };
 
 FileAccess *PackedData::try_open_path(const String &p_path) {
-	PathMD5 pmd5(p_path.md5_buffer());
-	Map<PathMD5, PackedFile>::Element *E = files.find(pmd5);
-	if (!E) {
+	PackedFile pf;
+	if (!_find_file(p_path, pf)) {
 		return nullptr; //not found
 	}
-	if (E->get().offset == 0) {
-		return nullptr; //was erased
-	}
 
-	return E->get().src->get_file(p_path, &E->get());
+	return pf.src->get_file(p_path, &pf);
 }
 
 bool PackedData::has_path(const String &p_path) {
-	return files.has(PathMD5(p_path.md5_buffer()));
+	PackedFile pf;
+	return _find_file(p_path, pf);
 }
 
 bool PackedData::has_directory(const String &p_path) {
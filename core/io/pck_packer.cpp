@@ -33,7 +33,7 @@
 #include "core/crypto/crypto_core.h"
 #include "core/io/file_access.h"
 #include "core/io/file_access_encrypted.h"
-#include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION
+#include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION, PackIndexWriter
 #include "core/version.h"
 
 static int _get_pad(int p_alignment, int p_n) {
@@ -101,6 +101,8 @@ Error PCKPacker::pck_start(const String &p_file, int p_alignment, const String &
 	uint32_t pack_flags = 0;
 	if (enc_dir) {
 		pack_flags |= PACK_DIR_ENCRYPTED;
+	} else {
+		pack_flags |= PACK_INDEXED; // An encrypted directory is kept private, so it gets no index.
 	}
 	file->store_32(pack_flags); // flags
 
@@ -206,6 +208,16 @@ Error PCKPacker::flush(bool p_verbose) {
 		memdelete(fae);
 	}
 
+	int64_t index_ofs = 0;
+	if (!enc_dir) {
+		index_ofs = file->get_position();
+		PackIndexWriter index;
+		for (int i = 0; i < files.size(); i++) {
+			index.add_file(files[i].path, files[i].ofs, files[i].size, files[i].md5.ptr(), files[i].encrypted ? PACK_FILE_ENCRYPTED : 0);
+		}
+		index.store(file);
+	}
+
 	int header_padding = _get_pad(alignment, file->get_position());
 	for (int i = 0; i < header_padding; i++) {
 		file->store_8(Math::rand() % 256);
@@ -214,6 +226,7 @@ Error PCKPacker::flush(bool p_verbose) {
 	int64_t file_base = file->get_position();
 	file->seek(file_base_ofs);
 	file->store_64(file_base); // update files base
+	file->store_64(index_ofs); // index, in the first reserved fields
 	file->seek(file_base);
 
 	const uint32_t buf_max = 65536;
@@ -101,20 +101,32 @@ void ResourceLoaderBinary::_advance_padding(uint32_t p_len) {
 	}
 }
 
+String ResourceLoaderBinary::_get_utf8(uint32_t p_len) {
+	String s;
+
+	// Parse in place when the file is in memory (i.e. a mapped pack).
+	const char *mapped = (const char *)f->get_mapped_buffer(p_len);
+	if (mapped) {
+		s.parse_utf8(mapped, strnlen(mapped, p_len));
+		return s;
+	}
+
+	if ((int)p_len > str_buf.size()) {
+		str_buf.resize(p_len);
+	}
+	f->get_buffer((uint8_t *)&str_buf[0], p_len);
+	s.parse_utf8(&str_buf[0]);
+	return s;
+}
+
 StringName ResourceLoaderBinary::_get_string() {
 	uint32_t id = f->get_32();
 	if (id & 0x80000000) {
 		uint32_t len = id & 0x7FFFFFFF;
-		if ((int)len > str_buf.size()) {
-			str_buf.resize(len);
-		}
 		if (len == 0) {
 			return StringName();
 		}
-		f->get_buffer((uint8_t *)&str_buf[0], len);
-		String s;
-		s.parse_utf8(&str_buf[0]);
-		return s;
+		return _get_utf8(len);
 	}
 
 	return string_map[id];
@@ -322,6 +334,17 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 					}
 
 					//always use internal cache for loading internal resources
+					if (!internal_index_cache.has(path) && using_named_scene_ids && !internal_resources[index].loaded && !internal_resources[index].loading) {
+						// Not loaded yet, only happens when loading lazily or with resources out of order.
+						uint64_t pos = f->get_position();
+						RES res;
+						Error err = _load_internal_resource(index, res);
+						if (err != OK) {
+							return err;
+						}
+						f->seek(pos);
+					}
+
 					if (!internal_index_cache.has(path)) {
 						WARN_PRINT(String("Couldn't load resource (no cache): " + path).utf8().get_data());
 						r_v = Variant();
@@ -362,7 +385,12 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 					} else {
 						if (external_resources[erindex].cache.is_null()) {
 							//cache not here yet, wait for it?
-							if (use_sub_threads) {
+							if (lazy) {
+								Error err = _load_external_resource(erindex);
+								if (err != OK) {
+									return err;
+								}
+							} else if (use_sub_threads) {
 								Error err;
 								external_resources.write[erindex].cache = ResourceLoader::load_threaded_get(external_resources[erindex].path, &err);
 
@@ -612,13 +640,7 @@ Ref<Resource> ResourceLoaderBinary::get_resource() {
 	return resource;
 }
 
-Error ResourceLoaderBinary::load() {
-	if (error != OK) {
-		return error;
-	}
-
-	int stage = 0;
-
+void ResourceLoaderBinary::_update_paths() {
 	for (int i = 0; i < external_resources.size(); i++) {
 		String path = external_resources[i].path;
 
@@ -632,143 +654,184 @@ Error ResourceLoaderBinary::load() {
 		}
 
 		external_resources.write[i].path = path; //remap happens here, not on load because on load it can actually be used for filesystem dock resource remap
+	}
 
-		if (!use_sub_threads) {
-			external_resources.write[i].cache = ResourceLoader::load(path, external_resources[i].type);
+	// The main resource is last.
+	for (int i = 0; i < internal_resources.size() - 1; i++) {
+		String path = internal_resources[i].path;
 
-			if (external_resources[i].cache.is_null()) {
-				if (!ResourceLoader::get_abort_on_missing_resources()) {
-					ResourceLoader::notify_dependency_error(local_path, path, external_resources[i].type);
-				} else {
-					error = ERR_FILE_MISSING_DEPENDENCIES;
-					ERR_FAIL_V_MSG(error, "Can't load dependency: " + path + ".");
-				}
-			}
+		if (path.begins_with("local://")) {
+			path = path.replace_first("local://", "");
+			internal_resources.write[i].id = path;
+			internal_resources.write[i].path = res_path + "::" + path;
+		}
+	}
+}
 
+Error ResourceLoaderBinary::_load_external_resource(int p_index) {
+	const String &path = external_resources[p_index].path;
+	external_resources.write[p_index].cache = ResourceLoader::load(path, external_resources[p_index].type);
+
+	if (external_resources[p_index].cache.is_null()) {
+		if (!ResourceLoader::get_abort_on_missing_resources()) {
+			ResourceLoader::notify_dependency_error(local_path, path, external_resources[p_index].type);
 		} else {
-			Error err = ResourceLoader::load_threaded_request(path, external_resources[i].type, use_sub_threads, ResourceFormatLoader::CACHE_MODE_REUSE, local_path);
-			if (err != OK) {
-				if (!ResourceLoader::get_abort_on_missing_resources()) {
-					ResourceLoader::notify_dependency_error(local_path, path, external_resources[i].type);
-				} else {
-					error = ERR_FILE_MISSING_DEPENDENCIES;
-					ERR_FAIL_V_MSG(error, "Can't load dependency: " + path + ".");
-				}
-			}
+			error = ERR_FILE_MISSING_DEPENDENCIES;
+			ERR_FAIL_V_MSG(error, "Can't load dependency: " + path + ".");
 		}
-
-		stage++;
 	}
 
-	for (int i = 0; i < internal_resources.size(); i++) {
-		bool main = i == (internal_resources.size() - 1);
+	return OK;
+}
 
-		//maybe it is loaded already
-		String path;
-		String id;
+Error ResourceLoaderBinary::_load_internal_resource(int p_index, RES &r_res) {
+	IntResource &ir = internal_resources.write[p_index];
+	bool main = p_index == (internal_resources.size() - 1);
 
-		if (!main) {
-			path = internal_resources[i].path;
+	//maybe it is loaded already
+	String path;
 
-			if (path.begins_with("local://")) {
-				path = path.replace_first("local://", "");
-				id = path;
-				path = res_path + "::" + path;
+	if (!main) {
+		path = ir.path;
 
-				internal_resources.write[i].path = path; // Update path.
-			}
-
-			if (cache_mode == ResourceFormatLoader::CACHE_MODE_REUSE) {
-				if (ResourceCache::has(path)) {
-					//already loaded, don't do anything
-					stage++;
-					error = OK;
-					continue;
-				}
-			}
-		} else {
-			if (cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE && !ResourceCache::has(res_path)) {
-				path = res_path;
+		if (cache_mode == ResourceFormatLoader::CACHE_MODE_REUSE) {
+			RES cached = RES(ResourceCache::get(path));
+			if (cached.is_valid()) {
+				//already loaded, don't do anything
+				ir.loaded = true;
+				internal_index_cache[path] = cached;
+				error = OK;
+				return OK;
 			}
 		}
+	} else {
+		if (cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE && !ResourceCache::has(res_path)) {
+			path = res_path;
+		}
+	}
 
-		uint64_t offset = internal_resources[i].offset;
+	ir.loading = true;
 
-		f->seek(offset);
+	f->seek(ir.offset);
 
-		String t = get_unicode_string();
+	String t = get_unicode_string();
 
-		RES res;
+	RES res;
 
-		if (cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE && ResourceCache::has(path)) {
-			//use the existing one
-			Resource *r = ResourceCache::get(path);
-			if (r->get_class() == t) {
-				r->reset_state();
-				res = Ref<Resource>(r);
-			}
+	if (cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE && ResourceCache::has(path)) {
+		//use the existing one
+		Resource *r = ResourceCache::get(path);
+		if (r->get_class() == t) {
+			r->reset_state();
+			res = Ref<Resource>(r);
 		}
+	}
 
-		if (res.is_null()) {
-			//did not replace
+	if (res.is_null()) {
+		//did not replace
 
-			Object *obj = ClassDB::instantiate(t);
-			if (!obj) {
-				error = ERR_FILE_CORRUPT;
-				ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource of unrecognized type in file: " + t + ".");
-			}
+		Object *obj = ClassDB::instantiate(t);
+		if (!obj) {
+			error = ERR_FILE_CORRUPT;
+			ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource of unrecognized type in file: " + t + ".");
+		}
 
-			Resource *r = Object::cast_to<Resource>(obj);
-			if (!r) {
-				String obj_class = obj->get_class();
-				error = ERR_FILE_CORRUPT;
-				memdelete(obj); //bye
-				ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource type in resource field not a resource, type is: " + obj_class + ".");
-			}
+		Resource *r = Object::cast_to<Resource>(obj);
+		if (!r) {
+			String obj_class = obj->get_class();
+			error = ERR_FILE_CORRUPT;
+			memdelete(obj); //bye
+			ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource type in resource field not a resource, type is: " + obj_class + ".");
+		}
 
-			res = RES(r);
-			if (path != String() && cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE) {
-				r->set_path(path, cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE); //if got here because the resource with same path has different type, replace it
-			}
-			r->set_scene_unique_id(id);
+		res = RES(r);
+		if (path != String() && cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE) {
+			r->set_path(path, cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE); //if got here because the resource with same path has different type, replace it
+		}
+		r->set_scene_unique_id(ir.id);
+	}
+
+	if (!main) {
+		internal_index_cache[path] = res;
+	}
+
+	int pc = f->get_32();
+
+	//set properties
+
+	for (int j = 0; j < pc; j++) {
+		StringName name = _get_string();
+
+		if (name == StringName()) {
+			error = ERR_FILE_CORRUPT;
+			ERR_FAIL_V(ERR_FILE_CORRUPT);
 		}
 
-		if (!main) {
-			internal_index_cache[path] = res;
+		Variant value;
+
+		error = parse_variant(value);
+		if (error) {
+			return error;
 		}
 
-		int pc = f->get_32();
+		res->set(name, value);
+	}
+#ifdef TOOLS_ENABLED
+	res->set_edited(false);
+#endif
+
+	resource_cache.push_back(res);
+
+	ir.loading = false;
+	ir.loaded = true;
+	r_res = res;
+	return OK;
+}
+
+Error ResourceLoaderBinary::load() {
+	if (error != OK) {
+		return error;
+	}
+
+	_update_paths();
 
-		//set properties
+	for (int i = 0; i < external_resources.size(); i++) {
+		const String &path = external_resources[i].path;
 
-		for (int j = 0; j < pc; j++) {
-			StringName name = _get_string();
+		if (!use_sub_threads) {
+			Error err = _load_external_resource(i);
+			if (err != OK) {
+				return err;
+			}
 
-			if (name == StringName()) {
-				error = ERR_FILE_CORRUPT;
-				ERR_FAIL_V(ERR_FILE_CORRUPT);
+		} else {
+			Error err = ResourceLoader::load_threaded_request(path, external_resources[i].type, use_sub_threads, ResourceFormatLoader::CACHE_MODE_REUSE, local_path);
+			if (err != OK) {
+				if (!ResourceLoader::get_abort_on_missing_resources()) {
+					ResourceLoader::notify_dependency_error(local_path, path, external_resources[i].type);
+				} else {
+					error = ERR_FILE_MISSING_DEPENDENCIES;
+					ERR_FAIL_V_MSG(error, "Can't load dependency: " + path + ".");
+				}
 			}
+		}
+	}
 
-			Variant value;
+	for (int i = 0; i < internal_resources.size(); i++) {
+		bool main = i == (internal_resources.size() - 1);
 
-			error = parse_variant(value);
-			if (error) {
+		RES res;
+		if (!internal_resources[i].loaded) {
+			error = _load_internal_resource(i, res);
+			if (error != OK) {
 				return error;
 			}
-
-			res->set(name, value);
 		}
-#ifdef TOOLS_ENABLED
-		res->set_edited(false);
-#endif
-		stage++;
 
 		if (progress) {
 			*progress = (i + 1) / float(internal_resources.size());
 		}
 
-		resource_cache.push_back(res);
-
 		if (main) {
 			f->close();
 			resource = res;
@@ -781,6 +844,41 @@ Error ResourceLoaderBinary::load() {
 	return ERR_FILE_EOF;
 }
 
+Error ResourceLoaderBinary::load_sub_resource(const String &p_id) {
+	if (error != OK) {
+		return error;
+	}
+
+	ERR_FAIL_COND_V_MSG(!using_named_scene_ids, ERR_UNAVAILABLE, "Loading a single sub-resource requires a resource file saved with named sub-resource IDs: " + local_path + ".");
+
+	// Dependencies are loaded as they are found, so none are requested upfront.
+	lazy = true;
+	use_sub_threads = false;
+	_update_paths();
+
+	for (int i = 0; i < internal_resources.size() - 1; i++) {
+		if (internal_resources[i].id != p_id) {
+			continue;
+		}
+
+		RES res;
+		error = _load_internal_resource(i, res);
+		if (error != OK) {
+			return error;
+		}
+		if (res.is_null()) {
+			res = internal_index_cache[internal_resources[i].path]; // Was cached already.
+		}
+
+		f->close();
+		resource = res;
+		return OK;
+	}
+
+	error = ERR_DOES_NOT_EXIST;
+	ERR_FAIL_V_MSG(error, "Sub-resource '" + p_id + "' not found in: " + local_path + ".");
+}
+
 void ResourceLoaderBinary::set_translation_remapped(bool p_remapped) {
 	translation_remapped = p_remapped;
 }
@@ -802,17 +900,11 @@ static String get_ustring(FileAccess *f) {
 }
 
 String ResourceLoaderBinary::get_unicode_string() {
-	int len = f->get_32();
-	if (len > str_buf.size()) {
-		str_buf.resize(len);
-	}
+	uint32_t len = f->get_32();
 	if (len == 0) {
 		return String();
 	}
-	f->get_buffer((uint8_t *)&str_buf[0], len);
-	String s;
-	s.parse_utf8(&str_buf[0]);
-	return s;
+	return _get_utf8(len);
 }
 
 void ResourceLoaderBinary::get_dependencies(FileAccess *p_f, List<String> *p_dependencies, bool p_add_types) {
@@ -1017,22 +1109,35 @@ RES ResourceFormatLoaderBinary::load(const String &p_path, const String &p_origi
 		*r_error = ERR_FILE_CANT_OPEN;
 	}
 
+	// A path like "res://library.res::Mesh_1" loads only that sub-resource.
+	String file_path = p_path;
+	String sub_resource_id;
+	int sub_resource_pos = p_path.find("::");
+	if (sub_resource_pos != -1) {
+		file_path = p_path.left(sub_resource_pos);
+		sub_resource_id = p_path.substr(sub_resource_pos + 2);
+	}
+
 	Error err;
-	FileAccess *f = FileAccess::open(p_path, FileAccess::READ, &err);
+	FileAccess *f = FileAccess::open(file_path, FileAccess::READ, &err);
 
-	ERR_FAIL_COND_V_MSG(err != OK, RES(), "Cannot open file '" + p_path + "'.");
+	ERR_FAIL_COND_V_MSG(err != OK, RES(), "Cannot open file '" + file_path + "'.");
 
 	ResourceLoaderBinary loader;
 	loader.cache_mode = p_cache_mode;
 	loader.use_sub_threads = p_use_sub_threads;
 	loader.progress = r_progress;
-	String path = p_original_path != "" ? p_original_path : p_path;
+	String path = (p_original_path != "" ? p_original_path : p_path).get_slice("::", 0);
 	loader.local_path = ProjectSettings::get_singleton()->localize_path(path);
 	loader.res_path = loader.local_path;
 	//loader.set_local_path( Globals::get_singleton()->localize_path(p_path) );
 	loader.open(f);
 
-	err = loader.load();
+	if (sub_resource_id.is_empty()) {
+		err = loader.load();
+	} else {
+		err = loader.load_sub_resource(sub_resource_id);
+	}
 
 	if (r_error) {
 		*r_error = err;
@@ -1061,6 +1166,11 @@ void ResourceFormatLoaderBinary::get_recognized_extensions_for_type(const String
 	}
 }
 
+bool ResourceFormatLoaderBinary::recognize_path(const String &p_path, const String &p_for_type) const {
+	// Sub-resources are recognized by the file they are in.
+	return ResourceFormatLoader::recognize_path(p_path.get_slice("::", 0), p_for_type);
+}
+
 void ResourceFormatLoaderBinary::get_recognized_extensions(List<String> *p_extensions) const {
 	List<String> extensions;
 	ClassDB::get_resource_base_extensions(&extensions);
@@ -55,6 +55,7 @@ class ResourceLoaderBinary {
 	Vector<StringName> string_map;
 
 	StringName _get_string();
+	String _get_utf8(uint32_t p_len);
 
 	struct ExtResource {
 		String path;
@@ -71,12 +72,19 @@ class ResourceLoaderBinary {
 
 	struct IntResource {
 		String path;
+		String id;
 		uint64_t offset;
+		bool loading = false;
+		bool loaded = false;
 	};
 
 	Vector<IntResource> internal_resources;
 	Map<String, RES> internal_index_cache;
 
+	// When loading a single sub-resource, only what it uses is loaded, when first referenced.
+	// Loading the main resource always loads every internal resource, in file order.
+	bool lazy = false;
+
 	String get_unicode_string();
 	void _advance_padding(uint32_t p_len);
 
@@ -88,6 +96,9 @@ class ResourceLoaderBinary {
 	friend class ResourceFormatLoaderBinary;
 
 	Error parse_variant(Variant &r_v);
+	void _update_paths();
+	Error _load_external_resource(int p_index);
+	Error _load_internal_resource(int p_index, RES &r_res);
 
 	Map<String, RES> dependency_cache;
 
@@ -95,6 +106,7 @@ public:
 	void set_local_path(const String &p_local_path);
 	Ref<Resource> get_resource();
 	Error load();
+	Error load_sub_resource(const String &p_id);
 	void set_translation_remapped(bool p_remapped);
 
 	void set_remaps(const Map<String, String> &p_remaps) { remaps = p_remaps; }
@@ -111,6 +123,7 @@ public:
 	virtual RES load(const String &p_path, const String &p_original_path = "", Error *r_error = nullptr, bool p_use_sub_threads = false, float *r_progress = nullptr, CacheMode p_cache_mode = CACHE_MODE_REUSE);
 	virtual void get_recognized_extensions_for_type(const String &p_type, List<String> *p_extensions) const;
 	virtual void get_recognized_extensions(List<String> *p_extensions) const;
+	virtual bool recognize_path(const String &p_path, const String &p_for_type = String()) const;
 	virtual bool handles_type(const String &p_type) const;
 	virtual String get_resource_type(const String &p_path) const;
 	virtual ResourceUID::ID get_resource_uid(const String &p_path) const;
@@ -213,15 +213,33 @@ RES ResourceLoader::_load(const String &p_path, const String &p_original_path, c
 	ERR_FAIL_V_MSG(RES(), "No loader found for resource: " + p_path + ".");
 }
 
-void ResourceLoader::_thread_load_function(void *p_userdata) {
-	ThreadLoadTask &load_task = *(ThreadLoadTask *)p_userdata;
-	load_task.loader_id = Thread::get_caller_id();
+void ResourceLoader::ThreadLoadTask::run() {
+	thread_load_mutex->lock();
+	bool claimed = !started;
+	started = true;
+	thread_load_mutex->unlock();
 
-	if (load_task.semaphore) {
-		//this is an actual thread, so wait for Ok from semaphore
-		thread_load_semaphore->wait(); //wait until its ok to start loading
+	if (claimed) {
+		_thread_load_function(this);
 	}
+
+	thread_load_mutex->lock();
+	pool_refs--;
+	bool release = erased && pool_refs == 0;
+	thread_load_mutex->unlock();
+
+	if (release) {
+		memdelete(this);
+	}
+}
+
+void ResourceLoader::_thread_load_function(ThreadLoadTask *p_load_task) {
+	ThreadLoadTask &load_task = *p_load_task;
+	load_task.loader_id = Thread::get_caller_id();
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
 	load_task.resource = _load(load_task.remapped_path, load_task.remapped_path != load_task.local_path ? load_task.local_path : String(), load_task.type_hint, load_task.cache_mode, &load_task.error, load_task.use_sub_threads, &load_task.progress);
+	load_task.load_time_usec = OS::get_singleton()->get_ticks_usec() - begin;
 
 	load_task.progress = 1.0; //it was fully loaded at this point, so force progress to 1.0
 
@@ -231,23 +249,13 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 	} else {
 		load_task.status = THREAD_LOAD_LOADED;
 	}
-	if (load_task.semaphore) {
-		if (load_task.start_next && thread_waiting_count > 0) {
-			thread_waiting_count--;
-			//thread loading count remains constant, this ends but another one begins
-			thread_load_semaphore->post();
-		} else {
-			thread_loading_count--; //no threads waiting, just reduce loading count
-		}
 
-		print_lt("END: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+	print_lt("END: " + load_task.local_path + " in " + rtos(load_task.load_time_usec / 1000.0) + " ms");
 
-		for (int i = 0; i < load_task.poll_requests; i++) {
-			load_task.semaphore->post();
-		}
-		memdelete(load_task.semaphore);
-		load_task.semaphore = nullptr;
+	for (int i = 0; i < load_task.poll_requests; i++) {
+		load_task.done.post();
 	}
+	load_task.poll_requests = 0;
 
 	if (load_task.resource.is_valid()) {
 		load_task.resource->set_path(load_task.local_path);
@@ -272,6 +280,34 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 	}
 
 	thread_load_mutex->unlock();
+
+	print_verbose(vformat("Loaded resource: %s (%.2f ms)", load_task.local_path, load_task.load_time_usec / 1000.0));
+}
+
+// Must be called with thread_load_mutex held. Each queued instance keeps the task alive until the pool runs it.
+void ResourceLoader::_queue_load_task(ThreadLoadTask *p_load_task, WorkerThreadPool::Priority p_priority) {
+	p_load_task->pool_refs++;
+	WorkerThreadPool::get_singleton()->add_task(p_load_task, p_priority);
+}
+
+// Must be called with thread_load_mutex held. Queues the task again at high priority, along with everything it
+// still depends on, so the thread waiting on it isn't held up by unrelated loads requested earlier.
+void ResourceLoader::_boost_load_task(ThreadLoadTask *p_load_task) {
+	if (p_load_task->boosted) {
+		return;
+	}
+	p_load_task->boosted = true;
+
+	if (!p_load_task->started) {
+		_queue_load_task(p_load_task, WorkerThreadPool::PRIORITY_HIGH);
+	}
+
+	for (Set<String>::Element *E = p_load_task->sub_tasks.front(); E; E = E->next()) {
+		ThreadLoadTask **sub_task = thread_load_tasks.getptr(E->get());
+		if (sub_task) {
+			_boost_load_task(*sub_task);
+		}
+	}
 }
 
 static String _validate_local_path(const String &p_path) {
@@ -289,95 +325,80 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 
 	thread_load_mutex->lock();
 
+	ThreadLoadTask *source_task = nullptr;
 	if (p_source_resource != String()) {
 		//must be loading from this resource
 		if (!thread_load_tasks.has(p_source_resource)) {
 			thread_load_mutex->unlock();
 			ERR_FAIL_V_MSG(ERR_INVALID_PARAMETER, "There is no thread loading source resource '" + p_source_resource + "'.");
 		}
+		source_task = thread_load_tasks[p_source_resource];
 		//must be loading from this thread
-		if (thread_load_tasks[p_source_resource].loader_id != Thread::get_caller_id()) {
+		if (source_task->loader_id != Thread::get_caller_id()) {
 			thread_load_mutex->unlock();
 			ERR_FAIL_V_MSG(ERR_INVALID_PARAMETER, "Threading loading resource'" + local_path + " failed: Source specified: '" + p_source_resource + "' but was not called by it.");
 		}
 
 		//must not be already added as s sub tasks
-		if (thread_load_tasks[p_source_resource].sub_tasks.has(local_path)) {
+		if (source_task->sub_tasks.has(local_path)) {
 			thread_load_mutex->unlock();
 			ERR_FAIL_V_MSG(ERR_INVALID_PARAMETER, "Thread loading source resource '" + p_source_resource + "' already is loading '" + local_path + "'.");
 		}
 	}
 
 	if (thread_load_tasks.has(local_path)) {
-		thread_load_tasks[local_path].requests++;
-		if (p_source_resource != String()) {
-			thread_load_tasks[p_source_resource].sub_tasks.insert(local_path);
+		thread_load_tasks[local_path]->requests++;
+		if (source_task) {
+			source_task->sub_tasks.insert(local_path);
 		}
 		thread_load_mutex->unlock();
 		return OK;
 	}
 
-	{
-		//create load task
+	//create load task
 
-		ThreadLoadTask load_task;
+	ThreadLoadTask *load_task = memnew(ThreadLoadTask);
 
-		load_task.requests = 1;
-		load_task.remapped_path = _path_remap(local_path, &load_task.xl_remapped);
-		load_task.local_path = local_path;
-		load_task.type_hint = p_type_hint;
-		load_task.cache_mode = p_cache_mode;
-		load_task.use_sub_threads = p_use_sub_threads;
+	load_task->requests = 1;
+	load_task->remapped_path = _path_remap(local_path, &load_task->xl_remapped);
+	load_task->local_path = local_path;
+	load_task->type_hint = p_type_hint;
+	load_task->cache_mode = p_cache_mode;
+	load_task->use_sub_threads = p_use_sub_threads;
+	// Dependencies inherit the priority of the resource that needs them.
+	load_task->priority = source_task ? source_task->priority : WorkerThreadPool::PRIORITY_LOW;
 
-		{ //must check if resource is already loaded before attempting to load it in a thread
+	{ //must check if resource is already loaded before attempting to load it in a thread
 
-			if (load_task.loader_id == Thread::get_caller_id()) {
-				thread_load_mutex->unlock();
-				ERR_FAIL_V_MSG(ERR_INVALID_PARAMETER, "Attempted to load a resource already being loaded from this thread, cyclic reference?");
-			}
-			//lock first if possible
-			ResourceCache::lock.read_lock();
-
-			//get ptr
-			Resource **rptr = ResourceCache::resources.getptr(local_path);
-
-			if (rptr) {
-				RES res(*rptr);
-				//it is possible this resource was just freed in a thread. If so, this referencing will not work and resource is considered not cached
-				if (res.is_valid()) {
-					//referencing is fine
-					load_task.resource = res;
-					load_task.status = THREAD_LOAD_LOADED;
-					load_task.progress = 1.0;
-				}
-			}
-			ResourceCache::lock.read_unlock();
-		}
+		//lock first if possible
+		ResourceCache::lock.read_lock();
 
-		if (p_source_resource != String()) {
-			thread_load_tasks[p_source_resource].sub_tasks.insert(local_path);
-		}
+		//get ptr
+		Resource **rptr = ResourceCache::resources.getptr(local_path);
 
-		thread_load_tasks[local_path] = load_task;
+		if (rptr) {
+			RES res(*rptr);
+			//it is possible this resource was just freed in a thread. If so, this referencing will not work and resource is considered not cached
+			if (res.is_valid()) {
+				//referencing is fine
+				load_task->resource = res;
+				load_task->status = THREAD_LOAD_LOADED;
+				load_task->progress = 1.0;
+				load_task->started = true;
+			}
+		}
+		ResourceCache::lock.read_unlock();
 	}
 
-	ThreadLoadTask &load_task = thread_load_tasks[local_path];
-
-	if (load_task.resource.is_null()) { //needs to be loaded in thread
-
-		load_task.semaphore = memnew(Semaphore);
-		if (thread_loading_count < thread_load_max) {
-			thread_loading_count++;
-			thread_load_semaphore->post(); //we have free threads, so allow one
-		} else {
-			thread_waiting_count++;
-		}
+	if (source_task) {
+		source_task->sub_tasks.insert(local_path);
+	}
 
-		print_lt("REQUEST: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+	thread_load_tasks[local_path] = load_task;
 
-		load_task.thread = memnew(Thread);
-		load_task.thread->start(_thread_load_function, &thread_load_tasks[local_path]);
-		load_task.loader_id = load_task.thread->get_id();
+	if (load_task->resource.is_null()) { //needs to be loaded in thread
+		print_lt("REQUEST: " + local_path);
+		_queue_load_task(load_task, load_task->priority);
 	}
 
 	thread_load_mutex->unlock();
@@ -387,7 +408,7 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 
 float ResourceLoader::_dependency_get_progress(const String &p_path) {
 	if (thread_load_tasks.has(p_path)) {
-		ThreadLoadTask &load_task = thread_load_tasks[p_path];
+		ThreadLoadTask &load_task = *thread_load_tasks[p_path];
 		int dep_count = load_task.sub_tasks.size();
 		if (dep_count > 0) {
 			float dep_progress = 0;
@@ -415,7 +436,7 @@ ResourceLoader::ThreadLoadStatus ResourceLoader::load_threaded_get_status(const
 		thread_load_mutex->unlock();
 		return THREAD_LOAD_INVALID_RESOURCE;
 	}
-	ThreadLoadTask &load_task = thread_load_tasks[local_path];
+	ThreadLoadTask &load_task = *thread_load_tasks[local_path];
 	ThreadLoadStatus status;
 	status = load_task.status;
 	if (r_progress) {
@@ -439,64 +460,47 @@ RES ResourceLoader::load_threaded_get(const String &p_path, Error *r_error) {
 		return RES();
 	}
 
-	ThreadLoadTask &load_task = thread_load_tasks[local_path];
-
-	//semaphore still exists, meaning it's still loading, request poll
-	Semaphore *semaphore = load_task.semaphore;
-	if (semaphore) {
-		load_task.poll_requests++;
-
-		{
-			// As we got a semaphore, this means we are going to have to wait
-			// until the sub-resource is done loading
-			//
-			// As this thread will become 'blocked' we should "exchange" its
-			// active status with a waiting one, to ensure load continues.
-			//
-			// This ensures loading is never blocked and that is also within
-			// the maximum number of active threads.
-
-			if (thread_waiting_count > 0) {
-				thread_waiting_count--;
-				thread_loading_count++;
-				thread_load_semaphore->post();
-
-				load_task.start_next = false; //do not start next since we are doing it here
-			}
-
-			thread_suspended_count++;
-
-			print_lt("GET: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
-		}
+	ThreadLoadTask *load_task = thread_load_tasks[local_path];
 
+	if (!load_task->started) {
+		// Nobody picked it up yet, so rather than waiting for a worker, load it right here.
+		// Someone is waiting on it now, so its dependencies are queued ahead of other loads.
+		load_task->started = true;
+		load_task->priority = WorkerThreadPool::PRIORITY_HIGH;
 		thread_load_mutex->unlock();
-		semaphore->wait();
+		_thread_load_function(load_task);
 		thread_load_mutex->lock();
-
-		thread_suspended_count--;
-
-		if (!thread_load_tasks.has(local_path)) { //may have been erased during unlock and this was always an invalid call
+	} else if (load_task->status == THREAD_LOAD_IN_PROGRESS) {
+		if (load_task->loader_id == Thread::get_caller_id()) {
 			thread_load_mutex->unlock();
 			if (r_error) {
 				*r_error = ERR_INVALID_PARAMETER;
 			}
-			return RES();
+			ERR_FAIL_V_MSG(RES(), "Attempted to load a resource already being loaded from this thread, cyclic reference?");
 		}
+
+		// Being loaded by another thread, make sure what it still waits on is loaded first.
+		_boost_load_task(load_task);
+
+		load_task->poll_requests++;
+		thread_load_mutex->unlock();
+		load_task->done.wait();
+		thread_load_mutex->lock();
 	}
 
-	RES resource = load_task.resource;
+	RES resource = load_task->resource;
 	if (r_error) {
-		*r_error = load_task.error;
+		*r_error = load_task->error;
 	}
 
-	load_task.requests--;
+	load_task->requests--;
 
-	if (load_task.requests == 0) {
-		if (load_task.thread) { //thread may not have been used
-			load_task.thread->wait_to_finish();
-			memdelete(load_task.thread);
-		}
+	if (load_task->requests == 0) {
 		thread_load_tasks.erase(local_path);
+		load_task->erased = true;
+		if (load_task->pool_refs == 0) {
+			memdelete(load_task);
+		}
 	}
 
 	thread_load_mutex->unlock();
@@ -553,20 +557,21 @@ RES ResourceLoader::load(const String &p_path, const String &p_type_hint, Resour
 		ResourceCache::lock.read_unlock();
 
 		//load using task (but this thread)
-		ThreadLoadTask load_task;
+		ThreadLoadTask *load_task = memnew(ThreadLoadTask);
 
-		load_task.requests = 1;
-		load_task.local_path = local_path;
-		load_task.remapped_path = _path_remap(local_path, &load_task.xl_remapped);
-		load_task.type_hint = p_type_hint;
-		load_task.cache_mode = p_cache_mode; //ignore
-		load_task.loader_id = Thread::get_caller_id();
+		load_task->requests = 1;
+		load_task->local_path = local_path;
+		load_task->remapped_path = _path_remap(local_path, &load_task->xl_remapped);
+		load_task->type_hint = p_type_hint;
+		load_task->cache_mode = p_cache_mode; //ignore
+		load_task->loader_id = Thread::get_caller_id();
+		load_task->started = true;
 
 		thread_load_tasks[local_path] = load_task;
 
 		thread_load_mutex->unlock();
 
-		_thread_load_function(&thread_load_tasks[local_path]);
+		_thread_load_function(load_task);
 
 		return load_threaded_get(p_path, r_error);
 
@@ -798,6 +803,12 @@ ResourceUID::ID ResourceLoader::get_resource_uid(const String &p_path) {
 }
 
 String ResourceLoader::_path_remap(const String &p_path, bool *r_translation_remapped) {
+	int sub_resource_pos = p_path.find("::");
+	if (sub_resource_pos != -1) {
+		// Remap the file the sub-resource is in.
+		return _path_remap(p_path.left(sub_resource_pos), r_translation_remapped) + p_path.substr(sub_resource_pos);
+	}
+
 	String new_path = p_path;
 
 	if (translation_remaps.has(p_path)) {
@@ -1051,16 +1062,10 @@ void ResourceLoader::remove_custom_loaders() {
 
 void ResourceLoader::initialize() {
 	thread_load_mutex = memnew(Mutex);
-	thread_load_max = OS::get_singleton()->get_processor_count();
-	thread_loading_count = 0;
-	thread_waiting_count = 0;
-	thread_suspended_count = 0;
-	thread_load_semaphore = memnew(Semaphore);
 }
 
 void ResourceLoader::finalize() {
 	memdelete(thread_load_mutex);
-	memdelete(thread_load_semaphore);
 }
 
 ResourceLoadErrorNotify ResourceLoader::err_notify = nullptr;
@@ -1073,13 +1078,7 @@ bool ResourceLoader::abort_on_missing_resource = true;
 bool ResourceLoader::timestamp_on_load = false;
 
 Mutex *ResourceLoader::thread_load_mutex = nullptr;
-HashMap<String, ResourceLoader::ThreadLoadTask> ResourceLoader::thread_load_tasks;
-Semaphore *ResourceLoader::thread_load_semaphore = nullptr;
-
-int ResourceLoader::thread_loading_count = 0;
-int ResourceLoader::thread_waiting_count = 0;
-int ResourceLoader::thread_suspended_count = 0;
-int ResourceLoader::thread_load_max = 0;
+HashMap<String, ResourceLoader::ThreadLoadTask *> ResourceLoader::thread_load_tasks;
 
 SelfList<Resource>::List ResourceLoader::remapped_list;
 HashMap<String, Vector<String>> ResourceLoader::translation_remaps;
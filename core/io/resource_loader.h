@@ -36,6 +36,7 @@
 #include "core/object/script_language.h"
 #include "core/os/semaphore.h"
 #include "core/os/thread.h"
+#include "core/os/worker_thread_pool.h"
 
 class ResourceFormatLoader : public RefCounted {
 	GDCLASS(ResourceFormatLoader, RefCounted);
@@ -127,10 +128,14 @@ private:
 
 	static Ref<ResourceFormatLoader> _find_custom_resource_format_loader(String path);
 
-	struct ThreadLoadTask {
-		Thread *thread = nullptr;
+	// Threaded loads run as tasks in the WorkerThreadPool. Tasks are shared by
+	// every request for the same path and freed once the last request got its
+	// result and no pool queue references them anymore. A task is run by whoever
+	// claims it first: a pool worker, or a thread waiting for it in load_threaded_get().
+	// They are background tasks, so a pool wait() elsewhere (physics, rendering,
+	// audio) never ends up loading inline.
+	struct ThreadLoadTask : public WorkerThreadPool::Task {
 		Thread::ID loader_id = 0;
-		Semaphore *semaphore = nullptr;
 		String local_path;
 		String remapped_path;
 		String type_hint;
@@ -141,20 +146,29 @@ private:
 		RES resource;
 		bool xl_remapped = false;
 		bool use_sub_threads = false;
-		bool start_next = true;
+		WorkerThreadPool::Priority priority = WorkerThreadPool::PRIORITY_LOW;
+		bool started = false;
+		bool boosted = false;
+		bool erased = false;
+		int pool_refs = 0;
 		int requests = 0;
 		int poll_requests = 0;
+		Semaphore done;
+		uint64_t load_time_usec = 0;
 		Set<String> sub_tasks;
+
+		virtual void run() override;
+
+		ThreadLoadTask() {
+			background = true;
+		}
 	};
 
-	static void _thread_load_function(void *p_userdata);
+	static void _thread_load_function(ThreadLoadTask *p_load_task);
+	static void _queue_load_task(ThreadLoadTask *p_load_task, WorkerThreadPool::Priority p_priority);
+	static void _boost_load_task(ThreadLoadTask *p_load_task);
 	static Mutex *thread_load_mutex;
-	static HashMap<String, ThreadLoadTask> thread_load_tasks;
-	static Semaphore *thread_load_semaphore;
-	static int thread_waiting_count;
-	static int thread_loading_count;
-	static int thread_suspended_count;
-	static int thread_load_max;
+	static HashMap<String, ThreadLoadTask *> thread_load_tasks;
 
 	static float _dependency_get_progress(const String &p_path);
 
@@ -416,6 +416,9 @@ private:
 #include "bvh_split.inc"
 };
 
+template <class T, int MAX_CHILDREN, int MAX_ITEMS, bool USE_PAIRS, class Bounds, class Point>
+thread_local LocalVector<uint32_t, uint32_t, true> BVH_Tree<T, MAX_CHILDREN, MAX_ITEMS, USE_PAIRS, Bounds, Point>::_cull_hits;
+
 #undef VERBOSE_PRINT
 
 #endif // BVH_TREE_H
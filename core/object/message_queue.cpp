@@ -33,13 +33,137 @@
 #include "core/config/project_settings.h"
 #include "core/core_string_names.h"
 #include "core/object/script_language.h"
+#include "core/os/thread.h"
 
 MessageQueue *MessageQueue::singleton = nullptr;
+thread_local MessageQueue::ThreadQueueRef MessageQueue::thread_queue;
+uint64_t MessageQueue::last_instance = 0;
 
 MessageQueue *MessageQueue::get_singleton() {
 	return singleton;
 }
 
+void MessageQueue::ThreadQueueRef::release() {
+	// The owner may already be deleted at shutdown, so only the queue is
+	// touched. The next flush drops it once drained.
+	if (queue) {
+		queue->lock.lock();
+		queue->thread_exited = true;
+		queue->lock.unlock();
+		if (queue->refcount.unref()) {
+			memdelete(queue);
+		}
+	}
+	owner = nullptr;
+	queue = nullptr;
+}
+
+MessageQueue::ThreadQueue *MessageQueue::_get_thread_queue() {
+	if (likely(thread_queue.owner == this && thread_queue.owner_instance == instance)) {
+		return thread_queue.queue;
+	}
+
+	// A queue left from a previous message queue.
+	thread_queue.release();
+
+	ThreadQueue *queue = memnew(ThreadQueue);
+	queue->refcount.init(2);
+	queue->page_size = Thread::get_caller_id() == Thread::get_main_id() ? buffer_size : THREAD_QUEUE_SIZE_KB * 1024;
+
+	queues_mutex.lock();
+	queues.push_back(queue);
+	queue_count.set(queues.size());
+	queues_mutex.unlock();
+
+	thread_queue.owner = this;
+	thread_queue.owner_instance = instance;
+	thread_queue.queue = queue;
+	return queue;
+}
+
+MessageQueue::Message *MessageQueue::_allocate_message(ThreadQueue *p_queue, int p_argcount) {
+	uint32_t room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
+
+	if (p_queue->pages.is_empty() || p_queue->pages[p_queue->pages.size() - 1].end + room_needed > p_queue->pages[p_queue->pages.size() - 1].size) {
+		Page page;
+		page.size = MAX(p_queue->page_size, room_needed);
+		page.data = (uint8_t *)memalloc(page.size);
+		p_queue->pages.push_back(page);
+	}
+
+	Page &page = p_queue->pages[p_queue->pages.size() - 1];
+	Message *msg = memnew_placement(&page.data[page.end], Message);
+	msg->sequence = last_sequence.increment();
+	page.end += room_needed;
+	p_queue->used += room_needed;
+	return msg;
+}
+
+MessageQueue::Message *MessageQueue::_pop_message(ThreadQueue *p_queue) {
+	MutexLock lock(p_queue->lock);
+
+	while (p_queue->read_page < p_queue->pages.size()) {
+		Page &page = p_queue->pages[p_queue->read_page];
+		if (p_queue->read_pos < page.end) {
+			Message *message = (Message *)&page.data[p_queue->read_pos];
+			//pre-advance so flushing is reentrant
+			p_queue->read_pos += _get_message_size(message);
+			return message;
+		}
+		if (p_queue->read_page + 1 == p_queue->pages.size()) {
+			break;
+		}
+		p_queue->read_page++;
+		p_queue->read_pos = 0;
+	}
+
+	// Drained. The previous message was already freed, so rewind to the
+	// first page and release the ones added to absorb a burst.
+	for (uint32_t i = 1; i < p_queue->pages.size(); i++) {
+		memfree(p_queue->pages[i].data);
+	}
+	if (p_queue->pages.size() > 1) {
+		p_queue->pages.resize(1);
+	}
+	if (p_queue->pages.size()) {
+		p_queue->pages[0].end = 0;
+	}
+	p_queue->read_page = 0;
+	p_queue->read_pos = 0;
+	p_queue->used = 0;
+
+	return nullptr;
+}
+
+void MessageQueue::_free_message(Message *p_message) {
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		Variant *args = (Variant *)(p_message + 1);
+		for (int i = 0; i < p_message->args; i++) {
+			args[i].~Variant();
+		}
+	}
+
+	p_message->~Message();
+}
+
+void MessageQueue::_free_queue(ThreadQueue *p_queue) {
+	Message *message = _pop_message(p_queue);
+	while (message) {
+		_free_message(message);
+		message = _pop_message(p_queue);
+	}
+
+	for (uint32_t i = 0; i < p_queue->pages.size(); i++) {
+		memfree(p_queue->pages[i].data);
+	}
+	p_queue->pages.clear();
+
+	// The thread may still hold it.
+	if (p_queue->refcount.unref()) {
+		memdelete(p_queue);
+	}
+}
+
 Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
 	return push_callable(Callable(p_id, p_method), p_args, p_argcount, p_show_error);
 }
@@ -60,56 +184,33 @@ Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, VARIANT
 }
 
 Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
-	_THREAD_SAFE_METHOD_
-
-	uint8_t room_needed = sizeof(Message) + sizeof(Variant);
-
-	if ((buffer_end + room_needed) >= buffer_size) {
-		String type;
-		if (ObjectDB::get_instance(p_id)) {
-			type = ObjectDB::get_instance(p_id)->get_class();
-		}
-		print_line("Failed set: " + type + ":" + p_prop + " target ID: " + itos(p_id));
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
+	ThreadQueue *queue = _get_thread_queue();
+	MutexLock lock(queue->lock);
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = _allocate_message(queue, 1);
 	msg->args = 1;
 	msg->callable = Callable(p_id, p_prop);
 	msg->type = TYPE_SET;
 
-	buffer_end += sizeof(Message);
-
-	Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-	buffer_end += sizeof(Variant);
+	Variant *v = memnew_placement(msg + 1, Variant);
 	*v = p_value;
 
 	return OK;
 }
 
 Error MessageQueue::push_notification(ObjectID p_id, int p_notification) {
-	_THREAD_SAFE_METHOD_
-
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
 
-	uint8_t room_needed = sizeof(Message);
+	ThreadQueue *queue = _get_thread_queue();
+	MutexLock lock(queue->lock);
 
-	if ((buffer_end + room_needed) >= buffer_size) {
-		print_line("Failed notification: " + itos(p_notification) + " target ID: " + itos(p_id));
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
-
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = _allocate_message(queue, 0);
 
 	msg->type = TYPE_NOTIFICATION;
 	msg->callable = Callable(p_id, CoreStringNames::get_singleton()->notification); //name is meaningless but callable needs it
 	//msg->target;
 	msg->notification = p_notification;
 
-	buffer_end += sizeof(Message);
-
 	return OK;
 }
 
@@ -126,17 +227,10 @@ Error MessageQueue::push_set(Object *p_object, const StringName &p_prop, const V
 }
 
 Error MessageQueue::push_callable(const Callable &p_callable, const Variant **p_args, int p_argcount, bool p_show_error) {
-	_THREAD_SAFE_METHOD_
+	ThreadQueue *queue = _get_thread_queue();
+	MutexLock lock(queue->lock);
 
-	int room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
-
-	if ((buffer_end + room_needed) >= buffer_size) {
-		print_line("Failed method: " + p_callable);
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
-
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = _allocate_message(queue, p_argcount);
 	msg->args = p_argcount;
 	msg->callable = p_callable;
 	msg->type = TYPE_CALL;
@@ -144,11 +238,9 @@ Error MessageQueue::push_callable(const Callable &p_callable, const Variant **p_
 		msg->type |= FLAG_SHOW_ERROR;
 	}
 
-	buffer_end += sizeof(Message);
-
+	Variant *args = (Variant *)(msg + 1);
 	for (int i = 0; i < p_argcount; i++) {
-		Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-		buffer_end += sizeof(Variant);
+		Variant *v = memnew_placement(&args[i], Variant);
 		*v = *p_args[i];
 	}
 
@@ -175,56 +267,67 @@ void MessageQueue::statistics() {
 	Map<int, int> notify_count;
 	Map<Callable, int> call_count;
 	int null_count = 0;
+	uint32_t total_bytes = 0;
 
-	uint32_t read_pos = 0;
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
+	MutexLock queues_lock(queues_mutex);
 
-		Object *target = message->callable.get_object();
+	for (uint32_t q = 0; q < queues.size(); q++) {
+		ThreadQueue *queue = queues[q];
+		MutexLock lock(queue->lock);
+		total_bytes += queue->used;
 
-		if (target != nullptr) {
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
-					if (!call_count.has(message->callable)) {
-						call_count[message->callable] = 0;
-					}
+		for (uint32_t p = queue->read_page; p < queue->pages.size(); p++) {
+			const Page &page = queue->pages[p];
+			uint32_t read_pos = p == queue->read_page ? queue->read_pos : 0;
 
-					call_count[message->callable]++;
+			while (read_pos < page.end) {
+				Message *message = (Message *)&page.data[read_pos];
 
-				} break;
-				case TYPE_NOTIFICATION: {
-					if (!notify_count.has(message->notification)) {
-						notify_count[message->notification] = 0;
-					}
+				Object *target = message->callable.get_object();
 
-					notify_count[message->notification]++;
+				if (target != nullptr) {
+					switch (message->type & FLAG_MASK) {
+						case TYPE_CALL: {
+							if (!call_count.has(message->callable)) {
+								call_count[message->callable] = 0;
+							}
 
-				} break;
-				case TYPE_SET: {
-					StringName t = message->callable.get_method();
-					if (!set_count.has(t)) {
-						set_count[t] = 0;
-					}
+							call_count[message->callable]++;
 
-					set_count[t]++;
+						} break;
+						case TYPE_NOTIFICATION: {
+							if (!notify_count.has(message->notification)) {
+								notify_count[message->notification] = 0;
+							}
 
-				} break;
-			}
+							notify_count[message->notification]++;
 
-		} else {
-			//object was deleted
-			print_line("Object was deleted while awaiting a callback");
+						} break;
+						case TYPE_SET: {
+							StringName t = message->callable.get_method();
+							if (!set_count.has(t)) {
+								set_count[t] = 0;
+							}
 
-			null_count++;
-		}
+							set_count[t]++;
+
+						} break;
+					}
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
+				} else {
+					//object was deleted
+					print_line("Object was deleted while awaiting a callback");
+
+					null_count++;
+				}
+
+				read_pos += _get_message_size(message);
+			}
 		}
 	}
 
-	print_line("TOTAL BYTES: " + itos(buffer_end));
+	print_line("TOTAL BYTES: " + itos(total_bytes));
+	print_line("THREAD QUEUES: " + itos(queues.size()));
 	print_line("NULL count: " + itos(null_count));
 
 	for (Map<StringName, int>::Element *E = set_count.front(); E; E = E->next()) {
@@ -244,6 +347,10 @@ int MessageQueue::get_max_buffer_usage() const {
 	return buffer_max_used;
 }
 
+int MessageQueue::get_last_flush_message_count() const {
+	return last_flush_message_count;
+}
+
 void MessageQueue::_call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error) {
 	const Variant **argptrs = nullptr;
 	if (p_argcount) {
@@ -262,35 +369,61 @@ void MessageQueue::_call_function(const Callable &p_callable, const Variant *p_a
 }
 
 void MessageQueue::flush() {
-	if (buffer_end > buffer_max_used) {
-		buffer_max_used = buffer_end;
+	ERR_FAIL_COND(flushing.is_set()); //already flushing, you did something odd
+	flushing.set();
+
+	LocalVector<ThreadQueue *> to_flush;
+	queues_mutex.lock();
+	to_flush = queues;
+	queues_mutex.unlock();
+
+	uint32_t buffer_used = 0;
+	for (uint32_t i = 0; i < to_flush.size(); i++) {
+		MutexLock lock(to_flush[i]->lock);
+		buffer_used += to_flush[i]->used;
 	}
-
-	uint32_t read_pos = 0;
-
-	//using reverse locking strategy
-	_THREAD_SAFE_LOCK_
-
-	if (flushing) {
-		_THREAD_SAFE_UNLOCK_
-		ERR_FAIL_COND(flushing); //already flushing, you did something odd
+	if (buffer_used > buffer_max_used) {
+		buffer_max_used = buffer_used;
 	}
-	flushing = true;
-
-	while (read_pos < buffer_end) {
-		//lock on each iteration, so a call can re-add itself to the message queue
 
-		Message *message = (Message *)&buffer[read_pos];
+	// Messages run in the order they were posted across all threads, including
+	// whatever their calls post. The next message of each queue is popped ahead,
+	// and the oldest of them runs first.
+	LocalVector<Message *> next_messages;
+	next_messages.resize(to_flush.size());
+	for (uint32_t i = 0; i < to_flush.size(); i++) {
+		next_messages[i] = nullptr;
+	}
 
-		uint32_t advance = sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			advance += sizeof(Variant) * message->args;
+	uint32_t message_count = 0;
+	while (true) {
+		// Pick up threads that posted their first message meanwhile.
+		if (queue_count.get() != to_flush.size()) {
+			queues_mutex.lock();
+			to_flush = queues;
+			queues_mutex.unlock();
+			for (uint32_t i = next_messages.size(); i < to_flush.size(); i++) {
+				next_messages.push_back(nullptr);
+			}
 		}
 
-		//pre-advance so this function is reentrant
-		read_pos += advance;
+		// Queues found empty may have been posted to by now.
+		int oldest = -1;
+		for (uint32_t i = 0; i < to_flush.size(); i++) {
+			if (!next_messages[i]) {
+				next_messages[i] = _pop_message(to_flush[i]);
+			}
+			if (next_messages[i] && (oldest < 0 || next_messages[i]->sequence < next_messages[oldest]->sequence)) {
+				oldest = i;
+			}
+		}
+		if (oldest < 0) {
+			break;
+		}
 
-		_THREAD_SAFE_UNLOCK_
+		Message *message = next_messages[oldest];
+		next_messages[oldest] = nullptr;
+		message_count++;
 
 		Object *target = message->callable.get_object();
 
@@ -318,57 +451,52 @@ void MessageQueue::flush() {
 			}
 		}
 
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			Variant *args = (Variant *)(message + 1);
-			for (int i = 0; i < message->args; i++) {
-				args[i].~Variant();
-			}
-		}
-
-		message->~Message();
+		_free_message(message);
+	}
 
-		_THREAD_SAFE_LOCK_
+	// Queues of exited threads can't receive more messages.
+	queues_mutex.lock();
+	for (uint32_t i = 0; i < queues.size();) {
+		ThreadQueue *queue = queues[i];
+		queue->lock.lock();
+		bool remove = queue->thread_exited && queue->read_page == 0 && queue->read_pos == 0 && (queue->pages.is_empty() || queue->pages[0].end == 0);
+		queue->lock.unlock();
+		if (remove) {
+			_free_queue(queue);
+			queues.remove(i);
+			queue_count.set(queues.size());
+		} else {
+			i++;
+		}
 	}
+	queues_mutex.unlock();
 
-	buffer_end = 0; // reset buffer
-	flushing = false;
-	_THREAD_SAFE_UNLOCK_
+	last_flush_message_count = message_count;
+	flushing.clear();
 }
 
 bool MessageQueue::is_flushing() const {
-	return flushing;
+	return flushing.is_set();
 }
 
 MessageQueue::MessageQueue() {
 	ERR_FAIL_COND_MSG(singleton != nullptr, "A MessageQueue singleton already exists.");
 	singleton = this;
+	instance = ++last_instance;
 
 	buffer_size = GLOBAL_DEF_RST("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
 	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/message_queue/max_size_kb", PropertyInfo(Variant::INT, "memory/limits/message_queue/max_size_kb", PROPERTY_HINT_RANGE, "1024,4096,1,or_greater"));
 	buffer_size *= 1024;
-	buffer = memnew_arr(uint8_t, buffer_size);
+
+	// Registers the main thread first, so its messages always run first.
+	_get_thread_queue();
 }
 
 MessageQueue::~MessageQueue() {
-	uint32_t read_pos = 0;
-
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
-		Variant *args = (Variant *)(message + 1);
-		int argc = message->args;
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			for (int i = 0; i < argc; i++) {
-				args[i].~Variant();
-			}
-		}
-		message->~Message();
-
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
-		}
+	for (uint32_t i = 0; i < queues.size(); i++) {
+		_free_queue(queues[i]);
 	}
+	queues.clear();
 
 	singleton = nullptr;
-	memdelete_arr(buffer);
 }
@@ -32,13 +32,15 @@
 #define MESSAGE_QUEUE_H
 
 #include "core/object/class_db.h"
-#include "core/os/thread_safe.h"
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 
 class MessageQueue {
-	_THREAD_SAFE_CLASS_
-
 	enum {
-		DEFAULT_QUEUE_SIZE_KB = 4096
+		DEFAULT_QUEUE_SIZE_KB = 4096,
+		// Other threads usually post a handful of calls per frame.
+		THREAD_QUEUE_SIZE_KB = 64
 	};
 
 	enum {
@@ -52,6 +54,7 @@ class MessageQueue {
 
 	struct Message {
 		Callable callable;
+		uint64_t sequence; // Global posting order, queues are merged by it.
 		int16_t type;
 		union {
 			int16_t notification;
@@ -59,16 +62,67 @@ class MessageQueue {
 		};
 	};
 
-	uint8_t *buffer;
-	uint32_t buffer_end = 0;
-	uint32_t buffer_max_used = 0;
-	uint32_t buffer_size;
+	// Messages never move once pushed, so one can run while the call it
+	// makes pushes more. A queue grows by adding pages.
+	struct Page {
+		uint8_t *data = nullptr;
+		uint32_t size = 0;
+		uint32_t end = 0;
+	};
+
+	// Messages posted by a single thread, in order. Only that thread pushes
+	// and only the flushing thread pops, so the lock is rarely contended.
+	// The thread and the message queue each hold a reference, whichever
+	// lets go last deletes it, so neither outlives the other's data.
+	struct ThreadQueue {
+		SafeRefCount refcount;
+		BinaryMutex lock;
+		LocalVector<Page> pages;
+		uint32_t page_size = 0;
+		uint32_t read_page = 0;
+		uint32_t read_pos = 0;
+		uint32_t used = 0;
+		bool thread_exited = false;
+	};
 
+	struct ThreadQueueRef {
+		MessageQueue *owner = nullptr;
+		uint64_t owner_instance = 0;
+		ThreadQueue *queue = nullptr;
+		void release();
+		~ThreadQueueRef() { release(); }
+	};
+
+	static thread_local ThreadQueueRef thread_queue;
+	static uint64_t last_instance;
+
+	uint64_t instance = 0;
+	uint32_t buffer_size;
+	uint32_t buffer_max_used = 0;
+	uint32_t last_flush_message_count = 0;
+
+	BinaryMutex queues_mutex;
+	LocalVector<ThreadQueue *> queues;
+	SafeNumeric<uint32_t> queue_count; // Lets flush() notice new queues without locking.
+	SafeNumeric<uint64_t> last_sequence;
+
+	ThreadQueue *_get_thread_queue();
+	Message *_allocate_message(ThreadQueue *p_queue, int p_argcount);
+	Message *_pop_message(ThreadQueue *p_queue);
+	void _free_message(Message *p_message);
+	void _free_queue(ThreadQueue *p_queue);
 	void _call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error);
 
+	static _FORCE_INLINE_ uint32_t _get_message_size(const Message *p_message) {
+		if ((p_message->type & FLAG_MASK) == TYPE_NOTIFICATION) {
+			return sizeof(Message);
+		}
+		return sizeof(Message) + sizeof(Variant) * p_message->args;
+	}
+
 	static MessageQueue *singleton;
 
-	bool flushing = false;
+	SafeFlag flushing;
 
 public:
 	static MessageQueue *get_singleton();
@@ -90,6 +144,7 @@ public:
 	bool is_flushing() const;
 
 	int get_max_buffer_usage() const;
+	int get_last_flush_message_count() const;
 
 	MessageQueue();
 	~MessageQueue();
@@ -1000,11 +1000,30 @@ bool Object::_has_user_signal(const StringName &p_name) const {
 	return signal_map[p_name].user.name.length() > 0;
 }
 
-struct _ObjectSignalDisconnectData {
-	StringName signal;
-	Callable callable;
+// Tracks the emissions running on this thread, so they stop walking the slots if the emitter is freed by a callback.
+struct _ObjectEmitFrame {
+	enum {
+		BIND_STACK_SIZE = 16
+	};
+
+	static thread_local _ObjectEmitFrame *current;
+
+	Object *object;
+	bool freed = false;
+	_ObjectEmitFrame *prev;
+
+	_ObjectEmitFrame(Object *p_object) {
+		object = p_object;
+		prev = current;
+		current = this;
+	}
+	~_ObjectEmitFrame() {
+		current = prev;
+	}
 };
 
+thread_local _ObjectEmitFrame *_ObjectEmitFrame::current = nullptr;
+
 Variant Object::_emit_signal(const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
 	r_error.error = Callable::CallError::CALL_ERROR_TOO_FEW_ARGUMENTS;
 
@@ -1048,23 +1067,35 @@ Error Object::emit_signal(const StringName &p_name, const Variant **p_args, int
 		return ERR_UNAVAILABLE;
 	}
 
-	List<_ObjectSignalDisconnectData> disconnect_data;
-
-	//copy on write will ensure that disconnecting the signal or even deleting the object will not affect the signal calling.
-	//this happens automatically and will not change the performance of calling.
-	//awesome, isn't it?
-	VMap<Callable, SignalData::Slot> slot_map = s->slot_map;
-
-	int ssize = slot_map.size();
+	// Slots are called in place instead of from a copy. Slots connected by a callback have a
+	// generation at least as high as this emission and are skipped, disconnected ones are only
+	// flagged until the last emission of this signal is done.
+	_ObjectEmitFrame frame(this);
+	s->emitting++;
+	uint32_t generation = ++s->generation;
 
 	OBJ_DEBUG_LOCK
 
-	Vector<const Variant *> bind_mem;
+	// Bound arguments go after the emitted ones, on the stack unless there are too many.
+	const Variant *bind_stack[_ObjectEmitFrame::BIND_STACK_SIZE];
+	LocalVector<const Variant *> bind_heap;
 
 	Error err = OK;
 
-	for (int i = 0; i < ssize; i++) {
-		const Connection &c = slot_map.getv(i).conn;
+	int slot_count = s->slot_map.size();
+	int previous_slots = 0; // Slots that existed before the emission, up to the current one.
+
+	for (int i = 0; i < s->slot_map.size(); i++) {
+		const SignalData::Slot *slot = &((const VMap<Callable, SignalData::Slot> &)s->slot_map).getv(i);
+		if (slot->generation >= generation) {
+			continue;
+		}
+		previous_slots++;
+		if (slot->removed) {
+			continue;
+		}
+
+		const Connection &c = slot->conn;
 
 		Object *target = c.callable.get_object();
 		if (!target) {
@@ -1074,71 +1105,117 @@ Error Object::emit_signal(const StringName &p_name, const Variant **p_args, int
 
 		const Variant **args = p_args;
 		int argc = p_argcount;
+		uint32_t flags = c.flags;
+		// Keeps the bound arguments alive even if the callback disconnects the slot.
+		Vector<Variant> binds = c.binds;
 
-		if (c.binds.size()) {
+		if (binds.size()) {
 			//handle binds
-			bind_mem.resize(p_argcount + c.binds.size());
+			argc = p_argcount + binds.size();
+			if (argc <= _ObjectEmitFrame::BIND_STACK_SIZE) {
+				args = bind_stack;
+			} else {
+				bind_heap.resize(argc);
+				args = bind_heap.ptr();
+			}
 
 			for (int j = 0; j < p_argcount; j++) {
-				bind_mem.write[j] = p_args[j];
+				args[j] = p_args[j];
 			}
-			for (int j = 0; j < c.binds.size(); j++) {
-				bind_mem.write[p_argcount + j] = &c.binds[j];
+			for (int j = 0; j < binds.size(); j++) {
+				args[p_argcount + j] = &binds[j];
 			}
-
-			args = (const Variant **)bind_mem.ptr();
-			argc = bind_mem.size();
 		}
 
-		if (c.flags & CONNECT_DEFERRED) {
+		if (flags & CONNECT_DEFERRED) {
 			MessageQueue::get_singleton()->push_callable(c.callable, args, argc, true);
 		} else {
 			Callable::CallError ce;
 			_emitting = true;
 			Variant ret;
 			c.callable.call(args, argc, ret, ce);
+			if (frame.freed) {
+				return err; // The callback freed this object, there is nothing left to walk.
+			}
 			_emitting = false;
 
+			if (s->slot_map.size() != slot_count) {
+				// The callback connected new slots, which may have moved this one.
+				slot_count = s->slot_map.size();
+				int seen = 0;
+				for (i = 0; i < slot_count; i++) {
+					if (s->slot_map.getv(i).generation < generation && ++seen == previous_slots) {
+						break;
+					}
+				}
+				if (i == slot_count) {
+					break; // Can't happen, slots are never erased while emitting.
+				}
+				slot = &((const VMap<Callable, SignalData::Slot> &)s->slot_map).getv(i);
+			}
+
 			if (ce.error != Callable::CallError::CALL_OK) {
 #ifdef DEBUG_ENABLED
-				if (c.flags & CONNECT_PERSIST && Engine::get_singleton()->is_editor_hint() && (script.is_null() || !Ref<Script>(script)->is_tool())) {
+				if (flags & CONNECT_PERSIST && Engine::get_singleton()->is_editor_hint() && (script.is_null() || !Ref<Script>(script)->is_tool())) {
 					continue;
 				}
 #endif
 				if (ce.error == Callable::CallError::CALL_ERROR_INVALID_METHOD && !ClassDB::class_exists(target->get_class_name())) {
 					//most likely object is not initialized yet, do not throw error.
 				} else {
-					ERR_PRINT("Error calling from signal '" + String(p_name) + "' to callable: " + Variant::get_callable_error_text(c.callable, args, argc, ce) + ".");
+					ERR_PRINT("Error calling from signal '" + String(p_name) + "' to callable: " + Variant::get_callable_error_text(slot->conn.callable, args, argc, ce) + ".");
 					err = ERR_METHOD_NOT_FOUND;
 				}
 			}
 		}
 
-		bool disconnect = c.flags & CONNECT_ONESHOT;
+		bool disconnect = flags & CONNECT_ONESHOT;
 #ifdef TOOLS_ENABLED
-		if (disconnect && (c.flags & CONNECT_PERSIST) && Engine::get_singleton()->is_editor_hint()) {
+		if (disconnect && (flags & CONNECT_PERSIST) && Engine::get_singleton()->is_editor_hint()) {
 			//this signal was connected from the editor, and is being edited. just don't disconnect for now
 			disconnect = false;
 		}
 #endif
-		if (disconnect) {
-			_ObjectSignalDisconnectData dd;
-			dd.signal = p_name;
-			dd.callable = c.callable;
-			disconnect_data.push_back(dd);
+		if (disconnect && !slot->removed) {
+			_disconnect(p_name, slot->conn.callable);
 		}
 	}
 
-	while (!disconnect_data.is_empty()) {
-		const _ObjectSignalDisconnectData &dd = disconnect_data.front()->get();
-
-		_disconnect(dd.signal, dd.callable);
-		disconnect_data.pop_front();
+	s->emitting--;
+	if (s->emitting == 0) {
+		_signal_emitted(p_name, s);
 	}
 
 	return err;
 }
 
+void Object::_signal_emitted(const StringName &p_name, SignalData *p_signal) {
+	p_signal->generation = 0;
+
+	if (p_signal->new_slots) {
+		for (int i = 0; i < p_signal->slot_map.size(); i++) {
+			p_signal->slot_map.getv(i).generation = 0;
+		}
+		p_signal->new_slots = false;
+	}
+
+	if (p_signal->removed_slots == 0) {
+		return;
+	}
+
+	for (int i = p_signal->slot_map.size() - 1; i >= 0; i--) {
+		if (p_signal->slot_map.getv(i).removed) {
+			p_signal->slot_map.erase(p_signal->slot_map.getk(i));
+		}
+	}
+	p_signal->removed_slots = 0;
+
+	if (p_signal->slot_map.is_empty() && ClassDB::has_signal(get_class_name(), p_name)) {
+		//not user signal, delete
+		signal_map.erase(p_name);
+	}
+}
+
 Error Object::emit_signal(const StringName &p_name, VARIANT_ARG_DECLARE) {
 	VARIANT_ARGPTRS;
 
@@ -1262,7 +1339,9 @@ void Object::get_all_signal_connections(List<Connection> *p_connections) const {
 		const SignalData *s = &signal_map[*S];
 
 		for (int i = 0; i < s->slot_map.size(); i++) {
-			p_connections->push_back(s->slot_map.getv(i).conn);
+			if (!s->slot_map.getv(i).removed) {
+				p_connections->push_back(s->slot_map.getv(i).conn);
+			}
 		}
 	}
 }
@@ -1274,7 +1353,9 @@ void Object::get_signal_connection_list(const StringName &p_signal, List<Connect
 	}
 
 	for (int i = 0; i < s->slot_map.size(); i++) {
-		p_connections->push_back(s->slot_map.getv(i).conn);
+		if (!s->slot_map.getv(i).removed) {
+			p_connections->push_back(s->slot_map.getv(i).conn);
+		}
 	}
 }
 
@@ -1286,7 +1367,7 @@ int Object::get_persistent_signal_connection_count() const {
 		const SignalData *s = &signal_map[*S];
 
 		for (int i = 0; i < s->slot_map.size(); i++) {
-			if (s->slot_map.getv(i).conn.flags & CONNECT_PERSIST) {
+			if (!s->slot_map.getv(i).removed && s->slot_map.getv(i).conn.flags & CONNECT_PERSIST) {
 				count += 1;
 			}
 		}
@@ -1334,7 +1415,11 @@ Error Object::connect(const StringName &p_signal, const Callable &p_callable, co
 	Callable target = p_callable;
 
 	//compare with the base callable, so binds can be ignored
-	if (s->slot_map.has(*target.get_base_comparator())) {
+	int existing = s->slot_map.find(*target.get_base_comparator());
+	bool revived = existing != -1 && s->slot_map.getv(existing).removed;
+	if (revived) {
+		s->removed_slots--; // Disconnected during the current emission, replaced in place below.
+	} else if (existing != -1) {
 		if (p_flags & CONNECT_REFERENCE_COUNTED) {
 			s->slot_map[*target.get_base_comparator()].reference_count++;
 			return OK;
@@ -1355,6 +1440,12 @@ Error Object::connect(const StringName &p_signal, const Callable &p_callable, co
 	if (p_flags & CONNECT_REFERENCE_COUNTED) {
 		slot.reference_count = 1;
 	}
+	if (revived) {
+		slot.generation = s->slot_map.getv(existing).generation;
+	} else if (s->emitting > 0) {
+		slot.generation = s->generation;
+		s->new_slots = true;
+	}
 
 	//use callable version as key, so binds can be ignored
 	s->slot_map[*target.get_base_comparator()] = slot;
@@ -1380,7 +1471,8 @@ bool Object::is_connected(const StringName &p_signal, const Callable &p_callable
 
 	Callable target = p_callable;
 
-	return s->slot_map.has(*target.get_base_comparator());
+	int idx = s->slot_map.find(*target.get_base_comparator());
+	return idx != -1 && !s->slot_map.getv(idx).removed;
 	//const Map<Signal::Target,Signal::Slot>::Element *E = s->slot_map.find(target);
 	//return (E!=nullptr );
 }
@@ -1406,6 +1498,7 @@ void Object::_disconnect(const StringName &p_signal, const Callable &p_callable,
 	ERR_FAIL_COND_MSG(!s->slot_map.has(*p_callable.get_base_comparator()), "Disconnecting nonexistent signal '" + p_signal + "', callable: " + p_callable + ".");
 
 	SignalData::Slot *slot = &s->slot_map[p_callable];
+	ERR_FAIL_COND_MSG(slot->removed, "Disconnecting nonexistent signal '" + p_signal + "', callable: " + p_callable + ".");
 
 	if (!p_force) {
 		slot->reference_count--; // by default is zero, if it was not referenced it will go below it
@@ -1415,6 +1508,15 @@ void Object::_disconnect(const StringName &p_signal, const Callable &p_callable,
 	}
 
 	target_object->connections.erase(slot->cE);
+
+	if (s->emitting > 0) {
+		// The signal is being emitted, erasing would shift the slots being walked.
+		slot->removed = true;
+		slot->cE = nullptr;
+		s->removed_slots++;
+		return;
+	}
+
 	s->slot_map.erase(*p_callable.get_base_comparator());
 
 	if (s->slot_map.is_empty() && ClassDB::has_signal(get_class_name(), p_signal)) {
@@ -1867,6 +1969,12 @@ Object::~Object() {
 		ERR_PRINT("Object " + to_string() + " was freed or unreferenced while a signal is being emitted from it. Try connecting to the signal using 'CONNECT_DEFERRED' flag, or use queue_free() to free the object (if this object is a Node) to avoid this error and potential crashes.");
 	}
 
+	for (_ObjectEmitFrame *frame = _ObjectEmitFrame::current; frame; frame = frame->prev) {
+		if (frame->object == this) {
+			frame->freed = true;
+		}
+	}
+
 	while ((S = signal_map.next(nullptr))) {
 		SignalData *s = &signal_map[*S];
 
@@ -1875,7 +1983,9 @@ Object::~Object() {
 		const VMap<Callable, SignalData::Slot>::Pair *slot_list = s->slot_map.get_array();
 
 		for (int i = 0; i < slot_count; i++) {
-			slot_list[i].value.conn.callable.get_object()->connections.erase(slot_list[i].value.cE);
+			if (!slot_list[i].value.removed) {
+				slot_list[i].value.conn.callable.get_object()->connections.erase(slot_list[i].value.cE);
+			}
 		}
 
 		signal_map.erase(*S);
@@ -515,10 +515,18 @@ private:
 			int reference_count = 0;
 			Connection conn;
 			List<Connection>::Element *cE = nullptr;
+			uint32_t generation = 0; // Connected while emitting, only later emissions call it.
+			bool removed = false; // Disconnected while emitting, erased once done.
 		};
 
 		MethodInfo user;
 		VMap<Callable, Slot> slot_map;
+
+		// Emissions walk slot_map in place, so it can only grow while they run.
+		int emitting = 0;
+		uint32_t generation = 0;
+		int removed_slots = 0;
+		bool new_slots = false;
 	};
 
 	HashMap<StringName, SignalData> signal_map;
@@ -531,6 +539,7 @@ private:
 	ObjectID _instance_id;
 	bool _predelete();
 	void _postinitialize();
+	void _signal_emitted(const StringName &p_name, SignalData *p_signal);
 	bool _can_translate = true;
 	bool _emitting = false;
 #ifdef TOOLS_ENABLED
@@ -31,15 +31,18 @@
 #ifndef THREADED_ARRAY_PROCESSOR_H
 #define THREADED_ARRAY_PROCESSOR_H
 
-#include "core/os/mutex.h"
-#include "core/os/os.h"
-#include "core/os/thread.h"
-#include "core/os/thread_safe.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/templates/safe_refcount.h"
 
+// Runs a method over every element of an array on the shared WorkerThreadPool,
+// with the calling thread taking part. Elements are handed out p_batch_size at
+// a time, so very small per-element work doesn't pay one atomic increment and
+// one cache line transfer per element.
+
 template <class C, class U>
-struct ThreadArrayProcessData {
+struct ThreadArrayProcessData : public WorkerThreadPool::Task {
 	uint32_t elements;
+	uint32_t batch_size = 1;
 	SafeNumeric<uint32_t> index;
 	C *instance;
 	U userdata;
@@ -48,60 +51,43 @@ struct ThreadArrayProcessData {
 	void process(uint32_t p_index) {
 		(instance->*method)(p_index, userdata);
 	}
-};
-
-#ifndef NO_THREADS
 
-template <class T>
-void process_array_thread(void *ud) {
-	T &data = *(T *)ud;
-	while (true) {
-		uint32_t index = data.index.increment();
-		if (index >= data.elements) {
-			break;
+	virtual void run() override {
+		while (true) {
+			uint32_t from = index.postadd(batch_size);
+			if (from >= elements) {
+				break;
+			}
+			uint32_t to = MIN(from + batch_size, elements);
+			for (uint32_t i = from; i < to; i++) {
+				process(i);
+			}
 		}
-		data.process(index);
 	}
-}
+};
 
 template <class C, class M, class U>
-void thread_process_array(uint32_t p_elements, C *p_instance, M p_method, U p_userdata) {
+void thread_process_array(uint32_t p_elements, C *p_instance, M p_method, U p_userdata, uint32_t p_batch_size = 1) {
 	ThreadArrayProcessData<C, U> data;
 	data.method = p_method;
 	data.instance = p_instance;
 	data.userdata = p_userdata;
 	data.index.set(0);
 	data.elements = p_elements;
-	data.process(0); //process first, let threads increment for next
+	data.batch_size = MAX(p_batch_size, 1u);
 
-	int thread_count = OS::get_singleton()->get_processor_count();
-	Thread *threads = memnew_arr(Thread, thread_count);
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	uint32_t batches = (p_elements + data.batch_size - 1) / data.batch_size;
 
-	for (int i = 0; i < thread_count; i++) {
-		threads[i].start(process_array_thread<ThreadArrayProcessData<C, U>>, &data);
+	if (pool && pool->get_thread_count() > 0 && batches > 1) {
+		// The calling thread takes one share of the work itself.
+		WorkerThreadPool::Group group;
+		pool->add_task(&data, WorkerThreadPool::PRIORITY_NORMAL, &group, nullptr, MIN(batches - 1, pool->get_thread_count()));
+		data.run();
+		pool->wait(&group);
+	} else {
+		data.run();
 	}
-
-	for (int i = 0; i < thread_count; i++) {
-		threads[i].wait_to_finish();
-	}
-	memdelete_arr(threads);
 }
 
-#else
-
-template <class C, class M, class U>
-void thread_process_array(uint32_t p_elements, C *p_instance, M p_method, U p_userdata) {
-	ThreadArrayProcessData<C, U> data;
-	data.method = p_method;
-	data.instance = p_instance;
-	data.userdata = p_userdata;
-	data.index.set(0);
-	data.elements = p_elements;
-	for (uint32_t i = 0; i < p_elements; i++) {
-		data.process(i);
-	}
-}
-
-#endif
-
 #endif // THREADED_ARRAY_PROCESSOR_H
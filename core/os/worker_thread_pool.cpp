@@ -0,0 +1,355 @@
+/*************************************************************************/
+/*  worker_thread_pool.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "worker_thread_pool.h"
+
+#include "core/os/os.h"
+
+#include <thread>
+
+WorkerThreadPool *WorkerThreadPool::singleton = nullptr;
+thread_local int WorkerThreadPool::current_thread_index = -1;
+
+void WorkerThreadPool::TaskQueue::push_back(Task *p_task) {
+	if (count == tasks.size()) {
+		// Grow the ring, unwrapping it so it starts at zero again.
+		uint32_t old_size = tasks.size();
+		uint32_t new_size = old_size ? old_size * 2 : 16;
+		LocalVector<Task *> new_tasks;
+		new_tasks.resize(new_size);
+		for (uint32_t i = 0; i < count; i++) {
+			new_tasks[i] = tasks[(head + i) & (old_size - 1)];
+		}
+		tasks = new_tasks;
+		head = 0;
+	}
+	tasks[(head + count) & (tasks.size() - 1)] = p_task;
+	count++;
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::TaskQueue::pop_back() {
+	while (count > 0) {
+		count--;
+		Task *task = tasks[(head + count) & (tasks.size() - 1)];
+		if (task) {
+			return task;
+		}
+	}
+	return nullptr;
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::TaskQueue::pop_front() {
+	while (count > 0) {
+		Task *task = tasks[head];
+		head = (head + 1) & (tasks.size() - 1);
+		count--;
+		if (task) {
+			return task;
+		}
+	}
+	return nullptr;
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::TaskQueue::take(const Group *p_group) {
+	for (uint32_t i = 0; i < count; i++) {
+		Task *&slot = tasks[(head + i) & (tasks.size() - 1)];
+		if (slot && slot->group == p_group) {
+			Task *task = slot;
+			slot = nullptr;
+			return task;
+		}
+	}
+	return nullptr;
+}
+
+void WorkerThreadPool::_thread_function(void *p_user) {
+	ThreadData *thread = static_cast<ThreadData *>(p_user);
+	current_thread_index = thread->index;
+
+	while (true) {
+		Task *task = singleton->_pop_task(PRIORITY_LOW, true);
+		if (task) {
+			singleton->_run_task(task);
+			continue;
+		}
+		singleton->work_available.wait();
+		if (singleton->exit_threads.is_set()) {
+			break;
+		}
+	}
+
+	current_thread_index = -1;
+}
+
+void WorkerThreadPool::_push_task(Task *p_task, uint32_t p_instances) {
+	if (thread_count == 0) {
+		// No workers (threads disabled), run everything on the calling thread.
+		for (uint32_t i = 0; i < p_instances; i++) {
+			_run_task(p_task);
+		}
+		return;
+	}
+
+	TaskQueue *queue = &global_queues[p_task->priority];
+	if (p_task->background) {
+		queue = &background_queues[p_task->priority];
+	} else if (current_thread_index >= 0) {
+		queue = &threads[current_thread_index].queues[p_task->priority];
+	}
+	queue->lock.lock();
+	for (uint32_t i = 0; i < p_instances; i++) {
+		queue->push_back(p_task);
+	}
+	queue->lock.unlock();
+
+	// Waking up more workers than exist only leads to spurious wake-ups later.
+	uint32_t wake = MIN(p_instances, thread_count);
+	for (uint32_t i = 0; i < wake; i++) {
+		work_available.post();
+	}
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::_pop_task(Priority p_lowest_priority, bool p_background) {
+	int own_index = current_thread_index;
+
+	for (int p = 0; p <= p_lowest_priority; p++) {
+		Task *task = nullptr;
+
+		if (own_index >= 0) {
+			TaskQueue &own = threads[own_index].queues[p];
+			own.lock.lock();
+			task = own.pop_back();
+			own.lock.unlock();
+			if (task) {
+				return task;
+			}
+		}
+
+		TaskQueue &global = global_queues[p];
+		global.lock.lock();
+		task = global.pop_front();
+		global.lock.unlock();
+		if (task) {
+			return task;
+		}
+
+		// Steal, starting from the neighbor so workers don't all hammer the same victim.
+		for (uint32_t i = 1; i <= thread_count; i++) {
+			uint32_t victim = (own_index + i) % thread_count;
+			if ((int)victim == own_index) {
+				continue;
+			}
+			TaskQueue &other = threads[victim].queues[p];
+			other.lock.lock();
+			task = other.pop_front();
+			other.lock.unlock();
+			if (task) {
+				return task;
+			}
+		}
+
+		if (p_background) {
+			TaskQueue &background = background_queues[p];
+			background.lock.lock();
+			task = background.pop_front();
+			background.lock.unlock();
+			if (task) {
+				return task;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::_take_group_task(const Group *p_group) {
+	// Tasks added from a worker are in its own queue, the rest in the global ones.
+	for (int p = 0; p < PRIORITY_MAX; p++) {
+		TaskQueue &queue = current_thread_index >= 0 ? threads[current_thread_index].queues[p] : global_queues[p];
+		queue.lock.lock();
+		Task *task = queue.take(p_group);
+		queue.lock.unlock();
+		if (task) {
+			return task;
+		}
+	}
+	return nullptr;
+}
+
+void WorkerThreadPool::_run_task(Task *p_task) {
+	// Read before running, the task may be freed as soon as its group completes.
+	Group *group = p_task->group;
+
+	p_task->run();
+
+	if (!group) {
+		return;
+	}
+
+	LocalVector<Group::Dependent> released;
+
+	group->mutex.lock();
+	if (group->pending.decrement() == 0) {
+		for (uint32_t i = 0; i < group->waiters; i++) {
+			group->completed.post();
+		}
+		group->waiters = 0;
+		released = group->dependents;
+		group->dependents.clear();
+	}
+	group->mutex.unlock();
+
+	for (uint32_t i = 0; i < released.size(); i++) {
+		_push_task(released[i].task, released[i].instances);
+	}
+}
+
+void WorkerThreadPool::add_task(Task *p_task, Priority p_priority, Group *p_group, Group *p_depends_on, uint32_t p_instances) {
+	ERR_FAIL_NULL(p_task);
+	ERR_FAIL_INDEX(p_priority, PRIORITY_MAX);
+	ERR_FAIL_COND(p_group && p_group == p_depends_on);
+
+	if (p_instances == 0) {
+		return;
+	}
+
+	p_task->group = p_group;
+	p_task->priority = p_priority;
+
+	if (p_group) {
+		p_group->mutex.lock();
+		p_group->pending.add(p_instances);
+		if (p_priority < p_group->priority) {
+			p_group->priority = p_priority;
+		}
+		p_group->mutex.unlock();
+	}
+
+	if (p_depends_on) {
+		MutexLock lock(p_depends_on->mutex);
+		if (p_depends_on->pending.get() > 0) {
+			Group::Dependent dependent;
+			dependent.task = p_task;
+			dependent.instances = p_instances;
+			p_depends_on->dependents.push_back(dependent);
+			return;
+		}
+	}
+
+	_push_task(p_task, p_instances);
+}
+
+void WorkerThreadPool::wait(Group *p_group, bool p_group_tasks_only) {
+	ERR_FAIL_NULL(p_group);
+
+	while (p_group->pending.get() > 0) {
+		// Only help with work at least as urgent as the one being waited on,
+		// so a high priority wait is never held up by a long low priority task.
+		Task *task = nullptr;
+		if (thread_count > 0) {
+			task = p_group_tasks_only ? _take_group_task(p_group) : _pop_task(p_group->priority, false);
+		}
+		if (task) {
+			_run_task(task);
+			continue;
+		}
+
+		if (current_thread_index >= 0) {
+			// Workers must stay responsive to newly queued tasks, so never block here.
+			std::this_thread::yield();
+			continue;
+		}
+
+		p_group->mutex.lock();
+		if (p_group->pending.get() == 0) {
+			p_group->mutex.unlock();
+			break;
+		}
+		p_group->waiters++;
+		p_group->mutex.unlock();
+		p_group->completed.wait();
+	}
+
+	// The thread that finished the last task may still be releasing the group.
+	MutexLock lock(p_group->mutex);
+	p_group->priority = PRIORITY_LOW;
+}
+
+void WorkerThreadPool::init(int p_thread_count) {
+	ERR_FAIL_COND(threads != nullptr);
+
+#ifdef NO_THREADS
+	p_thread_count = 0;
+#else
+	if (p_thread_count < 0) {
+		p_thread_count = OS::get_singleton()->get_processor_count();
+	}
+#endif
+
+	thread_count = p_thread_count;
+	if (thread_count == 0) {
+		return;
+	}
+
+	exit_threads.clear();
+	threads = memnew_arr(ThreadData, thread_count);
+
+	for (uint32_t i = 0; i < thread_count; i++) {
+		threads[i].index = i;
+		threads[i].thread.start(&WorkerThreadPool::_thread_function, &threads[i]);
+	}
+}
+
+void WorkerThreadPool::finish() {
+	if (threads == nullptr) {
+		return;
+	}
+
+	exit_threads.set();
+	for (uint32_t i = 0; i < thread_count; i++) {
+		work_available.post();
+	}
+	for (uint32_t i = 0; i < thread_count; i++) {
+		threads[i].thread.wait_to_finish();
+	}
+
+	memdelete_arr(threads);
+	threads = nullptr;
+	thread_count = 0;
+}
+
+WorkerThreadPool::WorkerThreadPool() {
+	singleton = this;
+}
+
+WorkerThreadPool::~WorkerThreadPool() {
+	finish();
+	singleton = nullptr;
+}
@@ -0,0 +1,164 @@
+/*************************************************************************/
+/*  worker_thread_pool.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef WORKER_THREAD_POOL_H
+#define WORKER_THREAD_POOL_H
+
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/spin_lock.h"
+#include "core/os/thread.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+// Engine-wide task scheduler. A single set of worker threads (one per core) is
+// shared by every subsystem that fans work out across cores, so physics,
+// culling, text rendering and importing overlap instead of each one bursting
+// its own threads in turn.
+//
+// Each worker owns one deque per priority. Tasks added from a worker are pushed
+// and popped at the back of its own deque, while idle workers steal from the
+// front of the others. Tasks added from any other thread go to a shared queue.
+//
+// Completion is tracked with Group counters. A task can depend on a group, in
+// which case it is only queued once every task in that group has finished.
+//
+// Background tasks (loading, streaming) mostly wait on I/O. They have queues of
+// their own that only workers take from, so they never run inline in wait()
+// and stall a thread waiting on unrelated work.
+
+class WorkerThreadPool {
+public:
+	enum Priority {
+		PRIORITY_HIGH,
+		PRIORITY_NORMAL,
+		PRIORITY_LOW,
+		PRIORITY_MAX
+	};
+
+	class Group;
+
+	class Task {
+		friend class WorkerThreadPool;
+
+		Group *group = nullptr;
+		Priority priority = PRIORITY_NORMAL;
+
+	protected:
+		// Set by tasks that block on I/O, see above.
+		bool background = false;
+
+	public:
+		virtual void run() = 0;
+		virtual ~Task() {}
+	};
+
+	class Group {
+		friend class WorkerThreadPool;
+
+		struct Dependent {
+			Task *task = nullptr;
+			uint32_t instances = 0;
+		};
+
+		SafeNumeric<uint32_t> pending;
+		BinaryMutex mutex;
+		LocalVector<Dependent> dependents;
+		Priority priority = PRIORITY_LOW; // Highest priority of the tasks added so far.
+		uint32_t waiters = 0;
+		Semaphore completed;
+
+	public:
+		// Only a hint, use wait() before releasing anything the tasks use.
+		_FORCE_INLINE_ uint32_t get_pending() const { return pending.get(); }
+	};
+
+private:
+	struct TaskQueue {
+		SpinLock lock;
+		LocalVector<Task *> tasks; // Used as a ring, size is always a power of two.
+		uint32_t head = 0;
+		uint32_t count = 0;
+
+		void push_back(Task *p_task);
+		Task *pop_back();
+		Task *pop_front();
+		// Leaves an empty slot behind, which the pop functions skip.
+		Task *take(const Group *p_group);
+	};
+
+	struct ThreadData {
+		int index = 0;
+		Thread thread;
+		TaskQueue queues[PRIORITY_MAX];
+	};
+
+	static WorkerThreadPool *singleton;
+	static thread_local int current_thread_index; // -1 on threads not owned by the pool.
+
+	ThreadData *threads = nullptr;
+	uint32_t thread_count = 0;
+	TaskQueue global_queues[PRIORITY_MAX];
+	TaskQueue background_queues[PRIORITY_MAX];
+
+	Semaphore work_available;
+	SafeFlag exit_threads;
+
+	static void _thread_function(void *p_user);
+
+	void _push_task(Task *p_task, uint32_t p_instances);
+	Task *_pop_task(Priority p_lowest_priority, bool p_background);
+	Task *_take_group_task(const Group *p_group);
+	void _run_task(Task *p_task);
+
+public:
+	static WorkerThreadPool *get_singleton() { return singleton; }
+
+	// The same task may be queued several times at once with p_instances, it will
+	// then run that many times, possibly in parallel. Tasks are not owned by the
+	// pool and must be kept alive until their group has been waited on.
+	void add_task(Task *p_task, Priority p_priority = PRIORITY_NORMAL, Group *p_group = nullptr, Group *p_depends_on = nullptr, uint32_t p_instances = 1);
+
+	// Blocks until every task in the group has finished, running queued tasks on
+	// the calling thread in the meantime, except background ones. Threads with a
+	// deadline, like the audio one, can limit this to the group's own tasks.
+	void wait(Group *p_group, bool p_group_tasks_only = false);
+
+	_FORCE_INLINE_ uint32_t get_thread_count() const { return thread_count; }
+	_FORCE_INLINE_ static bool is_worker_thread() { return current_thread_index >= 0; }
+
+	void init(int p_thread_count = -1);
+	void finish();
+
+	WorkerThreadPool();
+	~WorkerThreadPool();
+};
+
+#endif // WORKER_THREAD_POOL_H
@@ -74,6 +74,7 @@
 #include "core/object/undo_redo.h"
 #include "core/os/main_loop.h"
 #include "core/os/time.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/string/optimized_translation.h"
 #include "core/string/translation.h"
 
@@ -108,6 +109,8 @@ extern void unregister_global_constants();
 
 static ResourceUID *resource_uid = nullptr;
 
+static WorkerThreadPool *worker_thread_pool = nullptr;
+
 void register_core_types() {
 	//consistency check
 	static_assert(sizeof(Callable) <= 16);
@@ -117,6 +120,9 @@ void register_core_types() {
 	StringName::setup();
 	ResourceLoader::initialize();
 
+	worker_thread_pool = memnew(WorkerThreadPool);
+	worker_thread_pool->init();
+
 	register_global_constants();
 
 	Variant::register_types();
@@ -365,6 +371,8 @@ void unregister_core_types() {
 
 	unregister_global_constants();
 
+	memdelete(worker_thread_pool);
+
 	ClassDB::cleanup();
 	ResourceCache::clear();
 	CoreStringNames::free();
@@ -46,7 +46,8 @@ StringName _scs_create(const char *p_chr, bool p_static) {
 }
 
 bool StringName::configured = false;
-Mutex StringName::mutex;
+Mutex StringName::table_locks[STRING_TABLE_LOCK_COUNT];
+thread_local StringName::_ThreadCache StringName::thread_cache;
 
 #ifdef DEBUG_ENABLED
 bool StringName::debug_stringname = false;
@@ -60,8 +61,72 @@ void StringName::setup() {
 	configured = true;
 }
 
+void StringName::_ThreadCache::clear() {
+	for (int i = 0; i < THREAD_CACHE_LEN; i++) {
+		if (entries[i]) {
+			if (configured) {
+				// Adopts the cached reference and releases it.
+				StringName released(entries[i]);
+			}
+			entries[i] = nullptr;
+		}
+	}
+}
+
+StringName::_Data *StringName::_cache_find(uint32_t p_hash, const char *p_name) {
+#ifdef DEBUG_ENABLED
+	if (unlikely(debug_stringname)) {
+		return nullptr;
+	}
+#endif
+	_Data *data = thread_cache.entries[p_hash & THREAD_CACHE_MASK];
+	if (data && data->hash == p_hash && data->name_equals(p_name)) {
+		// Can't fail, the cache owns a reference.
+		data->refcount.ref();
+		return data;
+	}
+	return nullptr;
+}
+
+StringName::_Data *StringName::_cache_find(uint32_t p_hash, const String &p_name) {
+#ifdef DEBUG_ENABLED
+	if (unlikely(debug_stringname)) {
+		return nullptr;
+	}
+#endif
+	_Data *data = thread_cache.entries[p_hash & THREAD_CACHE_MASK];
+	if (data && data->hash == p_hash && data->name_equals(p_name)) {
+		data->refcount.ref();
+		return data;
+	}
+	return nullptr;
+}
+
+void StringName::_cache_store(_Data *p_data) {
+#ifdef DEBUG_ENABLED
+	if (unlikely(debug_stringname)) {
+		return;
+	}
+#endif
+	// Must not be called with a table lock held, evicting may free the old entry.
+	_Data *&entry = thread_cache.entries[p_data->hash & THREAD_CACHE_MASK];
+	if (entry == p_data || !p_data->refcount.ref()) {
+		return;
+	}
+	_Data *evicted = entry;
+	entry = p_data;
+	if (evicted) {
+		StringName released(evicted);
+	}
+}
+
 void StringName::cleanup() {
-	MutexLock lock(mutex);
+	// Other threads are gone by now, only this one can still hold cached names.
+	thread_cache.clear();
+
+	for (int i = 0; i < STRING_TABLE_LOCK_COUNT; i++) {
+		table_locks[i].lock();
+	}
 
 #ifdef DEBUG_ENABLED
 	if (unlikely(debug_stringname)) {
@@ -101,13 +166,17 @@ void StringName::cleanup() {
 		print_verbose("StringName: " + itos(lost_strings) + " unclaimed string names at exit.");
 	}
 	configured = false;
+
+	for (int i = STRING_TABLE_LOCK_COUNT - 1; i >= 0; i--) {
+		table_locks[i].unlock();
+	}
 }
 
 void StringName::unref() {
 	ERR_FAIL_COND(!configured);
 
 	if (_data && _data->refcount.unref()) {
-		MutexLock lock(mutex);
+		MutexLock lock(_get_table_lock(_data->idx));
 
 		if (_data->static_count.get() > 0) {
 			if (_data->cname) {
@@ -191,17 +260,30 @@ StringName::StringName(const char *p_name, bool p_static) {
 		return; //empty, ignore
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
+	_data = _cache_find(hash, p_name);
+	if (_data) {
+		if (p_static) {
+			_data->static_count.increment();
+		}
+		return;
+	}
+
+	_intern(hash, p_name, nullptr, p_static);
+	_cache_store(_data);
+}
+
+void StringName::_intern(uint32_t p_hash, const char *p_name, const char *p_static_name, bool p_static) {
+	uint32_t idx = p_hash & STRING_TABLE_MASK;
+
+	MutexLock lock(_get_table_lock(idx));
 
 	_data = _table[idx];
 
 	while (_data) {
 		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
+		if (_data->hash == p_hash && _data->name_equals(p_name)) {
 			break;
 		}
 		_data = _data->next;
@@ -218,18 +300,19 @@ StringName::StringName(const char *p_name, bool p_static) {
 				_data->debug_references++;
 			}
 #endif
+			return;
 		}
-
-		return;
 	}
 
 	_data = memnew(_Data);
-	_data->name = p_name;
+	if (!p_static_name) {
+		_data->name = p_name;
+	}
 	_data->refcount.init();
 	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
+	_data->hash = p_hash;
 	_data->idx = idx;
-	_data->cname = nullptr;
+	_data->cname = p_static_name;
 	_data->next = _table[idx];
 	_data->prev = nullptr;
 #ifdef DEBUG_ENABLED
@@ -252,57 +335,18 @@ StringName::StringName(const StaticCString &p_static_string, bool p_static) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_static_string.ptr);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_static_string.ptr) {
-			break;
-		}
-		_data = _data->next;
-	}
-
+	_data = _cache_find(hash, p_static_string.ptr);
 	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			if (p_static) {
-				_data->static_count.increment();
-			}
-#ifdef DEBUG_ENABLED
-			if (unlikely(debug_stringname)) {
-				_data->debug_references++;
-			}
-#endif
-			return;
+		if (p_static) {
+			_data->static_count.increment();
 		}
+		return;
 	}
 
-	_data = memnew(_Data);
-
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = p_static_string.ptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_intern(hash, p_static_string.ptr, p_static_string.ptr, p_static);
+	_cache_store(_data);
 }
 
 StringName::StringName(const String &p_name, bool p_static) {
@@ -314,15 +358,29 @@ StringName::StringName(const String &p_name, bool p_static) {
 		return;
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = p_name.hash();
-	uint32_t idx = hash & STRING_TABLE_MASK;
+
+	_data = _cache_find(hash, p_name);
+	if (_data) {
+		if (p_static) {
+			_data->static_count.increment();
+		}
+		return;
+	}
+
+	_intern(hash, p_name, p_static);
+	_cache_store(_data);
+}
+
+void StringName::_intern(uint32_t p_hash, const String &p_name, bool p_static) {
+	uint32_t idx = p_hash & STRING_TABLE_MASK;
+
+	MutexLock lock(_get_table_lock(idx));
 
 	_data = _table[idx];
 
 	while (_data) {
-		if (_data->hash == hash && _data->get_name() == p_name) {
+		if (_data->hash == p_hash && _data->name_equals(p_name)) {
 			break;
 		}
 		_data = _data->next;
@@ -347,7 +405,7 @@ StringName::StringName(const String &p_name, bool p_static) {
 	_data->name = p_name;
 	_data->refcount.init();
 	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
+	_data->hash = p_hash;
 	_data->idx = idx;
 	_data->cname = nullptr;
 	_data->next = _table[idx];
@@ -374,32 +432,40 @@ StringName StringName::search(const char *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
+
+	_Data *_data = _cache_find(hash, p_name);
+	if (_data) {
+		return StringName(_data);
+	}
+
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
-	_Data *_data = _table[idx];
+	{
+		MutexLock lock(_get_table_lock(idx));
 
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
+		_data = _table[idx];
+
+		while (_data) {
+			// compare hash first
+			if (_data->hash == hash && _data->name_equals(p_name)) {
+				break;
+			}
+			_data = _data->next;
 		}
-		_data = _data->next;
-	}
 
-	if (_data && _data->refcount.ref()) {
+		if (!_data || !_data->refcount.ref()) {
+			return StringName(); //does not exist
+		}
 #ifdef DEBUG_ENABLED
 		if (unlikely(debug_stringname)) {
 			_data->debug_references++;
 		}
 #endif
-
-		return StringName(_data);
 	}
 
-	return StringName(); //does not exist
+	_cache_store(_data);
+	return StringName(_data);
 }
 
 StringName StringName::search(const char32_t *p_name) {
@@ -410,12 +476,12 @@ StringName StringName::search(const char32_t *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
 
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
+	MutexLock lock(_get_table_lock(idx));
+
 	_Data *_data = _table[idx];
 
 	while (_data) {
@@ -436,32 +502,40 @@ StringName StringName::search(const char32_t *p_name) {
 StringName StringName::search(const String &p_name) {
 	ERR_FAIL_COND_V(p_name == "", StringName());
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = p_name.hash();
 
+	_Data *_data = _cache_find(hash, p_name);
+	if (_data) {
+		return StringName(_data);
+	}
+
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
-	_Data *_data = _table[idx];
+	{
+		MutexLock lock(_get_table_lock(idx));
 
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && p_name == _data->get_name()) {
-			break;
+		_data = _table[idx];
+
+		while (_data) {
+			// compare hash first
+			if (_data->hash == hash && _data->name_equals(p_name)) {
+				break;
+			}
+			_data = _data->next;
 		}
-		_data = _data->next;
-	}
 
-	if (_data && _data->refcount.ref()) {
+		if (!_data || !_data->refcount.ref()) {
+			return StringName(); //does not exist
+		}
 #ifdef DEBUG_ENABLED
 		if (unlikely(debug_stringname)) {
 			_data->debug_references++;
 		}
 #endif
-		return StringName(_data);
 	}
 
-	return StringName(); //does not exist
+	_cache_store(_data);
+	return StringName(_data);
 }
 
 bool operator==(const String &p_name, const StringName &p_string_name) {
@@ -46,7 +46,13 @@ class StringName {
 	enum {
 		STRING_TABLE_BITS = 16,
 		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_MASK = STRING_TABLE_LEN - 1,
+		// Each lock guards a contiguous range of buckets.
+		STRING_TABLE_LOCK_BITS = 6,
+		STRING_TABLE_LOCK_COUNT = 1 << STRING_TABLE_LOCK_BITS,
+		THREAD_CACHE_BITS = 8,
+		THREAD_CACHE_LEN = 1 << THREAD_CACHE_BITS,
+		THREAD_CACHE_MASK = THREAD_CACHE_LEN - 1
 	};
 
 	struct _Data {
@@ -58,6 +64,9 @@ class StringName {
 		uint32_t debug_references = 0;
 #endif
 		String get_name() const { return cname ? String(cname) : name; }
+		// Compare without building a String for static names.
+		_FORCE_INLINE_ bool name_equals(const char *p_name) const { return cname ? strcmp(cname, p_name) == 0 : name == p_name; }
+		_FORCE_INLINE_ bool name_equals(const String &p_name) const { return cname ? p_name == cname : name == p_name; }
 		int idx = 0;
 		uint32_t hash = 0;
 		_Data *prev = nullptr;
@@ -67,6 +76,26 @@ class StringName {
 
 	static _Data *_table[STRING_TABLE_LEN];
 
+	// Names recently used by a thread, looked up without locking. Every
+	// entry holds a reference, so it can't be freed while cached.
+	struct _ThreadCache {
+		_Data *entries[THREAD_CACHE_LEN] = {};
+		void clear();
+		~_ThreadCache() { clear(); }
+	};
+
+	static thread_local _ThreadCache thread_cache;
+
+	static _FORCE_INLINE_ Mutex &_get_table_lock(uint32_t p_idx) {
+		return table_locks[p_idx >> (STRING_TABLE_BITS - STRING_TABLE_LOCK_BITS)];
+	}
+	static _Data *_cache_find(uint32_t p_hash, const char *p_name);
+	static _Data *_cache_find(uint32_t p_hash, const String &p_name);
+	static void _cache_store(_Data *p_data);
+
+	void _intern(uint32_t p_hash, const char *p_name, const char *p_static_name, bool p_static);
+	void _intern(uint32_t p_hash, const String &p_name, bool p_static);
+
 	_Data *_data = nullptr;
 
 	union _HashUnion {
@@ -78,7 +107,7 @@ class StringName {
 	friend void register_core_types();
 	friend void unregister_core_types();
 	friend class Main;
-	static Mutex mutex;
+	static Mutex table_locks[STRING_TABLE_LOCK_COUNT];
 	static void setup();
 	static void cleanup();
 	static bool configured;
@@ -32,48 +32,23 @@
 
 #include "core/os/os.h"
 
-void ThreadWorkPool::_thread_function(void *p_user) {
-	ThreadData *thread = static_cast<ThreadData *>(p_user);
-	while (true) {
-		thread->start.wait();
-		if (thread->exit.load()) {
-			break;
-		}
-		thread->work->work();
-		thread->completed.post();
-	}
-}
-
-void ThreadWorkPool::init(int p_thread_count) {
-	ERR_FAIL_COND(threads != nullptr);
+void ThreadWorkPool::init(int p_thread_count, WorkerThreadPool::Priority p_priority) {
+	ERR_FAIL_COND(thread_count != 0);
 	if (p_thread_count < 0) {
-		p_thread_count = OS::get_singleton()->get_processor_count();
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		p_thread_count = pool ? pool->get_thread_count() : OS::get_singleton()->get_processor_count();
 	}
 
-	thread_count = p_thread_count;
-	threads = memnew_arr(ThreadData, thread_count);
-
-	for (uint32_t i = 0; i < thread_count; i++) {
-		threads[i].exit.store(false);
-		threads[i].thread.start(&ThreadWorkPool::_thread_function, &threads[i]);
-	}
+	// Work is still split in at least one batch when the shared pool has no workers.
+	thread_count = MAX(p_thread_count, 1);
+	priority = p_priority;
 }
 
 void ThreadWorkPool::finish() {
-	if (threads == nullptr) {
-		return;
+	if (current_work != nullptr) {
+		end_work();
 	}
-
-	for (uint32_t i = 0; i < thread_count; i++) {
-		threads[i].exit.store(true);
-		threads[i].start.post();
-	}
-	for (uint32_t i = 0; i < thread_count; i++) {
-		threads[i].thread.wait_to_finish();
-	}
-
-	memdelete_arr(threads);
-	threads = nullptr;
+	thread_count = 0;
 }
 
 ThreadWorkPool::~ThreadWorkPool() {
@@ -32,19 +32,23 @@
 #define THREAD_WORK_POOL_H
 
 #include "core/os/memory.h"
-#include "core/os/semaphore.h"
-#include "core/os/thread.h"
+#include "core/os/worker_thread_pool.h"
 
 #include <atomic>
 
+// Parallel-for front end over the engine-wide WorkerThreadPool. Instances are
+// cheap and spawn no threads of their own: each work batch is queued on the
+// shared pool as up to get_thread_count() tasks that pull element indices from
+// a common counter, and the thread calling end_work() helps process them.
+
 class ThreadWorkPool {
 	std::atomic<uint32_t> index;
 
-	struct BaseWork {
+	struct BaseWork : public WorkerThreadPool::Task {
 		std::atomic<uint32_t> *index = nullptr;
 		uint32_t max_elements = 0;
 		virtual void work() = 0;
-		virtual ~BaseWork() = default;
+		virtual void run() override { work(); }
 	};
 
 	template <class C, class M, class U>
@@ -63,24 +67,15 @@ class ThreadWorkPool {
 		}
 	};
 
-	struct ThreadData {
-		Thread thread;
-		Semaphore start;
-		Semaphore completed;
-		std::atomic<bool> exit;
-		BaseWork *work;
-	};
-
-	ThreadData *threads = nullptr;
 	uint32_t thread_count = 0;
+	WorkerThreadPool::Priority priority = WorkerThreadPool::PRIORITY_NORMAL;
+	WorkerThreadPool::Group group;
 	BaseWork *current_work = nullptr;
 
-	static void _thread_function(void *p_user);
-
 public:
 	template <class C, class M, class U>
 	void begin_work(uint32_t p_elements, C *p_instance, M p_method, U p_userdata) {
-		ERR_FAIL_COND(!threads); //never initialized
+		ERR_FAIL_COND(thread_count == 0); //never initialized
 		ERR_FAIL_COND(current_work != nullptr);
 
 		index.store(0, std::memory_order_release);
@@ -94,9 +89,11 @@ public:
 
 		current_work = w;
 
-		for (uint32_t i = 0; i < thread_count; i++) {
-			threads[i].work = w;
-			threads[i].start.post();
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		if (pool && pool->get_thread_count() > 0) {
+			pool->add_task(w, priority, &group, nullptr, MIN(p_elements, thread_count));
+		} else {
+			w->work(); // No shared workers available, process everything right away.
 		}
 	}
 
@@ -117,9 +114,13 @@ public:
 
 	void end_work() {
 		ERR_FAIL_COND(current_work == nullptr);
-		for (uint32_t i = 0; i < thread_count; i++) {
-			threads[i].completed.wait();
-			threads[i].work = nullptr;
+
+		// Take whatever elements are left instead of idling until the workers get to them.
+		current_work->work();
+
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		if (pool) {
+			pool->wait(&group);
 		}
 
 		memdelete(current_work);
@@ -133,7 +134,7 @@ public:
 	}
 
 	_FORCE_INLINE_ int get_thread_count() const { return thread_count; }
-	void init(int p_thread_count = -1);
+	void init(int p_thread_count = -1, WorkerThreadPool::Priority p_priority = WorkerThreadPool::PRIORITY_NORMAL);
 	void finish();
 	~ThreadWorkPool();
 };
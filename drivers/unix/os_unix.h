@@ -68,6 +68,9 @@ public:
 	virtual Error close_dynamic_library(void *p_library_handle) override;
 	virtual Error get_dynamic_library_symbol_handle(void *p_library_handle, const String p_name, void *&p_symbol_handle, bool p_optional = false) override;
 
+	virtual Error map_file(const String &p_path, const uint8_t *&r_data, uint64_t &r_size) override;
+	virtual Error unmap_file(const uint8_t *p_data, uint64_t p_size) override;
+
 	virtual Error set_cwd(const String &p_cwd) override;
 
 	virtual String get_name() const override;
@@ -32,6 +32,7 @@
 
 #include "core/config/project_settings.h"
 #include "core/io/compression.h"
+#include "core/io/dir_access.h"
 #include "core/io/file_access.h"
 #include "core/io/marshalls.h"
 #include "core/os/os.h"
@@ -4083,13 +4084,14 @@ RenderingDevice::VertexFormatID RenderingDeviceVulkan::vertex_format_create(cons
 	return id;
 }
 
-RID RenderingDeviceVulkan::vertex_array_create(uint32_t p_vertex_count, VertexFormatID p_vertex_format, const Vector<RID> &p_src_buffers) {
+RID RenderingDeviceVulkan::vertex_array_create(uint32_t p_vertex_count, VertexFormatID p_vertex_format, const Vector<RID> &p_src_buffers, const Vector<uint64_t> &p_offsets) {
 	_THREAD_SAFE_METHOD_
 
 	ERR_FAIL_COND_V(!vertex_formats.has(p_vertex_format), RID());
 	const VertexDescriptionCache &vd = vertex_formats[p_vertex_format];
 
 	ERR_FAIL_COND_V(vd.vertex_formats.size() != p_src_buffers.size(), RID());
+	ERR_FAIL_COND_V(p_offsets.size() && p_offsets.size() != p_src_buffers.size(), RID());
 
 	for (int i = 0; i < p_src_buffers.size(); i++) {
 		ERR_FAIL_COND_V(!vertex_buffer_owner.owns(p_src_buffers[i]), RID());
@@ -4102,6 +4104,7 @@ RID RenderingDeviceVulkan::vertex_array_create(uint32_t p_vertex_count, VertexFo
 	vertex_array.max_instances_allowed = 0xFFFFFFFF; //by default as many as you want
 	for (int i = 0; i < p_src_buffers.size(); i++) {
 		Buffer *buffer = vertex_buffer_owner.getornull(p_src_buffers[i]);
+		uint64_t offset = p_offsets.size() ? p_offsets[i] : 0;
 
 		//validate with buffer
 		{
@@ -4112,13 +4115,15 @@ RID RenderingDeviceVulkan::vertex_array_create(uint32_t p_vertex_count, VertexFo
 
 			if (atf.frequency == VERTEX_FREQUENCY_VERTEX) {
 				//validate size for regular drawing
-				uint64_t total_size = uint64_t(atf.stride) * (p_vertex_count - 1) + atf.offset + element_size;
+				uint64_t total_size = offset + uint64_t(atf.stride) * (p_vertex_count - 1) + atf.offset + element_size;
 				ERR_FAIL_COND_V_MSG(total_size > buffer->size, RID(),
 						"Attachment (" + itos(i) + ") will read past the end of the buffer.");
 
 			} else {
 				//validate size for instances drawing
-				uint64_t available = buffer->size - atf.offset;
+				ERR_FAIL_COND_V_MSG(offset + atf.offset > buffer->size, RID(),
+						"Attachment (" + itos(i) + ") starts past the end of the buffer.");
+				uint64_t available = buffer->size - offset - atf.offset;
 				ERR_FAIL_COND_V_MSG(available < element_size, RID(),
 						"Attachment (" + itos(i) + ") uses instancing, but it's just too small.");
 
@@ -4128,7 +4133,7 @@ RID RenderingDeviceVulkan::vertex_array_create(uint32_t p_vertex_count, VertexFo
 		}
 
 		vertex_array.buffers.push_back(buffer->buffer);
-		vertex_array.offsets.push_back(0); //offset unused, but passing anyway
+		vertex_array.offsets.push_back(offset);
 	}
 
 	RID id = vertex_array_owner.make_rid(vertex_array);
@@ -6512,10 +6517,25 @@ RID RenderingDeviceVulkan::render_pipeline_create(RID p_shader, FramebufferForma
 	graphics_pipeline_create_info.basePipelineHandle = VK_NULL_HANDLE;
 	graphics_pipeline_create_info.basePipelineIndex = 0;
 
+	VkPipelineCreationFeedbackEXT creation_feedback = {};
+	Vector<VkPipelineCreationFeedbackEXT> stage_creation_feedback;
+	VkPipelineCreationFeedbackCreateInfoEXT creation_feedback_create_info;
+	if (context->is_pipeline_creation_feedback_available()) {
+		stage_creation_feedback.resize(pipeline_stages.size());
+		creation_feedback_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT;
+		creation_feedback_create_info.pNext = nullptr;
+		creation_feedback_create_info.pPipelineCreationFeedback = &creation_feedback;
+		creation_feedback_create_info.pipelineStageCreationFeedbackCount = stage_creation_feedback.size();
+		creation_feedback_create_info.pPipelineStageCreationFeedbacks = stage_creation_feedback.ptrw();
+		graphics_pipeline_create_info.pNext = &creation_feedback_create_info;
+	}
+
 	RenderPipeline pipeline;
-	VkResult err = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &graphics_pipeline_create_info, nullptr, &pipeline.pipeline);
+	VkResult err = vkCreateGraphicsPipelines(device, pipeline_cache, 1, &graphics_pipeline_create_info, nullptr, &pipeline.pipeline);
 	ERR_FAIL_COND_V_MSG(err, RID(), "vkCreateGraphicsPipelines failed with error " + itos(err) + " for shader '" + shader->name + "'.");
 
+	_count_pipeline_creation_feedback(creation_feedback);
+
 	pipeline.set_formats = shader->set_formats;
 	pipeline.push_constant_stages = shader->push_constant.push_constants_vk_stage;
 	pipeline.pipeline_layout = shader->pipeline_layout;
@@ -6624,10 +6644,24 @@ RID RenderingDeviceVulkan::compute_pipeline_create(RID p_shader, const Vector<Pi
 		compute_pipeline_create_info.stage.pSpecializationInfo = &specialization_info;
 	}
 
+	VkPipelineCreationFeedbackEXT creation_feedback = {};
+	VkPipelineCreationFeedbackEXT stage_creation_feedback = {};
+	VkPipelineCreationFeedbackCreateInfoEXT creation_feedback_create_info;
+	if (context->is_pipeline_creation_feedback_available()) {
+		creation_feedback_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT;
+		creation_feedback_create_info.pNext = nullptr;
+		creation_feedback_create_info.pPipelineCreationFeedback = &creation_feedback;
+		creation_feedback_create_info.pipelineStageCreationFeedbackCount = 1;
+		creation_feedback_create_info.pPipelineStageCreationFeedbacks = &stage_creation_feedback;
+		compute_pipeline_create_info.pNext = &creation_feedback_create_info;
+	}
+
 	ComputePipeline pipeline;
-	VkResult err = vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &compute_pipeline_create_info, nullptr, &pipeline.pipeline);
+	VkResult err = vkCreateComputePipelines(device, pipeline_cache, 1, &compute_pipeline_create_info, nullptr, &pipeline.pipeline);
 	ERR_FAIL_COND_V_MSG(err, RID(), "vkCreateComputePipelines failed with error " + itos(err) + ".");
 
+	_count_pipeline_creation_feedback(creation_feedback);
+
 	pipeline.set_formats = shader->set_formats;
 	pipeline.push_constant_stages = shader->push_constant.push_constants_vk_stage;
 	pipeline.pipeline_layout = shader->pipeline_layout;
@@ -8594,6 +8628,11 @@ void RenderingDeviceVulkan::swap_buffers() {
 	frame = (frame + 1) % frame_count;
 
 	_begin_frame();
+
+	if (frames_drawn - pipeline_cache_last_save_frame >= PIPELINE_CACHE_SAVE_INTERVAL) {
+		_save_pipeline_cache();
+		pipeline_cache_last_save_frame = frames_drawn;
+	}
 }
 
 void RenderingDeviceVulkan::submit() {
@@ -8797,6 +8836,145 @@ void RenderingDeviceVulkan::_flush(bool p_current_frame) {
 	}
 }
 
+void RenderingDeviceVulkan::_load_pipeline_cache() {
+	const VkPhysicalDeviceProperties &props = context->get_device_properties();
+	Vector<uint8_t> cache_data;
+
+	if (GLOBAL_GET("rendering/vulkan/pipeline_cache/enable")) {
+		pipeline_cache_path = OS::get_singleton()->get_user_data_dir().plus_file("vulkan").plus_file("pipelines." + context->get_device_pipeline_cache_uuid() + ".cache");
+
+		FileAccessRef f = FileAccess::open(pipeline_cache_path, FileAccess::READ);
+		if (f) {
+			PipelineCacheHeader header = {};
+			uint64_t len = f->get_length();
+			if (len > sizeof(PipelineCacheHeader) && f->get_buffer((uint8_t *)&header, sizeof(PipelineCacheHeader)) == sizeof(PipelineCacheHeader) && header.magic == PIPELINE_CACHE_MAGIC && header.data_size == len - sizeof(PipelineCacheHeader)) {
+				cache_data.resize(header.data_size);
+				f->get_buffer(cache_data.ptrw(), header.data_size);
+			}
+
+			bool valid = !cache_data.is_empty() &&
+						 header.data_hash == hash_djb2_buffer(cache_data.ptr(), cache_data.size()) &&
+						 header.vendor_id == props.vendorID &&
+						 header.device_id == props.deviceID &&
+						 header.driver_version == props.driverVersion &&
+						 memcmp(header.uuid, props.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+
+			// The driver validates the data too, but not all of them do so reliably. Check its own
+			// header (VkPipelineCacheHeaderVersionOne, always little endian) before handing it over.
+			const uint32_t vk_header_size = 16 + VK_UUID_SIZE;
+			if (valid && cache_data.size() >= (int)vk_header_size) {
+				const uint8_t *r = cache_data.ptr();
+				valid = decode_uint32(&r[0]) >= vk_header_size &&
+						decode_uint32(&r[4]) == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+						decode_uint32(&r[8]) == props.vendorID &&
+						decode_uint32(&r[12]) == props.deviceID &&
+						memcmp(&r[16], props.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+			} else {
+				valid = false;
+			}
+
+			if (!valid) {
+				print_verbose("Vulkan: Discarding invalid pipeline cache: " + pipeline_cache_path);
+				cache_data.clear();
+			}
+		}
+	}
+
+	VkPipelineCacheCreateInfo cache_create_info;
+	cache_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	cache_create_info.pNext = nullptr;
+	cache_create_info.flags = 0;
+	cache_create_info.initialDataSize = cache_data.size();
+	cache_create_info.pInitialData = cache_data.ptr();
+
+	VkResult err = vkCreatePipelineCache(device, &cache_create_info, nullptr, &pipeline_cache);
+	if (err && !cache_data.is_empty()) {
+		// Rejected by the driver, start over with an empty cache.
+		cache_data.clear();
+		cache_create_info.initialDataSize = 0;
+		cache_create_info.pInitialData = nullptr;
+		err = vkCreatePipelineCache(device, &cache_create_info, nullptr, &pipeline_cache);
+	}
+	if (err) {
+		pipeline_cache = VK_NULL_HANDLE;
+		pipeline_cache_path = String();
+		ERR_FAIL_MSG("vkCreatePipelineCache failed with error " + itos(err) + ".");
+	}
+
+	pipeline_cache_saved_size = cache_data.size();
+	if (!cache_data.is_empty()) {
+		print_verbose("Vulkan: Loaded pipeline cache (" + itos(cache_data.size()) + " bytes): " + pipeline_cache_path);
+	}
+}
+
+void RenderingDeviceVulkan::_save_pipeline_cache() {
+	if (pipeline_cache == VK_NULL_HANDLE || pipeline_cache_path.is_empty()) {
+		return;
+	}
+
+	size_t data_size = 0;
+	VkResult err = vkGetPipelineCacheData(device, pipeline_cache, &data_size, nullptr);
+	ERR_FAIL_COND(err);
+	// Pipelines are only ever added, so an unchanged size means nothing new to save.
+	if (data_size == 0 || data_size == pipeline_cache_saved_size) {
+		return;
+	}
+
+	Vector<uint8_t> cache_data;
+	cache_data.resize(data_size);
+	err = vkGetPipelineCacheData(device, pipeline_cache, &data_size, cache_data.ptrw());
+	ERR_FAIL_COND(err != VK_SUCCESS && err != VK_INCOMPLETE);
+	cache_data.resize(data_size);
+
+	const VkPhysicalDeviceProperties &props = context->get_device_properties();
+	PipelineCacheHeader header = {};
+	header.magic = PIPELINE_CACHE_MAGIC;
+	header.data_size = cache_data.size();
+	header.data_hash = hash_djb2_buffer(cache_data.ptr(), cache_data.size());
+	header.vendor_id = props.vendorID;
+	header.device_id = props.deviceID;
+	header.driver_version = props.driverVersion;
+	memcpy(header.uuid, props.pipelineCacheUUID, VK_UUID_SIZE);
+
+	DirAccessRef da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	da->make_dir_recursive(pipeline_cache_path.get_base_dir());
+
+	// Write to a temporary file first, so a crash while saving never leaves a truncated cache behind.
+	String tmp_path = pipeline_cache_path + ".tmp";
+	{
+		FileAccessRef f = FileAccess::open(tmp_path, FileAccess::WRITE);
+		ERR_FAIL_COND_MSG(!f, "Can't save pipeline cache to: " + tmp_path);
+		f->store_buffer((const uint8_t *)&header, sizeof(PipelineCacheHeader));
+		f->store_buffer(cache_data.ptr(), cache_data.size());
+	}
+	if (da->file_exists(pipeline_cache_path)) {
+		da->remove(pipeline_cache_path);
+	}
+	Error rename_err = da->rename(tmp_path, pipeline_cache_path);
+	ERR_FAIL_COND_MSG(rename_err != OK, "Can't save pipeline cache to: " + pipeline_cache_path);
+
+	pipeline_cache_saved_size = data_size;
+}
+
+void RenderingDeviceVulkan::_count_pipeline_creation_feedback(const VkPipelineCreationFeedbackEXT &p_feedback) {
+	if (!(p_feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT)) {
+		return; // Extension unavailable or the driver doesn't know.
+	}
+	if (p_feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT) {
+		pipeline_cache_hits.increment();
+	} else {
+		pipeline_cache_misses.increment();
+	}
+}
+
+uint64_t RenderingDeviceVulkan::get_pipeline_cache_hits() const {
+	return pipeline_cache_hits.get();
+}
+
+uint64_t RenderingDeviceVulkan::get_pipeline_cache_misses() const {
+	return pipeline_cache_misses.get();
+}
+
 void RenderingDeviceVulkan::initialize(VulkanContext *p_context, bool p_local_device) {
 	// get our device capabilities
 	{
@@ -8948,6 +9126,11 @@ void RenderingDeviceVulkan::initialize(VulkanContext *p_context, bool p_local_de
 	draw_list_split = false;
 
 	compute_list = nullptr;
+
+	GLOBAL_DEF("rendering/vulkan/pipeline_cache/enable", true);
+	if (!p_local_device) {
+		_load_pipeline_cache();
+	}
 }
 
 template <class T>
@@ -9230,6 +9413,12 @@ void RenderingDeviceVulkan::finalize() {
 	}
 	framebuffer_formats.clear();
 
+	if (pipeline_cache != VK_NULL_HANDLE) {
+		_save_pipeline_cache();
+		vkDestroyPipelineCache(device, pipeline_cache, nullptr);
+		pipeline_cache = VK_NULL_HANDLE;
+	}
+
 	//all these should be clear at this point
 	ERR_FAIL_COND(descriptor_pools.size());
 	ERR_FAIL_COND(dependency_map.size());
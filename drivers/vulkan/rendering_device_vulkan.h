@@ -35,6 +35,7 @@
 #include "core/templates/local_vector.h"
 #include "core/templates/oa_hash_map.h"
 #include "core/templates/rid_owner.h"
+#include "core/templates/safe_refcount.h"
 #include "servers/rendering/rendering_device.h"
 
 #ifdef DEBUG_ENABLED
@@ -1033,6 +1034,39 @@ class RenderingDeviceVulkan : public RenderingDevice {
 	void _finalize_command_bufers();
 	void _begin_frame();
 
+	/************************/
+	/**** PIPELINE CACHE ****/
+	/************************/
+
+	// Pipeline cache data is stored in the user data dir, prefixed by this header
+	// so stale or damaged files (other driver, truncated write) are discarded.
+
+	enum {
+		PIPELINE_CACHE_MAGIC = 0x43505652, // "RVPC"
+		PIPELINE_CACHE_SAVE_INTERVAL = 600, // In frames.
+	};
+
+	struct PipelineCacheHeader {
+		uint32_t magic;
+		uint32_t data_size;
+		uint32_t data_hash;
+		uint32_t vendor_id;
+		uint32_t device_id;
+		uint32_t driver_version;
+		uint8_t uuid[VK_UUID_SIZE];
+	};
+
+	VkPipelineCache pipeline_cache = VK_NULL_HANDLE;
+	String pipeline_cache_path;
+	size_t pipeline_cache_saved_size = 0;
+	uint64_t pipeline_cache_last_save_frame = 0;
+	SafeNumeric<uint64_t> pipeline_cache_hits;
+	SafeNumeric<uint64_t> pipeline_cache_misses;
+
+	void _load_pipeline_cache();
+	void _save_pipeline_cache();
+	void _count_pipeline_creation_feedback(const VkPipelineCreationFeedbackEXT &p_feedback);
+
 public:
 	virtual RID texture_create(const TextureFormat &p_format, const TextureView &p_view, const Vector<Vector<uint8_t>> &p_data = Vector<Vector<uint8_t>>());
 	virtual RID texture_create_shared(const TextureView &p_view, RID p_with_texture);
@@ -1079,7 +1113,7 @@ public:
 
 	// Internally reference counted, this ID is warranted to be unique for the same description, but needs to be freed as many times as it was allocated
 	virtual VertexFormatID vertex_format_create(const Vector<VertexAttribute> &p_vertex_formats);
-	virtual RID vertex_array_create(uint32_t p_vertex_count, VertexFormatID p_vertex_format, const Vector<RID> &p_src_buffers);
+	virtual RID vertex_array_create(uint32_t p_vertex_count, VertexFormatID p_vertex_format, const Vector<RID> &p_src_buffers, const Vector<uint64_t> &p_offsets = Vector<uint64_t>());
 
 	virtual RID index_buffer_create(uint32_t p_size_indices, IndexBufferFormat p_format, const Vector<uint8_t> &p_data = Vector<uint8_t>(), bool p_use_restart_indices = false);
 
@@ -1217,6 +1251,9 @@ public:
 
 	virtual uint64_t get_memory_usage(MemoryType p_type) const;
 
+	virtual uint64_t get_pipeline_cache_hits() const;
+	virtual uint64_t get_pipeline_cache_misses() const;
+
 	virtual void set_resource_name(RID p_id, const String p_name);
 
 	virtual void draw_command_begin_label(String p_label_name, const Color p_color = Color(1, 1, 1, 1));
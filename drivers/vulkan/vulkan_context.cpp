@@ -783,6 +783,11 @@ Error VulkanContext::_create_physical_device() {
 				// if multiview is supported, enable it
 				extension_names[enabled_extension_count++] = VK_KHR_MULTIVIEW_EXTENSION_NAME;
 			}
+			if (!strcmp(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME, device_extensions[i].extensionName)) {
+				// Used to tell whether pipelines were found in the pipeline cache.
+				pipeline_creation_feedback_available = true;
+				extension_names[enabled_extension_count++] = VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME;
+			}
 			if (enabled_extension_count >= MAX_EXTENSIONS) {
 				free(device_extensions);
 				ERR_FAIL_V_MSG(ERR_BUG, "Enabled extension count reaches MAX_EXTENSIONS, BUG");
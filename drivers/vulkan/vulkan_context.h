@@ -87,6 +87,7 @@ private:
 	uint32_t vulkan_minor = 0;
 	SubgroupCapabilities subgroup_capabilities;
 	MultiviewCapabilities multiview_capabilities;
+	bool pipeline_creation_feedback_available = false;
 
 	String device_vendor;
 	String device_name;
@@ -238,6 +239,7 @@ public:
 	uint32_t get_vulkan_minor() const { return vulkan_minor; };
 	SubgroupCapabilities get_subgroup_capabilities() const { return subgroup_capabilities; };
 	MultiviewCapabilities get_multiview_capabilities() const { return multiview_capabilities; };
+	bool is_pipeline_creation_feedback_available() const { return pipeline_creation_feedback_available; };
 
 	VkDevice get_device();
 	VkPhysicalDevice get_physical_device();
@@ -277,6 +279,7 @@ public:
 	String get_device_vendor_name() const;
 	String get_device_name() const;
 	String get_device_pipeline_cache_uuid() const;
+	const VkPhysicalDeviceProperties &get_device_properties() const { return gpu_props; }
 
 	void set_vsync_mode(DisplayServer::WindowID p_window, DisplayServer::VSyncMode p_mode);
 	DisplayServer::VSyncMode get_vsync_mode(DisplayServer::WindowID p_window = 0) const;
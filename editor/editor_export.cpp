@@ -1175,6 +1175,8 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 	bool enc_directory = p_preset->get_enc_directory();
 	if (enc_pck && enc_directory) {
 		pack_flags |= PACK_DIR_ENCRYPTED;
+	} else {
+		pack_flags |= PACK_INDEXED;
 	}
 	f->store_32(pack_flags); // flags
 
@@ -1254,6 +1256,16 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 		memdelete(fae);
 	}
 
+	uint64_t index_ofs = 0;
+	if (pack_flags & PACK_INDEXED) {
+		index_ofs = f->get_position();
+		PackIndexWriter index;
+		for (int i = 0; i < pd.file_ofs.size(); i++) {
+			index.add_file(String::utf8(pd.file_ofs[i].path_utf8.get_data()), pd.file_ofs[i].ofs, pd.file_ofs[i].size, pd.file_ofs[i].md5.ptr(), pd.file_ofs[i].encrypted ? PACK_FILE_ENCRYPTED : 0);
+		}
+		index.store(f);
+	}
+
 	int header_padding = _get_pad(PCK_PADDING, f->get_position());
 	for (int i = 0; i < header_padding; i++) {
 		f->store_8(Math::rand() % 256);
@@ -1262,6 +1274,7 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, c
 	uint64_t file_base = f->get_position();
 	f->seek(file_base_ofs);
 	f->store_64(file_base); // update files base
+	f->store_64(index_ofs); // index, in the first reserved fields
 	f->seek(file_base);
 
 	// Save the rest of the data.
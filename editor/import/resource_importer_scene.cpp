@@ -709,6 +709,8 @@ Node *ResourceImporterScene::_post_fix_node(Node *p_node, Node *p_root, Map<Ref<
 		float anim_optimizer_angerr = node_settings["optimizer/max_angular_error"];
 		float anim_optimizer_maxang = node_settings["optimizer/max_angle"];
 
+		bool use_compression = node_settings["compression/enabled"];
+
 		if (use_optimizer) {
 			_optimize_animations(ap, anim_optimizer_linerr, anim_optimizer_angerr, anim_optimizer_maxang);
 		}
@@ -737,12 +739,15 @@ Node *ResourceImporterScene::_post_fix_node(Node *p_node, Node *p_root, Map<Ref<
 		}
 
 		if (animation_clips.size()) {
-			_create_clips(ap, animation_clips, true);
+			_create_clips(ap, animation_clips, true, use_compression);
 		} else {
 			List<StringName> anims;
 			ap->get_animation_list(&anims);
 			for (const StringName &name : anims) {
 				Ref<Animation> anim = ap->get_animation(name);
+				if (use_compression) {
+					anim->compress();
+				}
 				if (p_animation_data.has(name)) {
 					Dictionary anim_settings = p_animation_data[name];
 					{
@@ -805,7 +810,7 @@ Ref<Animation> ResourceImporterScene::_save_animation_to_file(Ref<Animation> ani
 	return anim;
 }
 
-void ResourceImporterScene::_create_clips(AnimationPlayer *anim, const Array &p_clips, bool p_bake_all) {
+void ResourceImporterScene::_create_clips(AnimationPlayer *anim, const Array &p_clips, bool p_bake_all, bool p_compress) {
 	if (!anim->has_animation("default")) {
 		return;
 	}
@@ -906,6 +911,10 @@ void ResourceImporterScene::_create_clips(AnimationPlayer *anim, const Array &p_
 
 		new_anim->set_loop(loop);
 		new_anim->set_length(to - from);
+		if (p_compress) {
+			// Compressed keys can't be copied into clips, so this is done per clip.
+			new_anim->compress();
+		}
 		anim->add_animation(name, new_anim);
 
 		Ref<Animation> saved_anim = _save_animation_to_file(new_anim, save_to_file, save_to_path, keep_current);
@@ -960,6 +969,7 @@ void ResourceImporterScene::get_internal_import_options(InternalImportCategory p
 			r_options->push_back(ImportOption(PropertyInfo(Variant::FLOAT, "optimizer/max_linear_error"), 0.05));
 			r_options->push_back(ImportOption(PropertyInfo(Variant::FLOAT, "optimizer/max_angular_error"), 0.01));
 			r_options->push_back(ImportOption(PropertyInfo(Variant::FLOAT, "optimizer/max_angle"), 22));
+			r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "compression/enabled"), false));
 			r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "slices/amount", PROPERTY_HINT_RANGE, "0,256,1", PROPERTY_USAGE_DEFAULT | PROPERTY_USAGE_UPDATE_ALL_IF_MODIFIED), 0));
 
 			for (int i = 0; i < 256; i++) {
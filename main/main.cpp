@@ -175,6 +175,7 @@ static int frame_delay = 0;
 static bool disable_render_loop = false;
 static int fixed_fps = -1;
 static bool print_fps = false;
+static String profile_script_path;
 #ifdef TOOLS_ENABLED
 static bool dump_extension_api = false;
 #endif
@@ -362,6 +363,7 @@ void Main::print_help(const char *p_binary) {
 	OS::get_singleton()->print("  --fixed-fps <fps>                            Force a fixed number of frames per second. This setting disables real-time synchronization.\n");
 	OS::get_singleton()->print("  --print-fps                                  Print the frames per second to the stdout.\n");
 	OS::get_singleton()->print("  --profile-gpu                                Show a simple profile of the tasks that took more time during frame rendering.\n");
+	OS::get_singleton()->print("  --profile-script <file>                      Sample running scripts and save a flame graph (collapsed stacks) to <file> on exit.\n");
 	OS::get_singleton()->print("\n");
 
 	OS::get_singleton()->print("Standalone tools:\n");
@@ -1026,6 +1028,14 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 			print_fps = true;
 		} else if (I->get() == "--profile-gpu") {
 			profile_gpu = true;
+		} else if (I->get() == "--profile-script") {
+			if (I->next()) {
+				profile_script_path = I->next()->get();
+				N = I->next()->next();
+			} else {
+				OS::get_singleton()->print("Missing profile output file argument, aborting.\n");
+				goto error;
+			}
 		} else if (I->get() == "--disable-crash-handler") {
 			OS::get_singleton()->disable_crash_handler();
 		} else if (I->get() == "--skip-breakpoints") {
@@ -1810,6 +1820,19 @@ Error Main::setup2(Thread::ID p_main_tid_override) {
 
 	audio_server->load_default_bus_layout();
 
+	if (profile_script_path != "") {
+		bool profiling_scripts = false;
+		for (int i = 0; i < ScriptServer::get_language_count(); i++) {
+			if (ScriptServer::get_language(i)->sampling_profiler_start(profile_script_path)) {
+				profiling_scripts = true;
+				break;
+			}
+		}
+		if (!profiling_scripts) {
+			ERR_PRINT("No script language supports sampling profiling, ignoring --profile-script.");
+		}
+	}
+
 	if (use_debug_profiler && EngineDebugger::is_active()) {
 		// Start the "scripts" profiler, used in local debugging.
 		// We could add more, and make the CLI arg require a comma-separated list of profilers.
@@ -2661,6 +2684,9 @@ void Main::cleanup(bool p_force) {
 	ResourceLoader::clear_translation_remaps();
 	ResourceLoader::clear_path_remaps();
 
+	for (int i = 0; i < ScriptServer::get_language_count(); i++) {
+		ScriptServer::get_language(i)->sampling_profiler_stop();
+	}
 	ScriptServer::finish_languages();
 
 	// Sync pending commands that may have been queued from a different thread during ScriptServer finalization
@@ -35,6 +35,7 @@
 #include "scene/main/node.h"
 #include "scene/main/scene_tree.h"
 #include "servers/audio_server.h"
+#include "servers/navigation_server_3d.h"
 #include "servers/physics_server_2d.h"
 #include "servers/physics_server_3d.h"
 #include "servers/rendering_server.h"
@@ -73,6 +74,13 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PHYSICS_3D_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ISLAND_COUNT);
 	BIND_ENUM_CONSTANT(AUDIO_OUTPUT_LATENCY);
+	BIND_ENUM_CONSTANT(NAVIGATION_QUERY_COUNT);
+	BIND_ENUM_CONSTANT(NAVIGATION_QUERY_TIME);
+	BIND_ENUM_CONSTANT(OBJECT_MESSAGE_COUNT);
+	BIND_ENUM_CONSTANT(RENDER_PIPELINE_CACHE_HITS);
+	BIND_ENUM_CONSTANT(RENDER_PIPELINE_CACHE_MISSES);
+	BIND_ENUM_CONSTANT(AUDIO_REAL_VOICES);
+	BIND_ENUM_CONSTANT(AUDIO_VIRTUAL_VOICES);
 
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
@@ -112,6 +120,13 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"physics_3d/collision_pairs",
 		"physics_3d/islands",
 		"audio/driver/output_latency",
+		"navigation/queries",
+		"navigation/query_time",
+		"object/messages",
+		"video/pipeline_cache_hits",
+		"video/pipeline_cache_misses",
+		"audio/voices/real",
+		"audio/voices/virtual",
 
 	};
 
@@ -166,6 +181,27 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return PhysicsServer3D::get_singleton()->get_process_info(PhysicsServer3D::INFO_ISLAND_COUNT);
 		case AUDIO_OUTPUT_LATENCY:
 			return AudioServer::get_singleton()->get_output_latency();
+		case NAVIGATION_QUERY_COUNT:
+			// The navigation server may be disabled, while the debugger polls every monitor.
+			if (!NavigationServer3D::get_singleton()) {
+				return 0;
+			}
+			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_QUERY_COUNT);
+		case NAVIGATION_QUERY_TIME:
+			if (!NavigationServer3D::get_singleton()) {
+				return 0;
+			}
+			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_QUERY_TIME) / 1000000.0;
+		case OBJECT_MESSAGE_COUNT:
+			return MessageQueue::get_singleton()->get_last_flush_message_count();
+		case RENDER_PIPELINE_CACHE_HITS:
+			return RS::get_singleton()->get_rendering_info(RS::RENDERING_INFO_PIPELINE_CACHE_HITS);
+		case RENDER_PIPELINE_CACHE_MISSES:
+			return RS::get_singleton()->get_rendering_info(RS::RENDERING_INFO_PIPELINE_CACHE_MISSES);
+		case AUDIO_REAL_VOICES:
+			return AudioServer::get_singleton()->get_real_voice_count();
+		case AUDIO_VIRTUAL_VOICES:
+			return AudioServer::get_singleton()->get_virtual_voice_count();
 
 		default: {
 		}
@@ -201,6 +237,13 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
 
 	};
 
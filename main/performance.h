@@ -87,6 +87,13 @@ public:
 		PHYSICS_3D_ISLAND_COUNT,
 		//physics
 		AUDIO_OUTPUT_LATENCY,
+		NAVIGATION_QUERY_COUNT,
+		NAVIGATION_QUERY_TIME,
+		OBJECT_MESSAGE_COUNT,
+		RENDER_PIPELINE_CACHE_HITS,
+		RENDER_PIPELINE_CACHE_MISSES,
+		AUDIO_REAL_VOICES,
+		AUDIO_VIRTUAL_VOICES,
 		MONITOR_MAX
 	};
 
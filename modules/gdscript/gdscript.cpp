@@ -43,6 +43,7 @@
 #include "gdscript_cache.h"
 #include "gdscript_compiler.h"
 #include "gdscript_parser.h"
+#include "gdscript_sampling_profiler.h"
 #include "gdscript_warning.h"
 
 #ifdef TESTS_ENABLED
@@ -1710,6 +1711,14 @@ void GDScriptLanguage::profiling_stop() {
 #endif
 }
 
+bool GDScriptLanguage::sampling_profiler_start(const String &p_output_path) {
+	return sampling_profiler->start(p_output_path);
+}
+
+void GDScriptLanguage::sampling_profiler_stop() {
+	sampling_profiler->stop();
+}
+
 int GDScriptLanguage::profiling_get_accumulated_data(ProfilingInfo *p_info_arr, int p_info_max) {
 	int current = 0;
 #ifdef DEBUG_ENABLED
@@ -2151,6 +2160,7 @@ GDScriptLanguage::GDScriptLanguage() {
 
 	profiling = false;
 	script_frame_time = 0;
+	sampling_profiler = memnew(GDScriptSamplingProfiler);
 
 	_debug_call_stack_pos = 0;
 	int dmcs = GLOBAL_DEF("debug/settings/gdscript/max_call_stack", 1024);
@@ -2210,6 +2220,7 @@ GDScriptLanguage::~GDScriptLanguage() {
 		script->unreference();
 	}
 
+	memdelete(sampling_profiler);
 	singleton = nullptr;
 }
 
@@ -39,6 +39,8 @@
 #include "core/object/script_language.h"
 #include "gdscript_function.h"
 
+class GDScriptSamplingProfiler;
+
 class GDScriptNativeClass : public RefCounted {
 	GDCLASS(GDScriptNativeClass, RefCounted);
 
@@ -342,6 +344,7 @@ class GDScriptLanguage : public ScriptLanguage {
 
 	SelfList<GDScriptFunction>::List function_list;
 	bool profiling;
+	GDScriptSamplingProfiler *sampling_profiler = nullptr;
 	uint64_t script_frame_time;
 
 	Map<String, ObjectID> orphan_subclasses;
@@ -491,6 +494,9 @@ public:
 	virtual int profiling_get_accumulated_data(ProfilingInfo *p_info_arr, int p_info_max);
 	virtual int profiling_get_frame_data(ProfilingInfo *p_info_arr, int p_info_max);
 
+	virtual bool sampling_profiler_start(const String &p_output_path);
+	virtual void sampling_profiler_stop();
+
 	/* LOADER FUNCTIONS */
 
 	virtual void get_recognized_extensions(List<String> *p_extensions) const;
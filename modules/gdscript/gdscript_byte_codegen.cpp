@@ -531,6 +531,34 @@ void GDScriptByteCodeGenerator::write_type_adjust(const Address &p_target, Varia
 	append(p_target);
 }
 
+// Returns the opcode working on unboxed operands for this operator, or OPCODE_END if there is none.
+// Must stay in sync with the operators handled by the VM.
+static GDScriptFunction::Opcode _get_typed_operator_opcode(Variant::Operator p_operator, Variant::Type p_left_type, Variant::Type p_right_type) {
+	bool is_comparison = p_operator == Variant::OP_EQUAL || p_operator == Variant::OP_NOT_EQUAL || p_operator == Variant::OP_LESS || p_operator == Variant::OP_LESS_EQUAL || p_operator == Variant::OP_GREATER || p_operator == Variant::OP_GREATER_EQUAL;
+	bool is_arithmetic = p_operator == Variant::OP_ADD || p_operator == Variant::OP_SUBTRACT || p_operator == Variant::OP_MULTIPLY;
+
+	if (p_left_type == Variant::INT && p_right_type == Variant::INT) {
+		// Division and modulo need the zero checks of the regular evaluators.
+		if (is_comparison || is_arithmetic || p_operator == Variant::OP_BIT_AND || p_operator == Variant::OP_BIT_OR || p_operator == Variant::OP_BIT_XOR) {
+			return GDScriptFunction::OPCODE_OPERATOR_INT;
+		}
+	} else if (p_left_type == Variant::FLOAT && p_right_type == Variant::FLOAT) {
+		if (is_comparison || is_arithmetic || p_operator == Variant::OP_DIVIDE) {
+			return GDScriptFunction::OPCODE_OPERATOR_FLOAT;
+		}
+	} else if ((p_left_type == Variant::VECTOR2 || p_left_type == Variant::VECTOR3) && p_right_type == p_left_type) {
+		if (is_arithmetic || p_operator == Variant::OP_DIVIDE || p_operator == Variant::OP_EQUAL || p_operator == Variant::OP_NOT_EQUAL) {
+			return p_left_type == Variant::VECTOR2 ? GDScriptFunction::OPCODE_OPERATOR_VECTOR2 : GDScriptFunction::OPCODE_OPERATOR_VECTOR3;
+		}
+	} else if ((p_left_type == Variant::VECTOR2 || p_left_type == Variant::VECTOR3) && p_right_type == Variant::FLOAT) {
+		if (p_operator == Variant::OP_MULTIPLY || p_operator == Variant::OP_DIVIDE) {
+			return p_left_type == Variant::VECTOR2 ? GDScriptFunction::OPCODE_OPERATOR_VECTOR2_FLOAT : GDScriptFunction::OPCODE_OPERATOR_VECTOR3_FLOAT;
+		}
+	}
+
+	return GDScriptFunction::OPCODE_END;
+}
+
 void GDScriptByteCodeGenerator::write_unary_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand) {
 	if (HAS_BUILTIN_TYPE(p_left_operand)) {
 		// Gather specific operator.
@@ -562,6 +590,16 @@ void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, V
 			}
 		}
 
+		GDScriptFunction::Opcode typed_opcode = _get_typed_operator_opcode(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
+		if (typed_opcode != GDScriptFunction::OPCODE_END) {
+			append(typed_opcode, 3);
+			append(p_left_operand);
+			append(p_right_operand);
+			append(p_target);
+			append(p_operator);
+			return;
+		}
+
 		// Gather specific operator.
 		Variant::ValidatedOperatorEvaluator op_func = Variant::get_validated_operator_evaluator(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
 
@@ -691,6 +729,23 @@ void GDScriptByteCodeGenerator::write_end_ternary() {
 }
 
 void GDScriptByteCodeGenerator::write_set(const Address &p_target, const Address &p_index, const Address &p_source) {
+	if (IS_BUILTIN_TYPE(p_target, Variant::ARRAY) && IS_BUILTIN_TYPE(p_index, Variant::INT)) {
+		// Validation can only be skipped when the value is known to be of the element type.
+		// An array without element type may still be typed at runtime.
+		bool value_matches = false;
+		if (p_target.type.has_container_element_type() && HAS_BUILTIN_TYPE(p_source)) {
+			GDScriptDataType element_type = p_target.type.get_container_element_type();
+			value_matches = element_type.kind == GDScriptDataType::BUILTIN && element_type.builtin_type == p_source.type.builtin_type;
+		}
+		if (value_matches) {
+			append(GDScriptFunction::OPCODE_SET_INDEXED_ARRAY, 3);
+			append(p_target);
+			append(p_index);
+			append(p_source);
+			return;
+		}
+	}
+
 	if (HAS_BUILTIN_TYPE(p_target)) {
 		if (IS_BUILTIN_TYPE(p_index, Variant::INT) && Variant::get_member_validated_indexed_setter(p_target.type.builtin_type)) {
 			// Use indexed setter instead.
@@ -719,6 +774,14 @@ void GDScriptByteCodeGenerator::write_set(const Address &p_target, const Address
 }
 
 void GDScriptByteCodeGenerator::write_get(const Address &p_target, const Address &p_index, const Address &p_source) {
+	if (IS_BUILTIN_TYPE(p_source, Variant::ARRAY) && IS_BUILTIN_TYPE(p_index, Variant::INT)) {
+		append(GDScriptFunction::OPCODE_GET_INDEXED_ARRAY, 3);
+		append(p_source);
+		append(p_index);
+		append(p_target);
+		return;
+	}
+
 	if (HAS_BUILTIN_TYPE(p_source)) {
 		if (IS_BUILTIN_TYPE(p_index, Variant::INT) && Variant::get_member_validated_indexed_getter(p_source.type.builtin_type)) {
 			// Use indexed getter instead.
@@ -1064,10 +1064,27 @@ GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &code
 					return GDScriptCodeGenerator::Address();
 				}
 
+				bool assigned_in_place = false;
 				if (assignment->operation != GDScriptParser::AssignmentNode::OP_NONE) {
-					// Perform operation.
-					op_result = codegen.add_temporary();
-					gen->write_binary_operator(op_result, assignment->variant_op, target, assigned);
+					GDScriptDataType result_type;
+					if (target.type.has_type && target.type.kind == GDScriptDataType::BUILTIN && assigned.type.has_type && assigned.type.kind == GDScriptDataType::BUILTIN) {
+						Variant::Type result_builtin_type = Variant::get_operator_return_type(assignment->variant_op, target.type.builtin_type, assigned.type.builtin_type);
+						if (result_builtin_type != Variant::NIL) {
+							result_type.has_type = true;
+							result_type.kind = GDScriptDataType::BUILTIN;
+							result_type.builtin_type = result_builtin_type;
+						}
+					}
+
+					if (target.mode == GDScriptCodeGenerator::Address::LOCAL_VARIABLE && !has_setter && !assignment->use_conversion_assign && result_type.has_type && result_type.builtin_type == target.type.builtin_type) {
+						// The operation keeps the type of the typed local (like `i += 1`), so write the result straight into it.
+						gen->write_binary_operator(target, assignment->variant_op, target, assigned);
+						assigned_in_place = true;
+					} else {
+						// Perform operation. A temporary of the result type doesn't need adjusting at runtime.
+						op_result = codegen.add_temporary(result_type);
+						gen->write_binary_operator(op_result, assignment->variant_op, target, assigned);
+					}
 				} else {
 					op_result = assigned;
 					assigned = GDScriptCodeGenerator::Address();
@@ -1080,7 +1097,7 @@ GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &code
 					Vector<GDScriptCodeGenerator::Address> args;
 					args.push_back(op_result);
 					gen->write_call(GDScriptCodeGenerator::Address(), GDScriptCodeGenerator::Address(GDScriptCodeGenerator::Address::SELF), setter_function, args);
-				} else {
+				} else if (!assigned_in_place) {
 					// Just assign.
 					if (assignment->use_conversion_assign) {
 						gen->write_assign_with_conversion(target, op_result);
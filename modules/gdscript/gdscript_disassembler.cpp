@@ -134,6 +134,26 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
+			case OPCODE_OPERATOR_INT:
+			case OPCODE_OPERATOR_FLOAT:
+			case OPCODE_OPERATOR_VECTOR2:
+			case OPCODE_OPERATOR_VECTOR3:
+			case OPCODE_OPERATOR_VECTOR2_FLOAT:
+			case OPCODE_OPERATOR_VECTOR3_FLOAT: {
+				int operation = _code_ptr[ip + 4];
+
+				text += "typed operator ";
+
+				text += DADDR(3);
+				text += " = ";
+				text += DADDR(1);
+				text += " ";
+				text += Variant::get_operator_name(Variant::Operator(operation));
+				text += " ";
+				text += DADDR(2);
+
+				incr += 5;
+			} break;
 			case OPCODE_EXTENDS_TEST: {
 				text += "is object ";
 				text += DADDR(3);
@@ -184,6 +204,16 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
+			case OPCODE_SET_INDEXED_ARRAY: {
+				text += "set indexed array ";
+				text += DADDR(1);
+				text += "[";
+				text += DADDR(2);
+				text += "] = ";
+				text += DADDR(3);
+
+				incr += 4;
+			} break;
 			case OPCODE_GET_KEYED: {
 				text += "get keyed ";
 				text += DADDR(3);
@@ -217,6 +247,17 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
+			case OPCODE_GET_INDEXED_ARRAY: {
+				text += "get indexed array ";
+				text += DADDR(3);
+				text += " = ";
+				text += DADDR(1);
+				text += "[";
+				text += DADDR(2);
+				text += "]";
+
+				incr += 4;
+			} break;
 			case OPCODE_SET_NAMED: {
 				text += "set_named ";
 				text += DADDR(1);
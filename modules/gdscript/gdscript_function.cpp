@@ -31,6 +31,7 @@
 #include "gdscript_function.h"
 
 #include "gdscript.h"
+#include "gdscript_sampling_profiler.h"
 
 const int *GDScriptFunction::get_code() const {
 	return _code_ptr;
@@ -153,6 +154,10 @@ GDScriptFunction::~GDScriptFunction() {
 		memdelete(lambdas[i]);
 	}
 
+	if (GDScriptSamplingProfiler::get_singleton()) {
+		GDScriptSamplingProfiler::get_singleton()->function_freed(this);
+	}
+
 #ifdef DEBUG_ENABLED
 
 	MutexLock lock(GDScriptLanguage::get_singleton()->lock);
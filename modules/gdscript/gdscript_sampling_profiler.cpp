@@ -0,0 +1,201 @@
+/*************************************************************************/
+/*  gdscript_sampling_profiler.cpp                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_sampling_profiler.h"
+
+#include "core/io/file_access.h"
+#include "core/os/os.h"
+#include "gdscript_function.h"
+
+GDScriptSamplingProfiler *GDScriptSamplingProfiler::singleton = nullptr;
+bool GDScriptSamplingProfiler::sampling = false;
+
+GDScriptSamplingProfiler::OpcodeClass GDScriptSamplingProfiler::get_opcode_class(int p_opcode) {
+	if (p_opcode <= GDScriptFunction::OPCODE_IS_BUILTIN) {
+		return OPCODE_CLASS_OPERATOR;
+	} else if (p_opcode <= GDScriptFunction::OPCODE_GET_MEMBER) {
+		return OPCODE_CLASS_ACCESS;
+	} else if (p_opcode <= GDScriptFunction::OPCODE_CAST_TO_SCRIPT) {
+		return OPCODE_CLASS_ASSIGN;
+	} else if (p_opcode <= GDScriptFunction::OPCODE_CONSTRUCT_DICTIONARY) {
+		return OPCODE_CLASS_CONSTRUCT;
+	} else if (p_opcode <= GDScriptFunction::OPCODE_CALL_PTRCALL_PACKED_COLOR_ARRAY) {
+		return OPCODE_CLASS_CALL;
+	} else if (p_opcode >= GDScriptFunction::OPCODE_JUMP && p_opcode <= GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT) {
+		return OPCODE_CLASS_JUMP;
+	} else if (p_opcode >= GDScriptFunction::OPCODE_RETURN && p_opcode <= GDScriptFunction::OPCODE_RETURN_TYPED_SCRIPT) {
+		return OPCODE_CLASS_RETURN;
+	} else if (p_opcode >= GDScriptFunction::OPCODE_ITERATE_BEGIN && p_opcode <= GDScriptFunction::OPCODE_ITERATE_OBJECT) {
+		return OPCODE_CLASS_ITERATE;
+	}
+	return OPCODE_CLASS_OTHER;
+}
+
+const char *GDScriptSamplingProfiler::get_opcode_class_name(OpcodeClass p_class) {
+	static const char *names[OPCODE_CLASS_MAX] = {
+		"operator",
+		"access",
+		"assign",
+		"construct",
+		"call",
+		"jump",
+		"return",
+		"iterate",
+		"other",
+	};
+	ERR_FAIL_INDEX_V(p_class, OPCODE_CLASS_MAX, "");
+	return names[p_class];
+}
+
+void GDScriptSamplingProfiler::_thread_func(void *p_user) {
+	GDScriptSamplingProfiler *profiler = static_cast<GDScriptSamplingProfiler *>(p_user);
+	while (!profiler->exit_thread.is_set()) {
+		OS::get_singleton()->delay_usec(profiler->interval_usec);
+		profiler->_take_sample();
+	}
+}
+
+void GDScriptSamplingProfiler::_take_sample() {
+	MutexLock lock(mutex);
+
+	sample_count++;
+
+	// Frames below the depth read here may be popped while sampling, but their
+	// functions stay alive until the lock is released (see function_freed()).
+	// The ip and line values themselves are read racily, which is fine for sampling.
+	uint32_t count = MIN(depth.get(), (uint32_t)MAX_STACK_DEPTH);
+	if (count == 0) {
+		idle_count++;
+		return;
+	}
+
+	String key;
+	for (uint32_t i = 0; i < count; i++) {
+		const Frame &frame = frames[i];
+		if (i > 0) {
+			key += ";";
+		}
+		key += String(frame.function->source) + ":" + String(frame.function->name) + ":" + itos(frame.position.line);
+	}
+
+	const Frame &top = frames[count - 1];
+	int ip = top.position.ip;
+	OpcodeClass opcode_class = OPCODE_CLASS_OTHER;
+	if (ip >= 0 && ip < top.function->_code_size) {
+		opcode_class = get_opcode_class(top.function->_code_ptr[ip] & GDScriptFunction::INSTR_MASK);
+	}
+	opcode_class_samples[opcode_class]++;
+	key += ";[" + String(get_opcode_class_name(opcode_class)) + "]";
+
+	uint64_t *samples = stacks.getptr(key);
+	if (samples) {
+		(*samples)++;
+	} else {
+		stacks.set(key, 1);
+	}
+}
+
+Error GDScriptSamplingProfiler::_save(const String &p_path) const {
+	Error err;
+	FileAccessRef f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Cannot open file '" + p_path + "' for writing the script profile.");
+
+	// Collapsed stacks, one "frame;frame;...;frame count" per line, as read by
+	// flamegraph.pl, speedscope and most other flame graph tools.
+	Vector<String> keys;
+	const String *key = nullptr;
+	while ((key = stacks.next(key))) {
+		keys.push_back(*key);
+	}
+	keys.sort();
+
+	for (int i = 0; i < keys.size(); i++) {
+		f->store_line(keys[i] + " " + itos(*stacks.getptr(keys[i])));
+	}
+
+	return OK;
+}
+
+void GDScriptSamplingProfiler::function_freed(GDScriptFunction *p_function) {
+	if (!sampling) {
+		return;
+	}
+	MutexLock lock(mutex);
+}
+
+bool GDScriptSamplingProfiler::start(const String &p_output_path, uint64_t p_interval_usec) {
+	ERR_FAIL_COND_V_MSG(sampling, false, "The script sampling profiler is already running.");
+
+	stacks.clear();
+	for (int i = 0; i < OPCODE_CLASS_MAX; i++) {
+		opcode_class_samples[i] = 0;
+	}
+	sample_count = 0;
+	idle_count = 0;
+	output_path = p_output_path;
+	interval_usec = MAX(p_interval_usec, (uint64_t)1);
+
+	sampling = true;
+	exit_thread.clear();
+	thread.start(&GDScriptSamplingProfiler::_thread_func, this);
+	return true;
+}
+
+void GDScriptSamplingProfiler::stop() {
+	if (!sampling) {
+		return;
+	}
+
+	exit_thread.set();
+	thread.wait_to_finish();
+	sampling = false;
+
+	uint64_t script_count = sample_count - idle_count;
+	print_line(vformat("Script sampling profiler: %d samples, %d in scripts.", sample_count, script_count));
+	for (int i = 0; i < OPCODE_CLASS_MAX; i++) {
+		if (opcode_class_samples[i] > 0) {
+			print_line(vformat("  %s: %.1f%%", get_opcode_class_name(OpcodeClass(i)), opcode_class_samples[i] * 100.0 / script_count));
+		}
+	}
+
+	if (_save(output_path) == OK) {
+		print_line(vformat("Script profile saved to \"%s\".", output_path));
+	}
+	stacks.clear();
+}
+
+GDScriptSamplingProfiler::GDScriptSamplingProfiler() {
+	singleton = this;
+}
+
+GDScriptSamplingProfiler::~GDScriptSamplingProfiler() {
+	stop();
+	singleton = nullptr;
+}
@@ -0,0 +1,142 @@
+/*************************************************************************/
+/*  gdscript_sampling_profiler.h                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_SAMPLING_PROFILER_H
+#define GDSCRIPT_SAMPLING_PROFILER_H
+
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/safe_refcount.h"
+
+class GDScriptFunction;
+
+// Periodically samples the script call stack of the main thread from a
+// separate thread, aggregating samples per source line and opcode class.
+// Unlike the instrumenting profiler it works in release builds. While not
+// sampling it costs a branch per call and a never taken one per instruction.
+class GDScriptSamplingProfiler {
+public:
+	enum OpcodeClass {
+		OPCODE_CLASS_OPERATOR,
+		OPCODE_CLASS_ACCESS,
+		OPCODE_CLASS_ASSIGN,
+		OPCODE_CLASS_CONSTRUCT,
+		OPCODE_CLASS_CALL,
+		OPCODE_CLASS_JUMP,
+		OPCODE_CLASS_RETURN,
+		OPCODE_CLASS_ITERATE,
+		OPCODE_CLASS_OTHER,
+		OPCODE_CLASS_MAX
+	};
+
+	enum {
+		MAX_STACK_DEPTH = 256, // Deeper frames are still tracked, but not sampled.
+		DEFAULT_INTERVAL_USEC = 1000,
+	};
+
+	// Copied by the VM before each instruction of a sampled function, so the
+	// addresses of its own ip and line never escape the dispatch loop.
+	struct Position {
+		int ip = 0;
+		int line = 0;
+	};
+
+private:
+	struct Frame {
+		GDScriptFunction *function = nullptr;
+		Position position;
+	};
+
+	static GDScriptSamplingProfiler *singleton;
+	static bool sampling;
+
+	// Written by the main thread only, read by the sampler thread.
+	Frame frames[MAX_STACK_DEPTH];
+	Position overflow_position; // Written by the frames too deep to be sampled.
+	SafeNumeric<uint32_t> depth;
+
+	Thread thread;
+	SafeFlag exit_thread;
+	uint64_t interval_usec = DEFAULT_INTERVAL_USEC;
+	String output_path;
+
+	// Held while taking a sample, so functions can't be freed while being read.
+	Mutex mutex;
+	HashMap<String, uint64_t> stacks;
+	uint64_t opcode_class_samples[OPCODE_CLASS_MAX] = {};
+	uint64_t sample_count = 0;
+	uint64_t idle_count = 0;
+
+	static void _thread_func(void *p_user);
+	void _take_sample();
+	Error _save(const String &p_path) const;
+
+public:
+	static GDScriptSamplingProfiler *get_singleton() { return singleton; }
+	static _FORCE_INLINE_ bool is_sampling() { return sampling; }
+
+	static OpcodeClass get_opcode_class(int p_opcode);
+	static const char *get_opcode_class_name(OpcodeClass p_class);
+
+	// Returns where the function must keep its position, or nullptr if no frame was
+	// pushed. exit_function() must only be called if one was.
+	_FORCE_INLINE_ Position *enter_function(GDScriptFunction *p_function, int p_line) {
+		if (Thread::get_caller_id() != Thread::get_main_id()) {
+			return nullptr;
+		}
+
+		uint32_t index = depth.get();
+		Position *position = &overflow_position;
+		if (index < MAX_STACK_DEPTH) {
+			frames[index].function = p_function;
+			position = &frames[index].position;
+			position->ip = 0;
+			position->line = p_line;
+		}
+		depth.increment();
+		return position;
+	}
+
+	_FORCE_INLINE_ void exit_function() {
+		depth.decrement();
+	}
+
+	// Must be called before a function is freed, waits for a sample in progress.
+	void function_freed(GDScriptFunction *p_function);
+
+	bool start(const String &p_output_path, uint64_t p_interval_usec = DEFAULT_INTERVAL_USEC);
+	void stop();
+
+	GDScriptSamplingProfiler();
+	~GDScriptSamplingProfiler();
+};
+
+#endif // GDSCRIPT_SAMPLING_PROFILER_H
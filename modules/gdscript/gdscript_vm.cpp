@@ -34,6 +34,7 @@
 #include "core/os/os.h"
 #include "gdscript.h"
 #include "gdscript_lambda_callable.h"
+#include "gdscript_sampling_profiler.h"
 
 Variant *GDScriptFunction::_get_variant(int p_address, GDScriptInstance *p_instance, Variant *p_stack, String &r_error) const {
 	int address = p_address & ADDR_MASK;
@@ -190,19 +191,149 @@ void (*type_init_function_table[])(Variant *) = {
 	&VariantInitializer<PackedColorArray>::init, // PACKED_COLOR_ARRAY.
 };
 
+// Operators on unboxed values, used when the analyzer proved the operand
+// types. The byte code generator only emits the operators handled here.
+
+template <class T>
+static _FORCE_INLINE_ bool _evaluate_comparison(int p_operator, const T &p_a, const T &p_b, Variant *r_dst) {
+	bool *dst = VariantInternal::get_bool(r_dst);
+	switch (p_operator) {
+		case Variant::OP_EQUAL:
+			*dst = p_a == p_b;
+			return true;
+		case Variant::OP_NOT_EQUAL:
+			*dst = p_a != p_b;
+			return true;
+		case Variant::OP_LESS:
+			*dst = p_a < p_b;
+			return true;
+		case Variant::OP_LESS_EQUAL:
+			*dst = p_a <= p_b;
+			return true;
+		case Variant::OP_GREATER:
+			*dst = p_a > p_b;
+			return true;
+		case Variant::OP_GREATER_EQUAL:
+			*dst = p_a >= p_b;
+			return true;
+		default:
+			return false;
+	}
+}
+
+static _FORCE_INLINE_ bool _evaluate_int_operator(int p_operator, const Variant *p_a, const Variant *p_b, Variant *r_dst) {
+	const int64_t a = *VariantInternal::get_int(p_a);
+	const int64_t b = *VariantInternal::get_int(p_b);
+	switch (p_operator) {
+		case Variant::OP_ADD:
+			*VariantInternal::get_int(r_dst) = a + b;
+			return true;
+		case Variant::OP_SUBTRACT:
+			*VariantInternal::get_int(r_dst) = a - b;
+			return true;
+		case Variant::OP_MULTIPLY:
+			*VariantInternal::get_int(r_dst) = a * b;
+			return true;
+		case Variant::OP_BIT_AND:
+			*VariantInternal::get_int(r_dst) = a & b;
+			return true;
+		case Variant::OP_BIT_OR:
+			*VariantInternal::get_int(r_dst) = a | b;
+			return true;
+		case Variant::OP_BIT_XOR:
+			*VariantInternal::get_int(r_dst) = a ^ b;
+			return true;
+		default:
+			return _evaluate_comparison(p_operator, a, b, r_dst);
+	}
+}
+
+static _FORCE_INLINE_ bool _evaluate_float_operator(int p_operator, const Variant *p_a, const Variant *p_b, Variant *r_dst) {
+	const double a = *VariantInternal::get_float(p_a);
+	const double b = *VariantInternal::get_float(p_b);
+	switch (p_operator) {
+		case Variant::OP_ADD:
+			*VariantInternal::get_float(r_dst) = a + b;
+			return true;
+		case Variant::OP_SUBTRACT:
+			*VariantInternal::get_float(r_dst) = a - b;
+			return true;
+		case Variant::OP_MULTIPLY:
+			*VariantInternal::get_float(r_dst) = a * b;
+			return true;
+		case Variant::OP_DIVIDE:
+			*VariantInternal::get_float(r_dst) = a / b;
+			return true;
+		default:
+			return _evaluate_comparison(p_operator, a, b, r_dst);
+	}
+}
+
+template <class T>
+static _FORCE_INLINE_ bool _evaluate_vector_operator(int p_operator, const Variant *p_a, const Variant *p_b, Variant *r_dst) {
+	const T &a = *VariantGetInternalPtr<T>::get_ptr(p_a);
+	const T &b = *VariantGetInternalPtr<T>::get_ptr(p_b);
+	switch (p_operator) {
+		case Variant::OP_ADD:
+			*VariantGetInternalPtr<T>::get_ptr(r_dst) = a + b;
+			return true;
+		case Variant::OP_SUBTRACT:
+			*VariantGetInternalPtr<T>::get_ptr(r_dst) = a - b;
+			return true;
+		case Variant::OP_MULTIPLY:
+			*VariantGetInternalPtr<T>::get_ptr(r_dst) = a * b;
+			return true;
+		case Variant::OP_DIVIDE:
+			*VariantGetInternalPtr<T>::get_ptr(r_dst) = a / b;
+			return true;
+		case Variant::OP_EQUAL:
+			*VariantInternal::get_bool(r_dst) = a == b;
+			return true;
+		case Variant::OP_NOT_EQUAL:
+			*VariantInternal::get_bool(r_dst) = a != b;
+			return true;
+		default:
+			return false;
+	}
+}
+
+template <class T>
+static _FORCE_INLINE_ bool _evaluate_vector_float_operator(int p_operator, const Variant *p_a, const Variant *p_b, Variant *r_dst) {
+	const T &a = *VariantGetInternalPtr<T>::get_ptr(p_a);
+	const real_t b = *VariantInternal::get_float(p_b);
+	switch (p_operator) {
+		case Variant::OP_MULTIPLY:
+			*VariantGetInternalPtr<T>::get_ptr(r_dst) = a * b;
+			return true;
+		case Variant::OP_DIVIDE:
+			*VariantGetInternalPtr<T>::get_ptr(r_dst) = a / b;
+			return true;
+		default:
+			return false;
+	}
+}
+
 #if defined(__GNUC__)
 #define OPCODES_TABLE                                \
 	static const void *switch_table_ops[] = {        \
 		&&OPCODE_OPERATOR,                           \
 		&&OPCODE_OPERATOR_VALIDATED,                 \
+		&&OPCODE_OPERATOR_INT,                       \
+		&&OPCODE_OPERATOR_FLOAT,                     \
+		&&OPCODE_OPERATOR_VECTOR2,                   \
+		&&OPCODE_OPERATOR_VECTOR3,                   \
+		&&OPCODE_OPERATOR_VECTOR2_FLOAT,             \
+		&&OPCODE_OPERATOR_VECTOR3_FLOAT,             \
 		&&OPCODE_EXTENDS_TEST,                       \
 		&&OPCODE_IS_BUILTIN,                         \
 		&&OPCODE_SET_KEYED,                          \
 		&&OPCODE_SET_KEYED_VALIDATED,                \
 		&&OPCODE_SET_INDEXED_VALIDATED,              \
+		&&OPCODE_SET_INDEXED_ARRAY,                  \
 		&&OPCODE_GET_KEYED,                          \
 		&&OPCODE_GET_KEYED_VALIDATED,                \
 		&&OPCODE_GET_INDEXED_VALIDATED,              \
+		&&OPCODE_GET_INDEXED_ARRAY,                  \
 		&&OPCODE_SET_NAMED,                          \
 		&&OPCODE_SET_NAMED_VALIDATED,                \
 		&&OPCODE_GET_NAMED,                          \
@@ -536,6 +667,11 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 	String err_text;
 
+	GDScriptSamplingProfiler::Position *sample_position = nullptr;
+	if (unlikely(GDScriptSamplingProfiler::is_sampling())) {
+		sample_position = GDScriptSamplingProfiler::get_singleton()->enter_function(this, line);
+	}
+
 #ifdef DEBUG_ENABLED
 
 	if (EngineDebugger::is_active()) {
@@ -592,6 +728,11 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #else
 	OPCODE_WHILE(true) {
 #endif
+		if (unlikely(sample_position)) {
+			sample_position->ip = ip;
+			sample_position->line = line;
+		}
+
 		// Load arguments for the instruction before each instruction.
 		int instr_arg_count = ((_code_ptr[ip]) & INSTR_ARGS_MASK) >> INSTR_BITS;
 		for (int i = 0; i < instr_arg_count; i++) {
@@ -652,6 +793,26 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+#define OPCODE_OPERATOR_TYPED(m_opcode, m_evaluate)            \
+	OPCODE(m_opcode) {                                         \
+		CHECK_SPACE(5);                                        \
+		GET_INSTRUCTION_ARG(a, 0);                             \
+		GET_INSTRUCTION_ARG(b, 1);                             \
+		GET_INSTRUCTION_ARG(dst, 2);                           \
+		bool valid = m_evaluate(_code_ptr[ip + 4], a, b, dst); \
+		GD_ERR_BREAK(!valid);                                  \
+		(void)valid;                                           \
+		ip += 5;                                               \
+	}                                                          \
+	DISPATCH_OPCODE
+
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_INT, _evaluate_int_operator);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_FLOAT, _evaluate_float_operator);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_VECTOR2, _evaluate_vector_operator<Vector2>);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_VECTOR3, _evaluate_vector_operator<Vector3>);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_VECTOR2_FLOAT, _evaluate_vector_float_operator<Vector2>);
+			OPCODE_OPERATOR_TYPED(OPCODE_OPERATOR_VECTOR3_FLOAT, _evaluate_vector_float_operator<Vector3>);
+
 			OPCODE(OPCODE_EXTENDS_TEST) {
 				CHECK_SPACE(4);
 
@@ -829,6 +990,36 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_SET_INDEXED_ARRAY) {
+				CHECK_SPACE(4);
+
+				GET_INSTRUCTION_ARG(dst, 0);
+				GET_INSTRUCTION_ARG(index, 1);
+				GET_INSTRUCTION_ARG(value, 2);
+
+				// The value is known to match the element type, skip validation.
+				Array *array = VariantInternal::get_array(dst);
+				int64_t int_index = *VariantInternal::get_int(index);
+				int64_t size = array->size();
+				if (int_index < 0) {
+					int_index += size;
+				}
+
+				bool oob = int_index < 0 || int_index >= size;
+				if (likely(!oob)) {
+					(*array)[int_index] = *value;
+				}
+
+#ifdef DEBUG_ENABLED
+				if (oob) {
+					err_text = "Out of bounds set index '" + index->operator String() + "' (on base: '" + _get_var_type(dst) + "')";
+					OPCODE_BREAK;
+				}
+#endif
+				ip += 4;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_GET_KEYED) {
 				CHECK_SPACE(3);
 
@@ -929,6 +1120,35 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_GET_INDEXED_ARRAY) {
+				CHECK_SPACE(4);
+
+				GET_INSTRUCTION_ARG(src, 0);
+				GET_INSTRUCTION_ARG(index, 1);
+				GET_INSTRUCTION_ARG(dst, 2);
+
+				const Array *array = VariantInternal::get_array(src);
+				int64_t int_index = *VariantInternal::get_int(index);
+				int64_t size = array->size();
+				if (int_index < 0) {
+					int_index += size;
+				}
+
+				bool oob = int_index < 0 || int_index >= size;
+				if (likely(!oob)) {
+					*dst = (*array)[int_index];
+				}
+
+#ifdef DEBUG_ENABLED
+				if (oob) {
+					err_text = "Out of bounds get index '" + index->operator String() + "' (on base: '" + _get_var_type(src) + "')";
+					OPCODE_BREAK;
+				}
+#endif
+				ip += 4;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_SET_NAMED) {
 				CHECK_SPACE(3);
 
@@ -3292,6 +3512,11 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	}
 
 	OPCODES_OUT
+
+	if (sample_position) {
+		GDScriptSamplingProfiler::get_singleton()->exit_function();
+	}
+
 #ifdef DEBUG_ENABLED
 	if (GDScriptLanguage::get_singleton()->profiling) {
 		uint64_t time_taken = OS::get_singleton()->get_ticks_usec() - function_start_time;
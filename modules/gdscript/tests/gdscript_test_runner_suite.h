@@ -32,6 +32,10 @@
 #define GDSCRIPT_TEST_RUNNER_SUITE_H
 
 #include "gdscript_test_runner.h"
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/os/os.h"
 #include "tests/test_macros.h"
 
 namespace GDScriptTests {
@@ -69,6 +73,37 @@ func _init():
 	CHECK_MESSAGE(int(ref_counted->get_meta("result")) == 42, "The script should assign object metadata successfully.");
 }
 
+TEST_CASE("[Modules][GDScript] Sampling profiler") {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(R"(
+extends RefCounted
+
+func _init():
+	var end = Time.get_ticks_msec() + 100
+	var count = 0
+	while Time.get_ticks_msec() < end:
+		count += 1
+)");
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The script should parse successfully.");
+
+	const String path = OS::get_singleton()->get_cache_path().plus_file("gdscript_sampling_profiler_test.folded");
+	REQUIRE(GDScriptLanguage::get_singleton()->sampling_profiler_start(path));
+
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(gdscript);
+
+	GDScriptLanguage::get_singleton()->sampling_profiler_stop();
+
+	const String folded = FileAccess::get_file_as_string(path);
+	CHECK_MESSAGE(folded.find(":_init:") != -1, "The busy function should have been sampled.");
+	CHECK_MESSAGE(folded.find(";[") != -1, "Samples should be attributed to an opcode class.");
+
+	DirAccess::remove_file_or_error(path);
+}
+
 } // namespace GDScriptTests
 
 #endif // GDSCRIPT_TEST_RUNNER_SUITE_H
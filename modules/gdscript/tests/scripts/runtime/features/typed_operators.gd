@@ -0,0 +1,39 @@
+# Typed operands use specialized opcodes, results must match the generic path.
+func test():
+	var sum: int = 0
+	var i: int = 0
+	while i < 10:
+		sum += i
+		i += 1
+	print(sum)
+
+	var a: int = 7
+	var b: int = 3
+	print(a - b)
+	print(a * b)
+	print(a & b)
+	print(a | b)
+	print(a ^ b)
+	print(a < b)
+	print(a >= b)
+
+	var x: float = 1.5
+	var y: float = 0.5
+	x *= 2.0
+	print(x + y)
+	print(x / y)
+	print(x > y)
+
+	var v := Vector2(1, 2)
+	v += Vector2(2, 2)
+	print(v == Vector2(3, 4))
+	print(v * 2.0 == Vector2(6, 8))
+	var w := Vector3(1, 2, 3)
+	print(w / 2.0 == Vector3(0.5, 1, 1.5))
+	print(w - w == Vector3())
+
+	var numbers: Array[int] = [1, 2, 3]
+	numbers[0] = 10
+	numbers[-1] += 5
+	print(numbers[0] + numbers[2])
+	print(numbers)
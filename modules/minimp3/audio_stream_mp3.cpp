@@ -59,8 +59,9 @@ int AudioStreamPlaybackMP3::_mix_internal(AudioFrame *p_buffer, int p_frames) {
 		else {
 			//EOF
 			if (mp3_stream->loop) {
-				seek(mp3_stream->loop_offset);
+				_seek(mp3_stream->loop_offset);
 				loops++;
+				_mark_position(float(frames_mixed) / mp3_stream->sample_rate, p_frames - todo);
 			} else {
 				frames_mixed_this_step = p_frames - todo;
 				//fill remainder with silence
@@ -80,14 +81,18 @@ float AudioStreamPlaybackMP3::get_stream_sampling_rate() {
 }
 
 void AudioStreamPlaybackMP3::start(float p_from_pos) {
+	_finish_predecode();
 	active = true;
-	seek(p_from_pos);
+	_seek(p_from_pos);
+	_mark_position(float(frames_mixed) / mp3_stream->sample_rate);
 	loops = 0;
 	_begin_resample();
 }
 
 void AudioStreamPlaybackMP3::stop() {
+	MutexLock lock(decoder_mutex);
 	active = false;
+	_discard_predecoded();
 }
 
 bool AudioStreamPlaybackMP3::is_playing() const {
@@ -99,10 +104,31 @@ int AudioStreamPlaybackMP3::get_loop_count() const {
 }
 
 float AudioStreamPlaybackMP3::get_playback_position() const {
-	return float(frames_mixed) / mp3_stream->sample_rate;
+	// The decoder may be ahead of what was mixed.
+	return _get_mixed_position(float(frames_mixed) / mp3_stream->sample_rate);
 }
 
 void AudioStreamPlaybackMP3::seek(float p_time) {
+	MutexLock lock(decoder_mutex);
+	_seek(p_time);
+	_discard_predecoded();
+	_mark_position(float(frames_mixed) / mp3_stream->sample_rate);
+}
+
+float AudioStreamPlaybackMP3::get_length() const {
+	return mp3_stream->get_length();
+}
+
+bool AudioStreamPlaybackMP3::get_loop_range(float &r_begin, float &r_end) const {
+	if (!mp3_stream->loop) {
+		return false;
+	}
+	r_begin = mp3_stream->loop_offset;
+	r_end = mp3_stream->get_length();
+	return true;
+}
+
+void AudioStreamPlaybackMP3::_seek(float p_time) {
 	if (!active) {
 		return;
 	}
@@ -116,6 +142,8 @@ void AudioStreamPlaybackMP3::seek(float p_time) {
 }
 
 AudioStreamPlaybackMP3::~AudioStreamPlaybackMP3() {
+	_finish_predecode();
+
 	if (mp3d) {
 		mp3dec_ex_close(mp3d);
 		memfree(mp3d);
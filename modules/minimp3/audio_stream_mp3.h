@@ -46,6 +46,8 @@ class AudioStreamPlaybackMP3 : public AudioStreamPlaybackResampled {
 	bool active = false;
 	int loops = 0;
 
+	void _seek(float p_time);
+
 	friend class AudioStreamMP3;
 
 	Ref<AudioStreamMP3> mp3_stream;
@@ -53,6 +55,7 @@ class AudioStreamPlaybackMP3 : public AudioStreamPlaybackResampled {
 protected:
 	virtual int _mix_internal(AudioFrame *p_buffer, int p_frames) override;
 	virtual float get_stream_sampling_rate() override;
+	virtual bool _can_predecode() const override { return true; }
 
 public:
 	virtual void start(float p_from_pos = 0.0) override;
@@ -64,6 +67,9 @@ public:
 	virtual float get_playback_position() const override;
 	virtual void seek(float p_time) override;
 
+	virtual float get_length() const override;
+	virtual bool get_loop_range(float &r_begin, float &r_end) const override;
+
 	AudioStreamPlaybackMP3() {}
 	~AudioStreamPlaybackMP3();
 };
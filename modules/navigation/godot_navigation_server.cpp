@@ -31,6 +31,7 @@
 #include "godot_navigation_server.h"
 
 #include "core/os/mutex.h"
+#include "core/os/os.h"
 
 #ifndef _3D_DISABLED
 #include "navigation_mesh_generator.h"
@@ -118,6 +119,15 @@ GodotNavigationServer::GodotNavigationServer() :
 }
 
 GodotNavigationServer::~GodotNavigationServer() {
+	// Don't leave workers reading freed maps, the results are dropped.
+	for (uint32_t i = 0; i < path_queries_running.size(); i++) {
+		WorkerThreadPool::get_singleton()->wait(&path_queries_running[i]->group);
+		memdelete(path_queries_running[i]);
+	}
+	for (uint32_t i = 0; i < path_queries_held.size(); i++) {
+		memdelete(path_queries_held[i]);
+	}
+
 	flush_queries();
 }
 
@@ -208,35 +218,159 @@ Vector<Vector3> GodotNavigationServer::map_get_path(RID p_map, Vector3 p_origin,
 	const NavMap *map = map_owner.getornull(p_map);
 	ERR_FAIL_COND_V(map == nullptr, Vector<Vector3>());
 
-	return map->get_path(p_origin, p_destination, p_optimize, p_layers);
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	Vector<Vector3> path = map->get_path(p_origin, p_destination, p_optimize, p_layers);
+	_record_query(begin);
+
+	return path;
 }
 
 Vector3 GodotNavigationServer::map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
 	const NavMap *map = map_owner.getornull(p_map);
 	ERR_FAIL_COND_V(map == nullptr, Vector3());
 
-	return map->get_closest_point_to_segment(p_from, p_to, p_use_collision);
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	Vector3 point = map->get_closest_point_to_segment(p_from, p_to, p_use_collision);
+	_record_query(begin);
+
+	return point;
 }
 
 Vector3 GodotNavigationServer::map_get_closest_point(RID p_map, const Vector3 &p_point) const {
 	const NavMap *map = map_owner.getornull(p_map);
 	ERR_FAIL_COND_V(map == nullptr, Vector3());
 
-	return map->get_closest_point(p_point);
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	Vector3 point = map->get_closest_point(p_point);
+	_record_query(begin);
+
+	return point;
 }
 
 Vector3 GodotNavigationServer::map_get_closest_point_normal(RID p_map, const Vector3 &p_point) const {
 	const NavMap *map = map_owner.getornull(p_map);
 	ERR_FAIL_COND_V(map == nullptr, Vector3());
 
-	return map->get_closest_point_normal(p_point);
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	Vector3 normal = map->get_closest_point_normal(p_point);
+	_record_query(begin);
+
+	return normal;
 }
 
 RID GodotNavigationServer::map_get_closest_point_owner(RID p_map, const Vector3 &p_point) const {
 	const NavMap *map = map_owner.getornull(p_map);
 	ERR_FAIL_COND_V(map == nullptr, RID());
 
-	return map->get_closest_point_owner(p_point);
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	RID owner = map->get_closest_point_owner(p_point);
+	_record_query(begin);
+
+	return owner;
+}
+
+void GodotNavigationServer::map_get_paths_async(RID p_map, const Vector<Vector3> &p_origins, const Vector<Vector3> &p_destinations, bool p_optimize, const Vector<int32_t> &p_layers, const Callable &p_callback) const {
+	ERR_FAIL_COND(map_owner.getornull(p_map) == nullptr);
+	ERR_FAIL_COND_MSG(p_origins.size() != p_destinations.size(), "The origins and destinations must have the same size.");
+	ERR_FAIL_COND_MSG(p_layers.size() > 1 && p_layers.size() != p_origins.size(), "The layers must be empty, a single mask or one mask per query.");
+
+	PathQueryBatch *batch = memnew(PathQueryBatch);
+	batch->server = this;
+	batch->map_rid = p_map;
+	batch->origins = p_origins;
+	batch->destinations = p_destinations;
+	batch->layers = p_layers;
+	batch->optimize = p_optimize;
+	batch->callback = p_callback;
+	batch->paths.resize(p_origins.size());
+
+	GodotNavigationServer *mut_this = const_cast<GodotNavigationServer *>(this);
+	MutexLock lock(mut_this->path_queries_mutex);
+	if (path_queries_on_hold) {
+		mut_this->path_queries_held.push_back(batch);
+	} else {
+		_start_path_queries(batch);
+	}
+}
+
+void GodotNavigationServer::PathQueryBatch::run() {
+	const uint32_t count = origins.size();
+	while (true) {
+		const uint32_t i = next_query.postincrement();
+		if (i >= count) {
+			break;
+		}
+
+		uint32_t query_layers = 1;
+		if (layers.size() == 1) {
+			query_layers = layers[0];
+		} else if (layers.size() > 1) {
+			query_layers = layers[i];
+		}
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		paths[i] = map->get_path(origins[i], destinations[i], optimize, query_layers);
+		server->_record_query(begin);
+	}
+}
+
+void GodotNavigationServer::_start_path_queries(PathQueryBatch *p_batch) const {
+	GodotNavigationServer *mut_this = const_cast<GodotNavigationServer *>(this);
+	mut_this->path_queries_running.push_back(p_batch);
+
+	// The map may have been freed while the batch was held.
+	p_batch->map = map_owner.getornull(p_batch->map_rid);
+	if (p_batch->map == nullptr || p_batch->paths.size() == 0) {
+		return;
+	}
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool == nullptr) {
+		p_batch->run();
+		return;
+	}
+
+	const uint32_t instances = CLAMP(p_batch->paths.size(), 1u, MAX(pool->get_thread_count(), 1u));
+	pool->add_task(p_batch, WorkerThreadPool::PRIORITY_NORMAL, &p_batch->group, nullptr, instances);
+}
+
+void GodotNavigationServer::_finish_path_queries() {
+	LocalVector<PathQueryBatch *> finished;
+	{
+		MutexLock lock(path_queries_mutex);
+		path_queries_on_hold = true;
+		finished = path_queries_running;
+		path_queries_running.clear();
+	}
+
+	for (uint32_t i = 0; i < finished.size(); i++) {
+		PathQueryBatch *batch = finished[i];
+		if (WorkerThreadPool::get_singleton()) {
+			WorkerThreadPool::get_singleton()->wait(&batch->group);
+		}
+
+		Array paths;
+		paths.resize(batch->paths.size());
+		for (uint32_t j = 0; j < batch->paths.size(); j++) {
+			paths[j] = batch->paths[j];
+		}
+
+		Variant paths_arg = paths;
+		const Variant *args[1] = { &paths_arg };
+		Variant ret;
+		Callable::CallError ce;
+		batch->callback.call(args, 1, ret, ce);
+		if (ce.error != Callable::CallError::CALL_OK) {
+			ERR_PRINT("Error calling the path queries callback: " + Variant::get_callable_error_text(batch->callback, args, 1, ce));
+		}
+
+		memdelete(batch);
+	}
+}
+
+void GodotNavigationServer::_record_query(uint64_t p_begin_usec) const {
+	query_usec.add(OS::get_singleton()->get_ticks_usec() - p_begin_usec);
+	query_count.increment();
 }
 
 RID GodotNavigationServer::region_create() const {
@@ -519,12 +653,34 @@ void GodotNavigationServer::flush_queries() {
 }
 
 void GodotNavigationServer::process(real_t p_delta_time) {
+	// The async path queries read the maps, so they must be completed before
+	// anything changes them. New ones are held until the maps are synced.
+	_finish_path_queries();
+
 	flush_queries();
 
-	if (!active) {
-		return;
+	// Subtract what was read rather than resetting, so queries finishing
+	// concurrently are carried over to the next frame instead of lost.
+	uint32_t count = query_count.get();
+	query_count.sub(count);
+	last_query_count = count;
+	uint64_t usec = query_usec.get();
+	query_usec.sub(usec);
+	last_query_usec = usec;
+
+	if (active) {
+		_sync_maps(p_delta_time);
 	}
 
+	MutexLock lock(path_queries_mutex);
+	path_queries_on_hold = false;
+	for (uint32_t i = 0; i < path_queries_held.size(); i++) {
+		_start_path_queries(path_queries_held[i]);
+	}
+	path_queries_held.clear();
+}
+
+void GodotNavigationServer::_sync_maps(real_t p_delta_time) {
 	// In c++ we can't be sure that this is performed in the main thread
 	// even with mutable functions.
 	MutexLock lock(operations_mutex);
@@ -542,6 +698,19 @@ void GodotNavigationServer::process(real_t p_delta_time) {
 	}
 }
 
+int GodotNavigationServer::get_process_info(ProcessInfo p_info) const {
+	switch (p_info) {
+		case INFO_QUERY_COUNT: {
+			return last_query_count;
+		} break;
+		case INFO_QUERY_TIME: {
+			return last_query_usec;
+		} break;
+	}
+
+	return 0;
+}
+
 #undef COMMAND_1
 #undef COMMAND_2
 #undef COMMAND_4
@@ -31,9 +31,11 @@
 #ifndef GODOT_NAVIGATION_SERVER_H
 #define GODOT_NAVIGATION_SERVER_H
 
+#include "core/os/worker_thread_pool.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/rid.h"
 #include "core/templates/rid_owner.h"
+#include "core/templates/safe_refcount.h"
 #include "servers/navigation_server_3d.h"
 
 #include "nav_map.h"
@@ -83,6 +85,46 @@ class GodotNavigationServer : public NavigationServer3D {
 	LocalVector<NavMap *> active_maps;
 	LocalVector<uint32_t> active_maps_update_id;
 
+	/// Queries can run on any thread, so they are counted atomically and
+	/// snapshotted once per `process` frame.
+	mutable SafeNumeric<uint32_t> query_count;
+	mutable SafeNumeric<uint64_t> query_usec;
+	int last_query_count = 0;
+	int last_query_usec = 0;
+
+	void _record_query(uint64_t p_begin_usec) const;
+
+	/// A batch of `map_get_paths_async` queries, every task instance takes
+	/// the next unsolved query until none is left.
+	struct PathQueryBatch : public WorkerThreadPool::Task {
+		const GodotNavigationServer *server = nullptr;
+		RID map_rid;
+		const NavMap *map = nullptr;
+		Vector<Vector3> origins;
+		Vector<Vector3> destinations;
+		Vector<int32_t> layers;
+		bool optimize = false;
+		Callable callback;
+
+		LocalVector<Vector<Vector3>> paths;
+		SafeNumeric<uint32_t> next_query;
+		WorkerThreadPool::Group group;
+
+		virtual void run() override;
+	};
+
+	/// The batches only read the maps, so they run freely between two
+	/// `process` calls and are completed before the maps are synced again.
+	/// Batches submitted during `process` are held until it ends.
+	Mutex path_queries_mutex;
+	LocalVector<PathQueryBatch *> path_queries_running;
+	LocalVector<PathQueryBatch *> path_queries_held;
+	bool path_queries_on_hold = false;
+
+	void _start_path_queries(PathQueryBatch *p_batch) const;
+	void _finish_path_queries();
+	void _sync_maps(real_t p_delta_time);
+
 public:
 	GodotNavigationServer();
 	virtual ~GodotNavigationServer();
@@ -108,6 +150,7 @@ public:
 	virtual Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const;
 	virtual Vector3 map_get_closest_point_normal(RID p_map, const Vector3 &p_point) const;
 	virtual RID map_get_closest_point_owner(RID p_map, const Vector3 &p_point) const;
+	virtual void map_get_paths_async(RID p_map, const Vector<Vector3> &p_origins, const Vector<Vector3> &p_destinations, bool p_optimize, const Vector<int32_t> &p_layers, const Callable &p_callback) const;
 
 	virtual RID region_create() const;
 	COMMAND_2(region_set_map, RID, p_region, RID, p_map);
@@ -140,6 +183,8 @@ public:
 
 	void flush_queries();
 	virtual void process(real_t p_delta_time);
+
+	virtual int get_process_info(ProcessInfo p_info) const;
 };
 
 #undef COMMAND_1
@@ -31,6 +31,7 @@
 #include "nav_map.h"
 
 #include "core/os/threaded_array_processor.h"
+#include "core/templates/sort_array.h"
 #include "nav_region.h"
 #include "rvo_agent.h"
 
@@ -42,6 +43,288 @@
 
 #define THREE_POINTS_CROSS_PRODUCT(m_a, m_b, m_c) (((m_c) - (m_a)).cross((m_b) - (m_a)))
 
+static _FORCE_INLINE_ real_t _get_aabb_distance_squared(const AABB &p_a, const AABB &p_b) {
+	real_t d = 0.0;
+	for (int i = 0; i < 3; i++) {
+		real_t gap = MAX(p_a.position[i] - (p_b.position[i] + p_b.size[i]), p_b.position[i] - (p_a.position[i] + p_a.size[i]));
+		if (gap > 0.0) {
+			d += gap * gap;
+		}
+	}
+	return d;
+}
+
+static _FORCE_INLINE_ real_t _get_aabb_distance_squared(const AABB &p_aabb, const Vector3 &p_point) {
+	return _get_aabb_distance_squared(p_aabb, AABB(p_point, Vector3()));
+}
+
+/// Closest point on the map polygons to a point.
+struct NavMapClosestPointQuery {
+	const std::vector<gd::Polygon> *polygons = nullptr;
+	Vector3 point;
+	/// Polygons in regions without any of these layers are ignored.
+	uint32_t layers = UINT32_MAX;
+	/// Use the faces built from every three consecutive points (wrapping
+	/// around) instead of only the ones ending at each point after the second.
+	bool wrap_faces = false;
+
+	real_t closest_distance = 1e20;
+	Vector3 closest_point;
+	Vector3 closest_normal;
+	const gd::Polygon *closest_polygon = nullptr;
+
+	_FORCE_INLINE_ bool get_bound(const AABB &p_aabb, real_t &r_bound) const {
+		r_bound = _get_aabb_distance_squared(p_aabb, point);
+		return true;
+	}
+
+	_FORCE_INLINE_ real_t get_limit() const {
+		return closest_distance * closest_distance;
+	}
+
+	_FORCE_INLINE_ void process(const Face3 &p_face, const gd::Polygon &p_polygon) {
+		const Vector3 inters = p_face.get_closest_point_to(point);
+		const real_t d = inters.distance_to(point);
+		if (d < closest_distance) {
+			closest_distance = d;
+			closest_point = inters;
+			closest_normal = p_face.get_plane().normal;
+			closest_polygon = &p_polygon;
+		}
+	}
+
+	void process(int p_polygon_index) {
+		const gd::Polygon &p = (*polygons)[p_polygon_index];
+		if ((layers & p.owner->get_layers()) == 0) {
+			return;
+		}
+
+		const size_t point_count = p.points.size();
+		if (wrap_faces) {
+			for (size_t point_id = 0; point_id < point_count; point_id++) {
+				process(Face3(p.points[point_id].pos, p.points[(point_id + 1) % point_count].pos, p.points[(point_id + 2) % point_count].pos), p);
+			}
+		} else {
+			for (size_t point_id = 2; point_id < point_count; point_id++) {
+				process(Face3(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos), p);
+			}
+		}
+	}
+};
+
+/// Closest intersection of a segment with the map polygons, measured from the segment start.
+struct NavMapSegmentIntersectionQuery {
+	const std::vector<gd::Polygon> *polygons = nullptr;
+	Vector3 from;
+	Vector3 to;
+
+	real_t closest_distance = 1e20;
+	Vector3 closest_point;
+	bool found = false;
+
+	_FORCE_INLINE_ bool get_bound(const AABB &p_aabb, real_t &r_bound) const {
+		if (!p_aabb.intersects_segment(from, to)) {
+			return false;
+		}
+		r_bound = _get_aabb_distance_squared(p_aabb, from);
+		return true;
+	}
+
+	_FORCE_INLINE_ real_t get_limit() const {
+		return closest_distance * closest_distance;
+	}
+
+	void process(int p_polygon_index) {
+		const gd::Polygon &p = (*polygons)[p_polygon_index];
+		for (size_t point_id = 2; point_id < p.points.size(); point_id++) {
+			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
+			Vector3 inters;
+			if (f.intersects_segment(from, to, &inters)) {
+				const real_t d = from.distance_to(inters);
+				if (d < closest_distance) {
+					closest_distance = d;
+					closest_point = inters;
+					found = true;
+				}
+			}
+		}
+	}
+};
+
+/// Closest point on the map polygon edges to a segment.
+struct NavMapSegmentClosestEdgeQuery {
+	const std::vector<gd::Polygon> *polygons = nullptr;
+	Vector3 from;
+	Vector3 to;
+	AABB segment_aabb;
+
+	real_t closest_distance = 1e20;
+	Vector3 closest_point;
+
+	_FORCE_INLINE_ bool get_bound(const AABB &p_aabb, real_t &r_bound) const {
+		r_bound = _get_aabb_distance_squared(p_aabb, segment_aabb);
+		return true;
+	}
+
+	_FORCE_INLINE_ real_t get_limit() const {
+		return closest_distance * closest_distance;
+	}
+
+	void process(int p_polygon_index) {
+		const gd::Polygon &p = (*polygons)[p_polygon_index];
+		for (size_t point_id = 0; point_id < p.points.size(); point_id++) {
+			Vector3 a, b;
+			Geometry3D::get_closest_points_between_segments(
+					from,
+					to,
+					p.points[point_id].pos,
+					p.points[(point_id + 1) % p.points.size()].pos,
+					a,
+					b);
+
+			const real_t d = a.distance_to(b);
+			if (d < closest_distance) {
+				closest_distance = d;
+				closest_point = b;
+			}
+		}
+	}
+};
+
+/// Per thread working memory of `NavMap::get_path`, kept between calls so
+/// repeated queries don't allocate once it has grown to the map size.
+struct NavMapPathScratch {
+	struct OpenEntry {
+		float cost;
+		uint32_t id;
+
+		// Equal costs are common (entries clamped to a shared vertex), so
+		// break ties by discovery order to keep the paths deterministic.
+		_FORCE_INLINE_ bool operator<(const OpenEntry &p_other) const {
+			return cost == p_other.cost ? id < p_other.id : cost < p_other.cost;
+		}
+	};
+
+	/// The reachable navigation polygons, in discovery order.
+	std::vector<gd::NavigationPoly> navigation_polys;
+
+	/// Binary min heap of the navigation polygons left to visit.
+	LocalVector<OpenEntry> open;
+
+	/// Visited table, indexed by map polygon. An entry is only valid when its
+	/// pass matches the current one, so starting a search never clears it.
+	LocalVector<uint32_t> polygon_pass;
+	LocalVector<uint32_t> polygon_navigation_id;
+	uint32_t pass = 0;
+
+	void begin(uint32_t p_polygon_count) {
+		if (polygon_pass.size() < p_polygon_count) {
+			uint32_t old_size = polygon_pass.size();
+			polygon_pass.resize(p_polygon_count);
+			polygon_navigation_id.resize(p_polygon_count);
+			for (uint32_t i = old_size; i < p_polygon_count; i++) {
+				polygon_pass[i] = 0;
+			}
+		}
+
+		pass++;
+		if (pass == 0) {
+			// Wrapped around, stale entries could match again.
+			for (uint32_t i = 0; i < polygon_pass.size(); i++) {
+				polygon_pass[i] = 0;
+			}
+			pass = 1;
+		}
+
+		navigation_polys.clear();
+		open.clear();
+	}
+
+	_FORCE_INLINE_ int find(uint32_t p_polygon_index) const {
+		return polygon_pass[p_polygon_index] == pass ? int(polygon_navigation_id[p_polygon_index]) : -1;
+	}
+
+	_FORCE_INLINE_ uint32_t add(uint32_t p_polygon_index, const gd::NavigationPoly &p_navigation_poly) {
+		uint32_t id = navigation_polys.size();
+		navigation_polys.push_back(p_navigation_poly);
+		navigation_polys.back().self_id = id;
+		polygon_pass[p_polygon_index] = pass;
+		polygon_navigation_id[p_polygon_index] = id;
+		return id;
+	}
+
+	void open_push(uint32_t p_id, float p_cost) {
+		OpenEntry entry;
+		entry.cost = p_cost;
+		entry.id = p_id;
+		open.push_back(entry);
+		_sift_up(open.size() - 1);
+	}
+
+	uint32_t open_pop() {
+		uint32_t id = open[0].id;
+		navigation_polys[id].open_index = -1;
+		open[0] = open[open.size() - 1];
+		open.resize(open.size() - 1);
+		if (open.size()) {
+			_sift_down(0);
+		}
+		return id;
+	}
+
+	/// A shorter travel distance also moves the entry point, so the cost
+	/// can go either way.
+	void open_update(uint32_t p_id, float p_cost) {
+		uint32_t pos = navigation_polys[p_id].open_index;
+		float old_cost = open[pos].cost;
+		open[pos].cost = p_cost;
+		if (p_cost < old_cost) {
+			_sift_up(pos);
+		} else {
+			_sift_down(pos);
+		}
+	}
+
+	void _sift_up(uint32_t p_pos) {
+		OpenEntry entry = open[p_pos];
+		while (p_pos > 0) {
+			uint32_t parent = (p_pos - 1) / 2;
+			if (!(entry < open[parent])) {
+				break;
+			}
+			open[p_pos] = open[parent];
+			navigation_polys[open[p_pos].id].open_index = p_pos;
+			p_pos = parent;
+		}
+		open[p_pos] = entry;
+		navigation_polys[entry.id].open_index = p_pos;
+	}
+
+	void _sift_down(uint32_t p_pos) {
+		OpenEntry entry = open[p_pos];
+		const uint32_t size = open.size();
+		while (true) {
+			uint32_t child = p_pos * 2 + 1;
+			if (child >= size) {
+				break;
+			}
+			if (child + 1 < size && open[child + 1] < open[child]) {
+				child++;
+			}
+			if (!(open[child] < entry)) {
+				break;
+			}
+			open[p_pos] = open[child];
+			navigation_polys[open[p_pos].id].open_index = p_pos;
+			p_pos = child;
+		}
+		open[p_pos] = entry;
+		navigation_polys[entry.id].open_index = p_pos;
+	}
+};
+
+static thread_local NavMapPathScratch path_scratch;
+
 void NavMap::set_up(Vector3 p_up) {
 	up = p_up;
 	regenerate_polygons = true;
@@ -72,45 +355,10 @@ gd::PointKey NavMap::get_point_key(const Vector3 &p_pos) const {
 
 Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_layers) const {
 	// Find the start poly and the end poly on this map.
-	const gd::Polygon *begin_poly = nullptr;
-	const gd::Polygon *end_poly = nullptr;
 	Vector3 begin_point;
 	Vector3 end_point;
-	float begin_d = 1e20;
-	float end_d = 1e20;
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// Only consider the polygon if it in a region with compatible layers.
-		if ((p_layers & p.owner->get_layers()) == 0) {
-			continue;
-		}
-
-		// For each point cast a face and check the distance between the origin/destination
-		for (size_t point_id = 0; point_id < p.points.size(); point_id++) {
-			const Vector3 p1 = p.points[point_id].pos;
-			const Vector3 p2 = p.points[(point_id + 1) % p.points.size()].pos;
-			const Vector3 p3 = p.points[(point_id + 2) % p.points.size()].pos;
-			const Face3 face(p1, p2, p3);
-
-			Vector3 point = face.get_closest_point_to(p_origin);
-			float distance_to_point = point.distance_to(p_origin);
-			if (distance_to_point < begin_d) {
-				begin_d = distance_to_point;
-				begin_poly = &p;
-				begin_point = point;
-			}
-
-			point = face.get_closest_point_to(p_destination);
-			distance_to_point = point.distance_to(p_destination);
-			if (distance_to_point < end_d) {
-				end_d = distance_to_point;
-				end_poly = &p;
-				end_point = point;
-			}
-		}
-	}
+	const gd::Polygon *begin_poly = _get_closest_polygon(p_origin, p_layers, begin_point);
+	const gd::Polygon *end_poly = _get_closest_polygon(p_destination, p_layers, end_point);
 
 	// Check for trivial cases
 	if (!begin_poly || !end_poly) {
@@ -124,23 +372,20 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		return path;
 	}
 
-	// List of all reachable navigation polys.
-	std::vector<gd::NavigationPoly> navigation_polys;
-	navigation_polys.reserve(polygons.size() * 0.75);
+	NavMapPathScratch &scratch = path_scratch;
+	std::vector<gd::NavigationPoly> &navigation_polys = scratch.navigation_polys;
+	const uint32_t begin_poly_index = begin_poly - polygons.data();
+	scratch.begin(polygons.size());
 
 	// Add the start polygon to the reachable navigation polygons.
 	gd::NavigationPoly begin_navigation_poly = gd::NavigationPoly(begin_poly);
-	begin_navigation_poly.self_id = 0;
 	begin_navigation_poly.entry = begin_point;
 	begin_navigation_poly.back_navigation_edge_pathway_start = begin_point;
 	begin_navigation_poly.back_navigation_edge_pathway_end = begin_point;
-	navigation_polys.push_back(begin_navigation_poly);
-
-	// List of polygon IDs to visit.
-	List<uint32_t> to_visit;
-	to_visit.push_back(0);
+	scratch.add(begin_poly_index, begin_navigation_poly);
 
-	// This is an implementation of the A* algorithm.
+	// This is an implementation of the A* algorithm, the start polygon is
+	// visited first.
 	int least_cost_id = 0;
 	bool found_route = false;
 
@@ -149,11 +394,11 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	bool is_reachable = true;
 
 	while (true) {
-		gd::NavigationPoly *least_cost_poly = &navigation_polys[least_cost_id];
-
-		// Takes the current least_cost_poly neighbors (iterating over its edges) and compute the traveled_distance.
-		for (size_t i = 0; i < least_cost_poly->poly->edges.size(); i++) {
-			const gd::Edge &edge = least_cost_poly->poly->edges[i];
+		// Takes the current least cost poly neighbors (iterating over its edges) and compute the traveled_distance.
+		// Note: `navigation_polys` may grow in this loop, so don't keep pointers into it.
+		const gd::Polygon *least_cost_polygon = navigation_polys[least_cost_id].poly;
+		for (size_t i = 0; i < least_cost_polygon->edges.size(); i++) {
+			const gd::Edge &edge = least_cost_polygon->edges[i];
 
 			// Iterate over connections in this edge, then compute the new optimized travel distance assigned to this polygon.
 			for (int connection_index = 0; connection_index < edge.connections.size(); connection_index++) {
@@ -164,48 +409,47 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 					continue;
 				}
 
+				const gd::NavigationPoly &least_cost_poly = navigation_polys[least_cost_id];
 				Vector3 pathway[2] = { connection.pathway_start, connection.pathway_end };
-				const Vector3 new_entry = Geometry3D::get_closest_point_to_segment(least_cost_poly->entry, pathway);
-				const float new_distance = least_cost_poly->entry.distance_to(new_entry) + least_cost_poly->traveled_distance;
+				const Vector3 new_entry = Geometry3D::get_closest_point_to_segment(least_cost_poly.entry, pathway);
+				const float new_distance = least_cost_poly.entry.distance_to(new_entry) + least_cost_poly.traveled_distance;
 
-				const std::vector<gd::NavigationPoly>::iterator it = std::find(
-						navigation_polys.begin(),
-						navigation_polys.end(),
-						gd::NavigationPoly(connection.polygon));
+				const uint32_t polygon_index = connection.polygon - polygons.data();
+				const int id = scratch.find(polygon_index);
 
-				if (it != navigation_polys.end()) {
+				if (id != -1) {
 					// Polygon already visited, check if we can reduce the travel cost.
-					if (new_distance < it->traveled_distance) {
-						it->back_navigation_poly_id = least_cost_id;
-						it->back_navigation_edge = connection.edge;
-						it->back_navigation_edge_pathway_start = connection.pathway_start;
-						it->back_navigation_edge_pathway_end = connection.pathway_end;
-						it->traveled_distance = new_distance;
-						it->entry = new_entry;
+					gd::NavigationPoly &np = navigation_polys[id];
+					if (new_distance < np.traveled_distance) {
+						np.back_navigation_poly_id = least_cost_id;
+						np.back_navigation_edge = connection.edge;
+						np.back_navigation_edge_pathway_start = connection.pathway_start;
+						np.back_navigation_edge_pathway_end = connection.pathway_end;
+						np.traveled_distance = new_distance;
+						np.entry = new_entry;
+						if (np.open_index != -1) {
+							scratch.open_update(id, new_distance + new_entry.distance_to(end_point));
+						}
 					}
 				} else {
 					// Add the neighbour polygon to the reachable ones.
 					gd::NavigationPoly new_navigation_poly = gd::NavigationPoly(connection.polygon);
-					new_navigation_poly.self_id = navigation_polys.size();
 					new_navigation_poly.back_navigation_poly_id = least_cost_id;
 					new_navigation_poly.back_navigation_edge = connection.edge;
 					new_navigation_poly.back_navigation_edge_pathway_start = connection.pathway_start;
 					new_navigation_poly.back_navigation_edge_pathway_end = connection.pathway_end;
 					new_navigation_poly.traveled_distance = new_distance;
 					new_navigation_poly.entry = new_entry;
-					navigation_polys.push_back(new_navigation_poly);
 
 					// Add the neighbour polygon to the polygons to visit.
-					to_visit.push_back(navigation_polys.size() - 1);
+					const uint32_t new_id = scratch.add(polygon_index, new_navigation_poly);
+					scratch.open_push(new_id, new_distance + new_entry.distance_to(end_point));
 				}
 			}
 		}
 
-		// Removes the least cost polygon from the list of polygons to visit so we can advance.
-		to_visit.erase(least_cost_id);
-
 		// When the list of polygons to visit is empty at this point it means the End Polygon is not reachable
-		if (to_visit.size() == 0) {
+		if (scratch.open.is_empty()) {
 			// Thus use the further reachable polygon
 			ERR_BREAK_MSG(is_reachable == false, "It's not expect to not find the most reachable polygons");
 			is_reachable = false;
@@ -216,7 +460,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 
 			// Set as end point the furthest reachable point.
 			end_poly = reachable_end;
-			end_d = 1e20;
+			float end_d = 1e20;
 			for (size_t point_id = 2; point_id < end_poly->points.size(); point_id++) {
 				Face3 f(end_poly->points[point_id - 2].pos, end_poly->points[point_id - 1].pos, end_poly->points[point_id].pos);
 				Vector3 spoint = f.get_closest_point_to(p_destination);
@@ -227,30 +471,19 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 				}
 			}
 
-			// Reset open and navigation_polys
+			// Restart the search from the start polygon only.
 			gd::NavigationPoly np = navigation_polys[0];
-			navigation_polys.clear();
-			navigation_polys.push_back(np);
-			to_visit.clear();
-			to_visit.push_back(0);
+			scratch.begin(polygons.size());
+			scratch.add(begin_poly_index, np);
+			least_cost_id = 0;
 
 			reachable_end = nullptr;
 
 			continue;
 		}
 
-		// Find the polygon with the minimum cost from the list of polygons to visit.
-		least_cost_id = -1;
-		float least_cost = 1e30;
-		for (List<uint32_t>::Element *element = to_visit.front(); element != nullptr; element = element->next()) {
-			gd::NavigationPoly *np = &navigation_polys[element->get()];
-			float cost = np->traveled_distance;
-			cost += np->entry.distance_to(end_point);
-			if (cost < least_cost) {
-				least_cost_id = np->self_id;
-				least_cost = cost;
-			}
-		}
+		// Take the polygon with the minimum cost from the list of polygons to visit.
+		least_cost_id = scratch.open_pop();
 
 		// Stores the further reachable end polygon, in case our goal is not reachable.
 		if (is_reachable) {
@@ -261,8 +494,6 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 			}
 		}
 
-		ERR_BREAK(least_cost_id == -1);
-
 		// Check if we reached the end
 		if (navigation_polys[least_cost_id].poly == end_poly) {
 			found_route = true;
@@ -370,132 +601,211 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 }
 
 Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
-	bool use_collision = p_use_collision;
-	Vector3 closest_point;
-	real_t closest_point_d = 1e20;
-
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
+	// The closest intersection with the polygons is always preferred.
+	NavMapSegmentIntersectionQuery intersection_query;
+	intersection_query.polygons = &polygons;
+	intersection_query.from = p_from;
+	intersection_query.to = p_to;
+	_query_polygons_bvh(intersection_query);
+
+	if (intersection_query.found || p_use_collision) {
+		return intersection_query.closest_point;
+	}
 
-		// For each point cast a face and check the distance to the segment
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			Vector3 inters;
-			if (f.intersects_segment(p_from, p_to, &inters)) {
-				const real_t d = closest_point_d = p_from.distance_to(inters);
-				if (use_collision == false) {
-					closest_point = inters;
-					use_collision = true;
-					closest_point_d = d;
-				} else if (closest_point_d > d) {
-					closest_point = inters;
-					closest_point_d = d;
-				}
-			}
-		}
+	NavMapSegmentClosestEdgeQuery edge_query;
+	edge_query.polygons = &polygons;
+	edge_query.from = p_from;
+	edge_query.to = p_to;
+	edge_query.segment_aabb.position = p_from;
+	edge_query.segment_aabb.expand_to(p_to);
+	_query_polygons_bvh(edge_query);
 
-		if (use_collision == false) {
-			for (size_t point_id = 0; point_id < p.points.size(); point_id += 1) {
-				Vector3 a, b;
+	return edge_query.closest_point;
+}
 
-				Geometry3D::get_closest_points_between_segments(
-						p_from,
-						p_to,
-						p.points[point_id].pos,
-						p.points[(point_id + 1) % p.points.size()].pos,
-						a,
-						b);
+Vector3 NavMap::get_closest_point(const Vector3 &p_point) const {
+	// TODO this is really not optimal, please redesign the API to directly return all this data
 
-				const real_t d = a.distance_to(b);
-				if (d < closest_point_d) {
-					closest_point_d = d;
-					closest_point = b;
-				}
-			}
-		}
-	}
+	NavMapClosestPointQuery query;
+	query.polygons = &polygons;
+	query.point = p_point;
+	_query_polygons_bvh(query);
 
-	return closest_point;
+	return query.closest_point;
 }
 
-Vector3 NavMap::get_closest_point(const Vector3 &p_point) const {
+Vector3 NavMap::get_closest_point_normal(const Vector3 &p_point) const {
 	// TODO this is really not optimal, please redesign the API to directly return all this data
 
-	Vector3 closest_point;
-	real_t closest_point_d = 1e20;
+	NavMapClosestPointQuery query;
+	query.polygons = &polygons;
+	query.point = p_point;
+	_query_polygons_bvh(query);
 
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
+	return query.closest_normal;
+}
 
-		// For each point cast a face and check the distance to the point
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			const Vector3 inters = f.get_closest_point_to(p_point);
-			const real_t d = inters.distance_to(p_point);
-			if (d < closest_point_d) {
-				closest_point = inters;
-				closest_point_d = d;
-			}
-		}
+RID NavMap::get_closest_point_owner(const Vector3 &p_point) const {
+	// TODO this is really not optimal, please redesign the API to directly return all this data
+
+	NavMapClosestPointQuery query;
+	query.polygons = &polygons;
+	query.point = p_point;
+	_query_polygons_bvh(query);
+
+	if (!query.closest_polygon) {
+		return RID();
 	}
+	return query.closest_polygon->owner->get_self();
+}
+
+const gd::Polygon *NavMap::_get_closest_polygon(const Vector3 &p_point, uint32_t p_layers, Vector3 &r_point) const {
+	NavMapClosestPointQuery query;
+	query.polygons = &polygons;
+	query.point = p_point;
+	query.layers = p_layers;
+	query.wrap_faces = true;
+	_query_polygons_bvh(query);
 
-	return closest_point;
+	r_point = query.closest_point;
+	return query.closest_polygon;
 }
 
-Vector3 NavMap::get_closest_point_normal(const Vector3 &p_point) const {
-	// TODO this is really not optimal, please redesign the API to directly return all this data
+template <class Q>
+void NavMap::_query_polygons_bvh(Q &r_query) const {
+	if (polygons_bvh.is_empty()) {
+		return;
+	}
 
-	Vector3 closest_point;
-	Vector3 closest_point_normal;
-	real_t closest_point_d = 1e20;
+	// Depth first, visiting the nearest child first so the limit shrinks
+	// quickly and far away subtrees get culled.
+	struct Entry {
+		int node;
+		real_t bound;
+	};
+	Entry *stack = (Entry *)alloca(sizeof(Entry) * (polygons_bvh_max_depth + 1));
+	const PolygonBVH *bvh = polygons_bvh.ptr();
+
+	int level = 0;
+	stack[0].node = polygons_bvh.size() - 1;
+	if (!r_query.get_bound(bvh[stack[0].node].aabb, stack[0].bound)) {
+		return;
+	}
 
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
+	while (level >= 0) {
+		const Entry entry = stack[level--];
+		if (entry.bound > r_query.get_limit()) {
+			continue;
+		}
 
-		// For each point cast a face and check the distance to the point
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			const Vector3 inters = f.get_closest_point_to(p_point);
-			const real_t d = inters.distance_to(p_point);
-			if (d < closest_point_d) {
-				closest_point = inters;
-				closest_point_normal = f.get_plane().normal;
-				closest_point_d = d;
+		const PolygonBVH &b = bvh[entry.node];
+		if (b.polygon_index >= 0) {
+			r_query.process(b.polygon_index);
+			continue;
+		}
+
+		Entry left;
+		left.node = b.left;
+		bool visit_left = r_query.get_bound(bvh[b.left].aabb, left.bound);
+		Entry right;
+		right.node = b.right;
+		bool visit_right = r_query.get_bound(bvh[b.right].aabb, right.bound);
+
+		if (visit_left && visit_right && left.bound < right.bound) {
+			stack[++level] = right;
+			stack[++level] = left;
+		} else {
+			if (visit_left) {
+				stack[++level] = left;
+			}
+			if (visit_right) {
+				stack[++level] = right;
 			}
 		}
 	}
+}
 
-	return closest_point_normal;
+int NavMap::_create_polygons_bvh(PolygonBVH **p_bb, int p_from, int p_size, int p_depth, int &r_max_depth, int &r_max_alloc) {
+	if (p_depth > r_max_depth) {
+		r_max_depth = p_depth;
+	}
+
+	if (p_size == 1) {
+		return p_bb[p_from] - polygons_bvh.ptr();
+	} else if (p_size == 0) {
+		return -1;
+	}
+
+	AABB aabb = p_bb[p_from]->aabb;
+	for (int i = 1; i < p_size; i++) {
+		aabb.merge_with(p_bb[p_from + i]->aabb);
+	}
+
+	switch (aabb.get_longest_axis_index()) {
+		case Vector3::AXIS_X: {
+			SortArray<PolygonBVH *, PolygonBVHCmpX> sort_x;
+			sort_x.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
+		} break;
+		case Vector3::AXIS_Y: {
+			SortArray<PolygonBVH *, PolygonBVHCmpY> sort_y;
+			sort_y.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
+		} break;
+		case Vector3::AXIS_Z: {
+			SortArray<PolygonBVH *, PolygonBVHCmpZ> sort_z;
+			sort_z.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
+		} break;
+	}
+
+	int left = _create_polygons_bvh(p_bb, p_from, p_size / 2, p_depth + 1, r_max_depth, r_max_alloc);
+	int right = _create_polygons_bvh(p_bb, p_from + p_size / 2, p_size - p_size / 2, p_depth + 1, r_max_depth, r_max_alloc);
+
+	int index = r_max_alloc++;
+	PolygonBVH &node = polygons_bvh[index];
+	node.aabb = aabb;
+	node.center = aabb.position + aabb.size * 0.5;
+	node.polygon_index = -1;
+	node.left = left;
+	node.right = right;
+
+	return index;
 }
 
-RID NavMap::get_closest_point_owner(const Vector3 &p_point) const {
-	// TODO this is really not optimal, please redesign the API to directly return all this data
+void NavMap::_update_polygons_bvh() {
+	polygons_bvh.clear();
+	polygons_bvh_max_depth = 0;
 
-	Vector3 closest_point;
-	RID closest_point_owner;
-	real_t closest_point_d = 1e20;
+	const int polygon_count = polygons.size();
+	if (polygon_count == 0) {
+		return;
+	}
 
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
+	// A binary tree with one leaf per polygon.
+	polygons_bvh.resize(polygon_count * 2 - 1);
+	LocalVector<PolygonBVH *> bb;
+	bb.resize(polygon_count);
 
-		// For each point cast a face and check the distance to the point
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			const Vector3 inters = f.get_closest_point_to(p_point);
-			const real_t d = inters.distance_to(p_point);
-			if (d < closest_point_d) {
-				closest_point = inters;
-				closest_point_owner = p.owner->get_self();
-				closest_point_d = d;
+	for (int i = 0; i < polygon_count; i++) {
+		const gd::Polygon &p = polygons[i];
+		PolygonBVH &leaf = polygons_bvh[i];
+		leaf.aabb = AABB();
+		for (size_t point_id = 0; point_id < p.points.size(); point_id++) {
+			if (point_id == 0) {
+				leaf.aabb.position = p.points[point_id].pos;
+			} else {
+				leaf.aabb.expand_to(p.points[point_id].pos);
 			}
 		}
+		// Flat navigation meshes give flat boxes, make sure segment tests can't miss them.
+		leaf.aabb.grow_by(CMP_EPSILON);
+		leaf.center = leaf.aabb.position + leaf.aabb.size * 0.5;
+		leaf.left = -1;
+		leaf.right = -1;
+		leaf.polygon_index = i;
+		bb[i] = &leaf;
 	}
 
-	return closest_point_owner;
+	int max_alloc = polygon_count;
+	_create_polygons_bvh(bb.ptr(), 0, polygon_count, 1, polygons_bvh_max_depth, max_alloc);
 }
 
 void NavMap::add_region(NavRegion *p_region) {
@@ -584,6 +894,8 @@ void NavMap::sync() {
 			count += regions[r]->get_polygons().size();
 		}
 
+		_update_polygons_bvh();
+
 		// Group all edges per key.
 		Map<gd::EdgeKey, Vector<gd::Edge::Connection>> connections;
 		for (size_t poly_id(0); poly_id < polygons.size(); poly_id++) {
@@ -717,11 +1029,14 @@ void NavMap::compute_single_step(uint32_t index, RvoAgent **agent) {
 void NavMap::step(real_t p_deltatime) {
 	deltatime = p_deltatime;
 	if (controlled_agents.size() > 0) {
+		// Stepping one agent is cheap, so hand agents out to the workers in
+		// chunks instead of one at a time.
 		thread_process_array(
 				controlled_agents.size(),
 				this,
 				&NavMap::compute_single_step,
-				controlled_agents.data());
+				controlled_agents.data(),
+				AGENT_STEP_BATCH_SIZE);
 	}
 }
 
@@ -33,7 +33,9 @@
 
 #include "nav_rid.h"
 
+#include "core/math/aabb.h"
 #include "core/math/math_defs.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/map.h"
 #include "nav_utils.h"
 #include <KdTree.h>
@@ -47,6 +49,9 @@ class RvoAgent;
 class NavRegion;
 
 class NavMap : public NavRid {
+	/// Number of agents a worker thread steps at once.
+	static const uint32_t AGENT_STEP_BATCH_SIZE = 16;
+
 	/// Map Up
 	Vector3 up = Vector3(0, 1, 0);
 
@@ -65,6 +70,38 @@ class NavMap : public NavRid {
 	/// Map polygons
 	std::vector<gd::Polygon> polygons;
 
+	/// Bounding volume hierarchy over the map polygons, used by the closest
+	/// polygon queries. The leaves are the polygons in the same order as
+	/// `polygons`, the root is the last node.
+	struct PolygonBVH {
+		AABB aabb;
+		Vector3 center; // Used for sorting.
+		int left = -1;
+		int right = -1;
+		int polygon_index = -1;
+	};
+
+	struct PolygonBVHCmpX {
+		bool operator()(const PolygonBVH *p_left, const PolygonBVH *p_right) const {
+			return p_left->center.x < p_right->center.x;
+		}
+	};
+
+	struct PolygonBVHCmpY {
+		bool operator()(const PolygonBVH *p_left, const PolygonBVH *p_right) const {
+			return p_left->center.y < p_right->center.y;
+		}
+	};
+
+	struct PolygonBVHCmpZ {
+		bool operator()(const PolygonBVH *p_left, const PolygonBVH *p_right) const {
+			return p_left->center.z < p_right->center.z;
+		}
+	};
+
+	LocalVector<PolygonBVH> polygons_bvh;
+	int polygons_bvh_max_depth = 0;
+
 	/// Rvo world
 	RVO::KdTree rvo;
 
@@ -135,6 +172,13 @@ public:
 
 private:
 	void compute_single_step(uint32_t index, RvoAgent **agent);
+
+	int _create_polygons_bvh(PolygonBVH **p_bb, int p_from, int p_size, int p_depth, int &r_max_depth, int &r_max_alloc);
+	void _update_polygons_bvh();
+	template <class Q>
+	void _query_polygons_bvh(Q &r_query) const;
+	const gd::Polygon *_get_closest_polygon(const Vector3 &p_point, uint32_t p_layers, Vector3 &r_point) const;
+
 	void clip_path(const std::vector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly) const;
 };
 
@@ -122,6 +122,8 @@ struct NavigationPoly {
 	Vector3 entry;
 	/// The distance to the destination.
 	float traveled_distance = 0.0;
+	/// Position in the open list heap, -1 when not waiting to be visited.
+	int open_index = -1;
 
 	NavigationPoly(const Polygon *p_poly) :
 			poly(p_poly) {}
@@ -0,0 +1,367 @@
+/*************************************************************************/
+/*  test_nav_map.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NAV_MAP_H
+#define TEST_NAV_MAP_H
+
+#include "core/math/geometry_3d.h"
+#include "core/math/random_pcg.h"
+#include "core/templates/map.h"
+#include "modules/navigation/nav_map.h"
+#include "modules/navigation/nav_region.h"
+#include "scene/resources/navigation_mesh.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavMap {
+
+// A grid of quads on the XZ plane with bumpy heights, so the faces aren't coplanar.
+static Ref<NavigationMesh> create_grid_mesh(int p_size, real_t p_offset_x) {
+	Vector<Vector3> vertices;
+	for (int z = 0; z <= p_size; z++) {
+		for (int x = 0; x <= p_size; x++) {
+			const real_t height = Math::sin(real_t(x) * 1.3) * 0.5 + Math::cos(real_t(z) * 0.7) * 0.4;
+			vertices.push_back(Vector3(p_offset_x + x, height, z));
+		}
+	}
+
+	Ref<NavigationMesh> mesh;
+	mesh.instantiate();
+	mesh->set_vertices(vertices);
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			const int i = z * (p_size + 1) + x;
+			Vector<int> polygon;
+			polygon.push_back(i);
+			polygon.push_back(i + p_size + 1);
+			polygon.push_back(i + p_size + 2);
+			polygon.push_back(i + 1);
+			mesh->add_polygon(polygon);
+		}
+	}
+	return mesh;
+}
+
+// Two regions side by side, so the owner queries have more than one answer.
+struct TestMap {
+	NavMap map;
+	NavRegion regions[2];
+
+	TestMap() {
+		for (int i = 0; i < 2; i++) {
+			regions[i].set_self(RID::from_uint64(i + 1));
+			regions[i].set_mesh(create_grid_mesh(6, i * 6));
+			regions[i].set_map(&map);
+			map.add_region(&regions[i]);
+		}
+		map.sync();
+	}
+};
+
+// The same faces the map queries use, visited without the BVH.
+template <class F>
+static void for_each_face(const TestMap &p_map, F p_function) {
+	for (int r = 0; r < 2; r++) {
+		const std::vector<gd::Polygon> &polygons = p_map.regions[r].get_polygons();
+		for (size_t i = 0; i < polygons.size(); i++) {
+			const gd::Polygon &p = polygons[i];
+			for (size_t j = 2; j < p.points.size(); j++) {
+				p_function(Face3(p.points[j - 2].pos, p.points[j - 1].pos, p.points[j].pos), r);
+			}
+		}
+	}
+}
+
+static Vector3 random_point(RandomPCG &r_rng) {
+	return Vector3(r_rng.random(-3.0f, 15.0f), r_rng.random(-2.0f, 3.0f), r_rng.random(-3.0f, 9.0f));
+}
+
+TEST_CASE("[NavMap] Closest point matches a brute force search") {
+	TestMap test_map;
+	RandomPCG rng(1234);
+
+	for (int i = 0; i < 200; i++) {
+		const Vector3 point = random_point(rng);
+
+		real_t best_distance = 1e20;
+		for_each_face(test_map, [&](const Face3 &p_face, int p_region) {
+			best_distance = MIN(best_distance, p_face.get_closest_point_to(point).distance_to(point));
+		});
+
+		const Vector3 closest = test_map.map.get_closest_point(point);
+		CHECK(closest.distance_to(point) == doctest::Approx(best_distance).epsilon(0.0001));
+	}
+}
+
+TEST_CASE("[NavMap] Closest point normal and owner match a brute force search") {
+	TestMap test_map;
+	RandomPCG rng(5678);
+
+	int compared = 0;
+	for (int i = 0; i < 200; i++) {
+		const Vector3 point = random_point(rng);
+
+		real_t best_distance = 1e20;
+		Vector3 best_normal;
+		int best_region = -1;
+		for_each_face(test_map, [&](const Face3 &p_face, int p_region) {
+			const real_t d = p_face.get_closest_point_to(point).distance_to(point);
+			if (d < best_distance) {
+				best_distance = d;
+				best_normal = p_face.get_plane().normal;
+				best_region = p_region;
+			}
+		});
+
+		// Points closest to an edge or vertex shared by several faces have
+		// more than one right answer, only compare the unambiguous ones.
+		bool ambiguous = false;
+		for_each_face(test_map, [&](const Face3 &p_face, int p_region) {
+			const real_t d = p_face.get_closest_point_to(point).distance_to(point);
+			if (d < best_distance + 0.0001 && (p_region != best_region || !p_face.get_plane().normal.is_equal_approx(best_normal))) {
+				ambiguous = true;
+			}
+		});
+		if (ambiguous) {
+			continue;
+		}
+
+		compared++;
+		CHECK(test_map.map.get_closest_point_normal(point).is_equal_approx(best_normal));
+		CHECK(test_map.map.get_closest_point_owner(point) == test_map.regions[best_region].get_self());
+	}
+	CHECK(compared > 0);
+}
+
+TEST_CASE("[NavMap] Closest point to segment matches a brute force search") {
+	TestMap test_map;
+	RandomPCG rng(9012);
+
+	int intersecting = 0;
+	for (int i = 0; i < 200; i++) {
+		const Vector3 from = random_point(rng);
+		const Vector3 to = random_point(rng);
+
+		// The intersection nearest to the segment start is preferred.
+		real_t intersection_distance = 1e20;
+		for_each_face(test_map, [&](const Face3 &p_face, int p_region) {
+			Vector3 inters;
+			if (p_face.intersects_segment(from, to, &inters)) {
+				intersection_distance = MIN(intersection_distance, from.distance_to(inters));
+			}
+		});
+
+		const Vector3 closest = test_map.map.get_closest_point_to_segment(from, to, false);
+		if (intersection_distance < 1e20) {
+			intersecting++;
+			CHECK(from.distance_to(closest) == doctest::Approx(intersection_distance).epsilon(0.0001));
+			continue;
+		}
+
+		// Otherwise the closest point on the polygon edges.
+		real_t edge_distance = 1e20;
+		for (int r = 0; r < 2; r++) {
+			const std::vector<gd::Polygon> &polygons = test_map.regions[r].get_polygons();
+			for (size_t j = 0; j < polygons.size(); j++) {
+				const gd::Polygon &p = polygons[j];
+				for (size_t k = 0; k < p.points.size(); k++) {
+					Vector3 a, b;
+					Geometry3D::get_closest_points_between_segments(from, to, p.points[k].pos, p.points[(k + 1) % p.points.size()].pos, a, b);
+					edge_distance = MIN(edge_distance, a.distance_to(b));
+				}
+			}
+		}
+
+		const Vector3 segment[2] = { from, to };
+		const real_t distance = Geometry3D::get_closest_point_to_segment(closest, segment).distance_to(closest);
+		CHECK(distance == doctest::Approx(edge_distance).epsilon(0.0001));
+	}
+
+	// Both branches must have been exercised.
+	CHECK(intersecting > 0);
+	CHECK(intersecting < 200);
+}
+
+// Unit quads on the XZ plane, one per cell, sharing the vertices of adjacent cells.
+static Ref<NavigationMesh> create_cells_mesh(const Vector<Vector2i> &p_cells) {
+	Vector<Vector3> vertices;
+	Map<Vector2i, int> vertex_ids;
+	Ref<NavigationMesh> mesh;
+	mesh.instantiate();
+
+	for (int i = 0; i < p_cells.size(); i++) {
+		const Vector2i corners[4] = { p_cells[i], p_cells[i] + Vector2i(0, 1), p_cells[i] + Vector2i(1, 1), p_cells[i] + Vector2i(1, 0) };
+		Vector<int> polygon;
+		for (int j = 0; j < 4; j++) {
+			if (!vertex_ids.has(corners[j])) {
+				vertex_ids[corners[j]] = vertices.size();
+				vertices.push_back(Vector3(corners[j].x, 0, corners[j].y));
+			}
+			polygon.push_back(vertex_ids[corners[j]]);
+		}
+		mesh->add_polygon(polygon);
+	}
+	mesh->set_vertices(vertices);
+	return mesh;
+}
+
+struct TestPathMap {
+	NavMap map;
+	NavRegion region;
+
+	TestPathMap(const Vector<Vector2i> &p_cells) {
+		region.set_mesh(create_cells_mesh(p_cells));
+		region.set_map(&map);
+		map.add_region(&region);
+		map.sync();
+	}
+};
+
+static void check_path(const Vector<Vector3> &p_path, const Vector<Vector3> &p_expected) {
+	REQUIRE(p_path.size() == p_expected.size());
+	for (int i = 0; i < p_path.size(); i++) {
+		CHECK(p_path[i].is_equal_approx(p_expected[i]));
+	}
+}
+
+static real_t get_path_length(const Vector<Vector3> &p_path) {
+	real_t length = 0.0;
+	for (int i = 1; i < p_path.size(); i++) {
+		length += p_path[i - 1].distance_to(p_path[i]);
+	}
+	return length;
+}
+
+TEST_CASE("[NavMap] Path along a corridor") {
+	Vector<Vector2i> cells;
+	for (int i = 0; i < 4; i++) {
+		cells.push_back(Vector2i(i, 0));
+	}
+	TestPathMap test_map(cells);
+
+	const Vector3 begin(0.5, 0, 0.5);
+	const Vector3 end(3.5, 0, 0.5);
+
+	// Without optimization, the path enters every polygon at the point of
+	// the shared edge closest to the previous entry.
+	Vector<Vector3> expected;
+	expected.push_back(begin);
+	expected.push_back(Vector3(1, 0, 0.5));
+	expected.push_back(Vector3(2, 0, 0.5));
+	expected.push_back(Vector3(3, 0, 0.5));
+	expected.push_back(end);
+	check_path(test_map.map.get_path(begin, end, false), expected);
+
+	expected.clear();
+	expected.push_back(begin);
+	expected.push_back(end);
+	check_path(test_map.map.get_path(begin, end, true), expected);
+}
+
+TEST_CASE("[NavMap] Path around a corner") {
+	Vector<Vector2i> cells;
+	cells.push_back(Vector2i(0, 0));
+	cells.push_back(Vector2i(1, 0));
+	cells.push_back(Vector2i(1, 1));
+	TestPathMap test_map(cells);
+
+	const Vector3 begin(0.5, 0, 0.5);
+	const Vector3 end(1.5, 0, 1.8);
+	const Vector3 corner(1, 0, 1);
+
+	Vector<Vector3> expected;
+	expected.push_back(begin);
+	expected.push_back(Vector3(1, 0, 0.5));
+	expected.push_back(corner);
+	expected.push_back(end);
+	check_path(test_map.map.get_path(begin, end, false), expected);
+
+	// The straight line leaves the mesh, so the shortest path bends at the
+	// inner corner.
+	const Vector<Vector3> path = test_map.map.get_path(begin, end, true);
+	REQUIRE(path.size() >= 3);
+	CHECK(path[0].is_equal_approx(begin));
+	CHECK(path[path.size() - 1].is_equal_approx(end));
+	CHECK(get_path_length(path) == doctest::Approx(begin.distance_to(corner) + corner.distance_to(end)));
+}
+
+TEST_CASE("[NavMap] Path to an unreachable destination ends at the closest reachable point") {
+	Vector<Vector2i> cells;
+	cells.push_back(Vector2i(0, 0));
+	cells.push_back(Vector2i(1, 0));
+	cells.push_back(Vector2i(4, 0));
+	TestPathMap test_map(cells);
+
+	Vector<Vector3> expected;
+	expected.push_back(Vector3(0.5, 0, 0.5));
+	expected.push_back(Vector3(1, 0, 0.5));
+	expected.push_back(Vector3(2, 0, 0.5));
+	check_path(test_map.map.get_path(Vector3(0.5, 0, 0.5), Vector3(4.5, 0, 0.5), false), expected);
+}
+
+TEST_CASE("[NavMap] Repeated path queries give the same results") {
+	// A grid with a wall in the middle, open at the top.
+	Vector<Vector2i> cells;
+	for (int z = 0; z < 8; z++) {
+		for (int x = 0; x < 8; x++) {
+			if (x != 4 || z == 7) {
+				cells.push_back(Vector2i(x, z));
+			}
+		}
+	}
+	TestPathMap test_map(cells);
+
+	// The search memory is kept between the queries, so interleaving
+	// different queries must not change their results.
+	RandomPCG rng(3456);
+	Vector<Vector3> begins;
+	Vector<Vector3> ends;
+	Vector<Vector<Vector3>> paths;
+	for (int i = 0; i < 20; i++) {
+		begins.push_back(Vector3(rng.random(0.0f, 8.0f), 0, rng.random(0.0f, 8.0f)));
+		ends.push_back(Vector3(rng.random(0.0f, 8.0f), 0, rng.random(0.0f, 8.0f)));
+		paths.push_back(test_map.map.get_path(begins[i], ends[i], i % 2 == 0));
+	}
+
+	for (int i = 19; i >= 0; i--) {
+		const Vector<Vector3> path = test_map.map.get_path(begins[i], ends[i], i % 2 == 0);
+		check_path(path, paths[i]);
+
+		// Every destination is reachable, and no path is shorter than the
+		// straight line between its ends.
+		REQUIRE(path.size() >= 2);
+		CHECK(path[path.size() - 1].is_equal_approx(test_map.map.get_closest_point(ends[i])));
+		CHECK(get_path_length(path) >= path[0].distance_to(path[path.size() - 1]) - 0.001);
+	}
+}
+
+} // namespace TestNavMap
+
+#endif // TEST_NAV_MAP_H
@@ -0,0 +1,247 @@
+/*************************************************************************/
+/*  test_navigation_server.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NAVIGATION_SERVER_H
+#define TEST_NAVIGATION_SERVER_H
+
+#include "modules/navigation/godot_navigation_server.h"
+#include "scene/resources/navigation_mesh.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavigationServer {
+
+class PathsReceiver : public Object {
+public:
+	int calls = 0;
+	Array paths;
+
+	// Optionally submits another batch from the callback.
+	GodotNavigationServer *server = nullptr;
+	RID map;
+	PathsReceiver *resubmit_to = nullptr;
+
+	void _on_paths(const Array &p_paths) {
+		calls++;
+		paths = p_paths;
+		if (resubmit_to) {
+			Vector<Vector3> origins;
+			origins.push_back(Vector3(0.5, 0, 0.5));
+			Vector<Vector3> destinations;
+			destinations.push_back(Vector3(3.5, 0, 3.5));
+			server->map_get_paths_async(map, origins, destinations, true, Vector<int32_t>(), callable_mp(resubmit_to, &PathsReceiver::_on_paths));
+			resubmit_to = nullptr;
+		}
+	}
+};
+
+// A server with one active map made of a 4x4 grid of unit quads.
+struct TestServer {
+	GodotNavigationServer *server = nullptr;
+	RID map;
+	RID region;
+
+	TestServer() {
+		server = memnew(GodotNavigationServer);
+
+		Vector<Vector3> vertices;
+		for (int z = 0; z <= 4; z++) {
+			for (int x = 0; x <= 4; x++) {
+				vertices.push_back(Vector3(x, 0, z));
+			}
+		}
+		Ref<NavigationMesh> mesh;
+		mesh.instantiate();
+		mesh->set_vertices(vertices);
+		for (int z = 0; z < 4; z++) {
+			for (int x = 0; x < 4; x++) {
+				const int i = z * 5 + x;
+				Vector<int> polygon;
+				polygon.push_back(i);
+				polygon.push_back(i + 5);
+				polygon.push_back(i + 6);
+				polygon.push_back(i + 1);
+				mesh->add_polygon(polygon);
+			}
+		}
+
+		map = server->map_create();
+		server->map_set_active(map, true);
+		region = server->region_create();
+		server->region_set_map(region, map);
+		server->region_set_navmesh(region, mesh);
+		server->process(0.0);
+	}
+
+	~TestServer() {
+		server->free(region);
+		server->free(map);
+		server->process(0.0);
+		memdelete(server);
+	}
+};
+
+static void make_queries(int p_count, Vector<Vector3> &r_origins, Vector<Vector3> &r_destinations) {
+	for (int i = 0; i < p_count; i++) {
+		r_origins.push_back(Vector3(0.5 + (i % 4), 0, 0.5));
+		r_destinations.push_back(Vector3(3.5 - (i % 3), 0, 3.5 - (i % 4)));
+	}
+}
+
+TEST_CASE("[NavigationServer] Async path queries match the synchronous ones") {
+	TestServer test_server;
+	GodotNavigationServer *server = test_server.server;
+
+	Vector<Vector3> origins;
+	Vector<Vector3> destinations;
+	make_queries(37, origins, destinations);
+
+	PathsReceiver receiver;
+	server->map_get_paths_async(test_server.map, origins, destinations, true, Vector<int32_t>(), callable_mp(&receiver, &PathsReceiver::_on_paths));
+
+	// The results are only delivered by the next process.
+	CHECK(receiver.calls == 0);
+	server->process(0.0);
+	CHECK(receiver.calls == 1);
+
+	// One result per query, in the order of the queries.
+	REQUIRE(receiver.paths.size() == origins.size());
+	for (int i = 0; i < origins.size(); i++) {
+		const Vector<Vector3> path = receiver.paths[i];
+		const Vector<Vector3> expected = server->map_get_path(test_server.map, origins[i], destinations[i], true);
+		REQUIRE(path.size() == expected.size());
+		for (int j = 0; j < path.size(); j++) {
+			CHECK(path[j].is_equal_approx(expected[j]));
+		}
+	}
+
+	// Delivered only once.
+	server->process(0.0);
+	CHECK(receiver.calls == 1);
+}
+
+TEST_CASE("[NavigationServer] Every async batch gets its own callback") {
+	TestServer test_server;
+	GodotNavigationServer *server = test_server.server;
+
+	PathsReceiver receivers[3];
+	for (int i = 0; i < 3; i++) {
+		Vector<Vector3> origins;
+		Vector<Vector3> destinations;
+		make_queries(i * 5, origins, destinations);
+		server->map_get_paths_async(test_server.map, origins, destinations, false, Vector<int32_t>(), callable_mp(&receivers[i], &PathsReceiver::_on_paths));
+	}
+
+	server->process(0.0);
+	for (int i = 0; i < 3; i++) {
+		CHECK(receivers[i].calls == 1);
+		CHECK(receivers[i].paths.size() == i * 5);
+	}
+}
+
+TEST_CASE("[NavigationServer] Async path queries use their layers") {
+	TestServer test_server;
+	GodotNavigationServer *server = test_server.server;
+	server->region_set_layers(test_server.region, 2);
+	server->process(0.0);
+
+	Vector<Vector3> origins;
+	Vector<Vector3> destinations;
+	make_queries(4, origins, destinations);
+
+	// A single mask applies to every query.
+	Vector<int32_t> layers;
+	layers.push_back(2);
+	PathsReceiver single;
+	server->map_get_paths_async(test_server.map, origins, destinations, true, layers, callable_mp(&single, &PathsReceiver::_on_paths));
+
+	// Otherwise each query has its own.
+	layers.clear();
+	layers.push_back(1);
+	layers.push_back(2);
+	layers.push_back(1);
+	layers.push_back(2);
+	PathsReceiver each;
+	server->map_get_paths_async(test_server.map, origins, destinations, true, layers, callable_mp(&each, &PathsReceiver::_on_paths));
+
+	server->process(0.0);
+	REQUIRE(single.paths.size() == 4);
+	REQUIRE(each.paths.size() == 4);
+	for (int i = 0; i < 4; i++) {
+		CHECK(Vector<Vector3>(single.paths[i]).size() >= 2);
+		CHECK(Vector<Vector3>(each.paths[i]).is_empty() == (i % 2 == 0));
+	}
+}
+
+TEST_CASE("[NavigationServer] Async path queries made during process wait for the next one") {
+	TestServer test_server;
+	GodotNavigationServer *server = test_server.server;
+
+	Vector<Vector3> origins;
+	Vector<Vector3> destinations;
+	make_queries(3, origins, destinations);
+
+	PathsReceiver late;
+	PathsReceiver first;
+	first.server = server;
+	first.map = test_server.map;
+	first.resubmit_to = &late;
+	server->map_get_paths_async(test_server.map, origins, destinations, true, Vector<int32_t>(), callable_mp(&first, &PathsReceiver::_on_paths));
+
+	server->process(0.0);
+	CHECK(first.calls == 1);
+	CHECK(late.calls == 0);
+
+	server->process(0.0);
+	CHECK(late.calls == 1);
+	CHECK(late.paths.size() == 1);
+}
+
+TEST_CASE("[NavigationServer] Async path queries with mismatched sizes are rejected") {
+	TestServer test_server;
+	GodotNavigationServer *server = test_server.server;
+
+	Vector<Vector3> origins;
+	Vector<Vector3> destinations;
+	make_queries(3, origins, destinations);
+	destinations.resize(2);
+
+	PathsReceiver receiver;
+	ERR_PRINT_OFF;
+	server->map_get_paths_async(test_server.map, origins, destinations, true, Vector<int32_t>(), callable_mp(&receiver, &PathsReceiver::_on_paths));
+	ERR_PRINT_ON;
+
+	server->process(0.0);
+	CHECK(receiver.calls == 0);
+}
+
+} // namespace TestNavigationServer
+
+#endif // TEST_NAVIGATION_SERVER_H
@@ -31,6 +31,7 @@
 #include "raycast_occlusion_cull.h"
 #include "core/config/project_settings.h"
 #include "core/templates/local_vector.h"
+#include "servers/rendering/rendering_server_globals.h"
 
 #ifdef __SSE2__
 #include <pmmintrin.h>
@@ -43,7 +44,12 @@ void RaycastOcclusionCull::RaycastHZBuffer::clear() {
 
 	camera_rays.clear();
 	camera_ray_masks.clear();
+	trace_packets.clear();
+	prev_depth.clear();
+	trace_tiles.clear();
+	stale_tiles.clear();
 	packs_size = Size2i();
+	has_history = false;
 }
 
 void RaycastOcclusionCull::RaycastHZBuffer::resize(const Size2i &p_size) {
@@ -62,6 +68,200 @@ void RaycastOcclusionCull::RaycastHZBuffer::resize(const Size2i &p_size) {
 	int ray_packets_count = packs_size.x * packs_size.y;
 	camera_rays.resize(ray_packets_count);
 	camera_ray_masks.resize(ray_packets_count * TILE_SIZE * TILE_SIZE);
+	trace_tiles.resize(ray_packets_count);
+	stale_tiles.resize(ray_packets_count);
+	memset(stale_tiles.ptr(), 0, ray_packets_count);
+	has_history = false;
+}
+
+void RaycastOcclusionCull::RaycastHZBuffer::_get_pixel_ray(const CameraMatrix &p_inv_cam_projection, const Transform3D &p_cam_transform, bool p_cam_orthogonal, int p_x, int p_y, Vector3 &r_origin, Vector3 &r_dir) const {
+	Size2i buffer_size = sizes[0];
+
+	float u = p_x / float(buffer_size.x - 1);
+	float v = p_y / float(buffer_size.y - 1);
+	u = u * 2.0f - 1.0f;
+	v = v * 2.0f - 1.0f;
+
+	Plane pixel_proj = Plane(u, v, -1.0, 1.0);
+	Plane pixel_view = p_inv_cam_projection.xform4(pixel_proj);
+	r_origin = p_cam_transform.xform(pixel_view.normal);
+
+	if (p_cam_orthogonal) {
+		r_dir = -p_cam_transform.basis.get_axis(2);
+	} else {
+		r_dir = (r_origin - p_cam_transform.origin).normalized();
+	}
+}
+
+void RaycastOcclusionCull::RaycastHZBuffer::_reproject_depth(const Transform3D &p_cam_transform, const CameraMatrix &p_cam_projection, float p_z_far) {
+	Size2i buffer_size = sizes[0];
+	int pixel_count = buffer_size.x * buffer_size.y;
+	float *depth = mips[0];
+
+	prev_depth.resize(pixel_count);
+	memcpy(prev_depth.ptr(), depth, pixel_count * sizeof(float));
+	for (int i = 0; i < pixel_count; i++) {
+		depth[i] = -1.0f; // No sample landed here yet.
+	}
+
+	CameraMatrix prev_inv_projection = prev_cam_projection.inverse();
+	Transform3D inv_cam_transform = p_cam_transform.affine_inverse();
+	bool orthogonal = prev_cam_orthogonal;
+	// Rays start on a plane parallel to the camera, depths are measured from it.
+	float origin_z = -p_cam_projection.inverse().xform4(Plane(0, 0, -1, 1)).normal.z;
+
+	for (int y = 0; y < buffer_size.y; y++) {
+		for (int x = 0; x < buffer_size.x; x++) {
+			float d = prev_depth[y * buffer_size.x + x];
+
+			Vector3 origin;
+			Vector3 dir;
+			_get_pixel_ray(prev_inv_projection, prev_cam_transform, orthogonal, x, y, origin, dir);
+
+			Vector3 view = inv_cam_transform.xform(origin + dir * d);
+			if (-view.z <= origin_z) {
+				continue;
+			}
+
+			Vector3 projected = p_cam_projection.xform(view);
+			int px = Math::round((projected.x * 0.5f + 0.5f) * (buffer_size.x - 1));
+			int py = Math::round((projected.y * 0.5f + 0.5f) * (buffer_size.y - 1));
+			if (px < 0 || py < 0 || px >= buffer_size.x || py >= buffer_size.y) {
+				continue;
+			}
+
+			float new_depth;
+			if (d >= prev_z_far) {
+				new_depth = p_z_far; // Nothing was hit, keep it that way.
+			} else if (orthogonal) {
+				new_depth = -view.z - origin_z;
+			} else {
+				new_depth = view.length() * (1.0f - origin_z / -view.z);
+			}
+
+			// Keep the farthest sample, reprojection must never occlude more than the actual scene.
+			float &dst = depth[py * buffer_size.x + px];
+			dst = MAX(dst, MIN(new_depth, p_z_far));
+		}
+	}
+
+	// Single pixel gaps left by the scatter take their farthest neighbor, larger holes are disocclusions and need tracing.
+	for (int y = 0; y < buffer_size.y; y++) {
+		for (int x = 0; x < buffer_size.x; x++) {
+			float d = depth[y * buffer_size.x + x];
+			if (d < 0.0f) {
+				for (int ny = MAX(y - 1, 0); ny <= MIN(y + 1, buffer_size.y - 1); ny++) {
+					for (int nx = MAX(x - 1, 0); nx <= MIN(x + 1, buffer_size.x - 1); nx++) {
+						d = MAX(d, depth[ny * buffer_size.x + nx]);
+					}
+				}
+				if (d < 0.0f) {
+					trace_tiles[(y / TILE_SIZE) * packs_size.x + x / TILE_SIZE] = 1;
+				}
+			}
+			prev_depth[y * buffer_size.x + x] = d;
+		}
+	}
+
+	memcpy(depth, prev_depth.ptr(), pixel_count * sizeof(float));
+}
+
+bool RaycastOcclusionCull::RaycastHZBuffer::_mark_bounds(const AABB &p_bounds, const Transform3D &p_inv_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, float p_origin_z) {
+	Size2i buffer_size = sizes[0];
+	Vector2 rect_min = Vector2(FLT_MAX, FLT_MAX);
+	Vector2 rect_max = Vector2(-FLT_MAX, -FLT_MAX);
+	int behind = 0;
+
+	for (int i = 0; i < 8; i++) {
+		Vector3 view = p_inv_cam_transform.xform(p_bounds.get_endpoint(i));
+		if (!p_cam_orthogonal && -view.z <= p_origin_z) {
+			behind++;
+			continue;
+		}
+		Vector3 projected = p_cam_projection.xform(view);
+		rect_min = rect_min.min(Vector2(projected.x, projected.y));
+		rect_max = rect_max.max(Vector2(projected.x, projected.y));
+	}
+
+	if (behind == 8) {
+		return true;
+	} else if (behind > 0) {
+		return false; // Crosses the camera plane, can't be bounded on screen.
+	}
+
+	// Pad by a pixel, reprojected samples are only accurate to the pixel they landed on.
+	int min_x = Math::floor((rect_min.x * 0.5f + 0.5f) * (buffer_size.x - 1)) - 1;
+	int min_y = Math::floor((rect_min.y * 0.5f + 0.5f) * (buffer_size.y - 1)) - 1;
+	int max_x = Math::ceil((rect_max.x * 0.5f + 0.5f) * (buffer_size.x - 1)) + 1;
+	int max_y = Math::ceil((rect_max.y * 0.5f + 0.5f) * (buffer_size.y - 1)) + 1;
+
+	if (max_x < 0 || max_y < 0 || min_x >= buffer_size.x || min_y >= buffer_size.y) {
+		return true;
+	}
+
+	min_x = MAX(min_x, 0) / TILE_SIZE;
+	min_y = MAX(min_y, 0) / TILE_SIZE;
+	max_x = MIN(max_x, buffer_size.x - 1) / TILE_SIZE;
+	max_y = MIN(max_y, buffer_size.y - 1) / TILE_SIZE;
+
+	for (int y = min_y; y <= max_y; y++) {
+		for (int x = min_x; x <= max_x; x++) {
+			trace_tiles[y * packs_size.x + x] = 1;
+		}
+	}
+	return true;
+}
+
+void RaycastOcclusionCull::RaycastHZBuffer::select_packets(const Transform3D &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, const LocalVector<AABB> *p_changed_bounds) {
+	Size2i buffer_size = sizes[0];
+	uint32_t packet_count = camera_rays.size();
+	float z_far = p_cam_projection.get_z_far() * 1.05f;
+
+	bool full = p_changed_bounds == nullptr || !has_history || p_cam_orthogonal != prev_cam_orthogonal;
+	bool moved = false;
+
+	if (!full) {
+		memset(trace_tiles.ptr(), 0, packet_count);
+
+		moved = p_cam_transform != prev_cam_transform || p_cam_projection != prev_cam_projection;
+		if (moved) {
+			_reproject_depth(p_cam_transform, p_cam_projection, z_far);
+		}
+
+		Transform3D inv_cam_transform = p_cam_transform.affine_inverse();
+		float origin_z = -p_cam_projection.inverse().xform4(Plane(0, 0, -1, 1)).normal.z;
+		for (uint32_t i = 0; i < p_changed_bounds->size() && !full; i++) {
+			full = !_mark_bounds((*p_changed_bounds)[i], inv_cam_transform, p_cam_projection, p_cam_orthogonal, origin_z);
+		}
+	}
+
+	trace_packets.clear();
+	trace_ray_count = 0;
+
+	for (uint32_t i = 0; i < packet_count; i++) {
+		bool trace = full || trace_tiles[i] || (stale_tiles[i] && i % REFRESH_FRAMES == refresh_frame);
+		if (!trace) {
+			if (moved) {
+				stale_tiles[i] = 1;
+			}
+			continue;
+		}
+
+		stale_tiles[i] = 0;
+		trace_packets.push_back(i);
+
+		int tile_x = (i % packs_size.x) * TILE_SIZE;
+		int tile_y = (i / packs_size.x) * TILE_SIZE;
+		trace_ray_count += MIN(TILE_SIZE, buffer_size.x - tile_x) * MIN(TILE_SIZE, buffer_size.y - tile_y);
+	}
+
+	refresh_frame = (refresh_frame + 1) % REFRESH_FRAMES;
+
+	prev_cam_transform = p_cam_transform;
+	prev_cam_projection = p_cam_projection;
+	prev_cam_orthogonal = p_cam_orthogonal;
+	prev_z_far = z_far;
+	has_history = true;
 }
 
 void RaycastOcclusionCull::RaycastHZBuffer::update_camera_rays(const Transform3D &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, ThreadWorkPool &p_thread_work_pool) {
@@ -75,7 +275,7 @@ void RaycastOcclusionCull::RaycastHZBuffer::update_camera_rays(const Transform3D
 }
 
 void RaycastOcclusionCull::RaycastHZBuffer::_camera_rays_threaded(uint32_t p_thread, RaycastOcclusionCull::RaycastHZBuffer::CameraRayThreadData *p_data) {
-	uint32_t packs_total = camera_rays.size();
+	uint32_t packs_total = trace_packets.size();
 	uint32_t total_threads = p_data->thread_count;
 	uint32_t from = p_thread * packs_total / total_threads;
 	uint32_t to = (p_thread + 1 == total_threads) ? packs_total : ((p_thread + 1) * packs_total / total_threads);
@@ -92,35 +292,24 @@ void RaycastOcclusionCull::RaycastHZBuffer::_generate_camera_rays(const Transfor
 	RayPacket *ray_packets = camera_rays.ptr();
 	uint32_t *ray_masks = camera_ray_masks.ptr();
 
-	for (int i = p_from; i < p_to; i++) {
+	for (int p = p_from; p < p_to; p++) {
+		int i = trace_packets[p];
 		RayPacket &packet = ray_packets[i];
 		int tile_x = (i % packs_size.x) * TILE_SIZE;
 		int tile_y = (i / packs_size.x) * TILE_SIZE;
 
 		for (int j = 0; j < TILE_RAYS; j++) {
-			float x = tile_x + j % TILE_SIZE;
-			float y = tile_y + j / TILE_SIZE;
+			int x = tile_x + j % TILE_SIZE;
+			int y = tile_y + j / TILE_SIZE;
 
 			ray_masks[i * TILE_RAYS + j] = ~0U;
 
 			if (x >= buffer_size.x || y >= buffer_size.y) {
 				ray_masks[i * TILE_RAYS + j] = 0U;
 			} else {
-				float u = x / (buffer_size.x - 1);
-				float v = y / (buffer_size.y - 1);
-				u = u * 2.0f - 1.0f;
-				v = v * 2.0f - 1.0f;
-
-				Plane pixel_proj = Plane(u, v, -1.0, 1.0);
-				Plane pixel_view = inv_camera_matrix.xform4(pixel_proj);
-				Vector3 pixel_world = p_cam_transform.xform(pixel_view.normal);
-
+				Vector3 pixel_world;
 				Vector3 dir;
-				if (p_cam_orthogonal) {
-					dir = -p_cam_transform.basis.get_axis(2);
-				} else {
-					dir = (pixel_world - p_cam_transform.origin).normalized();
-				}
+				_get_pixel_ray(inv_camera_matrix, p_cam_transform, p_cam_orthogonal, x, y, pixel_world, dir);
 
 				packet.ray.org_x[j] = pixel_world.x;
 				packet.ray.org_y[j] = pixel_world.y;
@@ -150,19 +339,19 @@ void RaycastOcclusionCull::RaycastHZBuffer::sort_rays() {
 	}
 
 	Size2i buffer_size = sizes[0];
-	for (int i = 0; i < packs_size.y; i++) {
-		for (int j = 0; j < packs_size.x; j++) {
-			for (int tile_i = 0; tile_i < TILE_SIZE; tile_i++) {
-				for (int tile_j = 0; tile_j < TILE_SIZE; tile_j++) {
-					int x = j * TILE_SIZE + tile_j;
-					int y = i * TILE_SIZE + tile_i;
-					if (x >= buffer_size.x || y >= buffer_size.y) {
-						continue;
-					}
-					int k = tile_i * TILE_SIZE + tile_j;
-					int packet_index = i * packs_size.x + j;
-					mips[0][y * buffer_size.x + x] = camera_rays[packet_index].ray.tfar[k];
+	for (uint32_t p = 0; p < trace_packets.size(); p++) {
+		int packet_index = trace_packets[p];
+		int i = packet_index / packs_size.x;
+		int j = packet_index % packs_size.x;
+		for (int tile_i = 0; tile_i < TILE_SIZE; tile_i++) {
+			for (int tile_j = 0; tile_j < TILE_SIZE; tile_j++) {
+				int x = j * TILE_SIZE + tile_j;
+				int y = i * TILE_SIZE + tile_i;
+				if (x >= buffer_size.x || y >= buffer_size.y) {
+					continue;
 				}
+				int k = tile_i * TILE_SIZE + tile_j;
+				mips[0][y * buffer_size.x + x] = camera_rays[packet_index].ray.tfar[k];
 			}
 		}
 	}
@@ -267,6 +456,9 @@ void RaycastOcclusionCull::scenario_set_instance(RID p_scenario, RID p_instance,
 
 	if (instance.enabled != p_enabled) {
 		instance.enabled = p_enabled;
+		if (!instance.xformed_vertices.is_empty()) {
+			scenario.pending_bounds.push_back(instance.bounds);
+		}
 		scenario.dirty = true; // The scenario needs a scene re-build, but the instance doesn't need update
 	}
 
@@ -333,6 +525,15 @@ void RaycastOcclusionCull::Scenario::_update_dirty_instance(int p_idx, RID *p_in
 		_transform_vertices_range(read_ptr, write_ptr, occ_inst->xform, 0, vertices_size);
 	}
 
+	occ_inst->bounds = AABB();
+	for (int i = 0; i < vertices_size; i++) {
+		if (i == 0) {
+			occ_inst->bounds.position = write_ptr[i];
+		} else {
+			occ_inst->bounds.expand_to(write_ptr[i]);
+		}
+	}
+
 	occ_inst->indices.resize(occ->indices.size());
 	memcpy(occ_inst->indices.ptr(), occ->indices.ptr(), occ->indices.size() * sizeof(int32_t));
 }
@@ -369,6 +570,9 @@ bool RaycastOcclusionCull::Scenario::update(ThreadWorkPool &p_thread_pool) {
 		if (commit_done) {
 			commit_thread->wait_to_finish();
 			current_scene_idx = 1 - current_scene_idx;
+			changed_bounds = commit_bounds;
+			commit_bounds.clear();
+			scene_version++;
 		} else {
 			return false;
 		}
@@ -389,9 +593,20 @@ bool RaycastOcclusionCull::Scenario::update(ThreadWorkPool &p_thread_pool) {
 	}
 
 	for (unsigned int i = 0; i < removed_instances.size(); i++) {
+		const OccluderInstance *occ_inst = instances.getptr(removed_instances[i]);
+		if (occ_inst && !occ_inst->xformed_vertices.is_empty()) {
+			pending_bounds.push_back(occ_inst->bounds);
+		}
 		instances.erase(removed_instances[i]);
 	}
 
+	for (unsigned int i = 0; i < dirty_instances_array.size(); i++) {
+		const OccluderInstance *occ_inst = instances.getptr(dirty_instances_array[i]);
+		if (occ_inst && !occ_inst->xformed_vertices.is_empty()) {
+			pending_bounds.push_back(occ_inst->bounds);
+		}
+	}
+
 	if (dirty_instances_array.size() / p_thread_pool.get_thread_count() > 128) {
 		// Lots of instances, use per-instance threading
 		p_thread_pool.do_work(dirty_instances_array.size(), this, &Scenario::_update_dirty_instance_thread, dirty_instances_array.ptr());
@@ -402,6 +617,13 @@ bool RaycastOcclusionCull::Scenario::update(ThreadWorkPool &p_thread_pool) {
 		}
 	}
 
+	for (unsigned int i = 0; i < dirty_instances_array.size(); i++) {
+		const OccluderInstance *occ_inst = instances.getptr(dirty_instances_array[i]);
+		if (occ_inst && !occ_inst->xformed_vertices.is_empty()) {
+			pending_bounds.push_back(occ_inst->bounds);
+		}
+	}
+
 	dirty_instances.clear();
 	dirty_instances_array.clear();
 	removed_instances.clear();
@@ -437,6 +659,9 @@ bool RaycastOcclusionCull::Scenario::update(ThreadWorkPool &p_thread_pool) {
 		rtcReleaseGeometry(geom);
 	}
 
+	commit_bounds = pending_bounds;
+	pending_bounds.clear();
+
 	dirty = false;
 	commit_done = false;
 	commit_thread->start(&Scenario::_commit_scene, this);
@@ -448,24 +673,27 @@ void RaycastOcclusionCull::Scenario::_raycast(uint32_t p_idx, const RaycastThrea
 	rtcInitIntersectContext(&ctx);
 	ctx.flags = RTC_INTERSECT_CONTEXT_FLAG_COHERENT;
 
-	rtcIntersect16((const int *)&p_raycast_data->masks[p_idx * TILE_RAYS], ebr_scene[current_scene_idx], &ctx, &p_raycast_data->rays[p_idx]);
+	uint32_t packet = p_raycast_data->packets[p_idx];
+	rtcIntersect16((const int *)&p_raycast_data->masks[packet * TILE_RAYS], ebr_scene[current_scene_idx], &ctx, &p_raycast_data->rays[packet]);
 }
 
-void RaycastOcclusionCull::Scenario::raycast(LocalVector<RayPacket> &r_rays, const LocalVector<uint32_t> p_valid_masks, ThreadWorkPool &p_thread_pool) const {
-	ERR_FAIL_COND(singleton == nullptr);
+bool RaycastOcclusionCull::Scenario::raycast(LocalVector<RayPacket> &r_rays, const LocalVector<uint32_t> &p_valid_masks, const LocalVector<uint32_t> &p_packets, ThreadWorkPool &p_thread_pool) const {
+	ERR_FAIL_COND_V(singleton == nullptr, false);
 	if (raycast_singleton->ebr_device == nullptr) {
-		return; // Embree is initialized on demand when there is some scenario with occluders in it.
+		return false; // Embree is initialized on demand when there is some scenario with occluders in it.
 	}
 
 	if (ebr_scene[current_scene_idx] == nullptr) {
-		return;
+		return false;
 	}
 
 	RaycastThreadData td;
 	td.rays = r_rays.ptr();
 	td.masks = p_valid_masks.ptr();
+	td.packets = p_packets.ptr();
 
-	p_thread_pool.do_work(r_rays.size(), this, &Scenario::_raycast, &td);
+	p_thread_pool.do_work(p_packets.size(), this, &Scenario::_raycast, &td);
+	return true;
 }
 
 ////////////////////////////////////////////////////////
@@ -484,6 +712,7 @@ void RaycastOcclusionCull::buffer_set_scenario(RID p_buffer, RID p_scenario) {
 	ERR_FAIL_COND(!buffers.has(p_buffer));
 	ERR_FAIL_COND(p_scenario.is_valid() && !scenarios.has(p_scenario));
 	buffers[p_buffer].scenario_rid = p_scenario;
+	buffers[p_buffer].invalidate_history();
 }
 
 void RaycastOcclusionCull::buffer_set_size(RID p_buffer, const Vector2i &p_size) {
@@ -511,10 +740,32 @@ void RaycastOcclusionCull::buffer_update(RID p_buffer, const Transform3D &p_cam_
 		return;
 	}
 
-	buffer.update_camera_rays(p_cam_transform, p_cam_projection, p_cam_orthogonal, p_thread_pool);
+	// Only the changes of the scene that just became current can be applied, otherwise start over.
+	const LocalVector<AABB> *changed_bounds = nullptr;
+	if (temporal_reprojection && buffer.scene_version == scenario.scene_version) {
+		static const LocalVector<AABB> no_changes;
+		changed_bounds = &no_changes;
+	} else if (temporal_reprojection && buffer.scene_version + 1 == scenario.scene_version) {
+		changed_bounds = &scenario.changed_bounds;
+	}
+	buffer.scene_version = scenario.scene_version;
+
+	buffer.select_packets(p_cam_transform, p_cam_projection, p_cam_orthogonal, changed_bounds);
+
+	uint64_t frame = RSG::rasterizer->get_frame_number();
+	if (info.frame != frame) {
+		info.frame = frame;
+		info.rays_in_frame = 0;
+	}
 
-	scenario.raycast(buffer.camera_rays, buffer.camera_ray_masks, p_thread_pool);
-	buffer.sort_rays();
+	if (!buffer.trace_packets.is_empty()) {
+		buffer.update_camera_rays(p_cam_transform, p_cam_projection, p_cam_orthogonal, p_thread_pool);
+
+		if (scenario.raycast(buffer.camera_rays, buffer.camera_ray_masks, buffer.trace_packets, p_thread_pool)) {
+			info.rays_in_frame += buffer.trace_ray_count;
+		}
+		buffer.sort_rays();
+	}
 	buffer.update_mips();
 }
 
@@ -545,6 +796,13 @@ void RaycastOcclusionCull::set_build_quality(RS::ViewportOcclusionCullingBuildQu
 	}
 }
 
+uint64_t RaycastOcclusionCull::get_rendering_info(RS::RenderingInfo p_info) {
+	if (p_info == RS::RENDERING_INFO_OCCLUSION_RAYS_IN_FRAME) {
+		return info.rays_in_frame;
+	}
+	return 0;
+}
+
 void RaycastOcclusionCull::_init_embree() {
 #ifdef __SSE2__
 	_MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
@@ -559,6 +817,7 @@ RaycastOcclusionCull::RaycastOcclusionCull() {
 	raycast_singleton = this;
 	int default_quality = GLOBAL_GET("rendering/occlusion_culling/bvh_build_quality");
 	build_quality = RS::ViewportOcclusionCullingBuildQuality(default_quality);
+	temporal_reprojection = GLOBAL_GET("rendering/occlusion_culling/temporal_reprojection");
 }
 
 RaycastOcclusionCull::~RaycastOcclusionCull() {
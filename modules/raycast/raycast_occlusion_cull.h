@@ -58,16 +58,37 @@ public:
 			Size2i buffer_size;
 		};
 
+		// Last frame's camera, its depth is reprojected so only the tiles that can't be reused are traced again.
+		Transform3D prev_cam_transform;
+		CameraMatrix prev_cam_projection;
+		bool prev_cam_orthogonal = false;
+		float prev_z_far = 0.0f;
+		bool has_history = false;
+		uint32_t refresh_frame = 0;
+
+		LocalVector<float> prev_depth;
+		LocalVector<uint8_t> trace_tiles;
+		LocalVector<uint8_t> stale_tiles; // Reprojected since last traced, refreshed over time to avoid drifting.
+
+		_FORCE_INLINE_ void _get_pixel_ray(const CameraMatrix &p_inv_cam_projection, const Transform3D &p_cam_transform, bool p_cam_orthogonal, int p_x, int p_y, Vector3 &r_origin, Vector3 &r_dir) const;
+		void _reproject_depth(const Transform3D &p_cam_transform, const CameraMatrix &p_cam_projection, float p_z_far);
+		bool _mark_bounds(const AABB &p_bounds, const Transform3D &p_inv_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, float p_origin_z);
+
 		void _camera_rays_threaded(uint32_t p_thread, CameraRayThreadData *p_data);
 		void _generate_camera_rays(const Transform3D &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, int p_from, int p_to);
 
 	public:
 		LocalVector<RayPacket> camera_rays;
 		LocalVector<uint32_t> camera_ray_masks;
+		LocalVector<uint32_t> trace_packets;
+		uint32_t trace_ray_count = 0;
+		uint64_t scene_version = 0;
 		RID scenario_rid;
 
 		virtual void clear() override;
 		virtual void resize(const Size2i &p_size) override;
+		void invalidate_history() { has_history = false; }
+		void select_packets(const Transform3D &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, const LocalVector<AABB> *p_changed_bounds);
 		void sort_rays();
 		void update_camera_rays(const Transform3D &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, ThreadWorkPool &p_thread_work_pool);
 	};
@@ -100,6 +121,7 @@ private:
 		LocalVector<uint32_t> indices;
 		LocalVector<Vector3> xformed_vertices;
 		Transform3D xform;
+		AABB bounds;
 		bool enabled = true;
 		bool removed = false;
 	};
@@ -108,6 +130,7 @@ private:
 		struct RaycastThreadData {
 			RayPacket *rays;
 			const uint32_t *masks;
+			const uint32_t *packets;
 		};
 
 		struct TransformThreadData {
@@ -131,6 +154,12 @@ private:
 		LocalVector<RID> dirty_instances_array; // To iterate and split into threads
 		LocalVector<RID> removed_instances;
 
+		// Bounds of the occluders that changed, so buffers only re-trace the tiles they cover.
+		uint64_t scene_version = 0;
+		LocalVector<AABB> pending_bounds;
+		LocalVector<AABB> commit_bounds;
+		LocalVector<AABB> changed_bounds;
+
 		void _update_dirty_instance_thread(int p_idx, RID *p_instances);
 		void _update_dirty_instance(int p_idx, RID *p_instances, ThreadWorkPool *p_thread_pool);
 		void _transform_vertices_thread(uint32_t p_thread, TransformThreadData *p_data);
@@ -139,19 +168,26 @@ private:
 		bool update(ThreadWorkPool &p_thread_pool);
 
 		void _raycast(uint32_t p_thread, const RaycastThreadData *p_raycast_data) const;
-		void raycast(LocalVector<RayPacket> &r_rays, const LocalVector<uint32_t> p_valid_masks, ThreadWorkPool &p_thread_pool) const;
+		bool raycast(LocalVector<RayPacket> &r_rays, const LocalVector<uint32_t> &p_valid_masks, const LocalVector<uint32_t> &p_packets, ThreadWorkPool &p_thread_pool) const;
 	};
 
 	static RaycastOcclusionCull *raycast_singleton;
 
 	static const int TILE_SIZE = 4;
 	static const int TILE_RAYS = TILE_SIZE * TILE_SIZE;
+	static const int REFRESH_FRAMES = 8;
 
 	RTCDevice ebr_device = nullptr;
 	RID_PtrOwner<Occluder> occluder_owner;
 	HashMap<RID, Scenario> scenarios;
 	HashMap<RID, RaycastHZBuffer> buffers;
 	RS::ViewportOcclusionCullingBuildQuality build_quality;
+	bool temporal_reprojection = true;
+
+	struct Info {
+		uint64_t frame = 0;
+		uint64_t rays_in_frame = 0;
+	} info;
 
 	void _init_embree();
 
@@ -176,6 +212,7 @@ public:
 	virtual RID buffer_get_debug_texture(RID p_buffer) override;
 
 	virtual void set_build_quality(RS::ViewportOcclusionCullingBuildQuality p_quality) override;
+	virtual uint64_t get_rendering_info(RS::RenderingInfo p_info) override;
 
 	RaycastOcclusionCull();
 	~RaycastOcclusionCull();
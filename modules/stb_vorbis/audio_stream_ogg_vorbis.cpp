@@ -61,10 +61,11 @@ int AudioStreamPlaybackOGGVorbis::_mix_internal(AudioFrame *p_buffer, int p_fram
 			bool is_not_empty = mixed > 0 || stb_vorbis_stream_length_in_samples(ogg_stream) > 0;
 			if (vorbis_stream->loop && is_not_empty) {
 				//loop
-				seek(vorbis_stream->loop_offset);
+				_seek(vorbis_stream->loop_offset);
 				loops++;
 				// we still have buffer to fill, start from this element in the next iteration.
 				start_buffer = p_frames - todo;
+				_mark_position(float(frames_mixed) / vorbis_stream->sample_rate, start_buffer);
 			} else {
 				frames_mixed_this_step = p_frames - todo;
 				for (int i = p_frames - todo; i < p_frames; i++) {
@@ -83,14 +84,18 @@ float AudioStreamPlaybackOGGVorbis::get_stream_sampling_rate() {
 }
 
 void AudioStreamPlaybackOGGVorbis::start(float p_from_pos) {
+	_finish_predecode();
 	active = true;
-	seek(p_from_pos);
+	_seek(p_from_pos);
+	_mark_position(float(frames_mixed) / vorbis_stream->sample_rate);
 	loops = 0;
 	_begin_resample();
 }
 
 void AudioStreamPlaybackOGGVorbis::stop() {
+	MutexLock lock(decoder_mutex);
 	active = false;
+	_discard_predecoded();
 }
 
 bool AudioStreamPlaybackOGGVorbis::is_playing() const {
@@ -102,10 +107,31 @@ int AudioStreamPlaybackOGGVorbis::get_loop_count() const {
 }
 
 float AudioStreamPlaybackOGGVorbis::get_playback_position() const {
-	return float(frames_mixed) / vorbis_stream->sample_rate;
+	// The decoder may be ahead of what was mixed.
+	return _get_mixed_position(float(frames_mixed) / vorbis_stream->sample_rate);
 }
 
 void AudioStreamPlaybackOGGVorbis::seek(float p_time) {
+	MutexLock lock(decoder_mutex);
+	_seek(p_time);
+	_discard_predecoded();
+	_mark_position(float(frames_mixed) / vorbis_stream->sample_rate);
+}
+
+float AudioStreamPlaybackOGGVorbis::get_length() const {
+	return vorbis_stream->get_length();
+}
+
+bool AudioStreamPlaybackOGGVorbis::get_loop_range(float &r_begin, float &r_end) const {
+	if (!vorbis_stream->loop) {
+		return false;
+	}
+	r_begin = vorbis_stream->loop_offset;
+	r_end = vorbis_stream->get_length();
+	return true;
+}
+
+void AudioStreamPlaybackOGGVorbis::_seek(float p_time) {
 	if (!active) {
 		return;
 	}
@@ -119,6 +145,8 @@ void AudioStreamPlaybackOGGVorbis::seek(float p_time) {
 }
 
 AudioStreamPlaybackOGGVorbis::~AudioStreamPlaybackOGGVorbis() {
+	_finish_predecode();
+
 	if (ogg_alloc.alloc_buffer) {
 		stb_vorbis_close(ogg_stream);
 		memfree(ogg_alloc.alloc_buffer);
@@ -47,6 +47,8 @@ class AudioStreamPlaybackOGGVorbis : public AudioStreamPlaybackResampled {
 	bool active = false;
 	int loops = 0;
 
+	void _seek(float p_time);
+
 	friend class AudioStreamOGGVorbis;
 
 	Ref<AudioStreamOGGVorbis> vorbis_stream;
@@ -54,6 +56,7 @@ class AudioStreamPlaybackOGGVorbis : public AudioStreamPlaybackResampled {
 protected:
 	virtual int _mix_internal(AudioFrame *p_buffer, int p_frames) override;
 	virtual float get_stream_sampling_rate() override;
+	virtual bool _can_predecode() const override { return true; }
 
 public:
 	virtual void start(float p_from_pos = 0.0) override;
@@ -65,6 +68,9 @@ public:
 	virtual float get_playback_position() const override;
 	virtual void seek(float p_time) override;
 
+	virtual float get_length() const override;
+	virtual bool get_loop_range(float &r_begin, float &r_end) const override;
+
 	AudioStreamPlaybackOGGVorbis() {}
 	~AudioStreamPlaybackOGGVorbis();
 };
@@ -967,7 +967,7 @@ _FORCE_INLINE_ TextServerAdvanced::FontGlyph TextServerAdvanced::rasterize_msdf(
 		td.distancePixelConversion = &distancePixelConversion;
 
 		if (p_font_data->work_pool.get_thread_count() == 0) {
-			p_font_data->work_pool.init();
+			p_font_data->work_pool.init(-1, WorkerThreadPool::PRIORITY_LOW);
 		}
 		p_font_data->work_pool.do_work(h, this, &TextServerAdvanced::_generateMTSDF_threaded, &td);
 
@@ -31,6 +31,7 @@
 #ifndef ANIMATION_PLAYER_H
 #define ANIMATION_PLAYER_H
 
+#include "core/templates/local_vector.h"
 #include "scene/2d/node_2d.h"
 #include "scene/3d/node_3d.h"
 #include "scene/3d/skeleton_3d.h"
@@ -168,6 +169,7 @@ private:
 		String name;
 		StringName next;
 		Vector<TrackNodeCache *> node_cache;
+		LocalVector<int> key_cursors; // Last key found per track, for Animation::transform_track_interpolate().
 		Ref<Animation> animation;
 	};
 
@@ -339,6 +339,7 @@ void Node::_move_child(Node *p_child, int p_pos, bool p_ignore_end) {
 
 	if (data.tree) {
 		data.tree->tree_changed();
+		data.tree->_process_order_changed();
 	}
 
 	data.blocked++;
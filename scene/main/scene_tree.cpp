@@ -124,24 +124,63 @@ void SceneTree::node_renamed(Node *p_node) {
 	emit_signal(node_renamed_name, p_node);
 }
 
+bool SceneTree::ProcessComparator::operator()(const Node *p_a, const Node *p_b) const {
+	return Node::ComparatorWithPriority()(p_a, p_b);
+}
+
 SceneTree::Group *SceneTree::add_to_group(const StringName &p_group, Node *p_node) {
 	Map<StringName, Group>::Element *E = group_map.find(p_group);
 	if (!E) {
 		E = group_map.insert(p_group, Group());
+		E->get().process = p_group == SNAME("process") || p_group == SNAME("process_internal") || p_group == SNAME("physics_process") || p_group == SNAME("physics_process_internal");
+	}
+
+	Group &g = E->get();
+
+	if (g.process) {
+		ObjectID id = p_node->get_instance_id();
+		ERR_FAIL_COND_V_MSG(g.process_elements.has(id), &g, "Already in group: " + p_group + ".");
+		if (g.process_lock > 0) {
+			g.process_added.push_back(p_node);
+			g.process_elements.set(id, nullptr);
+		} else {
+			g.process_elements.set(id, g.process_order.insert(p_node, false));
+		}
+		g.nodes_dirty = true;
+		return &g;
 	}
 
-	ERR_FAIL_COND_V_MSG(E->get().nodes.find(p_node) != -1, &E->get(), "Already in group: " + p_group + ".");
-	E->get().nodes.push_back(p_node);
+	ERR_FAIL_COND_V_MSG(g.nodes.find(p_node) != -1, &g, "Already in group: " + p_group + ".");
+	g.nodes.push_back(p_node);
 	//E->get().last_tree_version=0;
-	E->get().changed = true;
-	return &E->get();
+	g.changed = true;
+	return &g;
 }
 
 void SceneTree::remove_from_group(const StringName &p_group, Node *p_node) {
 	Map<StringName, Group>::Element *E = group_map.find(p_group);
 	ERR_FAIL_COND(!E);
 
-	E->get().nodes.erase(p_node);
+	Group &g = E->get();
+
+	if (g.process) {
+		ObjectID id = p_node->get_instance_id();
+		ProcessOrder::Element **P = g.process_elements.getptr(id);
+		ERR_FAIL_COND(!P);
+		if (*P == nullptr) {
+			g.process_added.erase(p_node); // Added during the current pass.
+		} else if (g.process_lock > 0) {
+			(*P)->get() = true;
+			g.process_removed.push_back(*P);
+		} else {
+			g.process_order.erase(*P);
+		}
+		g.process_elements.erase(id);
+		g.nodes_dirty = true;
+		return; // Process groups are walked every frame, so they are kept even when empty.
+	}
+
+	g.nodes.erase(p_node);
 	if (E->get().nodes.is_empty()) {
 		group_map.erase(E);
 	}
@@ -154,6 +193,15 @@ void SceneTree::make_group_changed(const StringName &p_group) {
 	}
 }
 
+void SceneTree::_process_order_changed() {
+	// Moving a node reorders its whole subtree, which may hold processing
+	// nodes from any group, so all of them have to be sorted again.
+	make_group_changed(SNAME("process"));
+	make_group_changed(SNAME("process_internal"));
+	make_group_changed(SNAME("physics_process"));
+	make_group_changed(SNAME("physics_process_internal"));
+}
+
 void SceneTree::flush_transform_notifications() {
 	SelfList<Node> *n = xform_change_list.first();
 	while (n) {
@@ -185,7 +233,60 @@ void SceneTree::_flush_ugc() {
 	ugc_locked = false;
 }
 
+void SceneTree::_update_process_order(Group &g) {
+	if (!g.changed || g.process_lock > 0) {
+		return;
+	}
+
+	// Process priority or tree order changed, insert everything again.
+	LocalVector<Node *> nodes;
+	nodes.reserve(g.process_order.size());
+	for (ProcessOrder::Element *P = g.process_order.front(); P; P = P->next()) {
+		nodes.push_back(P->key());
+	}
+
+	g.process_order.clear();
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		g.process_elements.set(nodes[i]->get_instance_id(), g.process_order.insert(nodes[i], false));
+	}
+
+	g.changed = false;
+	g.nodes_dirty = true;
+}
+
+void SceneTree::_flush_process_group(Group &g) {
+	for (uint32_t i = 0; i < g.process_removed.size(); i++) {
+		g.process_order.erase(g.process_removed[i]);
+	}
+	g.process_removed.clear();
+
+	for (uint32_t i = 0; i < g.process_added.size(); i++) {
+		Node *node = g.process_added[i];
+		g.process_elements.set(node->get_instance_id(), g.process_order.insert(node, false));
+	}
+	g.process_added.clear();
+}
+
 void SceneTree::_update_group_order(Group &g, bool p_use_priority) {
+	if (g.process) {
+		_update_process_order(g);
+		if (g.nodes_dirty) {
+			g.nodes.resize(g.process_elements.size());
+			Node **nodes = g.nodes.ptrw();
+			int idx = 0;
+			for (ProcessOrder::Element *P = g.process_order.front(); P; P = P->next()) {
+				if (!P->get()) {
+					nodes[idx++] = P->key();
+				}
+			}
+			for (uint32_t i = 0; i < g.process_added.size(); i++) {
+				nodes[idx++] = g.process_added[i];
+			}
+			g.nodes_dirty = false;
+		}
+		return;
+	}
+
 	if (!g.changed) {
 		return;
 	}
@@ -212,6 +313,9 @@ void SceneTree::call_group_flags(uint32_t p_call_flags, const StringName &p_grou
 		return;
 	}
 	Group &g = E->get();
+	if (g.process) {
+		_update_group_order(g);
+	}
 	if (g.nodes.is_empty()) {
 		return;
 	}
@@ -288,6 +392,9 @@ void SceneTree::notify_group_flags(uint32_t p_call_flags, const StringName &p_gr
 		return;
 	}
 	Group &g = E->get();
+	if (g.process) {
+		_update_group_order(g);
+	}
 	if (g.nodes.is_empty()) {
 		return;
 	}
@@ -339,6 +446,9 @@ void SceneTree::set_group_flags(uint32_t p_call_flags, const StringName &p_group
 		return;
 	}
 	Group &g = E->get();
+	if (g.process) {
+		_update_group_order(g);
+	}
 	if (g.nodes.is_empty()) {
 		return;
 	}
@@ -814,12 +924,58 @@ bool SceneTree::is_paused() const {
 	return paused;
 }
 
+void SceneTree::_notify_process_group(Group &g, int p_notification) {
+	_update_process_order(g);
+
+	if (g.process_order.is_empty()) {
+		return;
+	}
+
+	// Walked in place, changes made during the pass are applied once it ends.
+	call_lock++;
+	g.process_lock++;
+
+	for (ProcessOrder::Element *P = g.process_order.front(); P; P = P->next()) {
+		if (P->get()) {
+			continue; // Removed during this pass.
+		}
+
+		Node *n = P->key();
+		if (call_lock && call_skip.has(n)) {
+			continue;
+		}
+
+		if (!n->can_process()) {
+			continue;
+		}
+		if (!n->can_process_notification(p_notification)) {
+			continue;
+		}
+
+		n->notification(p_notification);
+	}
+
+	g.process_lock--;
+	if (g.process_lock == 0) {
+		_flush_process_group(g);
+	}
+
+	call_lock--;
+	if (call_lock == 0) {
+		call_skip.clear();
+	}
+}
+
 void SceneTree::_notify_group_pause(const StringName &p_group, int p_notification) {
 	Map<StringName, Group>::Element *E = group_map.find(p_group);
 	if (!E) {
 		return;
 	}
 	Group &g = E->get();
+	if (g.process) {
+		_notify_process_group(g, p_notification);
+		return;
+	}
 	if (g.nodes.is_empty()) {
 		return;
 	}
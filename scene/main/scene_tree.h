@@ -34,6 +34,8 @@
 #include "core/multiplayer/multiplayer_api.h"
 #include "core/os/main_loop.h"
 #include "core/os/thread_safe.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/self_list.h"
 #include "scene/resources/mesh.h"
 #include "scene/resources/world_2d.h"
@@ -83,9 +85,26 @@ public:
 	typedef void (*IdleCallback)();
 
 private:
+	struct ProcessComparator {
+		bool operator()(const Node *p_a, const Node *p_b) const;
+	};
+
+	// The value is set for nodes removed while the group is being processed.
+	typedef Map<Node *, bool, ProcessComparator> ProcessOrder;
+
 	struct Group {
 		Vector<Node *> nodes;
 		bool changed = false;
+
+		// Process groups keep their nodes sorted as they come and go, `nodes` is only rebuilt when requested.
+		// While a group is processed, removed nodes are left as tombstones and added ones wait for the pass to end.
+		bool process = false;
+		bool nodes_dirty = false;
+		int process_lock = 0;
+		ProcessOrder process_order;
+		HashMap<ObjectID, ProcessOrder::Element *> process_elements;
+		LocalVector<ProcessOrder::Element *> process_removed;
+		LocalVector<Node *> process_added;
 	};
 
 	Window *root = nullptr;
@@ -136,6 +155,10 @@ private:
 	void _flush_ugc();
 
 	_FORCE_INLINE_ void _update_group_order(Group &g, bool p_use_priority = false);
+	void _update_process_order(Group &g);
+	void _flush_process_group(Group &g);
+	void _notify_process_group(Group &g, int p_notification);
+	void _process_order_changed();
 	void _update_listener();
 
 	Array _get_nodes_in_group(const StringName &p_group);
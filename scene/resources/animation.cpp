@@ -30,6 +30,7 @@
 
 #include "animation.h"
 
+#include "core/io/marshalls.h"
 #include "core/math/geometry_3d.h"
 #include "scene/scene_string_names.h"
 
@@ -77,6 +78,55 @@ bool Animation::_set(const StringName &p_name, const Variant &p_value) {
 		} else if (what == "keys" || what == "key_values") {
 			if (track_get_type(track) == TYPE_TRANSFORM3D) {
 				TransformTrack *tt = static_cast<TransformTrack *>(tracks[track]);
+
+				if (p_value.get_type() == Variant::DICTIONARY) {
+					// Compressed keys, see _get().
+					Dictionary d = p_value;
+					ERR_FAIL_COND_V(!d.has("pages"), false);
+					ERR_FAIL_COND_V(!d.has("keys"), false);
+
+					Vector<real_t> pages = d["pages"];
+					Vector<uint8_t> keys = d["keys"];
+					ERR_FAIL_COND_V(pages.size() % COMPRESSED_PAGE_SIZE, false);
+					ERR_FAIL_COND_V(keys.size() % COMPRESSED_KEY_SIZE, false);
+
+					int page_count = pages.size() / COMPRESSED_PAGE_SIZE;
+					int key_count = keys.size() / COMPRESSED_KEY_SIZE;
+					ERR_FAIL_COND_V(page_count != (key_count + COMPRESSED_PAGE_KEYS - 1) / COMPRESSED_PAGE_KEYS, false);
+
+					tt->transforms.clear();
+					tt->compressed = true;
+					tt->compressed_pages.resize(page_count);
+					tt->compressed_keys.resize(key_count);
+
+					const real_t *r = pages.ptr();
+					CompressedPage *pw = tt->compressed_pages.ptrw();
+					for (int i = 0; i < page_count; i++) {
+						const real_t *ofs = &r[i * COMPRESSED_PAGE_SIZE];
+						pw[i].time = ofs[0];
+						pw[i].duration = ofs[1];
+						pw[i].loc_min = Vector3(ofs[2], ofs[3], ofs[4]);
+						pw[i].loc_size = Vector3(ofs[5], ofs[6], ofs[7]);
+						pw[i].scale_min = Vector3(ofs[8], ofs[9], ofs[10]);
+						pw[i].scale_size = Vector3(ofs[11], ofs[12], ofs[13]);
+					}
+
+					const uint8_t *kr = keys.ptr();
+					CompressedTransformKey *kw = tt->compressed_keys.ptrw();
+					for (int i = 0; i < key_count; i++) {
+						uint16_t *dst = (uint16_t *)&kw[i];
+						for (int j = 0; j < COMPRESSED_KEY_SIZE / 2; j++) {
+							dst[j] = decode_uint16(&kr[i * COMPRESSED_KEY_SIZE + j * 2]);
+						}
+					}
+
+					return true;
+				}
+
+				tt->compressed = false;
+				tt->compressed_pages.clear();
+				tt->compressed_keys.clear();
+
 				Vector<real_t> values = p_value;
 				int vcount = values.size();
 				ERR_FAIL_COND_V(vcount % TRANSFORM_TRACK_SIZE, false);
@@ -352,7 +402,43 @@ bool Animation::_get(const StringName &p_name, Variant &r_ret) const {
 		} else if (what == "enabled") {
 			r_ret = track_is_enabled(track);
 		} else if (what == "keys") {
-			if (track_get_type(track) == TYPE_TRANSFORM3D) {
+			if (track_get_type(track) == TYPE_TRANSFORM3D && static_cast<const TransformTrack *>(tracks[track])->compressed) {
+				const TransformTrack *tt = static_cast<const TransformTrack *>(tracks[track]);
+
+				Vector<real_t> pages;
+				pages.resize(tt->compressed_pages.size() * COMPRESSED_PAGE_SIZE);
+				real_t *w = pages.ptrw();
+				for (int i = 0; i < tt->compressed_pages.size(); i++) {
+					const CompressedPage &page = tt->compressed_pages[i];
+					real_t *ofs = &w[i * COMPRESSED_PAGE_SIZE];
+					ofs[0] = page.time;
+					ofs[1] = page.duration;
+					for (int j = 0; j < 3; j++) {
+						ofs[2 + j] = page.loc_min[j];
+						ofs[5 + j] = page.loc_size[j];
+						ofs[8 + j] = page.scale_min[j];
+						ofs[11 + j] = page.scale_size[j];
+					}
+				}
+
+				// Stored as bytes so the format does not depend on the host endianness.
+				Vector<uint8_t> keys;
+				keys.resize(tt->compressed_keys.size() * COMPRESSED_KEY_SIZE);
+				uint8_t *kw = keys.ptrw();
+				for (int i = 0; i < tt->compressed_keys.size(); i++) {
+					const uint16_t *src = (const uint16_t *)&tt->compressed_keys[i];
+					for (int j = 0; j < COMPRESSED_KEY_SIZE / 2; j++) {
+						encode_uint16(src[j], &kw[i * COMPRESSED_KEY_SIZE + j * 2]);
+					}
+				}
+
+				Dictionary d;
+				d["pages"] = pages;
+				d["keys"] = keys;
+				r_ret = d;
+				return true;
+
+			} else if (track_get_type(track) == TYPE_TRANSFORM3D) {
 				Vector<real_t> keys;
 				int kk = track_get_key_count(track);
 				keys.resize(kk * TRANSFORM_TRACK_SIZE);
@@ -780,16 +866,24 @@ Error Animation::transform_track_get_key(int p_track, int p_key, Vector3 *r_loc,
 
 	TransformTrack *tt = static_cast<TransformTrack *>(t);
 	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM3D, ERR_INVALID_PARAMETER);
-	ERR_FAIL_INDEX_V(p_key, tt->transforms.size(), ERR_INVALID_PARAMETER);
+
+	TransformKey tk;
+	if (tt->compressed) {
+		ERR_FAIL_INDEX_V(p_key, tt->compressed_keys.size(), ERR_INVALID_PARAMETER);
+		tk = CompressedTransformKeys(tt).get_value(p_key);
+	} else {
+		ERR_FAIL_INDEX_V(p_key, tt->transforms.size(), ERR_INVALID_PARAMETER);
+		tk = tt->transforms[p_key].value;
+	}
 
 	if (r_loc) {
-		*r_loc = tt->transforms[p_key].value.loc;
+		*r_loc = tk.loc;
 	}
 	if (r_rot) {
-		*r_rot = tt->transforms[p_key].value.rot;
+		*r_rot = tk.rot;
 	}
 	if (r_scale) {
-		*r_scale = tt->transforms[p_key].value.scale;
+		*r_scale = tk.scale;
 	}
 
 	return OK;
@@ -801,6 +895,7 @@ int Animation::transform_track_insert_key(int p_track, double p_time, const Vect
 	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM3D, -1);
 
 	TransformTrack *tt = static_cast<TransformTrack *>(t);
+	ERR_FAIL_COND_V_MSG(tt->compressed, -1, "Compressed transform tracks can't be edited.");
 
 	TKey<TransformKey> tkey;
 	tkey.time = p_time;
@@ -826,6 +921,7 @@ void Animation::track_remove_key(int p_track, int p_idx) {
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			ERR_FAIL_COND_MSG(tt->compressed, "Compressed transform tracks can't be edited.");
 			ERR_FAIL_INDEX(p_idx, tt->transforms.size());
 			tt->transforms.remove(p_idx);
 
@@ -872,6 +968,17 @@ int Animation::track_find_key(int p_track, double p_time, bool p_exact) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				CompressedTransformKeys keys(tt);
+				int k = _find(keys, p_time);
+				if (k < 0 || k >= keys.size()) {
+					return -1;
+				}
+				if (keys.get_time(k) != p_time && p_exact) {
+					return -1;
+				}
+				return k;
+			}
 			int k = _find(tt->transforms, p_time);
 			if (k < 0 || k >= tt->transforms.size()) {
 				return -1;
@@ -1056,7 +1163,7 @@ int Animation::track_get_key_count(int p_track) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
-			return tt->transforms.size();
+			return tt->compressed ? tt->compressed_keys.size() : tt->transforms.size();
 		} break;
 		case TYPE_VALUE: {
 			ValueTrack *vt = static_cast<ValueTrack *>(t);
@@ -1090,13 +1197,15 @@ Variant Animation::track_get_key_value(int p_track, int p_key_idx) const {
 
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
-			TransformTrack *tt = static_cast<TransformTrack *>(t);
-			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), Variant());
+			Vector3 loc;
+			Quaternion rot;
+			Vector3 scale;
+			ERR_FAIL_COND_V(transform_track_get_key(p_track, p_key_idx, &loc, &rot, &scale) != OK, Variant());
 
 			Dictionary d;
-			d["location"] = tt->transforms[p_key_idx].value.loc;
-			d["rotation"] = tt->transforms[p_key_idx].value.rot;
-			d["scale"] = tt->transforms[p_key_idx].value.scale;
+			d["location"] = loc;
+			d["rotation"] = rot;
+			d["scale"] = scale;
 
 			return d;
 		} break;
@@ -1159,6 +1268,10 @@ double Animation::track_get_key_time(int p_track, int p_key_idx) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				ERR_FAIL_INDEX_V(p_key_idx, tt->compressed_keys.size(), -1);
+				return CompressedTransformKeys(tt).get_time(p_key_idx);
+			}
 			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), -1);
 			return tt->transforms[p_key_idx].time;
 		} break;
@@ -1204,6 +1317,7 @@ void Animation::track_set_key_time(int p_track, int p_key_idx, double p_time) {
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			ERR_FAIL_COND_MSG(tt->compressed, "Compressed transform tracks can't be edited.");
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 			TKey<TransformKey> key = tt->transforms[p_key_idx];
 			key.time = p_time;
@@ -1268,6 +1382,11 @@ real_t Animation::track_get_key_transition(int p_track, int p_key_idx) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->compressed) {
+				// Only tracks without easing get compressed.
+				ERR_FAIL_INDEX_V(p_key_idx, tt->compressed_keys.size(), -1);
+				return 1.0;
+			}
 			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), -1);
 			return tt->transforms[p_key_idx].transition;
 		} break;
@@ -1304,6 +1423,7 @@ void Animation::track_set_key_value(int p_track, int p_key_idx, const Variant &p
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			ERR_FAIL_COND_MSG(tt->compressed, "Compressed transform tracks can't be edited.");
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 
 			Dictionary d = p_value;
@@ -1387,6 +1507,7 @@ void Animation::track_set_key_transition(int p_track, int p_key_idx, real_t p_tr
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			ERR_FAIL_COND_MSG(tt->compressed, "Compressed transform tracks can't be edited.");
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 			tt->transforms.write[p_key_idx].transition = p_transition;
 		} break;
@@ -1450,6 +1571,99 @@ int Animation::_find(const Vector<K> &p_keys, double p_time) const {
 	return middle;
 }
 
+int Animation::_find(const CompressedTransformKeys &p_keys, double p_time) const {
+	const TransformTrack *tt = p_keys.track;
+	int page_count = tt->compressed_pages.size();
+	if (page_count == 0) {
+		return -2;
+	}
+
+	// Find the page first, so only the keys of a single page are touched.
+	const CompressedPage *pages = tt->compressed_pages.ptr();
+	int low = 0;
+	int high = page_count - 1;
+	while (low < high) {
+		int middle = (low + high + 1) / 2;
+		if (pages[middle].time <= p_time || Math::is_equal_approx(p_time, pages[middle].time)) {
+			low = middle;
+		} else {
+			high = middle - 1;
+		}
+	}
+
+	low = low << COMPRESSED_PAGE_KEYS_SHIFT;
+	high = MIN(low + COMPRESSED_PAGE_KEYS, p_keys.size()) - 1;
+	int middle = low;
+
+	while (low <= high) {
+		middle = (low + high) / 2;
+		double time = p_keys.get_time(middle);
+
+		if (Math::is_equal_approx(p_time, time)) { //match
+			return middle;
+		} else if (p_time < time) {
+			high = middle - 1; //search low end of array
+		} else {
+			low = middle + 1; //search high end of array
+		}
+	}
+
+	if (p_keys.get_time(middle) > p_time) {
+		middle--;
+	}
+
+	return middle;
+}
+
+template <class K>
+int Animation::_find_from_cursor(const K &p_keys, double p_time, int p_cursor) const {
+	int len = p_keys.size();
+	if (len == 0) {
+		return -2;
+	}
+
+	// Playing forward, the key found last time or one shortly after it is almost always the right one.
+	for (int i = MAX(p_cursor, -1); i < len && i <= p_cursor + 2; i++) {
+		if (i >= 0 && p_keys[i].time > p_time && !Math::is_equal_approx(p_time, (double)p_keys[i].time)) {
+			break; // Went backwards.
+		}
+		if (i + 1 == len || (p_keys[i + 1].time > p_time && !Math::is_equal_approx(p_time, (double)p_keys[i + 1].time))) {
+			return i;
+		}
+	}
+
+	return _find(p_keys, p_time);
+}
+
+Animation::TransformKey Animation::CompressedTransformKeys::get_value(int p_idx) const {
+	const CompressedPage &page = track->compressed_pages.ptr()[p_idx >> COMPRESSED_PAGE_KEYS_SHIFT];
+	const CompressedTransformKey &key = track->compressed_keys.ptr()[p_idx];
+	const real_t to_unit = 1.0 / 65535.0;
+
+	TransformKey tk;
+	for (int i = 0; i < 3; i++) {
+		tk.loc[i] = page.loc_min[i] + page.loc_size[i] * (key.loc[i] * to_unit);
+		tk.scale[i] = page.scale_min[i] + page.scale_size[i] * (key.scale[i] * to_unit);
+	}
+
+	// The dropped component is the largest one and always positive, the other three are within +-1/sqrt(2).
+	int largest = (key.rot[0] >> 15) | ((key.rot[1] >> 15) << 1);
+	real_t components[4];
+	real_t sum = 0.0;
+	for (int i = 0, j = 0; i < 4; i++) {
+		if (i == largest) {
+			continue;
+		}
+		real_t c = ((key.rot[j++] & 0x7FFF) * (1.0 / 32767.0) * 2.0 - 1.0) * Math_SQRT12;
+		components[i] = c;
+		sum += c * c;
+	}
+	components[largest] = Math::sqrt(MAX(1.0 - sum, 0.0));
+	tk.rot = Quaternion(components[0], components[1], components[2], components[3]).normalized();
+
+	return tk;
+}
+
 Animation::TransformKey Animation::_interpolate(const Animation::TransformKey &p_a, const Animation::TransformKey &p_b, real_t p_c) const {
 	TransformKey ret;
 	ret.loc = _interpolate(p_a.loc, p_b.loc, p_c);
@@ -1482,7 +1696,7 @@ Animation::TransformKey Animation::_cubic_interpolate(const Animation::Transform
 
 	tk.loc = p_a.loc.cubic_interpolate(p_b.loc, p_pre_a.loc, p_post_b.loc, p_c);
 	tk.scale = p_a.scale.cubic_interpolate(p_b.scale, p_pre_a.scale, p_post_b.scale, p_c);
-	tk.rot = p_a.rot.cubic_slerp(p_b.rot, p_pre_a.rot, p_post_b.rot, p_c);
+	tk.rot = _cubic_interpolate(p_pre_a.rot, p_a.rot, p_b.rot, p_post_b.rot, p_c);
 
 	return tk;
 }
@@ -1492,7 +1706,12 @@ Vector3 Animation::_cubic_interpolate(const Vector3 &p_pre_a, const Vector3 &p_a
 }
 
 Quaternion Animation::_cubic_interpolate(const Quaternion &p_pre_a, const Quaternion &p_a, const Quaternion &p_b, const Quaternion &p_post_b, real_t p_c) const {
-	return p_a.cubic_slerp(p_b, p_pre_a, p_post_b, p_c);
+	// cubic_slerp() doesn't take the shortest path, so keep the keys in the hemisphere of p_a.
+	// Compressed keys in particular are flipped on their own, see _transform_track_compress().
+	Quaternion pre_a = p_pre_a.dot(p_a) < 0.0 ? -p_pre_a : p_pre_a;
+	Quaternion b = p_b.dot(p_a) < 0.0 ? -p_b : p_b;
+	Quaternion post_b = p_post_b.dot(b) < 0.0 ? -p_post_b : p_post_b;
+	return p_a.cubic_slerp(b, pre_a, post_b, p_c);
 }
 
 Variant Animation::_cubic_interpolate(const Variant &p_pre_a, const Variant &p_a, const Variant &p_b, const Variant &p_post_b, real_t p_c) const {
@@ -1584,9 +1803,12 @@ real_t Animation::_cubic_interpolate(const real_t &p_pre_a, const real_t &p_a, c
 	return _interpolate(p_a, p_b, p_c);
 }
 
-template <class T>
-T Animation::_interpolate(const Vector<TKey<T>> &p_keys, double p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok) const {
-	int len = _find(p_keys, length) + 1; // try to find last key (there may be more past the end)
+template <class T, class K>
+T Animation::_interpolate(const K &p_keys, double p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok, int *r_cursor) const {
+	int len = p_keys.size();
+	if (len > 0 && p_keys[len - 1].time > length && !Math::is_equal_approx(length, (double)p_keys[len - 1].time)) {
+		len = _find(p_keys, length) + 1; // try to find last key (there may be more past the end)
+	}
 
 	if (len <= 0) {
 		// (-1 or -2 returned originally) (plus one above)
@@ -1600,10 +1822,16 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, double p_time, Interpol
 		if (p_ok) {
 			*p_ok = true;
 		}
-		return p_keys[0].value;
+		return _get_key_value(p_keys, 0);
 	}
 
-	int idx = _find(p_keys, p_time);
+	int idx;
+	if (r_cursor) {
+		idx = _find_from_cursor(p_keys, p_time, *r_cursor);
+		*r_cursor = idx;
+	} else {
+		idx = _find(p_keys, p_time);
+	}
 
 	ERR_FAIL_COND_V(idx == -2, T());
 
@@ -1695,7 +1923,7 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, double p_time, Interpol
 
 	if (tr == 0 || idx == next) {
 		// don't interpolate if not needed
-		return p_keys[idx].value;
+		return _get_key_value(p_keys, idx);
 	}
 
 	if (tr != 1.0) {
@@ -1704,10 +1932,10 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, double p_time, Interpol
 
 	switch (p_interp) {
 		case INTERPOLATION_NEAREST: {
-			return p_keys[idx].value;
+			return _get_key_value(p_keys, idx);
 		} break;
 		case INTERPOLATION_LINEAR: {
-			return _interpolate(p_keys[idx].value, p_keys[next].value, c);
+			return _interpolate(_get_key_value(p_keys, idx), _get_key_value(p_keys, next), c);
 		} break;
 		case INTERPOLATION_CUBIC: {
 			int pre = idx - 1;
@@ -1719,17 +1947,17 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, double p_time, Interpol
 				post = next;
 			}
 
-			return _cubic_interpolate(p_keys[pre].value, p_keys[idx].value, p_keys[next].value, p_keys[post].value, c);
+			return _cubic_interpolate(_get_key_value(p_keys, pre), _get_key_value(p_keys, idx), _get_key_value(p_keys, next), _get_key_value(p_keys, post), c);
 
 		} break;
 		default:
-			return p_keys[idx].value;
+			return _get_key_value(p_keys, idx);
 	}
 
 	// do a barrel roll
 }
 
-Error Animation::transform_track_interpolate(int p_track, double p_time, Vector3 *r_loc, Quaternion *r_rot, Vector3 *r_scale) const {
+Error Animation::transform_track_interpolate(int p_track, double p_time, Vector3 *r_loc, Quaternion *r_rot, Vector3 *r_scale, int *r_cursor) const {
 	ERR_FAIL_INDEX_V(p_track, tracks.size(), ERR_INVALID_PARAMETER);
 	Track *t = tracks[p_track];
 	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM3D, ERR_INVALID_PARAMETER);
@@ -1738,7 +1966,12 @@ Error Animation::transform_track_interpolate(int p_track, double p_time, Vector3
 
 	bool ok = false;
 
-	TransformKey tk = _interpolate(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &ok);
+	TransformKey tk;
+	if (tt->compressed) {
+		tk = _interpolate<TransformKey>(CompressedTransformKeys(tt), p_time, tt->interpolation, tt->loop_wrap, &ok, r_cursor);
+	} else {
+		tk = _interpolate<TransformKey>(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &ok, r_cursor);
+	}
 
 	if (!ok) {
 		return ERR_UNAVAILABLE;
@@ -1767,7 +2000,7 @@ Variant Animation::value_track_interpolate(int p_track, double p_time) const {
 
 	bool ok = false;
 
-	Variant res = _interpolate(vt->values, p_time, (vt->update_mode == UPDATE_CONTINUOUS || vt->update_mode == UPDATE_CAPTURE) ? vt->interpolation : INTERPOLATION_NEAREST, vt->loop_wrap, &ok);
+	Variant res = _interpolate<Variant>(vt->values, p_time, (vt->update_mode == UPDATE_CONTINUOUS || vt->update_mode == UPDATE_CAPTURE) ? vt->interpolation : INTERPOLATION_NEAREST, vt->loop_wrap, &ok);
 
 	if (ok) {
 		return res;
@@ -1875,8 +2108,8 @@ Animation::UpdateMode Animation::value_track_get_update_mode(int p_track) const
 	return vt->update_mode;
 }
 
-template <class T>
-void Animation::_track_get_key_indices_in_range(const Vector<T> &p_array, double from_time, double to_time, List<int> *p_indices) const {
+template <class K>
+void Animation::_track_get_key_indices_in_range(const K &p_array, double from_time, double to_time, List<int> *p_indices) const {
 	if (from_time != length && to_time == length) {
 		to_time = length * 1.01; //include a little more if at the end
 	}
@@ -1935,8 +2168,13 @@ void Animation::track_get_key_indices_in_range(int p_track, double p_time, doubl
 			switch (t->type) {
 				case TYPE_TRANSFORM3D: {
 					const TransformTrack *tt = static_cast<const TransformTrack *>(t);
-					_track_get_key_indices_in_range(tt->transforms, from_time, length, p_indices);
-					_track_get_key_indices_in_range(tt->transforms, 0, to_time, p_indices);
+					if (tt->compressed) {
+						_track_get_key_indices_in_range(CompressedTransformKeys(tt), from_time, length, p_indices);
+						_track_get_key_indices_in_range(CompressedTransformKeys(tt), 0, to_time, p_indices);
+					} else {
+						_track_get_key_indices_in_range(tt->transforms, from_time, length, p_indices);
+						_track_get_key_indices_in_range(tt->transforms, 0, to_time, p_indices);
+					}
 
 				} break;
 				case TYPE_VALUE: {
@@ -1991,7 +2229,11 @@ void Animation::track_get_key_indices_in_range(int p_track, double p_time, doubl
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			const TransformTrack *tt = static_cast<const TransformTrack *>(t);
-			_track_get_key_indices_in_range(tt->transforms, from_time, to_time, p_indices);
+			if (tt->compressed) {
+				_track_get_key_indices_in_range(CompressedTransformKeys(tt), from_time, to_time, p_indices);
+			} else {
+				_track_get_key_indices_in_range(tt->transforms, from_time, to_time, p_indices);
+			}
 
 		} break;
 		case TYPE_VALUE: {
@@ -2674,6 +2916,8 @@ void Animation::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("clear"), &Animation::clear);
 	ClassDB::bind_method(D_METHOD("copy_track", "track_idx", "to_animation"), &Animation::copy_track);
+	ClassDB::bind_method(D_METHOD("compress"), &Animation::compress);
+	ClassDB::bind_method(D_METHOD("track_is_compressed", "track_idx"), &Animation::track_is_compressed);
 
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "length", PROPERTY_HINT_RANGE, "0.001,99999,0.001"), "set_length", "get_length");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "loop"), "set_loop", "has_loop");
@@ -2924,6 +3168,113 @@ void Animation::optimize(real_t p_allowed_linear_err, real_t p_allowed_angular_e
 	}
 }
 
+static _FORCE_INLINE_ uint16_t _quantize_unit(real_t p_value, uint16_t p_max) {
+	return (uint16_t)CLAMP(Math::round(p_value * p_max), 0, p_max);
+}
+
+void Animation::_transform_track_compress(TransformTrack *p_track) {
+	const Vector<TKey<TransformKey>> &keys = p_track->transforms;
+	int key_count = keys.size();
+	int page_count = (key_count + COMPRESSED_PAGE_KEYS - 1) / COMPRESSED_PAGE_KEYS;
+
+	p_track->compressed_pages.resize(page_count);
+	p_track->compressed_keys.resize(key_count);
+	CompressedPage *pages = p_track->compressed_pages.ptrw();
+	CompressedTransformKey *ckeys = p_track->compressed_keys.ptrw();
+
+	for (int i = 0; i < page_count; i++) {
+		int from = i << COMPRESSED_PAGE_KEYS_SHIFT;
+		int to = MIN(from + COMPRESSED_PAGE_KEYS, key_count);
+
+		// Bounds are per page, so precision only depends on how much the values move within it.
+		AABB loc_bounds(keys[from].value.loc, Vector3());
+		AABB scale_bounds(keys[from].value.scale, Vector3());
+		for (int j = from + 1; j < to; j++) {
+			loc_bounds.expand_to(keys[j].value.loc);
+			scale_bounds.expand_to(keys[j].value.scale);
+		}
+
+		CompressedPage &page = pages[i];
+		page.time = keys[from].time;
+		page.duration = keys[to - 1].time - keys[from].time;
+		page.loc_min = loc_bounds.position;
+		page.loc_size = loc_bounds.size;
+		page.scale_min = scale_bounds.position;
+		page.scale_size = scale_bounds.size;
+
+		for (int j = from; j < to; j++) {
+			const TransformKey &tk = keys[j].value;
+			CompressedTransformKey &ck = ckeys[j];
+
+			ck.time = page.duration > 0.0 ? _quantize_unit((keys[j].time - page.time) / page.duration, 65535) : 0;
+			for (int k = 0; k < 3; k++) {
+				ck.loc[k] = page.loc_size[k] > 0.0 ? _quantize_unit((tk.loc[k] - page.loc_min[k]) / page.loc_size[k], 65535) : 0;
+				ck.scale[k] = page.scale_size[k] > 0.0 ? _quantize_unit((tk.scale[k] - page.scale_min[k]) / page.scale_size[k], 65535) : 0;
+			}
+
+			// Drop the largest component and rebuild it from the others on decode, flipping the sign
+			// so it is positive (q and -q are the same rotation).
+			Quaternion rot = tk.rot.normalized();
+			real_t components[4] = { rot.x, rot.y, rot.z, rot.w };
+			int largest = 0;
+			for (int k = 1; k < 4; k++) {
+				if (Math::abs(components[k]) > Math::abs(components[largest])) {
+					largest = k;
+				}
+			}
+			real_t sign = components[largest] < 0.0 ? -1.0 : 1.0;
+			for (int k = 0, l = 0; k < 4; k++) {
+				if (k == largest) {
+					continue;
+				}
+				ck.rot[l++] = _quantize_unit((components[k] * sign / Math_SQRT12) * 0.5 + 0.5, 0x7FFF);
+			}
+			ck.rot[0] |= (largest & 1) << 15;
+			ck.rot[1] |= (largest >> 1) << 15;
+		}
+	}
+
+	p_track->transforms.clear();
+	p_track->compressed = true;
+}
+
+void Animation::compress() {
+	for (int i = 0; i < tracks.size(); i++) {
+		if (tracks[i]->type != TYPE_TRANSFORM3D) {
+			continue;
+		}
+
+		TransformTrack *tt = static_cast<TransformTrack *>(tracks[i]);
+		if (tt->compressed || tt->transforms.is_empty()) {
+			continue;
+		}
+
+		// Easing is not stored, leave tracks that use it as they are.
+		bool eased = false;
+		for (int j = 0; j < tt->transforms.size(); j++) {
+			if (tt->transforms[j].transition != 1.0) {
+				eased = true;
+				break;
+			}
+		}
+		if (eased) {
+			continue;
+		}
+
+		_transform_track_compress(tt);
+	}
+
+	emit_changed();
+}
+
+bool Animation::track_is_compressed(int p_track) const {
+	ERR_FAIL_INDEX_V(p_track, tracks.size(), false);
+	if (tracks[p_track]->type != TYPE_TRANSFORM3D) {
+		return false;
+	}
+	return static_cast<const TransformTrack *>(tracks[p_track])->compressed;
+}
+
 Animation::Animation() {}
 
 Animation::~Animation() {
@@ -97,12 +97,61 @@ private:
 
 	/* TRANSFORM TRACK */
 
+	enum {
+		COMPRESSED_PAGE_KEYS_SHIFT = 7,
+		COMPRESSED_PAGE_KEYS = 1 << COMPRESSED_PAGE_KEYS_SHIFT, // 128 keys of 20 bytes, a page fits in 4KB.
+		// Amount of numbers in a serialized CompressedPage, and of bytes in a serialized CompressedTransformKey.
+		COMPRESSED_PAGE_SIZE = 14,
+		COMPRESSED_KEY_SIZE = 20,
+	};
+
+	struct CompressedTransformKey {
+		uint16_t loc[3]; // Relative to the page bounds.
+		uint16_t rot[3]; // Smallest three components, the index of the dropped one is kept in the top bits of rot[0] and rot[1].
+		uint16_t scale[3]; // Relative to the page bounds.
+		uint16_t time; // Fraction of the page duration.
+	};
+	static_assert(sizeof(CompressedTransformKey) == COMPRESSED_KEY_SIZE, "Compressed keys are serialized as 10 uint16_t.");
+
+	struct CompressedPage {
+		double time = 0.0; // Time of the first key, pages are searched by it before touching any key.
+		double duration = 0.0;
+		Vector3 loc_min;
+		Vector3 loc_size;
+		Vector3 scale_min;
+		Vector3 scale_size;
+	};
+
 	struct TransformTrack : public Track {
 		Vector<TKey<TransformKey>> transforms;
 
+		// When compressed, keys live here instead of in transforms and can no longer be edited.
+		bool compressed = false;
+		Vector<CompressedPage> compressed_pages;
+		Vector<CompressedTransformKey> compressed_keys;
+
 		TransformTrack() { type = TYPE_TRANSFORM3D; }
 	};
 
+	// Read only key access for compressed tracks, decodes only what is asked for.
+	struct CompressedTransformKeys {
+		const TransformTrack *track = nullptr;
+
+		_FORCE_INLINE_ int size() const { return track->compressed_keys.size(); }
+		_FORCE_INLINE_ double get_time(int p_idx) const {
+			const CompressedPage &page = track->compressed_pages.ptr()[p_idx >> COMPRESSED_PAGE_KEYS_SHIFT];
+			return page.time + page.duration * (track->compressed_keys.ptr()[p_idx].time * (1.0 / 65535.0));
+		}
+		_FORCE_INLINE_ Key operator[](int p_idx) const {
+			Key key;
+			key.time = get_time(p_idx);
+			return key;
+		}
+		TransformKey get_value(int p_idx) const;
+
+		explicit CompressedTransformKeys(const TransformTrack *p_track) { track = p_track; }
+	};
+
 	/* PROPERTY VALUE TRACK */
 
 	struct ValueTrack : public Track {
@@ -185,6 +234,13 @@ private:
 
 	template <class K>
 	inline int _find(const Vector<K> &p_keys, double p_time) const;
+	int _find(const CompressedTransformKeys &p_keys, double p_time) const;
+	template <class K>
+	_FORCE_INLINE_ int _find_from_cursor(const K &p_keys, double p_time, int p_cursor) const;
+
+	template <class T>
+	_FORCE_INLINE_ const T &_get_key_value(const Vector<TKey<T>> &p_keys, int p_idx) const { return p_keys[p_idx].value; }
+	_FORCE_INLINE_ TransformKey _get_key_value(const CompressedTransformKeys &p_keys, int p_idx) const { return p_keys.get_value(p_idx); }
 
 	_FORCE_INLINE_ Animation::TransformKey _interpolate(const Animation::TransformKey &p_a, const Animation::TransformKey &p_b, real_t p_c) const;
 
@@ -199,11 +255,11 @@ private:
 	_FORCE_INLINE_ Variant _cubic_interpolate(const Variant &p_pre_a, const Variant &p_a, const Variant &p_b, const Variant &p_post_b, real_t p_c) const;
 	_FORCE_INLINE_ real_t _cubic_interpolate(const real_t &p_pre_a, const real_t &p_a, const real_t &p_b, const real_t &p_post_b, real_t p_c) const;
 
-	template <class T>
-	_FORCE_INLINE_ T _interpolate(const Vector<TKey<T>> &p_keys, double p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok) const;
+	template <class T, class K>
+	_FORCE_INLINE_ T _interpolate(const K &p_keys, double p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok, int *r_cursor = nullptr) const;
 
-	template <class T>
-	_FORCE_INLINE_ void _track_get_key_indices_in_range(const Vector<T> &p_array, double from_time, double to_time, List<int> *p_indices) const;
+	template <class K>
+	_FORCE_INLINE_ void _track_get_key_indices_in_range(const K &p_array, double from_time, double to_time, List<int> *p_indices) const;
 
 	_FORCE_INLINE_ void _value_track_get_key_indices_in_range(const ValueTrack *vt, double from_time, double to_time, List<int> *p_indices) const;
 	_FORCE_INLINE_ void _method_track_get_key_indices_in_range(const MethodTrack *mt, double from_time, double to_time, List<int> *p_indices) const;
@@ -249,6 +305,7 @@ private:
 
 	bool _transform_track_optimize_key(const TKey<TransformKey> &t0, const TKey<TransformKey> &t1, const TKey<TransformKey> &t2, real_t p_alowed_linear_err, real_t p_alowed_angular_err, real_t p_max_optimizable_angle, const Vector3 &p_norm);
 	void _transform_track_optimize(int p_idx, real_t p_allowed_linear_err = 0.05, real_t p_allowed_angular_err = 0.01, real_t p_max_optimizable_angle = Math_PI * 0.125);
+	void _transform_track_compress(TransformTrack *p_track);
 
 protected:
 	bool _set(const StringName &p_name, const Variant &p_value);
@@ -324,7 +381,8 @@ public:
 	void track_set_interpolation_loop_wrap(int p_track, bool p_enable);
 	bool track_get_interpolation_loop_wrap(int p_track) const;
 
-	Error transform_track_interpolate(int p_track, double p_time, Vector3 *r_loc, Quaternion *r_rot, Vector3 *r_scale) const;
+	// r_cursor, when given, is the key found by the previous call and makes sequential playback skip the key search.
+	Error transform_track_interpolate(int p_track, double p_time, Vector3 *r_loc, Quaternion *r_rot, Vector3 *r_scale, int *r_cursor = nullptr) const;
 
 	Variant value_track_interpolate(int p_track, double p_time) const;
 	void value_track_get_key_indices(int p_track, double p_time, double p_delta, List<int> *p_indices) const;
@@ -351,6 +409,8 @@ public:
 	void clear();
 
 	void optimize(real_t p_allowed_linear_err = 0.05, real_t p_allowed_angular_err = 0.01, real_t p_max_optimizable_angle = Math_PI * 0.125);
+	void compress();
+	bool track_is_compressed(int p_track) const;
 
 	Animation();
 	~Animation();
@@ -86,6 +86,19 @@ void AudioStreamPlaybackSample::seek(float p_time) {
 	offset = uint64_t(p_time * base->mix_rate) << MIX_FRAC_BITS;
 }
 
+float AudioStreamPlaybackSample::get_length() const {
+	return base->get_length();
+}
+
+bool AudioStreamPlaybackSample::get_loop_range(float &r_begin, float &r_end) const {
+	if (base->loop_mode == AudioStreamSample::LOOP_DISABLED) {
+		return false;
+	}
+	r_begin = float(base->loop_begin) / base->mix_rate;
+	r_end = float(base->loop_end) / base->mix_rate;
+	return true;
+}
+
 template <class Depth, bool is_stereo, bool is_ima_adpcm>
 void AudioStreamPlaybackSample::do_resample(const Depth *p_src, AudioFrame *p_dst, int64_t &offset, int32_t &increment, uint32_t amount, IMA_ADPCM_State *ima_adpcm) {
 	// this function will be compiled branchless by any decent compiler
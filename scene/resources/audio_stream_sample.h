@@ -73,6 +73,9 @@ public:
 	virtual float get_playback_position() const override;
 	virtual void seek(float p_time) override;
 
+	virtual float get_length() const override;
+	virtual bool get_loop_range(float &r_begin, float &r_end) const override;
+
 	virtual int mix(AudioFrame *p_buffer, float p_rate_scale, int p_frames) override;
 
 	AudioStreamPlaybackSample();
@@ -346,20 +346,31 @@ Ref<Image> StreamTexture2D::load_image_from_file(FileAccess *f, int p_size_limit
 				continue;
 			}
 
-			Vector<uint8_t> pv;
-			pv.resize(size);
-			{
-				uint8_t *wr = pv.ptrw();
-				f->get_buffer(wr, size);
-			}
-
 			Ref<Image> img;
-			if (data_format == DATA_FORMAT_BASIS_UNIVERSAL && Image::basis_universal_unpacker) {
-				img = Image::basis_universal_unpacker(pv);
-			} else if (data_format == DATA_FORMAT_PNG && Image::png_unpacker) {
-				img = Image::png_unpacker(pv);
-			} else if (data_format == DATA_FORMAT_WEBP && Image::webp_unpacker) {
-				img = Image::webp_unpacker(pv);
+
+			// Decode straight from the file when it's in memory, skipping the "PNG " or "WEBP" prefix.
+			const uint8_t *mapped = data_format != DATA_FORMAT_BASIS_UNIVERSAL && size > 4 ? f->get_mapped_buffer(size) : nullptr;
+			if (mapped) {
+				if (data_format == DATA_FORMAT_PNG && Image::_png_mem_loader_func && memcmp(mapped, "PNG ", 4) == 0) {
+					img = Image::_png_mem_loader_func(mapped + 4, size - 4);
+				} else if (data_format == DATA_FORMAT_WEBP && Image::_webp_mem_loader_func && memcmp(mapped, "WEBP", 4) == 0) {
+					img = Image::_webp_mem_loader_func(mapped + 4, size - 4);
+				}
+			} else {
+				Vector<uint8_t> pv;
+				pv.resize(size);
+				{
+					uint8_t *wr = pv.ptrw();
+					f->get_buffer(wr, size);
+				}
+
+				if (data_format == DATA_FORMAT_BASIS_UNIVERSAL && Image::basis_universal_unpacker) {
+					img = Image::basis_universal_unpacker(pv);
+				} else if (data_format == DATA_FORMAT_PNG && Image::png_unpacker) {
+					img = Image::png_unpacker(pv);
+				} else if (data_format == DATA_FORMAT_WEBP && Image::webp_unpacker) {
+					img = Image::webp_unpacker(pv);
+				}
 			}
 
 			if (img.is_null() || img->is_empty()) {
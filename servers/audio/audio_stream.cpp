@@ -95,16 +95,228 @@ void AudioStreamPlayback::_bind_methods() {
 //////////////////////////////
 
 void AudioStreamPlaybackResampled::_begin_resample() {
+	predecoding = false;
+	predecode_read.set(0);
+	predecode_write.set(0);
+	predecode_discard_to.set(0);
+
+	// The decoder marked where it starts, which is now the start of the ring.
+	position_marks_lock.lock();
+	if (position_mark_count > 0) {
+		position_marks[0].frame = 0;
+		position_marks[0].time = position_marks[position_mark_count - 1].time;
+		position_mark_count = 1;
+	}
+	position_marks_lock.unlock();
+
+	float lookahead = AudioServer::get_singleton()->get_predecode_lookahead();
+	if (_can_predecode() && lookahead > 0 && WorkerThreadPool::get_singleton()->get_thread_count() > 0) {
+		predecode_rate = get_stream_sampling_rate();
+		predecode_lookahead = MAX(uint32_t(predecode_rate * lookahead), (uint32_t)PREDECODE_CHUNK_LEN);
+		uint32_t ring_size = next_power_of_2(predecode_lookahead + PREDECODE_CHUNK_LEN);
+		if (predecode_ring.size() != ring_size) {
+			predecode_ring.resize(ring_size);
+		}
+		predecoding = true;
+	}
+
 	//clear cubic interpolation history
 	internal_buffer[0] = AudioFrame(0.0, 0.0);
 	internal_buffer[1] = AudioFrame(0.0, 0.0);
 	internal_buffer[2] = AudioFrame(0.0, 0.0);
 	internal_buffer[3] = AudioFrame(0.0, 0.0);
 	//mix buffer
-	_mix_internal(internal_buffer + 4, INTERNAL_BUFFER_LEN);
+	_pull_frames(internal_buffer + 4, INTERNAL_BUFFER_LEN);
 	mix_offset = 0;
 }
 
+void AudioStreamPlaybackResampled::PredecodeTask::run() {
+#ifdef DEBUG_ENABLED
+	uint64_t ticks = OS::get_singleton()->get_ticks_usec();
+#endif
+
+	playback->_predecode(playback->predecode_lookahead);
+	playback->predecode_queued.clear();
+
+#ifdef DEBUG_ENABLED
+	AudioServer::get_singleton()->thread_add_decode_time(OS::get_singleton()->get_ticks_usec() - ticks);
+#endif
+}
+
+void AudioStreamPlaybackResampled::_predecode(uint32_t p_frames) {
+	// Decodes until p_frames are buffered ahead of the mix, or the stream ends.
+	const uint32_t ring_size = predecode_ring.size();
+	const uint32_t ring_mask = ring_size - 1;
+
+	while (true) {
+		MutexLock lock(decoder_mutex);
+
+		uint32_t write = predecode_write.get();
+		uint32_t read = predecode_read.get();
+		uint32_t used = write - read;
+		// Discarded frames still take room until the mix skips them, but don't count as buffered.
+		uint32_t discard_to = predecode_discard_to.get();
+		uint32_t buffered = int32_t(discard_to - read) > 0 ? write - discard_to : used;
+		if (buffered >= p_frames || !is_playing()) {
+			break;
+		}
+
+		// Decode straight into the ring, without wrapping in a single call.
+		uint32_t todo = MIN(MIN(p_frames - buffered, ring_size - used), (uint32_t)PREDECODE_CHUNK_LEN);
+		todo = MIN(todo, ring_size - (write & ring_mask));
+		if (todo == 0) {
+			break;
+		}
+
+		int decoded = _mix_internal(&predecode_ring[write & ring_mask], todo);
+		predecode_write.set(write + decoded);
+		if ((uint32_t)decoded < todo) {
+			break; // Reached the end.
+		}
+	}
+}
+
+void AudioStreamPlaybackResampled::_queue_predecode() {
+	if (predecode_queued.is_set()) {
+		return;
+	}
+	predecode_queued.set();
+	// High priority, so it doesn't wait behind the frame's foreground work.
+	WorkerThreadPool::get_singleton()->add_task(&predecode_task, WorkerThreadPool::PRIORITY_HIGH, &predecode_group);
+}
+
+int AudioStreamPlaybackResampled::_pull_frames(AudioFrame *p_buffer, int p_frames) {
+	if (!predecoding) {
+		return _mix_internal(p_buffer, p_frames);
+	}
+
+	// Skip what was decoded before a seek.
+	uint32_t read = predecode_read.get();
+	uint32_t discard_to = predecode_discard_to.get();
+	if (int32_t(discard_to - read) > 0) {
+		read = discard_to;
+		predecode_read.set(read);
+	}
+
+	uint32_t buffered = predecode_write.get() - read;
+	if (buffered < (uint32_t)p_frames && is_playing()) {
+		// The workers fell behind, decode here rather than leaving a gap.
+#ifdef DEBUG_ENABLED
+		uint64_t ticks = OS::get_singleton()->get_ticks_usec();
+#endif
+		_predecode(p_frames);
+#ifdef DEBUG_ENABLED
+		AudioServer::get_singleton()->thread_add_decode_time(OS::get_singleton()->get_ticks_usec() - ticks);
+#endif
+		discard_to = predecode_discard_to.get();
+		if (int32_t(discard_to - read) > 0) {
+			read = discard_to;
+			predecode_read.set(read);
+		}
+		buffered = predecode_write.get() - read;
+	}
+
+	const uint32_t ring_mask = predecode_ring.size() - 1;
+	int frames = MIN(buffered, (uint32_t)p_frames);
+	for (int i = 0; i < frames; i++) {
+		p_buffer[i] = predecode_ring[(read + i) & ring_mask];
+	}
+	for (int i = frames; i < p_frames; i++) {
+		p_buffer[i] = AudioFrame(0, 0);
+	}
+	predecode_read.set(read + frames);
+
+	if (buffered - frames < predecode_lookahead && is_playing()) {
+		_queue_predecode();
+	}
+
+	return frames;
+}
+
+void AudioStreamPlaybackResampled::_discard_predecoded() {
+	// Called with the decoder locked, so nothing is being written.
+	predecode_discard_to.set(predecode_write.get());
+}
+
+void AudioStreamPlaybackResampled::_finish_predecode() {
+	if (WorkerThreadPool::get_singleton()) {
+		WorkerThreadPool::get_singleton()->wait(&predecode_group);
+	}
+}
+
+uint32_t AudioStreamPlaybackResampled::_get_predecode_read() const {
+	// Discarded frames count as mixed.
+	uint32_t read = predecode_read.get();
+	uint32_t discard_to = predecode_discard_to.get();
+	return int32_t(discard_to - read) > 0 ? discard_to : read;
+}
+
+float AudioStreamPlaybackResampled::_get_predecoded_time() const {
+	if (!predecoding) {
+		return 0;
+	}
+	return (predecode_write.get() - _get_predecode_read()) / predecode_rate;
+}
+
+void AudioStreamPlaybackResampled::_mark_position(float p_time, int p_offset) {
+	// The write position only moves once _mix_internal() returns.
+	PositionMark mark;
+	mark.frame = predecode_write.get() + p_offset;
+	mark.time = p_time;
+
+	position_marks_lock.lock();
+	// Of the marks the mix already passed, only the last one is still needed.
+	uint32_t read = _get_predecode_read();
+	uint32_t first = 0;
+	for (uint32_t i = 1; i < position_mark_count; i++) {
+		if (int32_t(read - position_marks[i].frame) >= 0) {
+			first = i;
+		}
+	}
+	if (position_mark_count - first == PREDECODE_MAX_MARKS) {
+		first++; // Only with loops much shorter than the lookahead.
+	}
+	for (uint32_t i = first; i < position_mark_count; i++) {
+		position_marks[i - first] = position_marks[i];
+	}
+	position_mark_count -= first;
+	position_marks[position_mark_count++] = mark;
+	position_marks_lock.unlock();
+}
+
+float AudioStreamPlaybackResampled::_get_mixed_position(float p_decoded_time) const {
+	if (!predecoding) {
+		return p_decoded_time;
+	}
+
+	float position = -1;
+	position_marks_lock.lock();
+	uint32_t read = _get_predecode_read();
+	for (int i = int(position_mark_count) - 1; i >= 0; i--) {
+		int32_t since = int32_t(read - position_marks[i].frame);
+		if (since >= 0) {
+			position = position_marks[i].time + since / predecode_rate;
+			break;
+		}
+	}
+	position_marks_lock.unlock();
+
+	if (position < 0) {
+		// The mark was dropped, see _mark_position().
+		position = MAX(p_decoded_time - _get_predecoded_time(), 0.0f);
+	}
+	return position;
+}
+
+AudioStreamPlaybackResampled::AudioStreamPlaybackResampled() {
+	mix_offset = 0;
+	predecode_task.playback = this;
+}
+
+AudioStreamPlaybackResampled::~AudioStreamPlaybackResampled() {
+	_finish_predecode();
+}
+
 int AudioStreamPlaybackResampled::mix(AudioFrame *p_buffer, float p_rate_scale, int p_frames) {
 	float target_rate = AudioServer::get_singleton()->get_mix_rate();
 	float playback_speed_scale = AudioServer::get_singleton()->get_playback_speed_scale();
@@ -143,8 +355,9 @@ int AudioStreamPlaybackResampled::mix(AudioFrame *p_buffer, float p_rate_scale,
 			internal_buffer[1] = internal_buffer[INTERNAL_BUFFER_LEN + 1];
 			internal_buffer[2] = internal_buffer[INTERNAL_BUFFER_LEN + 2];
 			internal_buffer[3] = internal_buffer[INTERNAL_BUFFER_LEN + 3];
-			if (is_playing()) {
-				int mixed_frames = _mix_internal(internal_buffer + 4, INTERNAL_BUFFER_LEN);
+			// Pre-decoded frames are still mixed after the decoder reached the end.
+			if (predecoding || is_playing()) {
+				int mixed_frames = _pull_frames(internal_buffer + 4, INTERNAL_BUFFER_LEN);
 				if (mixed_frames != INTERNAL_BUFFER_LEN) {
 					// internal_buffer[mixed_frames] is the first frame of silence.
 					internal_buffer_end = mixed_frames;
@@ -474,6 +687,22 @@ void AudioStreamPlaybackRandomPitch::seek(float p_time) {
 	}
 }
 
+float AudioStreamPlaybackRandomPitch::get_length() const {
+	if (playing.is_valid()) {
+		return playing->get_length();
+	}
+
+	return 0;
+}
+
+bool AudioStreamPlaybackRandomPitch::get_loop_range(float &r_begin, float &r_end) const {
+	if (playing.is_valid()) {
+		return playing->get_loop_range(r_begin, r_end);
+	}
+
+	return false;
+}
+
 int AudioStreamPlaybackRandomPitch::mix(AudioFrame *p_buffer, float p_rate_scale, int p_frames) {
 	if (playing.is_valid()) {
 		return playing->mix(p_buffer, p_rate_scale * pitch_scale, p_frames);
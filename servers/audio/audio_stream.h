@@ -33,6 +33,10 @@
 
 #include "core/io/image.h"
 #include "core/io/resource.h"
+#include "core/os/mutex.h"
+#include "core/os/spin_lock.h"
+#include "core/os/worker_thread_pool.h"
+#include "core/templates/local_vector.h"
 #include "servers/audio/audio_filter_sw.h"
 #include "servers/audio_server.h"
 
@@ -62,6 +66,11 @@ public:
 	virtual float get_playback_position() const;
 	virtual void seek(float p_time);
 
+	// Lets the server keep track of playbacks it doesn't mix. The length is 0 when
+	// unknown or endless, and only looping playbacks return a loop range.
+	virtual float get_length() const { return 0; }
+	virtual bool get_loop_range(float &r_begin, float &r_end) const { return false; }
+
 	virtual int mix(AudioFrame *p_buffer, float p_rate_scale, int p_frames);
 };
 
@@ -80,16 +89,75 @@ class AudioStreamPlaybackResampled : public AudioStreamPlayback {
 	unsigned int internal_buffer_end = -1;
 	uint64_t mix_offset;
 
+	// Pre-decoding. A worker thread decodes ahead into the ring, so the mix only
+	// has to resample. Positions only grow, the ring size is a power of two.
+	struct PredecodeTask : public WorkerThreadPool::Task {
+		AudioStreamPlaybackResampled *playback = nullptr;
+		virtual void run() override;
+		// Runs on the workers only, never inline in a wait() on unrelated tasks.
+		PredecodeTask() { background = true; }
+	};
+
+	enum {
+		PREDECODE_CHUNK_LEN = INTERNAL_BUFFER_LEN * 4, // Frames decoded per lock of the decoder.
+		PREDECODE_MAX_MARKS = 8,
+	};
+
+	// Where the decoded position jumped (start, seek or loop), so the mixed
+	// position can be told from the decoded one.
+	struct PositionMark {
+		uint32_t frame = 0; // In ring positions.
+		float time = 0;
+	};
+
+	bool predecoding = false;
+	LocalVector<AudioFrame> predecode_ring;
+	uint32_t predecode_lookahead = 0;
+	float predecode_rate = 1;
+	SafeNumeric<uint32_t> predecode_read; // Only advanced by the mix.
+	SafeNumeric<uint32_t> predecode_write;
+	SafeNumeric<uint32_t> predecode_discard_to; // Frames before this were decoded before a seek.
+	SafeFlag predecode_queued;
+	PositionMark position_marks[PREDECODE_MAX_MARKS];
+	uint32_t position_mark_count = 0;
+	mutable SpinLock position_marks_lock;
+	PredecodeTask predecode_task;
+	WorkerThreadPool::Group predecode_group;
+
+	void _predecode(uint32_t p_frames);
+	void _queue_predecode();
+	uint32_t _get_predecode_read() const;
+	int _pull_frames(AudioFrame *p_buffer, int p_frames);
+
 protected:
+	// Held while decoding. Decoders that can be pre-decoded must hold it while
+	// they seek or stop and then call _discard_predecoded(), must call
+	// _finish_predecode() before starting and in their destructor, and report
+	// their position with _get_mixed_position().
+	BinaryMutex decoder_mutex;
+
 	void _begin_resample();
+	void _discard_predecoded();
+	void _finish_predecode();
+	// Time decoded ahead which wasn't mixed yet.
+	float _get_predecoded_time() const;
+	// Decoders call this with the decoder locked whenever their position jumps
+	// to p_time, p_offset frames into the current _mix_internal() call.
+	void _mark_position(float p_time, int p_offset = 0);
+	// Position of what was mixed, given where the decoder is.
+	float _get_mixed_position(float p_decoded_time) const;
+
 	// Returns the number of frames that were mixed.
 	virtual int _mix_internal(AudioFrame *p_buffer, int p_frames) = 0;
 	virtual float get_stream_sampling_rate() = 0;
+	// Only decoders reading from memory should be decoded ahead.
+	virtual bool _can_predecode() const { return false; }
 
 public:
 	virtual int mix(AudioFrame *p_buffer, float p_rate_scale, int p_frames) override;
 
-	AudioStreamPlaybackResampled() { mix_offset = 0; }
+	AudioStreamPlaybackResampled();
+	~AudioStreamPlaybackResampled();
 };
 
 class AudioStream : public Resource {
@@ -215,6 +283,9 @@ public:
 	virtual float get_playback_position() const override;
 	virtual void seek(float p_time) override;
 
+	virtual float get_length() const override;
+	virtual bool get_loop_range(float &r_begin, float &r_end) const override;
+
 	virtual int mix(AudioFrame *p_buffer, float p_rate_scale, int p_frames) override;
 
 	~AudioStreamPlaybackRandomPitch();
@@ -39,18 +39,122 @@
 #include "core/os/os.h"
 #include "core/string/string_name.h"
 #include "core/templates/pair.h"
+#include "core/templates/sort_array.h"
 #include "scene/resources/audio_stream_sample.h"
 #include "servers/audio/audio_driver_dummy.h"
 #include "servers/audio/effects/audio_effect_compressor.h"
 
 #include <cstring>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AUDIO_MIX_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AUDIO_MIX_NEON
+#endif
+
 #ifdef TOOLS_ENABLED
 #define MARK_EDITED set_edited(true);
 #else
 #define MARK_EDITED
 #endif
 
+// Mixing kernels, they work on two stereo frames at a time where SIMD is available.
+
+// r_dst[i] += p_src[i] * (p_vol_start + p_vol_step * i)
+static void _mix_frames_ramp(AudioFrame *r_dst, const AudioFrame *p_src, AudioFrame p_vol_start, AudioFrame p_vol_step, uint32_t p_frames) {
+	uint32_t i = 0;
+#if defined(AUDIO_MIX_SSE2)
+	float *dst = (float *)r_dst;
+	const float *src = (const float *)p_src;
+	const __m128 start = _mm_setr_ps(p_vol_start.l, p_vol_start.r, p_vol_start.l, p_vol_start.r);
+	const __m128 step = _mm_setr_ps(p_vol_step.l, p_vol_step.r, p_vol_step.l, p_vol_step.r);
+	const __m128 two = _mm_set1_ps(2.0f);
+	__m128 index = _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+	for (; i + 2 <= p_frames; i += 2) {
+		__m128 vol = _mm_add_ps(start, _mm_mul_ps(step, index));
+		_mm_storeu_ps(dst + i * 2, _mm_add_ps(_mm_loadu_ps(dst + i * 2), _mm_mul_ps(vol, _mm_loadu_ps(src + i * 2))));
+		index = _mm_add_ps(index, two);
+	}
+#elif defined(AUDIO_MIX_NEON)
+	float *dst = (float *)r_dst;
+	const float *src = (const float *)p_src;
+	const float start_values[4] = { p_vol_start.l, p_vol_start.r, p_vol_start.l, p_vol_start.r };
+	const float step_values[4] = { p_vol_step.l, p_vol_step.r, p_vol_step.l, p_vol_step.r };
+	const float index_values[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+	const float32x4_t start = vld1q_f32(start_values);
+	const float32x4_t step = vld1q_f32(step_values);
+	const float32x4_t two = vdupq_n_f32(2.0f);
+	float32x4_t index = vld1q_f32(index_values);
+	for (; i + 2 <= p_frames; i += 2) {
+		float32x4_t vol = vaddq_f32(start, vmulq_f32(step, index));
+		vst1q_f32(dst + i * 2, vaddq_f32(vld1q_f32(dst + i * 2), vmulq_f32(vol, vld1q_f32(src + i * 2))));
+		index = vaddq_f32(index, two);
+	}
+#endif
+	for (; i < p_frames; i++) {
+		r_dst[i] += (p_vol_start + p_vol_step * float(i)) * p_src[i];
+	}
+}
+
+// Scales the frames and returns their peak.
+static AudioFrame _scale_frames(AudioFrame *r_buf, float p_volume, uint32_t p_frames) {
+	AudioFrame peak = AudioFrame(0, 0);
+	uint32_t i = 0;
+#if defined(AUDIO_MIX_SSE2)
+	float *buf = (float *)r_buf;
+	const __m128 volume = _mm_set1_ps(p_volume);
+	const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	__m128 peaks = _mm_setzero_ps();
+	for (; i + 2 <= p_frames; i += 2) {
+		__m128 frames = _mm_mul_ps(_mm_loadu_ps(buf + i * 2), volume);
+		_mm_storeu_ps(buf + i * 2, frames);
+		peaks = _mm_max_ps(peaks, _mm_and_ps(frames, abs_mask));
+	}
+	float lanes[4];
+	_mm_storeu_ps(lanes, peaks);
+	peak = AudioFrame(MAX(lanes[0], lanes[2]), MAX(lanes[1], lanes[3]));
+#elif defined(AUDIO_MIX_NEON)
+	float *buf = (float *)r_buf;
+	float32x4_t peaks = vdupq_n_f32(0.0f);
+	for (; i + 2 <= p_frames; i += 2) {
+		float32x4_t frames = vmulq_n_f32(vld1q_f32(buf + i * 2), p_volume);
+		vst1q_f32(buf + i * 2, frames);
+		peaks = vmaxq_f32(peaks, vabsq_f32(frames));
+	}
+	float lanes[4];
+	vst1q_f32(lanes, peaks);
+	peak = AudioFrame(MAX(lanes[0], lanes[2]), MAX(lanes[1], lanes[3]));
+#endif
+	for (; i < p_frames; i++) {
+		r_buf[i] *= p_volume;
+		peak.l = MAX(peak.l, ABS(r_buf[i].l));
+		peak.r = MAX(peak.r, ABS(r_buf[i].r));
+	}
+	return peak;
+}
+
+static void _add_frames(AudioFrame *r_dst, const AudioFrame *p_src, uint32_t p_frames) {
+	uint32_t i = 0;
+#if defined(AUDIO_MIX_SSE2)
+	float *dst = (float *)r_dst;
+	const float *src = (const float *)p_src;
+	for (; i + 2 <= p_frames; i += 2) {
+		_mm_storeu_ps(dst + i * 2, _mm_add_ps(_mm_loadu_ps(dst + i * 2), _mm_loadu_ps(src + i * 2)));
+	}
+#elif defined(AUDIO_MIX_NEON)
+	float *dst = (float *)r_dst;
+	const float *src = (const float *)p_src;
+	for (; i + 2 <= p_frames; i += 2) {
+		vst1q_f32(dst + i * 2, vaddq_f32(vld1q_f32(dst + i * 2), vld1q_f32(src + i * 2)));
+	}
+#endif
+	for (; i < p_frames; i++) {
+		r_dst[i] += p_src[i];
+	}
+}
+
 AudioDriver *AudioDriver::singleton = nullptr;
 AudioDriver *AudioDriver::get_singleton() {
 	return singleton;
@@ -302,7 +406,7 @@ void AudioServer::_driver_process(int p_frames, int32_t *p_buffer) {
 }
 
 void AudioServer::_mix_step() {
-	bool solo_mode = false;
+	solo_mode = false;
 
 	for (int i = 0; i < buses.size(); i++) {
 		Bus *bus = buses[i];
@@ -342,6 +446,11 @@ void AudioServer::_mix_step() {
 		ci->callback(ci->userdata);
 	}
 
+	_update_voices();
+
+	uint32_t real_voices = 0;
+	uint32_t virtual_voices = 0;
+
 	for (AudioStreamPlaybackListNode *playback : playback_list) {
 		// Paused streams are no-ops. Don't even mix audio from the stream playback.
 		if (playback->state.load() == AudioStreamPlaybackListNode::PAUSED) {
@@ -350,6 +459,32 @@ void AudioServer::_mix_step() {
 
 		bool fading_out = playback->state.load() == AudioStreamPlaybackListNode::FADE_OUT_TO_DELETION || playback->state.load() == AudioStreamPlaybackListNode::FADE_OUT_TO_PAUSE;
 
+		// Voices that can't be heard, or that lost their place to louder ones, fade out and then stop being mixed.
+		bool silenced = playback->audibility == 0 || playback->over_voice_limit;
+		if (silenced && (playback->is_virtual || _get_audibility(playback->prev_bus_details) == 0)) {
+			if (!playback->is_virtual) {
+				playback->is_virtual = true;
+				playback->virtual_time = 0;
+				for (AudioFrame &frame : playback->lookahead) {
+					frame = AudioFrame(0, 0);
+				}
+			}
+			// Keep track of where the stream would be, so it resumes in time.
+			playback->virtual_time += buffer_size * playback->pitch_scale.get() * playback_speed_scale / get_mix_rate();
+			_advance_virtual_voice(playback);
+			virtual_voices++;
+
+			_update_playback_state(playback);
+			continue;
+		}
+
+		if (playback->is_virtual) {
+			// The previous volumes are silent, so this ramps up from nothing.
+			playback->is_virtual = false;
+			playback->stream_playback->seek(playback->stream_playback->get_playback_position() + playback->virtual_time);
+		}
+		real_voices++;
+
 		AudioFrame *buf = mix_buffer.ptrw();
 
 		// Copy the lookeahead buffer into the mix buffer.
@@ -405,7 +540,7 @@ void AudioServer::_mix_step() {
 
 			for (int channel_idx = 0; channel_idx < channel_count; channel_idx++) {
 				AudioFrame *channel_buf = thread_get_channel_mix_buffer(bus_idx, channel_idx);
-				if (fading_out) {
+				if (fading_out || silenced) {
 					bus_details.volume[idx][channel_idx] = AudioFrame(0, 0);
 				}
 				AudioFrame channel_vol = bus_details.volume[idx][channel_idx];
@@ -451,81 +586,24 @@ void AudioServer::_mix_step() {
 			std::copy(std::begin(bus_details.volume[bus_idx]), std::end(bus_details.volume[bus_idx]), std::begin(playback->prev_bus_details->volume[bus_idx]));
 		}
 
-		switch (playback->state.load()) {
-			case AudioStreamPlaybackListNode::AWAITING_DELETION:
-			case AudioStreamPlaybackListNode::FADE_OUT_TO_DELETION:
-				playback_list.erase(playback, [](AudioStreamPlaybackListNode *p) {
-					if (p->prev_bus_details)
-						delete p->prev_bus_details;
-					if (p->bus_details)
-						delete p->bus_details;
-					p->stream_playback.unref();
-					delete p;
-				});
-				break;
-			case AudioStreamPlaybackListNode::FADE_OUT_TO_PAUSE: {
-				// Pause the stream.
-				AudioStreamPlaybackListNode::PlaybackState old_state, new_state;
-				do {
-					old_state = playback->state.load();
-					new_state = AudioStreamPlaybackListNode::PAUSED;
-				} while (!playback->state.compare_exchange_strong(/* expected= */ old_state, new_state));
-			} break;
-			case AudioStreamPlaybackListNode::PLAYING:
-			case AudioStreamPlaybackListNode::PAUSED:
-				// No-op!
-				break;
-		}
+		_update_playback_state(playback);
 	}
 
-	for (int i = buses.size() - 1; i >= 0; i--) {
-		//go bus by bus
-		Bus *bus = buses[i];
-
-		for (int k = 0; k < bus->channels.size(); k++) {
-			if (bus->channels[k].active && !bus->channels[k].used) {
-				//buffer was not used, but it's still active, so it must be cleaned
-				AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
-
-				for (uint32_t j = 0; j < buffer_size; j++) {
-					buf[j] = AudioFrame(0, 0);
-				}
-			}
-		}
-
-		//process effects
-		if (!bus->bypass) {
-			for (int j = 0; j < bus->effects.size(); j++) {
-				if (!bus->effects[j].enabled) {
-					continue;
-				}
+	real_voice_count.set(real_voices);
+	virtual_voice_count.set(virtual_voices);
 
-#ifdef DEBUG_ENABLED
-				uint64_t ticks = OS::get_singleton()->get_ticks_usec();
-#endif
-
-				for (int k = 0; k < bus->channels.size(); k++) {
-					if (!(bus->channels[k].active || bus->channels[k].effect_instances[j]->process_silence())) {
-						continue;
-					}
-					bus->channels.write[k].effect_instances.write[j]->process(bus->channels[k].buffer.ptr(), temp_buffer.write[k].ptrw(), buffer_size);
-				}
-
-				//swap buffers, so internal buffer always has the right data
-				for (int k = 0; k < bus->channels.size(); k++) {
-					if (!(buses[i]->channels[k].active || bus->channels[k].effect_instances[j]->process_silence())) {
-						continue;
-					}
-					SWAP(bus->channels.write[k].buffer, temp_buffer.write[k]);
-				}
-
-#ifdef DEBUG_ENABLED
-				bus->effects.write[j].prof_time += OS::get_singleton()->get_ticks_usec() - ticks;
-#endif
-			}
-		}
+	// Resolve where each bus sends and how deep it sits in the send tree. Sends
+	// always go to a lower index, so walking backwards sees every bus after all
+	// the buses sending to it.
+	int bus_count = buses.size();
+	bus_sends.resize(bus_count);
+	bus_depths.resize(bus_count);
+	for (int i = 0; i < bus_count; i++) {
+		bus_depths[i] = 0;
+	}
 
-		//process send
+	for (int i = bus_count - 1; i >= 0; i--) {
+		Bus *bus = buses[i];
 
 		Bus *send = nullptr;
 
@@ -541,71 +619,284 @@ void AudioServer::_mix_step() {
 			}
 		}
 
-		for (int k = 0; k < bus->channels.size(); k++) {
-			if (!bus->channels[k].active) {
-				bus->channels.write[k].peak_volume = AudioFrame(AUDIO_MIN_PEAK_DB, AUDIO_MIN_PEAK_DB);
+		bus_sends[i] = send ? send->index_cache : -1;
+		if (send) {
+			bus_depths[send->index_cache] = MAX(bus_depths[send->index_cache], bus_depths[i] + 1);
+		}
+	}
+
+	// Buses at the same depth don't feed each other, only the master bus is left at the deepest one.
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	for (int depth = 0; depth <= bus_depths[0]; depth++) {
+		LocalVector<int> &parallel_buses = bus_process_task.buses;
+		parallel_buses.clear();
+		depth_buses.clear();
+		sidechain_buses.clear();
+
+		int buses_with_effects = 0;
+		for (int i = bus_count - 1; i >= 0; i--) {
+			if (bus_depths[i] != depth) {
 				continue;
 			}
+			depth_buses.push_back(i);
+			// A sidechain reads the buffer of another bus, which may be at the same
+			// depth. These run once the others are done, so they see it processed.
+			if (_has_sidechain(i)) {
+				sidechain_buses.push_back(i);
+				continue;
+			}
+			parallel_buses.push_back(i);
+			if (!buses[i]->bypass && buses[i]->effects.size()) {
+				buses_with_effects++;
+			}
+		}
 
-			AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
+		if (buses_with_effects > 1 && pool && pool->get_thread_count() > 0) {
+			bus_process_task.next_bus.set(0);
+			pool->add_task(&bus_process_task, WorkerThreadPool::PRIORITY_HIGH, &bus_process_task.group, nullptr, MIN(parallel_buses.size(), pool->get_thread_count() + 1));
+			// Running unrelated tasks here could make the mix miss its deadline.
+			pool->wait(&bus_process_task.group, true);
+		} else {
+			for (uint32_t j = 0; j < parallel_buses.size(); j++) {
+				_process_bus(parallel_buses[j]);
+			}
+		}
 
-			AudioFrame peak = AudioFrame(0, 0);
+		for (uint32_t j = 0; j < sidechain_buses.size(); j++) {
+			_process_bus(sidechain_buses[j]);
+		}
 
-			float volume = Math::db2linear(bus->volume_db);
+		// Several buses may send to the same one, so sends are mixed here in bus order.
+		for (uint32_t j = 0; j < depth_buses.size(); j++) {
+			int i = depth_buses[j];
+			if (bus_sends[i] < 0) {
+				continue;
+			}
 
-			if (solo_mode) {
-				if (!bus->soloed) {
-					volume = 0.0;
-				}
-			} else {
-				if (bus->mute) {
-					volume = 0.0;
+			Bus *bus = buses[i];
+			for (int k = 0; k < bus->channels.size(); k++) {
+				if (!bus->channels[k].active) {
+					continue;
 				}
+				AudioFrame *target_buf = thread_get_channel_mix_buffer(bus_sends[i], k);
+				_add_frames(target_buf, bus->channels[k].buffer.ptr(), buffer_size);
 			}
+		}
+	}
+
+	mix_frames += buffer_size;
+	to_mix = buffer_size;
+}
+
+bool AudioServer::_has_sidechain(int p_bus) const {
+	const Bus *bus = buses[p_bus];
+	if (bus->bypass) {
+		return false;
+	}
+	for (int i = 0; i < bus->effects.size(); i++) {
+		if (!bus->effects[i].enabled) {
+			continue;
+		}
+		const AudioEffectCompressor *compressor = Object::cast_to<AudioEffectCompressor>(bus->effects[i].effect.ptr());
+		if (compressor && compressor->get_sidechain() != StringName()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void AudioServer::_advance_virtual_voice(AudioStreamPlaybackListNode *p_playback) {
+	Ref<AudioStreamPlayback> &stream_playback = p_playback->stream_playback;
+	float length = stream_playback->get_length();
+	if (length <= 0) {
+		return; // Endless, or nothing to compare with.
+	}
+
+	float position = stream_playback->get_playback_position();
+	float loop_begin = 0;
+	float loop_end = 0;
+	if (stream_playback->get_loop_range(loop_begin, loop_end)) {
+		// Seeking past the end doesn't loop, so stay within the loop.
+		if (loop_end > loop_begin && position + p_playback->virtual_time >= loop_end) {
+			float looped = loop_begin + Math::fposmod(position + p_playback->virtual_time - loop_begin, loop_end - loop_begin);
+			p_playback->virtual_time = looped - position;
+		}
+	} else if (position + p_playback->virtual_time >= length) {
+		// Ended while it couldn't be heard.
+		p_playback->state.store(AudioStreamPlaybackListNode::AWAITING_DELETION);
+	}
+}
+
+void AudioServer::BusProcessTask::run() {
+	const uint32_t count = buses.size();
+	while (true) {
+		const uint32_t i = next_bus.postincrement();
+		if (i >= count) {
+			break;
+		}
+		server->_process_bus(buses[i]);
+	}
+}
+
+void AudioServer::_process_bus(int p_bus) {
+	// Runs on worker threads, so only this bus may be touched here.
+	Bus *bus = buses[p_bus];
+
+	for (int k = 0; k < bus->channels.size(); k++) {
+		if (bus->channels[k].active && !bus->channels[k].used) {
+			//buffer was not used, but it's still active, so it must be cleaned
+			AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
 
-			//apply volume and compute peak
 			for (uint32_t j = 0; j < buffer_size; j++) {
-				buf[j] *= volume;
+				buf[j] = AudioFrame(0, 0);
+			}
+		}
+	}
+
+	//process effects
+	if (!bus->bypass) {
+		for (int j = 0; j < bus->effects.size(); j++) {
+			if (!bus->effects[j].enabled) {
+				continue;
+			}
 
-				float l = ABS(buf[j].l);
-				if (l > peak.l) {
-					peak.l = l;
+#ifdef DEBUG_ENABLED
+			uint64_t ticks = OS::get_singleton()->get_ticks_usec();
+#endif
+
+			for (int k = 0; k < bus->channels.size(); k++) {
+				if (!(bus->channels[k].active || bus->channels[k].effect_instances[j]->process_silence())) {
+					continue;
 				}
-				float r = ABS(buf[j].r);
-				if (r > peak.r) {
-					peak.r = r;
+				bus->channels.write[k].effect_instances.write[j]->process(bus->channels[k].buffer.ptr(), bus->channels.write[k].temp_buffer.ptrw(), buffer_size);
+			}
+
+			//swap buffers, so internal buffer always has the right data
+			for (int k = 0; k < bus->channels.size(); k++) {
+				if (!(bus->channels[k].active || bus->channels[k].effect_instances[j]->process_silence())) {
+					continue;
 				}
+				Bus::Channel &channel = bus->channels.write[k];
+				SWAP(channel.buffer, channel.temp_buffer);
 			}
 
-			bus->channels.write[k].peak_volume = AudioFrame(Math::linear2db(peak.l + AUDIO_PEAK_OFFSET), Math::linear2db(peak.r + AUDIO_PEAK_OFFSET));
+#ifdef DEBUG_ENABLED
+			bus->effects.write[j].prof_time += OS::get_singleton()->get_ticks_usec() - ticks;
+#endif
+		}
+	}
 
-			if (!bus->channels[k].used) {
-				//see if any audio is contained, because channel was not used
+	for (int k = 0; k < bus->channels.size(); k++) {
+		if (!bus->channels[k].active) {
+			bus->channels.write[k].peak_volume = AudioFrame(AUDIO_MIN_PEAK_DB, AUDIO_MIN_PEAK_DB);
+			continue;
+		}
 
-				if (MAX(peak.r, peak.l) > Math::db2linear(channel_disable_threshold_db)) {
-					bus->channels.write[k].last_mix_with_audio = mix_frames;
-				} else if (mix_frames - bus->channels[k].last_mix_with_audio > channel_disable_frames) {
-					bus->channels.write[k].active = false;
-					continue; //went inactive, don't mix.
-				}
+		AudioFrame *buf = bus->channels.write[k].buffer.ptrw();
+
+		float volume = Math::db2linear(bus->volume_db);
+
+		if (solo_mode) {
+			if (!bus->soloed) {
+				volume = 0.0;
 			}
+		} else {
+			if (bus->mute) {
+				volume = 0.0;
+			}
+		}
 
-			if (send) {
-				//if not master bus, send
-				AudioFrame *target_buf = thread_get_channel_mix_buffer(send->index_cache, k);
+		//apply volume and compute peak
+		AudioFrame peak = _scale_frames(buf, volume, buffer_size);
 
-				for (uint32_t j = 0; j < buffer_size; j++) {
-					target_buf[j] += buf[j];
-				}
+		bus->channels.write[k].peak_volume = AudioFrame(Math::linear2db(peak.l + AUDIO_PEAK_OFFSET), Math::linear2db(peak.r + AUDIO_PEAK_OFFSET));
+
+		if (!bus->channels[k].used) {
+			//see if any audio is contained, because channel was not used
+
+			if (MAX(peak.r, peak.l) > Math::db2linear(channel_disable_threshold_db)) {
+				bus->channels.write[k].last_mix_with_audio = mix_frames;
+			} else if (mix_frames - bus->channels[k].last_mix_with_audio > channel_disable_frames) {
+				bus->channels.write[k].active = false; //went inactive, don't send.
 			}
 		}
 	}
+}
 
-	mix_frames += buffer_size;
-	to_mix = buffer_size;
+void AudioServer::_update_voices() {
+	voice_order.clear();
+
+	for (AudioStreamPlaybackListNode *playback : playback_list) {
+		playback->over_voice_limit = false;
+		if (playback->state.load() == AudioStreamPlaybackListNode::PAUSED) {
+			continue;
+		}
+
+		AudioStreamPlaybackBusDetails *details = playback->bus_details.load();
+		playback->audibility = details ? _get_audibility(details) : 0;
+		if (playback->audibility > 0) {
+			voice_order.push_back(playback);
+		}
+	}
+
+	if (max_real_voices <= 0 || (int)voice_order.size() <= max_real_voices) {
+		return;
+	}
+
+	// Only the loudest voices stay real.
+	SortArray<AudioStreamPlaybackListNode *, VoiceAudibilityComparator> sorter;
+	sorter.sort(voice_order.ptr(), voice_order.size());
+	for (uint32_t i = max_real_voices; i < voice_order.size(); i++) {
+		voice_order[i]->over_voice_limit = true;
+	}
+}
+
+float AudioServer::_get_audibility(const AudioStreamPlaybackBusDetails *p_details) const {
+	float audibility = 0;
+	for (int idx = 0; idx < MAX_BUSES_PER_PLAYBACK; idx++) {
+		if (!p_details->bus_active[idx]) {
+			continue;
+		}
+		for (int channel_idx = 0; channel_idx < channel_count; channel_idx++) {
+			const AudioFrame &vol = p_details->volume[idx][channel_idx];
+			audibility = MAX(audibility, MAX(ABS(vol.l), ABS(vol.r)));
+		}
+	}
+	return audibility;
+}
+
+void AudioServer::_update_playback_state(AudioStreamPlaybackListNode *p_playback) {
+	switch (p_playback->state.load()) {
+		case AudioStreamPlaybackListNode::AWAITING_DELETION:
+		case AudioStreamPlaybackListNode::FADE_OUT_TO_DELETION:
+			playback_list.erase(p_playback, [](AudioStreamPlaybackListNode *p) {
+				if (p->prev_bus_details)
+					delete p->prev_bus_details;
+				if (p->bus_details)
+					delete p->bus_details;
+				p->stream_playback.unref();
+				delete p;
+			});
+			break;
+		case AudioStreamPlaybackListNode::FADE_OUT_TO_PAUSE: {
+			// Pause the stream.
+			AudioStreamPlaybackListNode::PlaybackState old_state, new_state;
+			do {
+				old_state = p_playback->state.load();
+				new_state = AudioStreamPlaybackListNode::PAUSED;
+			} while (!p_playback->state.compare_exchange_strong(/* expected= */ old_state, new_state));
+		} break;
+		case AudioStreamPlaybackListNode::PLAYING:
+		case AudioStreamPlaybackListNode::PAUSED:
+			// No-op!
+			break;
+	}
 }
 
 void AudioServer::_mix_step_for_channel(AudioFrame *p_out_buf, AudioFrame *p_source_buf, AudioFrame p_vol_start, AudioFrame p_vol_final, float p_attenuation_filter_cutoff_hz, float p_highshelf_gain, AudioFilterSW::Processor *p_processor_l, AudioFilterSW::Processor *p_processor_r) {
+	// Make this buffer size invariant if buffer_size ever becomes a project setting.
+	AudioFrame vol_step = (p_vol_final - p_vol_start) / float(buffer_size);
+
 	if (p_highshelf_gain != 0) {
 		AudioFilterSW filter;
 		filter.set_mode(AudioFilterSW::HIGHSHELF);
@@ -624,10 +915,9 @@ void AudioServer::_mix_step_for_channel(AudioFrame *p_out_buf, AudioFrame *p_sou
 		p_processor_r->set_filter(&filter, /* clear_history= */ is_just_started);
 		p_processor_r->update_coeffs(buffer_size);
 
+		// The filter is recursive, so this one can't be mixed in parallel.
 		for (unsigned int frame_idx = 0; frame_idx < buffer_size; frame_idx++) {
-			// Make this buffer size invariant if buffer_size ever becomes a project setting.
-			float lerp_param = (float)frame_idx / buffer_size;
-			AudioFrame vol = p_vol_final * lerp_param + (1 - lerp_param) * p_vol_start;
+			AudioFrame vol = p_vol_start + vol_step * float(frame_idx);
 			AudioFrame mixed = vol * p_source_buf[frame_idx];
 			p_processor_l->process_one_interp(mixed.l);
 			p_processor_r->process_one_interp(mixed.r);
@@ -635,11 +925,7 @@ void AudioServer::_mix_step_for_channel(AudioFrame *p_out_buf, AudioFrame *p_sou
 		}
 
 	} else {
-		for (unsigned int frame_idx = 0; frame_idx < buffer_size; frame_idx++) {
-			// Make this buffer size invariant if buffer_size ever becomes a project setting.
-			float lerp_param = (float)frame_idx / buffer_size;
-			p_out_buf[frame_idx] += (p_vol_final * lerp_param + (1 - lerp_param) * p_vol_start) * p_source_buf[frame_idx];
-		}
+		_mix_frames_ramp(p_out_buf, p_source_buf, p_vol_start, vol_step, buffer_size);
 	}
 }
 
@@ -734,6 +1020,7 @@ void AudioServer::set_bus_count(int p_count) {
 		buses.write[i]->channels.resize(channel_count);
 		for (int j = 0; j < channel_count; j++) {
 			buses.write[i]->channels.write[j].buffer.resize(buffer_size);
+			buses.write[i]->channels.write[j].temp_buffer.resize(buffer_size);
 		}
 		buses[i]->name = attempt;
 		buses[i]->solo = false;
@@ -803,6 +1090,7 @@ void AudioServer::add_bus(int p_at_pos) {
 	bus->channels.resize(channel_count);
 	for (int j = 0; j < channel_count; j++) {
 		bus->channels.write[j].buffer.resize(buffer_size);
+		bus->channels.write[j].temp_buffer.resize(buffer_size);
 	}
 	bus->name = attempt;
 	bus->solo = false;
@@ -1314,6 +1602,18 @@ bool AudioServer::is_playback_paused(Ref<AudioStreamPlayback> p_playback) {
 	return playback_node->state.load() == AudioStreamPlaybackListNode::PAUSED || playback_node->state.load() == AudioStreamPlaybackListNode::FADE_OUT_TO_PAUSE;
 }
 
+int AudioServer::get_real_voice_count() const {
+	return real_voice_count.get();
+}
+
+int AudioServer::get_virtual_voice_count() const {
+	return virtual_voice_count.get();
+}
+
+float AudioServer::get_predecode_lookahead() const {
+	return predecode_lookahead;
+}
+
 uint64_t AudioServer::get_mix_count() const {
 	return mix_count;
 }
@@ -1326,17 +1626,13 @@ void AudioServer::notify_listener_changed() {
 
 void AudioServer::init_channels_and_buffers() {
 	channel_count = get_channel_count();
-	temp_buffer.resize(channel_count);
 	mix_buffer.resize(buffer_size + LOOKAHEAD_BUFFER_SIZE);
 
-	for (int i = 0; i < temp_buffer.size(); i++) {
-		temp_buffer.write[i].resize(buffer_size);
-	}
-
 	for (int i = 0; i < buses.size(); i++) {
 		buses[i]->channels.resize(channel_count);
 		for (int j = 0; j < channel_count; j++) {
 			buses.write[i]->channels.write[j].buffer.resize(buffer_size);
+			buses.write[i]->channels.write[j].temp_buffer.resize(buffer_size);
 		}
 	}
 }
@@ -1345,6 +1641,10 @@ void AudioServer::init() {
 	channel_disable_threshold_db = GLOBAL_DEF_RST("audio/buses/channel_disable_threshold_db", -60.0);
 	channel_disable_frames = float(GLOBAL_DEF_RST("audio/buses/channel_disable_time", 2.0)) * get_mix_rate();
 	ProjectSettings::get_singleton()->set_custom_property_info("audio/buses/channel_disable_time", PropertyInfo(Variant::FLOAT, "audio/buses/channel_disable_time", PROPERTY_HINT_RANGE, "0,5,0.01,or_greater"));
+	max_real_voices = GLOBAL_DEF_RST("audio/voices/max_real_voices", 0);
+	predecode_lookahead = int(GLOBAL_DEF_RST("audio/streams/predecode_lookahead_ms", 100)) / 1000.0;
+	ProjectSettings::get_singleton()->set_custom_property_info("audio/streams/predecode_lookahead_ms", PropertyInfo(Variant::INT, "audio/streams/predecode_lookahead_ms", PROPERTY_HINT_RANGE, "0,1000,1,or_greater"));
+	ProjectSettings::get_singleton()->set_custom_property_info("audio/voices/max_real_voices", PropertyInfo(Variant::INT, "audio/voices/max_real_voices", PROPERTY_HINT_RANGE, "0,256,1,or_greater"));
 	buffer_size = 512; //hardcoded for now
 
 	init_channels_and_buffers();
@@ -1407,6 +1707,8 @@ void AudioServer::update() {
 		values.push_back(USEC_TO_SEC(server_time));
 		values.push_back("audio_driver");
 		values.push_back(USEC_TO_SEC(driver_time));
+		values.push_back("audio_decode");
+		values.push_back(USEC_TO_SEC(decode_time.get()));
 
 		values.push_front("audio_thread");
 		EngineDebugger::profiler_add_frame_data("servers", values);
@@ -1430,6 +1732,7 @@ void AudioServer::update() {
 
 	AudioDriver::get_singleton()->reset_profiling_time();
 	prof_time = 0;
+	decode_time.set(0);
 #endif
 
 	for (CallbackItem *ci : update_callback_list) {
@@ -1601,6 +1904,7 @@ void AudioServer::set_bus_layout(const Ref<AudioBusLayout> &p_bus_layout) {
 		buses[i]->channels.resize(channel_count);
 		for (int j = 0; j < channel_count; j++) {
 			buses.write[i]->channels.write[j].buffer.resize(buffer_size);
+			buses.write[i]->channels.write[j].temp_buffer.resize(buffer_size);
 		}
 		_update_bus_effects(i);
 	}
@@ -1747,6 +2051,7 @@ AudioServer::AudioServer() {
 	mix_time = 0;
 	mix_size = 0;
 	playback_speed_scale = 1;
+	bus_process_task.server = this;
 }
 
 AudioServer::~AudioServer() {
@@ -34,6 +34,8 @@
 #include "core/math/audio_frame.h"
 #include "core/object/class_db.h"
 #include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/safe_list.h"
 #include "core/variant/variant.h"
 #include "servers/audio/audio_effect.h"
@@ -177,13 +179,20 @@ private:
 	uint64_t mix_frames;
 #ifdef DEBUG_ENABLED
 	uint64_t prof_time;
+	SafeNumeric<uint64_t> decode_time; // Decoding ahead happens on worker threads.
 #endif
 
 	float channel_disable_threshold_db;
 	uint32_t channel_disable_frames;
 
+	int max_real_voices = 0; // Zero means no limit.
+	float predecode_lookahead = 0;
+	SafeNumeric<uint32_t> real_voice_count;
+	SafeNumeric<uint32_t> virtual_voice_count;
+
 	int channel_count;
 	int to_mix;
+	bool solo_mode = false;
 
 	float playback_speed_scale;
 
@@ -201,6 +210,7 @@ private:
 			bool active;
 			AudioFrame peak_volume;
 			Vector<AudioFrame> buffer;
+			Vector<AudioFrame> temp_buffer; // Effects write here, then it's swapped with buffer.
 			Vector<Ref<AudioEffectInstance>> effect_instances;
 			uint64_t last_mix_with_audio;
 			Channel() {
@@ -257,6 +267,11 @@ private:
 		AudioStreamPlaybackBusDetails *prev_bus_details = nullptr;
 		// The next few samples are stored here so we have some time to fade audio out if it ends abruptly at the beginning of the next mix.
 		AudioFrame lookahead[LOOKAHEAD_BUFFER_SIZE];
+		// Virtual voices are inaudible, they are not mixed but their position keeps advancing. Audio thread only.
+		bool is_virtual = false;
+		bool over_voice_limit = false;
+		float virtual_time = 0;
+		float audibility = 0;
 	};
 
 	SafeList<AudioStreamPlaybackListNode *> playback_list;
@@ -265,11 +280,37 @@ private:
 	// TODO document if this is necessary.
 	SafeList<AudioStreamPlaybackBusDetails *> bus_details_graveyard_frame_old;
 
-	Vector<Vector<AudioFrame>> temp_buffer; //temp_buffer for each level
 	Vector<AudioFrame> mix_buffer;
 	Vector<Bus *> buses;
 	Map<StringName, Bus *> bus_map;
 
+	struct VoiceAudibilityComparator {
+		_FORCE_INLINE_ bool operator()(const AudioStreamPlaybackListNode *p_a, const AudioStreamPlaybackListNode *p_b) const {
+			// On ties voices that are already real win, so they don't swap every mix.
+			return p_a->audibility > p_b->audibility || (p_a->audibility == p_b->audibility && !p_a->is_virtual && p_b->is_virtual);
+		}
+	};
+
+	// Playbacks sorted by audibility, to pick the real voices when they are limited.
+	LocalVector<AudioStreamPlaybackListNode *> voice_order;
+
+	// Buses only depend on the buses sending to them, so the ones at the same
+	// depth of the send tree run their effects in parallel.
+	struct BusProcessTask : public WorkerThreadPool::Task {
+		AudioServer *server = nullptr;
+		LocalVector<int> buses;
+		SafeNumeric<uint32_t> next_bus;
+		WorkerThreadPool::Group group;
+
+		virtual void run() override;
+	};
+
+	BusProcessTask bus_process_task;
+	LocalVector<int> bus_sends;
+	LocalVector<int> bus_depths;
+	LocalVector<int> depth_buses;
+	LocalVector<int> sidechain_buses; // Processed after the rest of their depth.
+
 	void _update_bus_effects(int p_bus);
 
 	static AudioServer *singleton;
@@ -277,6 +318,12 @@ private:
 	void init_channels_and_buffers();
 
 	void _mix_step();
+	void _update_voices();
+	float _get_audibility(const AudioStreamPlaybackBusDetails *p_details) const;
+	void _update_playback_state(AudioStreamPlaybackListNode *p_playback);
+	void _advance_virtual_voice(AudioStreamPlaybackListNode *p_playback);
+	bool _has_sidechain(int p_bus) const;
+	void _process_bus(int p_bus);
 	void _mix_step_for_channel(AudioFrame *p_out_buf, AudioFrame *p_source_buf, AudioFrame p_vol_start, AudioFrame p_vol_final, float p_attenuation_filter_cutoff_hz, float p_highshelf_gain, AudioFilterSW::Processor *p_processor_l, AudioFilterSW::Processor *p_processor_r);
 
 	// Should only be called on the main thread.
@@ -317,6 +364,9 @@ public:
 	AudioFrame *thread_get_channel_mix_buffer(int p_bus, int p_buffer);
 	int thread_get_mix_buffer_size() const;
 	int thread_find_bus_index(const StringName &p_name);
+#ifdef DEBUG_ENABLED
+	void thread_add_decode_time(uint64_t p_usec) { decode_time.add(p_usec); }
+#endif
 
 	void set_bus_count(int p_count);
 	int get_bus_count() const;
@@ -384,6 +434,13 @@ public:
 	float get_playback_position(Ref<AudioStreamPlayback> p_playback);
 	bool is_playback_paused(Ref<AudioStreamPlayback> p_playback);
 
+	// Voices counted during the last mix, virtual ones are playing but not mixed.
+	int get_real_voice_count() const;
+	int get_virtual_voice_count() const;
+
+	// How far ahead compressed streams are decoded, in seconds.
+	float get_predecode_lookahead() const;
+
 	uint64_t get_mix_count() const;
 
 	void notify_listener_changed();
@@ -95,6 +95,13 @@ public:
 	virtual Vector3 map_get_closest_point_normal(RID p_map, const Vector3 &p_point) const = 0;
 	virtual RID map_get_closest_point_owner(RID p_map, const Vector3 &p_point) const = 0;
 
+	/// Solve a batch of path queries on the worker threads.
+	/// `p_layers` holds either one mask per query, a single mask shared by
+	/// all of them, or nothing to use the default layer.
+	/// On the next `process` the callback receives an `Array` with one
+	/// `PackedVector3Array` per query, in the submission order.
+	virtual void map_get_paths_async(RID p_map, const Vector<Vector3> &p_origins, const Vector<Vector3> &p_destinations, bool p_optimize, const Vector<int32_t> &p_layers, const Callable &p_callback) const = 0;
+
 	/// Creates a new region.
 	virtual RID region_create() const = 0;
 
@@ -184,6 +191,15 @@ public:
 	/// Control activation of this server.
 	virtual void set_active(bool p_active) const = 0;
 
+	enum ProcessInfo {
+		INFO_QUERY_COUNT,
+		INFO_QUERY_TIME,
+	};
+
+	/// Statistics about the queries run during the last `process` frame.
+	/// `INFO_QUERY_TIME` is in microseconds.
+	virtual int get_process_info(ProcessInfo p_info) const = 0;
+
 	/// Process the collision avoidance agents.
 	/// The result of this process is needed by the physics server,
 	/// so this must be called in the main thread.
@@ -194,6 +210,8 @@ public:
 	virtual ~NavigationServer3D();
 };
 
+VARIANT_ENUM_CAST(NavigationServer3D::ProcessInfo);
+
 typedef NavigationServer3D *(*NavigationServer3DCallback)();
 
 /// Manager used for the server singleton registration
@@ -302,7 +302,7 @@ Step2DSW::Step2DSW() {
 	constraint_islands.reserve(ISLAND_COUNT_RESERVE);
 	all_constraints.reserve(CONSTRAINT_COUNT_RESERVE);
 
-	work_pool.init();
+	work_pool.init(-1, WorkerThreadPool::PRIORITY_HIGH);
 }
 
 Step2DSW::~Step2DSW() {
@@ -133,6 +133,7 @@ class Body3DSW : public CollisionObject3DSW {
 	PhysicsDirectBodyState3DSW *direct_state = nullptr;
 
 	uint64_t island_step = 0;
+	uint64_t island_colors = 0; // Colors taken by this body's constraints, used by Step3DSW.
 
 	_FORCE_INLINE_ void _compute_area_gravity_and_damping(const Area3DSW *p_area);
 
@@ -185,6 +186,9 @@ public:
 	_FORCE_INLINE_ uint64_t get_island_step() const { return island_step; }
 	_FORCE_INLINE_ void set_island_step(uint64_t p_step) { island_step = p_step; }
 
+	_FORCE_INLINE_ uint64_t get_island_colors() const { return island_colors; }
+	_FORCE_INLINE_ void set_island_colors(uint64_t p_colors) { island_colors = p_colors; }
+
 	_FORCE_INLINE_ void add_constraint(Constraint3DSW *p_constraint, int p_pos) { constraint_map[p_constraint] = p_pos; }
 	_FORCE_INLINE_ void remove_constraint(Constraint3DSW *p_constraint) { constraint_map.erase(p_constraint); }
 	const Map<Constraint3DSW *, int> &get_constraint_map() const { return constraint_map; }
@@ -32,8 +32,12 @@
 
 #include "collision_solver_3d_sw.h"
 #include "core/config/project_settings.h"
+#include "core/templates/thread_work_pool.h"
 #include "physics_server_3d_sw.h"
 
+thread_local CollisionObject3DSW *Space3DSW::intersection_query_results[Space3DSW::INTERSECTION_QUERY_MAX];
+thread_local int Space3DSW::intersection_query_subindex_results[Space3DSW::INTERSECTION_QUERY_MAX];
+
 _FORCE_INLINE_ static bool _can_collide_with(CollisionObject3DSW *p_object, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
 	if (!(p_object->get_collision_layer() & p_collision_mask)) {
 		return false;
@@ -180,6 +184,53 @@ bool PhysicsDirectSpaceState3DSW::intersect_ray(const Vector3 &p_from, const Vec
 	return true;
 }
 
+void PhysicsDirectSpaceState3DSW::_intersect_ray_chunk(uint32_t p_chunk, RayBatch *p_batch) {
+	int from = p_chunk * RAY_BATCH_CHUNK_SIZE;
+	int to = MIN(from + RAY_BATCH_CHUNK_SIZE, p_batch->count);
+	for (int i = from; i < to; i++) {
+		RayResult &result = p_batch->results[i];
+		if (!PhysicsDirectSpaceState3DSW::intersect_ray(p_batch->from[i], p_batch->to[i], result, *p_batch->exclude, p_batch->collision_mask, p_batch->collide_with_bodies, p_batch->collide_with_areas)) {
+			result = RayResult();
+		}
+	}
+}
+
+int PhysicsDirectSpaceState3DSW::intersect_rays(const Vector3 *p_from, const Vector3 *p_to, int p_ray_count, RayResult *r_results, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+	ERR_FAIL_COND_V(space->locked, 0);
+	if (p_ray_count <= 0) {
+		return 0;
+	}
+
+	RayBatch batch;
+	batch.from = p_from;
+	batch.to = p_to;
+	batch.count = p_ray_count;
+	batch.results = r_results;
+	batch.exclude = &p_exclude;
+	batch.collision_mask = p_collision_mask;
+	batch.collide_with_bodies = p_collide_with_bodies;
+	batch.collide_with_areas = p_collide_with_areas;
+
+	uint32_t chunk_count = (p_ray_count + RAY_BATCH_CHUNK_SIZE - 1) / RAY_BATCH_CHUNK_SIZE;
+	if (chunk_count > 1) {
+		// Queries only read the space, so the chunks can be spread over all the threads.
+		ThreadWorkPool work_pool;
+		work_pool.init(-1, WorkerThreadPool::PRIORITY_HIGH);
+		work_pool.do_work(chunk_count, this, &PhysicsDirectSpaceState3DSW::_intersect_ray_chunk, &batch);
+		work_pool.finish();
+	} else {
+		_intersect_ray_chunk(0, &batch);
+	}
+
+	int hit_count = 0;
+	for (int i = 0; i < p_ray_count; i++) {
+		if (r_results[i].rid.is_valid()) {
+			hit_count++;
+		}
+	}
+	return hit_count;
+}
+
 int PhysicsDirectSpaceState3DSW::intersect_shape(const RID &p_shape, const Transform3D &p_xform, real_t p_margin, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
 	if (p_result_max <= 0) {
 		return 0;
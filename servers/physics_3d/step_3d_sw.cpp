@@ -38,6 +38,9 @@
 #define ISLAND_COUNT_RESERVE 128
 #define ISLAND_SIZE_RESERVE 512
 #define CONSTRAINT_COUNT_RESERVE 1024
+#define ISLAND_COLORING_MIN_SIZE 256
+#define ISLAND_MAX_COLORS 64
+#define COLOR_PARALLEL_MIN_SIZE 32
 
 void Step3DSW::_populate_island(Body3DSW *p_body, LocalVector<Body3DSW *> &p_body_island, LocalVector<Constraint3DSW *> &p_constraint_island) {
 	p_body->set_island_step(_step);
@@ -156,6 +159,101 @@ void Step3DSW::_solve_island(uint32_t p_island_index, void *p_userdata) {
 	}
 }
 
+bool Step3DSW::_color_island(const LocalVector<Constraint3DSW *> &p_constraint_island, ColoredIsland &r_colored_island) {
+	uint32_t constraint_count = p_constraint_island.size();
+
+	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
+		Constraint3DSW *constraint = p_constraint_island[constraint_index];
+		if (constraint->get_soft_body_count() > 0) {
+			return false; // Soft bodies aren't tracked, keep solving on a single thread.
+		}
+		for (int i = 0; i < constraint->get_body_count(); i++) {
+			constraint->get_body_ptr()[i]->set_island_colors(0);
+		}
+	}
+
+	// Greedy coloring, each constraint takes the first color none of its dynamic bodies uses yet.
+	// Static and kinematic bodies are never written to by the solver, so they can be shared.
+	uint32_t color_counts[ISLAND_MAX_COLORS + 1] = {};
+	int max_priority = 1;
+	constraint_colors.resize(constraint_count);
+
+	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
+		Constraint3DSW *constraint = p_constraint_island[constraint_index];
+		Body3DSW **bodies = constraint->get_body_ptr();
+
+		uint64_t used_colors = 0;
+		for (int i = 0; i < constraint->get_body_count(); i++) {
+			if (bodies[i]->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC) {
+				used_colors |= bodies[i]->get_island_colors();
+			}
+		}
+
+		uint32_t color = 0;
+		while (color < ISLAND_MAX_COLORS && (used_colors & (uint64_t(1) << color))) {
+			color++;
+		}
+
+		if (color < ISLAND_MAX_COLORS) {
+			for (int i = 0; i < constraint->get_body_count(); i++) {
+				if (bodies[i]->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC) {
+					bodies[i]->set_island_colors(bodies[i]->get_island_colors() | (uint64_t(1) << color));
+				}
+			}
+		}
+
+		constraint_colors[constraint_index] = color;
+		color_counts[color]++;
+		max_priority = MAX(max_priority, constraint->get_priority());
+	}
+
+	// Sort by color, keeping the island order inside each color.
+	r_colored_island.color_offsets.resize(ISLAND_MAX_COLORS + 2);
+	r_colored_island.color_offsets[0] = 0;
+	for (uint32_t color = 0; color <= ISLAND_MAX_COLORS; color++) {
+		r_colored_island.color_offsets[color + 1] = r_colored_island.color_offsets[color] + color_counts[color];
+		color_counts[color] = r_colored_island.color_offsets[color];
+	}
+
+	r_colored_island.constraints.resize(constraint_count);
+	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
+		r_colored_island.constraints[color_counts[constraint_colors[constraint_index]]++] = p_constraint_island[constraint_index];
+	}
+	r_colored_island.max_priority = max_priority;
+
+	return true;
+}
+
+void Step3DSW::_solve_colored_island(ColoredIsland &p_colored_island) {
+	// Same passes as _solve_island, each pass goes through the colors in order.
+	for (solving_priority = 1; solving_priority <= p_colored_island.max_priority; solving_priority++) {
+		for (int i = 0; i < iterations; i++) {
+			for (uint32_t color = 0; color <= ISLAND_MAX_COLORS; color++) {
+				uint32_t color_begin = p_colored_island.color_offsets[color];
+				uint32_t color_size = p_colored_island.color_offsets[color + 1] - color_begin;
+				solving_constraints = p_colored_island.constraints.ptr() + color_begin;
+
+				if (color < ISLAND_MAX_COLORS && color_size >= COLOR_PARALLEL_MIN_SIZE) {
+					work_pool.do_work(color_size, this, &Step3DSW::_solve_colored_constraint, nullptr);
+				} else {
+					// Not worth waking the workers, or the constraints left uncolored.
+					for (uint32_t constraint_index = 0; constraint_index < color_size; ++constraint_index) {
+						_solve_colored_constraint(constraint_index);
+					}
+				}
+			}
+		}
+	}
+}
+
+void Step3DSW::_solve_colored_constraint(uint32_t p_constraint_index, void *p_userdata) {
+	Constraint3DSW *constraint = solving_constraints[p_constraint_index];
+	// The first pass solves everything, like _solve_island, whatever the priority.
+	if (solving_priority == 1 || constraint->get_priority() >= solving_priority) {
+		constraint->solve(delta);
+	}
+}
+
 void Step3DSW::_check_suspend(const LocalVector<Body3DSW *> &p_body_island) const {
 	bool can_sleep = true;
 
@@ -358,12 +456,37 @@ void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
 
 	// Warning: _solve_island modifies the constraint islands for optimization purpose,
 	// their content is not reliable after these calls and shouldn't be used anymore.
+
+	// A large island would keep a single thread busy while the others wait, so its
+	// constraints are colored and it is solved by all the threads after the others.
+	uint32_t colored_island_count = 0;
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool && pool->get_thread_count() > 0) {
+		for (uint32_t island_index = 0; island_index < island_count; ++island_index) {
+			LocalVector<Constraint3DSW *> &constraint_island = constraint_islands[island_index];
+			if (constraint_island.size() < ISLAND_COLORING_MIN_SIZE) {
+				continue;
+			}
+			if (colored_islands.size() <= colored_island_count) {
+				colored_islands.resize(colored_island_count + 1);
+			}
+			if (_color_island(constraint_island, colored_islands[colored_island_count])) {
+				++colored_island_count;
+				constraint_island.clear();
+			}
+		}
+	}
+
 	if (island_count > 1) {
 		work_pool.do_work(island_count, this, &Step3DSW::_solve_island, nullptr);
 	} else if (island_count > 0) {
 		_solve_island(0);
 	}
 
+	for (uint32_t island_index = 0; island_index < colored_island_count; ++island_index) {
+		_solve_colored_island(colored_islands[island_index]);
+	}
+
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
 		p_space->set_elapsed_time(Space3DSW::ELAPSED_TIME_SOLVE_CONSTRAINTS, profile_endtime - profile_begtime);
@@ -413,7 +536,7 @@ Step3DSW::Step3DSW() {
 	constraint_islands.reserve(ISLAND_COUNT_RESERVE);
 	all_constraints.reserve(CONSTRAINT_COUNT_RESERVE);
 
-	work_pool.init();
+	work_pool.init(-1, WorkerThreadPool::PRIORITY_HIGH);
 }
 
 Step3DSW::~Step3DSW() {
@@ -48,11 +48,29 @@ class Step3DSW {
 	LocalVector<LocalVector<Constraint3DSW *>> constraint_islands;
 	LocalVector<Constraint3DSW *> all_constraints;
 
+	// Islands too large for a single thread, split into colors where no two
+	// constraints act on the same dynamic body, so each color can be solved
+	// in parallel. The last color holds what couldn't be colored.
+	struct ColoredIsland {
+		LocalVector<Constraint3DSW *> constraints;
+		LocalVector<uint32_t> color_offsets;
+		int max_priority = 1;
+	};
+
+	LocalVector<ColoredIsland> colored_islands;
+	LocalVector<uint32_t> constraint_colors;
+
+	Constraint3DSW **solving_constraints = nullptr;
+	int solving_priority = 1;
+
 	void _populate_island(Body3DSW *p_body, LocalVector<Body3DSW *> &p_body_island, LocalVector<Constraint3DSW *> &p_constraint_island);
 	void _populate_island_soft_body(SoftBody3DSW *p_soft_body, LocalVector<Body3DSW *> &p_body_island, LocalVector<Constraint3DSW *> &p_constraint_island);
 	void _setup_contraint(uint32_t p_constraint_index, void *p_userdata = nullptr);
 	void _pre_solve_island(LocalVector<Constraint3DSW *> &p_constraint_island) const;
 	void _solve_island(uint32_t p_island_index, void *p_userdata = nullptr);
+	bool _color_island(const LocalVector<Constraint3DSW *> &p_constraint_island, ColoredIsland &r_colored_island);
+	void _solve_colored_island(ColoredIsland &p_colored_island);
+	void _solve_colored_constraint(uint32_t p_constraint_index, void *p_userdata = nullptr);
 	void _check_suspend(const LocalVector<Body3DSW *> &p_body_island) const;
 
 public:
@@ -275,6 +275,49 @@ Dictionary PhysicsDirectSpaceState3D::_intersect_ray(const Vector3 &p_from, cons
 	return d;
 }
 
+int PhysicsDirectSpaceState3D::intersect_rays(const Vector3 *p_from, const Vector3 *p_to, int p_ray_count, RayResult *r_results, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+	int hit_count = 0;
+	for (int i = 0; i < p_ray_count; i++) {
+		if (intersect_ray(p_from[i], p_to[i], r_results[i], p_exclude, p_collision_mask, p_collide_with_bodies, p_collide_with_areas)) {
+			hit_count++;
+		} else {
+			r_results[i] = RayResult();
+		}
+	}
+	return hit_count;
+}
+
+Array PhysicsDirectSpaceState3D::_intersect_rays(const PackedVector3Array &p_from, const PackedVector3Array &p_to, const Vector<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+	ERR_FAIL_COND_V_MSG(p_from.size() != p_to.size(), Array(), "The 'from' and 'to' arrays must have the same size.");
+
+	Set<RID> exclude;
+	for (int i = 0; i < p_exclude.size(); i++) {
+		exclude.insert(p_exclude[i]);
+	}
+
+	Vector<RayResult> results;
+	results.resize(p_from.size());
+	intersect_rays(p_from.ptr(), p_to.ptr(), p_from.size(), results.ptrw(), exclude, p_collision_mask, p_collide_with_bodies, p_collide_with_areas);
+
+	Array ret;
+	ret.resize(results.size());
+	for (int i = 0; i < results.size(); i++) {
+		const RayResult &inters = results[i];
+		Dictionary d;
+		if (inters.rid.is_valid()) {
+			d["position"] = inters.position;
+			d["normal"] = inters.normal;
+			d["collider_id"] = inters.collider_id;
+			d["collider"] = inters.collider;
+			d["shape"] = inters.shape;
+			d["rid"] = inters.rid;
+		}
+		ret[i] = d;
+	}
+
+	return ret;
+}
+
 Array PhysicsDirectSpaceState3D::_intersect_shape(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, int p_max_results) {
 	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Array());
 
@@ -354,6 +397,7 @@ PhysicsDirectSpaceState3D::PhysicsDirectSpaceState3D() {
 
 void PhysicsDirectSpaceState3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("intersect_ray", "from", "to", "exclude", "collision_mask", "collide_with_bodies", "collide_with_areas"), &PhysicsDirectSpaceState3D::_intersect_ray, DEFVAL(Array()), DEFVAL(UINT32_MAX), DEFVAL(true), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("intersect_rays", "from", "to", "exclude", "collision_mask", "collide_with_bodies", "collide_with_areas"), &PhysicsDirectSpaceState3D::_intersect_rays, DEFVAL(Array()), DEFVAL(UINT32_MAX), DEFVAL(true), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("intersect_shape", "shape", "max_results"), &PhysicsDirectSpaceState3D::_intersect_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("cast_motion", "shape", "motion"), &PhysicsDirectSpaceState3D::_cast_motion);
 	ClassDB::bind_method(D_METHOD("collide_shape", "shape", "max_results"), &PhysicsDirectSpaceState3D::_collide_shape, DEFVAL(32));
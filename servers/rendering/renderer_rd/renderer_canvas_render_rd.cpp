@@ -392,6 +392,59 @@ void RendererCanvasRenderRD::_bind_canvas_texture(RD::DrawListID p_draw_list, RI
 	r_last_texture = p_texture;
 }
 
+uint16_t RendererCanvasRenderRD::_get_item_lights(const Item *p_item, Light *p_lights, uint32_t *r_lights) const {
+	uint16_t light_count = 0;
+	Light *light = p_lights;
+
+	while (light) {
+		if (light->render_index_cache >= 0 && p_item->light_mask & light->item_mask && p_item->z_final >= light->z_min && p_item->z_final <= light->z_max && p_item->global_rect_cache.intersects_transformed(light->xform_cache, light->rect_cache)) {
+			uint32_t light_index = light->render_index_cache;
+			r_lights[light_count >> 2] |= light_index << ((light_count & 3) * 8);
+
+			light_count++;
+
+			if (light_count == MAX_LIGHTS_PER_ITEM) {
+				break;
+			}
+		}
+		light = light->next_ptr;
+	}
+
+	return light_count;
+}
+
+void RendererCanvasRenderRD::_get_rect_src_dst(const Item::CommandRect *p_rect, const Size2 &p_texpixel_size, Rect2 &r_src_rect, Rect2 &r_dst_rect) const {
+	r_dst_rect = Rect2(p_rect->rect.position, p_rect->rect.size);
+
+	if (r_dst_rect.size.width < 0) {
+		r_dst_rect.position.x += r_dst_rect.size.width;
+		r_dst_rect.size.width *= -1;
+	}
+	if (r_dst_rect.size.height < 0) {
+		r_dst_rect.position.y += r_dst_rect.size.height;
+		r_dst_rect.size.height *= -1;
+	}
+
+	if (p_rect->texture == RID()) {
+		r_src_rect = Rect2(0, 0, 1, 1);
+		return;
+	}
+
+	r_src_rect = (p_rect->flags & CANVAS_RECT_REGION) ? Rect2(p_rect->source.position * p_texpixel_size, p_rect->source.size * p_texpixel_size) : Rect2(0, 0, 1, 1);
+
+	if (p_rect->flags & CANVAS_RECT_FLIP_H) {
+		r_src_rect.size.x *= -1;
+	}
+
+	if (p_rect->flags & CANVAS_RECT_FLIP_V) {
+		r_src_rect.size.y *= -1;
+	}
+
+	if (p_rect->flags & CANVAS_RECT_TRANSPOSE) {
+		r_dst_rect.size.x *= -1; // Encoding in the dst_rect.z uniform
+	}
+}
+
 void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_render_target, const Item *p_item, RD::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants) {
 	//create an empty push constant
 
@@ -433,30 +486,10 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 
 	uint32_t base_flags = 0;
 
-	uint16_t light_count = 0;
-	PipelineLightMode light_mode;
-
-	{
-		Light *light = p_lights;
-
-		while (light) {
-			if (light->render_index_cache >= 0 && p_item->light_mask & light->item_mask && p_item->z_final >= light->z_min && p_item->z_final <= light->z_max && p_item->global_rect_cache.intersects_transformed(light->xform_cache, light->rect_cache)) {
-				uint32_t light_index = light->render_index_cache;
-				push_constant.lights[light_count >> 2] |= light_index << ((light_count & 3) * 8);
-
-				light_count++;
-
-				if (light_count == MAX_LIGHTS_PER_ITEM) {
-					break;
-				}
-			}
-			light = light->next_ptr;
-		}
-
-		base_flags |= light_count << FLAGS_LIGHT_COUNT_SHIFT;
-	}
+	uint16_t light_count = _get_item_lights(p_item, p_lights, push_constant.lights);
+	base_flags |= light_count << FLAGS_LIGHT_COUNT_SHIFT;
 
-	light_mode = (light_count > 0 || using_directional_lights) ? PIPELINE_LIGHT_MODE_ENABLED : PIPELINE_LIGHT_MODE_DISABLED;
+	PipelineLightMode light_mode = (light_count > 0 || using_directional_lights) ? PIPELINE_LIGHT_MODE_ENABLED : PIPELINE_LIGHT_MODE_DISABLED;
 
 	PipelineVariants *pipeline_variants = p_pipeline_variants;
 
@@ -484,6 +517,14 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 					current_repeat = RenderingServer::CanvasItemTextureRepeat::CANVAS_ITEM_TEXTURE_REPEAT_ENABLED;
 				}
 
+				uint32_t batch = _next_batch_command();
+				if (batch == BATCH_COMMAND_MERGED) {
+					break; // Already drawn as part of a batch.
+				} else if (batch != BATCH_COMMAND_UNBATCHED) {
+					_draw_batch(p_draw_list, batch, p_framebuffer_format, pipeline_variants, last_texture, push_constant, texpixel_size);
+					break;
+				}
+
 				//bind pipeline
 				{
 					RID pipeline = pipeline_variants->variants[light_mode][PIPELINE_VARIANT_QUAD].get_render_pipeline(RD::INVALID_ID, p_framebuffer_format);
@@ -496,49 +537,10 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 
 				Rect2 src_rect;
 				Rect2 dst_rect;
+				_get_rect_src_dst(rect, texpixel_size, src_rect, dst_rect);
 
-				if (rect->texture != RID()) {
-					src_rect = (rect->flags & CANVAS_RECT_REGION) ? Rect2(rect->source.position * texpixel_size, rect->source.size * texpixel_size) : Rect2(0, 0, 1, 1);
-					dst_rect = Rect2(rect->rect.position, rect->rect.size);
-
-					if (dst_rect.size.width < 0) {
-						dst_rect.position.x += dst_rect.size.width;
-						dst_rect.size.width *= -1;
-					}
-					if (dst_rect.size.height < 0) {
-						dst_rect.position.y += dst_rect.size.height;
-						dst_rect.size.height *= -1;
-					}
-
-					if (rect->flags & CANVAS_RECT_FLIP_H) {
-						src_rect.size.x *= -1;
-					}
-
-					if (rect->flags & CANVAS_RECT_FLIP_V) {
-						src_rect.size.y *= -1;
-					}
-
-					if (rect->flags & CANVAS_RECT_TRANSPOSE) {
-						dst_rect.size.x *= -1; // Encoding in the dst_rect.z uniform
-					}
-
-					if (rect->flags & CANVAS_RECT_CLIP_UV) {
-						push_constant.flags |= FLAGS_CLIP_RECT_UV;
-					}
-
-				} else {
-					dst_rect = Rect2(rect->rect.position, rect->rect.size);
-
-					if (dst_rect.size.width < 0) {
-						dst_rect.position.x += dst_rect.size.width;
-						dst_rect.size.width *= -1;
-					}
-					if (dst_rect.size.height < 0) {
-						dst_rect.position.y += dst_rect.size.height;
-						dst_rect.size.height *= -1;
-					}
-
-					src_rect = Rect2(0, 0, 1, 1);
+				if (rect->texture != RID() && rect->flags & CANVAS_RECT_CLIP_UV) {
+					push_constant.flags |= FLAGS_CLIP_RECT_UV;
 				}
 
 				if (rect->flags & CANVAS_RECT_MSDF) {
@@ -567,6 +569,7 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 				RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 				RD::get_singleton()->draw_list_bind_index_array(p_draw_list, shader.quad_index_array);
 				RD::get_singleton()->draw_list_draw(p_draw_list, true);
+				info.batches++;
 
 			} break;
 
@@ -631,6 +634,7 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 				RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 				RD::get_singleton()->draw_list_bind_index_array(p_draw_list, shader.quad_index_array);
 				RD::get_singleton()->draw_list_draw(p_draw_list, true);
+				info.batches++;
 
 				// Restore if overridden.
 				push_constant.color_texture_pixel_size[0] = texpixel_size.x;
@@ -676,11 +680,20 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 					RD::get_singleton()->draw_list_bind_index_array(p_draw_list, pb->indices);
 				}
 				RD::get_singleton()->draw_list_draw(p_draw_list, pb->indices.is_valid());
+				info.batches++;
 
 			} break;
 			case Item::Command::TYPE_PRIMITIVE: {
 				const Item::CommandPrimitive *primitive = static_cast<const Item::CommandPrimitive *>(c);
 
+				uint32_t batch = _next_batch_command();
+				if (batch == BATCH_COMMAND_MERGED) {
+					break;
+				} else if (batch != BATCH_COMMAND_UNBATCHED) {
+					_draw_batch(p_draw_list, batch, p_framebuffer_format, pipeline_variants, last_texture, push_constant, texpixel_size);
+					break;
+				}
+
 				//bind pipeline
 				{
 					static const PipelineVariant variant[4] = { PIPELINE_VARIANT_PRIMITIVE_POINTS, PIPELINE_VARIANT_PRIMITIVE_LINES, PIPELINE_VARIANT_PRIMITIVE_TRIANGLES, PIPELINE_VARIANT_PRIMITIVE_TRIANGLES };
@@ -706,6 +719,7 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 				}
 				RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 				RD::get_singleton()->draw_list_draw(p_draw_list, true);
+				info.batches++;
 
 				if (primitive->point_count == 4) {
 					for (uint32_t j = 1; j < 3; j++) {
@@ -721,6 +735,7 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 
 					RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 					RD::get_singleton()->draw_list_draw(p_draw_list, true);
+					info.batches++;
 				}
 
 			} break;
@@ -872,6 +887,7 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 					RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 
 					RD::get_singleton()->draw_list_draw(p_draw_list, index_array.is_valid(), instance_count);
+					info.batches++;
 				}
 
 				for (int j = 0; j < 6; j++) {
@@ -918,6 +934,314 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, RID p_rend
 	}
 }
 
+void RendererCanvasRenderRD::_batch_close() {
+	if (!batching.open) {
+		return;
+	}
+	batching.open = false;
+
+	const Batch &batch = batching.batches[batching.batches.size() - 1];
+	if (batch.command_count > 1) {
+		return;
+	}
+
+	// Nothing was merged, the regular path is cheaper for a single command.
+	batching.commands[batch.first_command] = BATCH_COMMAND_UNBATCHED;
+	batching.vertices.resize(batch.vertex_offset);
+	batching.batches.resize(batching.batches.size() - 1);
+}
+
+RendererCanvasRenderRD::BatchVertex *RendererCanvasRenderRD::_batch_add_command(const Batch &p_state, uint32_t p_vertex_count) {
+	if (batching.open && batching.batches[batching.batches.size() - 1].can_merge(p_state)) {
+		Batch &batch = batching.batches[batching.batches.size() - 1];
+		batch.command_count++;
+		batch.vertex_count += p_vertex_count;
+		batching.commands.push_back(BATCH_COMMAND_MERGED);
+	} else {
+		_batch_close();
+
+		Batch batch = p_state;
+		batch.first_command = batching.commands.size();
+		batch.command_count = 1;
+		batch.vertex_offset = batching.vertices.size();
+		batch.vertex_count = p_vertex_count;
+		batching.commands.push_back(batching.batches.size());
+		batching.batches.push_back(batch);
+		batching.open = true;
+	}
+
+	uint32_t from = batching.vertices.size();
+	batching.vertices.resize(from + p_vertex_count);
+	return &batching.vertices[from];
+}
+
+void RendererCanvasRenderRD::_prepare_batches(int p_item_count, const Transform2D &p_canvas_transform_inverse, Light *p_lights) {
+	batching.vertices.clear();
+	batching.batches.clear();
+	batching.commands.clear();
+	batching.command_cursor = 0;
+	batching.open = false;
+
+	if (!batching.enabled || using_directional_lights) {
+		return; // Lit items need their own transform for normals.
+	}
+
+	// Same corners as the quad vertex shader, split in two triangles like the quad index array.
+	static const Vector2 quad_corners[4] = { Vector2(0, 0), Vector2(0, 1), Vector2(1, 1), Vector2(1, 0) };
+	static const uint32_t quad_indices[6] = { 0, 1, 2, 0, 2, 3 };
+
+	Item *current_clip = nullptr;
+	RID size_texture;
+	Size2 texpixel_size;
+
+	for (int i = 0; i < p_item_count; i++) {
+		const Item *ci = items[i];
+
+		if (current_clip != ci->final_clip_owner) {
+			current_clip = ci->final_clip_owner;
+			_batch_close();
+		}
+
+		// Custom shaders can't be fed pre-transformed vertices, lit items need the item transform.
+		bool item_batchable = true;
+		RID material = ci->material;
+		if (material.is_null() && ci->canvas_group != nullptr) {
+			material = default_canvas_group_material;
+		}
+		if (material.is_valid()) {
+			MaterialData *material_data = (MaterialData *)storage->material_get_data(material, RendererStorageRD::SHADER_TYPE_2D);
+			if (material_data && material_data->shader_data->version.is_valid() && material_data->shader_data->valid) {
+				item_batchable = false;
+			}
+		}
+		if (item_batchable) {
+			uint32_t lights[4] = { 0, 0, 0, 0 };
+			item_batchable = _get_item_lights(ci, p_lights, lights) == 0;
+		}
+
+		RS::CanvasItemTextureFilter current_filter = ci->texture_filter != RS::CANVAS_ITEM_TEXTURE_FILTER_DEFAULT ? ci->texture_filter : default_filter;
+		RS::CanvasItemTextureRepeat current_repeat = ci->texture_repeat != RS::CANVAS_ITEM_TEXTURE_REPEAT_DEFAULT ? ci->texture_repeat : default_repeat;
+
+		Transform2D base_transform = p_canvas_transform_inverse * ci->final_transform;
+		Transform2D draw_transform = base_transform;
+		Color base_color = ci->final_modulate;
+		bool skipping = false;
+		bool clip_ignored = false;
+
+		for (const Item::Command *c = ci->commands; c; c = c->next) {
+			if (skipping && c->type != Item::Command::TYPE_ANIMATION_SLICE) {
+				continue;
+			}
+
+			switch (c->type) {
+				case Item::Command::TYPE_RECT: {
+					const Item::CommandRect *rect = static_cast<const Item::CommandRect *>(c);
+
+					if (rect->flags & CANVAS_RECT_TILE) {
+						current_repeat = RenderingServer::CanvasItemTextureRepeat::CANVAS_ITEM_TEXTURE_REPEAT_ENABLED;
+					}
+
+					// UV clipping and transposing are done by the rect shader.
+					bool batchable = item_batchable && !(rect->flags & (CANVAS_RECT_CLIP_UV | CANVAS_RECT_TRANSPOSE));
+
+					if (batchable && rect->texture.is_valid() && rect->texture != size_texture) {
+						RID uniform_set;
+						Color specular_shininess;
+						Size2i size;
+						bool use_normal;
+						bool use_specular;
+						if (storage->canvas_texture_get_uniform_set(rect->texture, current_filter, current_repeat, shader.default_version_rd_shader, CANVAS_TEXTURE_UNIFORM_SET, uniform_set, size, specular_shininess, use_normal, use_specular)) {
+							size_texture = rect->texture;
+							texpixel_size = Size2(1.0 / float(size.x), 1.0 / float(size.y));
+						} else {
+							batchable = false;
+						}
+					}
+
+					if (!batchable) {
+						_batch_close();
+						batching.commands.push_back(BATCH_COMMAND_UNBATCHED);
+						break;
+					}
+
+					Batch state;
+					state.texture = rect->texture.is_valid() ? rect->texture : default_canvas_texture;
+					state.filter = current_filter;
+					state.repeat = current_repeat;
+					if (rect->flags & CANVAS_RECT_MSDF) {
+						state.msdf = true;
+						state.msdf_px_range = rect->px_range;
+						state.msdf_outline = rect->outline;
+					}
+
+					Rect2 src_rect;
+					Rect2 dst_rect;
+					_get_rect_src_dst(rect, texpixel_size, src_rect, dst_rect);
+					Color color = rect->modulate * base_color;
+
+					BatchVertex *v = _batch_add_command(state, 6);
+					for (uint32_t j = 0; j < 6; j++) {
+						Vector2 corner = quad_corners[quad_indices[j]];
+						Vector2 uv = src_rect.position + src_rect.size.abs() * corner;
+						Vector2 flipped(src_rect.size.x < 0 ? 1.0 - corner.x : corner.x, src_rect.size.y < 0 ? 1.0 - corner.y : corner.y);
+						Vector2 vertex = draw_transform.xform(dst_rect.position + dst_rect.size.abs() * flipped);
+
+						v[j].vertex[0] = vertex.x;
+						v[j].vertex[1] = vertex.y;
+						v[j].color[0] = color.r;
+						v[j].color[1] = color.g;
+						v[j].color[2] = color.b;
+						v[j].color[3] = color.a;
+						v[j].uv[0] = uv.x;
+						v[j].uv[1] = uv.y;
+					}
+				} break;
+				case Item::Command::TYPE_PRIMITIVE: {
+					const Item::CommandPrimitive *primitive = static_cast<const Item::CommandPrimitive *>(c);
+
+					// Points and lines use their own pipelines.
+					if (!item_batchable || primitive->point_count < 3 || primitive->point_count > 4) {
+						_batch_close();
+						batching.commands.push_back(BATCH_COMMAND_UNBATCHED);
+						break;
+					}
+
+					Batch state;
+					state.texture = default_canvas_texture;
+					state.filter = current_filter;
+					state.repeat = current_repeat;
+
+					uint32_t vertex_count = primitive->point_count == 4 ? 6 : 3;
+					BatchVertex *v = _batch_add_command(state, vertex_count);
+					for (uint32_t j = 0; j < vertex_count; j++) {
+						uint32_t index = quad_indices[j];
+						Vector2 vertex = draw_transform.xform(primitive->points[index]);
+						Color color = primitive->colors[index] * base_color;
+
+						v[j].vertex[0] = vertex.x;
+						v[j].vertex[1] = vertex.y;
+						v[j].color[0] = color.r;
+						v[j].color[1] = color.g;
+						v[j].color[2] = color.b;
+						v[j].color[3] = color.a;
+						v[j].uv[0] = primitive->uvs[index].x;
+						v[j].uv[1] = primitive->uvs[index].y;
+					}
+				} break;
+				case Item::Command::TYPE_TRANSFORM: {
+					const Item::CommandTransform *transform = static_cast<const Item::CommandTransform *>(c);
+					draw_transform = base_transform * transform->xform;
+				} break;
+				case Item::Command::TYPE_CLIP_IGNORE: {
+					_batch_close();
+					clip_ignored = true;
+				} break;
+				case Item::Command::TYPE_ANIMATION_SLICE: {
+					const Item::CommandAnimationSlice *as = static_cast<const Item::CommandAnimationSlice *>(c);
+					double current_time = RendererCompositorRD::singleton->get_total_time();
+					double local_time = Math::fposmod(current_time - as->offset, as->animation_length);
+					skipping = !(local_time >= as->slice_begin && local_time < as->slice_end);
+				} break;
+				default: {
+					_batch_close(); // Drawn on its own.
+				} break;
+			}
+		}
+
+		if (clip_ignored) {
+			// The scissor is restored for the next item.
+			_batch_close();
+		}
+	}
+
+	_batch_close();
+}
+
+void RendererCanvasRenderRD::_upload_batches() {
+	if (batching.batches.is_empty()) {
+		return;
+	}
+
+	BatchBuffer &buffer = batching.buffers[batching.frame % batching.buffers.size()];
+	uint32_t vertex_count = batching.vertices.size();
+
+	if (buffer.used + vertex_count > buffer.size) {
+		// Draws recorded earlier this frame keep the old buffer alive until the frame is done.
+		if (buffer.vertex_buffer.is_valid()) {
+			RD::get_singleton()->free(buffer.vertex_buffer);
+		}
+		buffer.size = MAX((uint32_t)BATCH_MIN_VERTEX_BUFFER_SIZE, next_power_of_2(buffer.used + vertex_count));
+		buffer.vertex_buffer = RD::get_singleton()->vertex_buffer_create(buffer.size * sizeof(BatchVertex));
+		buffer.used = 0;
+	}
+
+	RD::get_singleton()->buffer_update(buffer.vertex_buffer, buffer.used * sizeof(BatchVertex), vertex_count * sizeof(BatchVertex), batching.vertices.ptr());
+
+	Vector<RID> buffers;
+	buffers.push_back(buffer.vertex_buffer);
+	buffers.push_back(buffer.vertex_buffer);
+	buffers.push_back(buffer.vertex_buffer);
+	buffers.push_back(storage->mesh_get_default_rd_buffer(RendererStorageRD::DEFAULT_RD_BUFFER_BONES));
+	buffers.push_back(storage->mesh_get_default_rd_buffer(RendererStorageRD::DEFAULT_RD_BUFFER_BONES));
+
+	Vector<uint64_t> offsets;
+	offsets.resize(buffers.size());
+	offsets.fill(0);
+
+	for (uint32_t i = 0; i < batching.batches.size(); i++) {
+		Batch &batch = batching.batches[i];
+		uint64_t offset = uint64_t(buffer.used + batch.vertex_offset) * sizeof(BatchVertex);
+		offsets.write[0] = offset;
+		offsets.write[1] = offset;
+		offsets.write[2] = offset;
+		batch.vertex_array = RD::get_singleton()->vertex_array_create(batch.vertex_count, batching.vertex_format, buffers, offsets);
+	}
+
+	buffer.used += vertex_count;
+}
+
+void RendererCanvasRenderRD::_free_batches() {
+	for (uint32_t i = 0; i < batching.batches.size(); i++) {
+		if (batching.batches[i].vertex_array.is_valid()) {
+			RD::get_singleton()->free(batching.batches[i].vertex_array);
+		}
+	}
+	batching.batches.clear();
+	batching.commands.clear();
+	batching.command_cursor = 0;
+}
+
+void RendererCanvasRenderRD::_draw_batch(RD::DrawListID p_draw_list, uint32_t p_batch, RD::FramebufferFormatID p_framebuffer_format, PipelineVariants *p_pipeline_variants, RID &r_last_texture, PushConstant &push_constant, Size2 &r_texpixel_size) {
+	const Batch &batch = batching.batches[p_batch];
+	ERR_FAIL_COND(batch.vertex_array.is_null());
+
+	RID pipeline = p_pipeline_variants->variants[PIPELINE_LIGHT_MODE_DISABLED][PIPELINE_VARIANT_ATTRIBUTE_TRIANGLES].get_render_pipeline(batching.vertex_format, p_framebuffer_format);
+	RD::get_singleton()->draw_list_bind_render_pipeline(p_draw_list, pipeline);
+
+	_bind_canvas_texture(p_draw_list, batch.texture, batch.filter, batch.repeat, r_last_texture, push_constant, r_texpixel_size);
+
+	// Vertices are already in canvas space and carry their modulation.
+	PushConstant batch_push_constant = push_constant;
+	_update_transform_2d_to_mat2x3(Transform2D(), batch_push_constant.world);
+	for (int i = 0; i < 4; i++) {
+		batch_push_constant.modulation[i] = 1.0;
+		batch_push_constant.msdf[i] = 0.0;
+		batch_push_constant.src_rect[i] = 0.0;
+		batch_push_constant.dst_rect[i] = 0.0;
+	}
+
+	if (batch.msdf) {
+		batch_push_constant.flags |= FLAGS_USE_MSDF;
+		batch_push_constant.msdf[0] = batch.msdf_px_range; // Pixel range.
+		batch_push_constant.msdf[1] = batch.msdf_outline; // Outline size.
+	}
+
+	RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &batch_push_constant, sizeof(PushConstant));
+	RD::get_singleton()->draw_list_bind_vertex_array(p_draw_list, batch.vertex_array);
+	RD::get_singleton()->draw_list_draw(p_draw_list, false);
+	info.batches++;
+}
+
 RID RendererCanvasRenderRD::_create_base_uniform_set(RID p_to_render_target, bool p_backbuffer) {
 	//re create canvas state
 	Vector<RD::Uniform> uniforms;
@@ -1062,6 +1386,10 @@ void RendererCanvasRenderRD::_render_items(RID p_to_render_target, int p_item_co
 
 	RD::FramebufferFormatID fb_format = RD::get_singleton()->framebuffer_get_format(framebuffer);
 
+	// Buffers can't be updated once the draw list has begun.
+	_prepare_batches(p_item_count, canvas_transform_inverse, p_lights);
+	_upload_batches();
+
 	RD::DrawListID draw_list = RD::get_singleton()->draw_list_begin(framebuffer, clear ? RD::INITIAL_ACTION_CLEAR : RD::INITIAL_ACTION_KEEP, RD::FINAL_ACTION_READ, RD::INITIAL_ACTION_KEEP, RD::FINAL_ACTION_DISCARD, clear_colors);
 
 	RD::get_singleton()->draw_list_bind_uniform_set(draw_list, fb_uniform_set, BASE_UNIFORM_SET);
@@ -1119,12 +1447,23 @@ void RendererCanvasRenderRD::_render_items(RID p_to_render_target, int p_item_co
 	}
 
 	RD::get_singleton()->draw_list_end();
+
+	_free_batches();
+	info.items += p_item_count;
 }
 
 void RendererCanvasRenderRD::canvas_render_items(RID p_to_render_target, Item *p_item_list, const Color &p_modulate, Light *p_light_list, Light *p_directional_light_list, const Transform2D &p_canvas_transform, RenderingServer::CanvasItemTextureFilter p_default_filter, RenderingServer::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel, bool &r_sdf_used) {
 	r_sdf_used = false;
 	int item_count = 0;
 
+	uint64_t frame = RendererCompositorRD::singleton->get_frame_number();
+	if (batching.frame != frame) {
+		batching.frame = frame;
+		batching.buffers[frame % batching.buffers.size()].used = 0;
+		info.items = 0;
+		info.batches = 0;
+	}
+
 	//setup canvas state uniforms if needed
 
 	Transform2D canvas_transform_inverse = p_canvas_transform.affine_inverse();
@@ -2235,6 +2574,15 @@ void RendererCanvasRenderRD::set_time(double p_time) {
 	state.time = p_time;
 }
 
+uint64_t RendererCanvasRenderRD::get_rendering_info(RS::RenderingInfo p_info) {
+	if (p_info == RS::RENDERING_INFO_2D_ITEMS_IN_FRAME) {
+		return info.items;
+	} else if (p_info == RS::RENDERING_INFO_2D_BATCHES_IN_FRAME) {
+		return info.batches;
+	}
+	return 0;
+}
+
 void RendererCanvasRenderRD::update() {
 }
 
@@ -2524,6 +2872,56 @@ RendererCanvasRenderRD::RendererCanvasRenderRD(RendererStorageRD *p_storage) {
 		shader.quad_index_array = RD::get_singleton()->index_array_create(shader.quad_index_buffer, 0, 6);
 	}
 
+	{ // batching
+		batching.enabled = GLOBAL_GET("rendering/2d/batching/enabled");
+
+		// Same layout as polygons without bones, see request_polygon().
+		Vector<RD::VertexAttribute> descriptions;
+		{
+			RD::VertexAttribute vd;
+			vd.format = RD::DATA_FORMAT_R32G32_SFLOAT;
+			vd.offset = offsetof(BatchVertex, vertex);
+			vd.location = RS::ARRAY_VERTEX;
+			vd.stride = sizeof(BatchVertex);
+			descriptions.push_back(vd);
+		}
+		{
+			RD::VertexAttribute vd;
+			vd.format = RD::DATA_FORMAT_R32G32B32A32_SFLOAT;
+			vd.offset = offsetof(BatchVertex, color);
+			vd.location = RS::ARRAY_COLOR;
+			vd.stride = sizeof(BatchVertex);
+			descriptions.push_back(vd);
+		}
+		{
+			RD::VertexAttribute vd;
+			vd.format = RD::DATA_FORMAT_R32G32_SFLOAT;
+			vd.offset = offsetof(BatchVertex, uv);
+			vd.location = RS::ARRAY_TEX_UV;
+			vd.stride = sizeof(BatchVertex);
+			descriptions.push_back(vd);
+		}
+		{
+			RD::VertexAttribute vd;
+			vd.format = RD::DATA_FORMAT_R32G32B32A32_UINT;
+			vd.offset = 0;
+			vd.location = RS::ARRAY_BONES;
+			vd.stride = 0;
+			descriptions.push_back(vd);
+		}
+		{
+			RD::VertexAttribute vd;
+			vd.format = RD::DATA_FORMAT_R32G32B32A32_SFLOAT;
+			vd.offset = 0;
+			vd.location = RS::ARRAY_WEIGHTS;
+			vd.stride = 0;
+			descriptions.push_back(vd);
+		}
+
+		batching.vertex_format = RD::get_singleton()->vertex_format_create(descriptions);
+		batching.buffers.resize(RD::get_singleton()->get_frame_delay() + 1);
+	}
+
 	{ //primitive
 		primitive_arrays.index_array[0] = shader.quad_index_array = RD::get_singleton()->index_array_create(shader.quad_index_buffer, 0, 1);
 		primitive_arrays.index_array[1] = shader.quad_index_array = RD::get_singleton()->index_array_create(shader.quad_index_buffer, 0, 2);
@@ -2681,6 +3079,12 @@ RendererCanvasRenderRD::~RendererCanvasRenderRD() {
 		RD::get_singleton()->free(shader.quad_index_array);
 		RD::get_singleton()->free(shader.quad_index_buffer);
 		//primitives are erase by dependency
+
+		for (uint32_t i = 0; i < batching.buffers.size(); i++) {
+			if (batching.buffers[i].vertex_buffer.is_valid()) {
+				RD::get_singleton()->free(batching.buffers[i].vertex_buffer);
+			}
+		}
 	}
 
 	if (state.shadow_fb.is_valid()) {
@@ -413,6 +413,71 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 		float skeleton_inverse[16];
 	};
 
+	/******************/
+	/**** BATCHING ****/
+	/******************/
+
+	// Runs of rects and primitives that share texture, clip and material state
+	// are written to a vertex buffer before the draw list begins, then drawn
+	// with the attribute pipeline in a single call. _prepare_batches() visits
+	// commands in the same order as _render_item(), which reads the outcome
+	// for each rect and primitive back through a cursor.
+
+	enum {
+		BATCH_COMMAND_UNBATCHED = 0xFFFFFFFF,
+		BATCH_COMMAND_MERGED = 0xFFFFFFFE,
+		BATCH_MIN_VERTEX_BUFFER_SIZE = 16384, // In vertices.
+	};
+
+	struct BatchVertex {
+		float vertex[2];
+		float color[4];
+		float uv[2];
+	};
+
+	struct Batch {
+		RID texture;
+		RS::CanvasItemTextureFilter filter = RS::CANVAS_ITEM_TEXTURE_FILTER_DEFAULT;
+		RS::CanvasItemTextureRepeat repeat = RS::CANVAS_ITEM_TEXTURE_REPEAT_DEFAULT;
+		bool msdf = false;
+		float msdf_px_range = 0.0;
+		float msdf_outline = 0.0;
+
+		uint32_t first_command = 0;
+		uint32_t command_count = 0;
+		uint32_t vertex_offset = 0;
+		uint32_t vertex_count = 0;
+		RID vertex_array;
+
+		_FORCE_INLINE_ bool can_merge(const Batch &p_batch) const {
+			return texture == p_batch.texture && filter == p_batch.filter && repeat == p_batch.repeat && msdf == p_batch.msdf && msdf_px_range == p_batch.msdf_px_range && msdf_outline == p_batch.msdf_outline;
+		}
+	};
+
+	struct BatchBuffer {
+		RID vertex_buffer;
+		uint32_t size = 0; // In vertices.
+		uint32_t used = 0;
+	};
+
+	struct {
+		bool enabled = true;
+		RD::VertexFormatID vertex_format = RD::INVALID_ID;
+		LocalVector<BatchBuffer> buffers; // One per frame in flight.
+		uint64_t frame = 0;
+
+		LocalVector<BatchVertex> vertices;
+		LocalVector<Batch> batches;
+		LocalVector<uint32_t> commands;
+		uint32_t command_cursor = 0;
+		bool open = false;
+	} batching;
+
+	struct {
+		uint64_t items = 0;
+		uint64_t batches = 0;
+	} info;
+
 	Item *items[MAX_RENDER_ITEMS];
 
 	bool using_directional_lights = false;
@@ -430,6 +495,19 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 	void _render_item(RenderingDevice::DrawListID p_draw_list, RID p_render_target, const Item *p_item, RenderingDevice::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants);
 	void _render_items(RID p_to_render_target, int p_item_count, const Transform2D &p_canvas_transform_inverse, Light *p_lights, bool p_to_backbuffer = false);
 
+	uint16_t _get_item_lights(const Item *p_item, Light *p_lights, uint32_t *r_lights) const;
+	_FORCE_INLINE_ void _get_rect_src_dst(const Item::CommandRect *p_rect, const Size2 &p_texpixel_size, Rect2 &r_src_rect, Rect2 &r_dst_rect) const;
+
+	void _batch_close();
+	BatchVertex *_batch_add_command(const Batch &p_state, uint32_t p_vertex_count);
+	void _prepare_batches(int p_item_count, const Transform2D &p_canvas_transform_inverse, Light *p_lights);
+	void _upload_batches();
+	void _free_batches();
+	_FORCE_INLINE_ uint32_t _next_batch_command() {
+		return batching.command_cursor < batching.commands.size() ? batching.commands[batching.command_cursor++] : BATCH_COMMAND_UNBATCHED;
+	}
+	void _draw_batch(RenderingDevice::DrawListID p_draw_list, uint32_t p_batch, RenderingDevice::FramebufferFormatID p_framebuffer_format, PipelineVariants *p_pipeline_variants, RID &r_last_texture, PushConstant &push_constant, Size2 &r_texpixel_size);
+
 	_FORCE_INLINE_ void _update_transform_2d_to_mat2x4(const Transform2D &p_transform, float *p_mat2x4);
 	_FORCE_INLINE_ void _update_transform_2d_to_mat2x3(const Transform2D &p_transform, float *p_mat2x3);
 
@@ -457,6 +535,7 @@ public:
 	void canvas_render_items(RID p_to_render_target, Item *p_item_list, const Color &p_modulate, Light *p_light_list, Light *p_directional_light_list, const Transform2D &p_canvas_transform, RS::CanvasItemTextureFilter p_default_filter, RS::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel, bool &r_sdf_used);
 
 	void canvas_debug_viewport_shadows(Light *p_lights_with_shadow) {}
+	uint64_t get_rendering_info(RS::RenderingInfo p_info);
 
 	virtual void set_shadow_texture_size(int p_size);
 
@@ -8853,6 +8853,10 @@ uint64_t RendererStorageRD::get_rendering_info(RS::RenderingInfo p_info) {
 		return buffer_mem_cache;
 	} else if (p_info == RS::RENDERING_INFO_VIDEO_MEM_USED) {
 		return total_mem_cache;
+	} else if (p_info == RS::RENDERING_INFO_PIPELINE_CACHE_HITS) {
+		return RenderingDevice::get_singleton()->get_pipeline_cache_hits();
+	} else if (p_info == RS::RENDERING_INFO_PIPELINE_CACHE_MISSES) {
+		return RenderingDevice::get_singleton()->get_pipeline_cache_misses();
 	}
 	return 0;
 }
@@ -37,6 +37,16 @@
 
 #include <new>
 
+#ifndef REAL_T_IS_DOUBLE
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CULL_BATCH_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CULL_BATCH_NEON
+#endif
+#endif
+
 /* CAMERA API */
 
 RID RendererSceneCull::camera_allocate() {
@@ -2503,6 +2513,110 @@ void RendererSceneCull::_scene_cull_threaded(uint32_t p_thread, CullData *cull_d
 	_scene_cull(*cull_data, scene_cull_result_threads[p_thread], cull_from, cull_to);
 }
 
+void RendererSceneCull::_cull_batch_frustum(const Frustum &p_frustum, const CullBatch &p_batch, uint32_t p_count, uint32_t *r_outside) {
+	// Same test as InstanceBounds::in_frustum(), a box is outside if its nearest corner is in front of a plane.
+	for (uint32_t i = 0; i < p_frustum.plane_count; i++) {
+		const Plane &plane = p_frustum.planes_ptr[i];
+		const real_t *xs = p_batch.bounds[p_frustum.plane_signs_ptr[i].signs[0]];
+		const real_t *ys = p_batch.bounds[p_frustum.plane_signs_ptr[i].signs[1]];
+		const real_t *zs = p_batch.bounds[p_frustum.plane_signs_ptr[i].signs[2]];
+
+#if defined(CULL_BATCH_SSE2)
+		const __m128 nx = _mm_set1_ps(plane.normal.x);
+		const __m128 ny = _mm_set1_ps(plane.normal.y);
+		const __m128 nz = _mm_set1_ps(plane.normal.z);
+		const __m128 d = _mm_set1_ps(plane.d);
+		const __m128 zero = _mm_setzero_ps();
+		for (uint32_t j = 0; j < p_count; j += 4) {
+			__m128 dist = _mm_add_ps(_mm_mul_ps(nx, _mm_load_ps(xs + j)), _mm_mul_ps(ny, _mm_load_ps(ys + j)));
+			dist = _mm_sub_ps(_mm_add_ps(dist, _mm_mul_ps(nz, _mm_load_ps(zs + j))), d);
+			__m128i outside = _mm_load_si128((const __m128i *)(r_outside + j));
+			outside = _mm_or_si128(outside, _mm_castps_si128(_mm_cmpge_ps(dist, zero)));
+			_mm_store_si128((__m128i *)(r_outside + j), outside);
+		}
+#elif defined(CULL_BATCH_NEON)
+		const float32x4_t nx = vdupq_n_f32(plane.normal.x);
+		const float32x4_t ny = vdupq_n_f32(plane.normal.y);
+		const float32x4_t nz = vdupq_n_f32(plane.normal.z);
+		const float32x4_t d = vdupq_n_f32(plane.d);
+		const float32x4_t zero = vdupq_n_f32(0.0f);
+		for (uint32_t j = 0; j < p_count; j += 4) {
+			float32x4_t dist = vaddq_f32(vmulq_f32(nx, vld1q_f32(xs + j)), vmulq_f32(ny, vld1q_f32(ys + j)));
+			dist = vsubq_f32(vaddq_f32(dist, vmulq_f32(nz, vld1q_f32(zs + j))), d);
+			vst1q_u32(r_outside + j, vorrq_u32(vld1q_u32(r_outside + j), vcgeq_f32(dist, zero)));
+		}
+#else
+		for (uint32_t j = 0; j < p_count; j++) {
+			real_t dist = plane.normal.x * xs[j] + plane.normal.y * ys[j] + plane.normal.z * zs[j] - plane.d;
+			r_outside[j] |= dist >= 0.0 ? 0xFFFFFFFF : 0;
+		}
+#endif
+	}
+}
+
+void RendererSceneCull::_cull_batch_shadows(const Cull &p_cull, CullBatch &r_batch, uint32_t p_count) {
+	// Shadow casters only need to be in one cascade to go through, which cascade is checked later.
+	// Every cascade starts from the hidden instances, and the results are intersected.
+	for (uint32_t i = 0; i < p_count; i++) {
+		r_batch.shadow_outside[i] = 0xFFFFFFFF;
+	}
+	for (uint32_t i = 0; i < p_cull.shadow_count; i++) {
+		for (uint32_t j = 0; j < p_cull.shadows[i].cascade_count; j++) {
+			memcpy(r_batch.cascade_outside, r_batch.hidden, sizeof(uint32_t) * p_count);
+			_cull_batch_frustum(p_cull.shadows[i].cascades[j].frustum, r_batch, p_count, r_batch.cascade_outside);
+			for (uint32_t k = 0; k < p_count; k++) {
+				r_batch.shadow_outside[k] &= r_batch.cascade_outside[k];
+			}
+		}
+	}
+}
+
+uint32_t RendererSceneCull::_scene_cull_batch(const CullData &cull_data, uint64_t p_from, uint32_t p_count, CullBatch &r_batch) {
+	const uint32_t visibility_hidden_mask = InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN_CLOSE_RANGE | InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN;
+
+	// Gather the bounds in SoA form, padded to the SIMD width.
+	uint32_t padded_count = (p_count + 3) & ~3;
+	for (uint32_t j = 0; j < padded_count; j++) {
+		if (j >= p_count) {
+			for (uint32_t k = 0; k < 6; k++) {
+				r_batch.bounds[k][j] = 0.0;
+			}
+			r_batch.outside[j] = 0xFFFFFFFF;
+			r_batch.hidden[j] = 0xFFFFFFFF;
+			continue;
+		}
+
+		const InstanceBounds &bounds = cull_data.scenario->instance_aabbs[p_from + j];
+		for (uint32_t k = 0; k < 6; k++) {
+			r_batch.bounds[k][j] = bounds.bounds[k];
+		}
+
+		const InstanceData &idata = cull_data.scenario->instance_data[p_from + j];
+		uint32_t visibility_flags = idata.flags & visibility_hidden_mask;
+		bool hidden = visibility_flags == InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN_CLOSE_RANGE || visibility_flags == InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN;
+		r_batch.outside[j] = (hidden || !(cull_data.visible_layers & idata.layer_mask)) ? 0xFFFFFFFF : 0;
+		r_batch.hidden[j] = hidden ? 0xFFFFFFFF : 0;
+	}
+
+	_cull_batch_frustum(cull_data.cull->frustum, r_batch, padded_count, r_batch.outside);
+	_cull_batch_shadows(*cull_data.cull, r_batch, padded_count);
+
+	// SDFGI regions are tested on every instance, hidden or not.
+	bool keep_all = cull_data.cull->sdfgi.region_count > 0;
+
+	uint32_t survivor_count = 0;
+	for (uint32_t j = 0; j < p_count; j++) {
+		bool visible = !r_batch.outside[j];
+		if (visible || !r_batch.shadow_outside[j] || keep_all) {
+			r_batch.survivors[survivor_count] = j;
+			r_batch.survivor_visible[survivor_count] = visible;
+			survivor_count++;
+		}
+	}
+
+	return survivor_count;
+}
+
 void RendererSceneCull::_scene_cull(CullData &cull_data, InstanceCullResult &cull_result, uint64_t p_from, uint64_t p_to) {
 	uint64_t frame_number = RSG::rasterizer->get_frame_number();
 	float lightmap_probe_update_speed = RSG::storage->lightmap_get_probe_capture_update_speed() * RSG::rasterizer->get_frame_delta_time();
@@ -2515,233 +2629,238 @@ void RendererSceneCull::_scene_cull(CullData &cull_data, InstanceCullResult &cul
 	Transform3D inv_cam_transform = cull_data.cam_transform.inverse();
 	float z_near = cull_data.camera_matrix->get_z_near();
 
-	for (uint64_t i = p_from; i < p_to; i++) {
-		bool mesh_visible = false;
+	CullBatch batch;
+
+	for (uint64_t batch_from = p_from; batch_from < p_to; batch_from += CULL_BATCH_SIZE) {
+		uint32_t survivor_count = _scene_cull_batch(cull_data, batch_from, MIN(p_to - batch_from, (uint64_t)CULL_BATCH_SIZE), batch);
 
-		InstanceData &idata = cull_data.scenario->instance_data[i];
-		uint32_t visibility_flags = idata.flags & (InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN_CLOSE_RANGE | InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN);
-		int32_t visibility_check = -1;
+		for (uint32_t s = 0; s < survivor_count; s++) {
+			uint64_t i = batch_from + batch.survivors[s];
+			bool mesh_visible = false;
+
+			InstanceData &idata = cull_data.scenario->instance_data[i];
+			uint32_t visibility_flags = idata.flags & (InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN_CLOSE_RANGE | InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN);
+			int32_t visibility_check = -1;
 
 #define HIDDEN_BY_VISIBILITY_CHECKS (visibility_flags == InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN_CLOSE_RANGE || visibility_flags == InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN)
-#define LAYER_CHECK (cull_data.visible_layers & idata.layer_mask)
 #define IN_FRUSTUM(f) (cull_data.scenario->instance_aabbs[i].in_frustum(f))
 #define VIS_RANGE_CHECK ((idata.visibility_index == -1) || _visibility_range_check(cull_data.scenario->instance_visibility[idata.visibility_index], cull_data.cam_transform.origin, cull_data.visibility_viewport_mask) == 0)
 #define VIS_PARENT_CHECK ((idata.parent_array_index == -1) || ((cull_data.scenario->instance_data[idata.parent_array_index].flags & InstanceData::FLAG_VISIBILITY_DEPENDENCY_NEEDS_CHECK) == InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN_CLOSE_RANGE))
 #define VIS_CHECK (visibility_check < 0 ? (visibility_check = (visibility_flags != InstanceData::FLAG_VISIBILITY_DEPENDENCY_NEEDS_CHECK || (VIS_RANGE_CHECK && VIS_PARENT_CHECK))) : visibility_check)
 #define OCCLUSION_CULLED (cull_data.occlusion_buffer != nullptr && (cull_data.scenario->instance_data[i].flags & InstanceData::FLAG_IGNORE_OCCLUSION_CULLING) == 0 && cull_data.occlusion_buffer->is_occluded(cull_data.scenario->instance_aabbs[i].bounds, cull_data.cam_transform.origin, inv_cam_transform, *cull_data.camera_matrix, z_near))
 
-		if (!HIDDEN_BY_VISIBILITY_CHECKS) {
-			if (LAYER_CHECK && IN_FRUSTUM(cull_data.cull->frustum) && VIS_CHECK && !OCCLUSION_CULLED) {
-				uint32_t base_type = idata.flags & InstanceData::FLAG_BASE_TYPE_MASK;
-				if (base_type == RS::INSTANCE_LIGHT) {
-					cull_result.lights.push_back(idata.instance);
-					cull_result.light_instances.push_back(RID::from_uint64(idata.instance_data_rid));
-					if (cull_data.shadow_atlas.is_valid() && RSG::storage->light_has_shadow(idata.base_rid)) {
-						scene_render->light_instance_mark_visible(RID::from_uint64(idata.instance_data_rid)); //mark it visible for shadow allocation later
-					}
+			if (!HIDDEN_BY_VISIBILITY_CHECKS) {
+				if (batch.survivor_visible[s] && VIS_CHECK && !OCCLUSION_CULLED) {
+					uint32_t base_type = idata.flags & InstanceData::FLAG_BASE_TYPE_MASK;
+					if (base_type == RS::INSTANCE_LIGHT) {
+						cull_result.lights.push_back(idata.instance);
+						cull_result.light_instances.push_back(RID::from_uint64(idata.instance_data_rid));
+						if (cull_data.shadow_atlas.is_valid() && RSG::storage->light_has_shadow(idata.base_rid)) {
+							scene_render->light_instance_mark_visible(RID::from_uint64(idata.instance_data_rid)); //mark it visible for shadow allocation later
+						}
 
-				} else if (base_type == RS::INSTANCE_REFLECTION_PROBE) {
-					if (cull_data.render_reflection_probe != idata.instance) {
-						//avoid entering The Matrix
+					} else if (base_type == RS::INSTANCE_REFLECTION_PROBE) {
+						if (cull_data.render_reflection_probe != idata.instance) {
+							//avoid entering The Matrix
+
+							if ((idata.flags & InstanceData::FLAG_REFLECTION_PROBE_DIRTY) || scene_render->reflection_probe_instance_needs_redraw(RID::from_uint64(idata.instance_data_rid))) {
+								InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(idata.instance->base_data);
+								cull_data.cull->lock.lock();
+								if (!reflection_probe->update_list.in_list()) {
+									reflection_probe->render_step = 0;
+									reflection_probe_render_list.add_last(&reflection_probe->update_list);
+								}
+								cull_data.cull->lock.unlock();
 
-						if ((idata.flags & InstanceData::FLAG_REFLECTION_PROBE_DIRTY) || scene_render->reflection_probe_instance_needs_redraw(RID::from_uint64(idata.instance_data_rid))) {
-							InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(idata.instance->base_data);
-							cull_data.cull->lock.lock();
-							if (!reflection_probe->update_list.in_list()) {
-								reflection_probe->render_step = 0;
-								reflection_probe_render_list.add_last(&reflection_probe->update_list);
+								idata.flags &= ~uint32_t(InstanceData::FLAG_REFLECTION_PROBE_DIRTY);
 							}
-							cull_data.cull->lock.unlock();
 
-							idata.flags &= ~uint32_t(InstanceData::FLAG_REFLECTION_PROBE_DIRTY);
+							if (scene_render->reflection_probe_instance_has_reflection(RID::from_uint64(idata.instance_data_rid))) {
+								cull_result.reflections.push_back(RID::from_uint64(idata.instance_data_rid));
+							}
 						}
-
-						if (scene_render->reflection_probe_instance_has_reflection(RID::from_uint64(idata.instance_data_rid))) {
-							cull_result.reflections.push_back(RID::from_uint64(idata.instance_data_rid));
+					} else if (base_type == RS::INSTANCE_DECAL) {
+						cull_result.decals.push_back(RID::from_uint64(idata.instance_data_rid));
+
+					} else if (base_type == RS::INSTANCE_VOXEL_GI) {
+						InstanceVoxelGIData *voxel_gi = static_cast<InstanceVoxelGIData *>(idata.instance->base_data);
+						cull_data.cull->lock.lock();
+						if (!voxel_gi->update_element.in_list()) {
+							voxel_gi_update_list.add(&voxel_gi->update_element);
 						}
-					}
-				} else if (base_type == RS::INSTANCE_DECAL) {
-					cull_result.decals.push_back(RID::from_uint64(idata.instance_data_rid));
-
-				} else if (base_type == RS::INSTANCE_VOXEL_GI) {
-					InstanceVoxelGIData *voxel_gi = static_cast<InstanceVoxelGIData *>(idata.instance->base_data);
-					cull_data.cull->lock.lock();
-					if (!voxel_gi->update_element.in_list()) {
-						voxel_gi_update_list.add(&voxel_gi->update_element);
-					}
-					cull_data.cull->lock.unlock();
-					cull_result.voxel_gi_instances.push_back(RID::from_uint64(idata.instance_data_rid));
-
-				} else if (base_type == RS::INSTANCE_LIGHTMAP) {
-					cull_result.lightmaps.push_back(RID::from_uint64(idata.instance_data_rid));
-				} else if (base_type == RS::INSTANCE_VISIBLITY_NOTIFIER) {
-					InstanceVisibilityNotifierData *vnd = idata.visibility_notifier;
-					if (!vnd->list_element.in_list()) {
-						visible_notifier_list_lock.lock();
-						visible_notifier_list.add(&vnd->list_element);
-						visible_notifier_list_lock.unlock();
-						vnd->just_visible = true;
-					}
-					vnd->visible_in_frame = RSG::rasterizer->get_frame_number();
-				} else if (((1 << base_type) & RS::INSTANCE_GEOMETRY_MASK) && !(idata.flags & InstanceData::FLAG_CAST_SHADOWS_ONLY)) {
-					bool keep = true;
-
-					if (idata.flags & InstanceData::FLAG_REDRAW_IF_VISIBLE) {
-						RenderingServerDefault::redraw_request();
-					}
+						cull_data.cull->lock.unlock();
+						cull_result.voxel_gi_instances.push_back(RID::from_uint64(idata.instance_data_rid));
+
+					} else if (base_type == RS::INSTANCE_LIGHTMAP) {
+						cull_result.lightmaps.push_back(RID::from_uint64(idata.instance_data_rid));
+					} else if (base_type == RS::INSTANCE_VISIBLITY_NOTIFIER) {
+						InstanceVisibilityNotifierData *vnd = idata.visibility_notifier;
+						if (!vnd->list_element.in_list()) {
+							visible_notifier_list_lock.lock();
+							visible_notifier_list.add(&vnd->list_element);
+							visible_notifier_list_lock.unlock();
+							vnd->just_visible = true;
+						}
+						vnd->visible_in_frame = RSG::rasterizer->get_frame_number();
+					} else if (((1 << base_type) & RS::INSTANCE_GEOMETRY_MASK) && !(idata.flags & InstanceData::FLAG_CAST_SHADOWS_ONLY)) {
+						bool keep = true;
 
-					if (base_type == RS::INSTANCE_MESH) {
-						mesh_visible = true;
-					} else if (base_type == RS::INSTANCE_PARTICLES) {
-						//particles visible? process them
-						if (RSG::storage->particles_is_inactive(idata.base_rid)) {
-							//but if nothing is going on, don't do it.
-							keep = false;
-						} else {
-							cull_data.cull->lock.lock();
-							RSG::storage->particles_request_process(idata.base_rid);
-							cull_data.cull->lock.unlock();
-							RSG::storage->particles_set_view_axis(idata.base_rid, -cull_data.cam_transform.basis.get_axis(2).normalized(), cull_data.cam_transform.basis.get_axis(1).normalized());
-							//particles visible? request redraw
+						if (idata.flags & InstanceData::FLAG_REDRAW_IF_VISIBLE) {
 							RenderingServerDefault::redraw_request();
 						}
-					}
 
-					if (geometry_instance_pair_mask & (1 << RS::INSTANCE_LIGHT) && (idata.flags & InstanceData::FLAG_GEOM_LIGHTING_DIRTY)) {
-						InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(idata.instance->base_data);
-						uint32_t idx = 0;
-
-						for (Set<Instance *>::Element *E = geom->lights.front(); E; E = E->next()) {
-							InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
-							instance_pair_buffer[idx++] = light->instance;
-							if (idx == MAX_INSTANCE_PAIRS) {
-								break;
+						if (base_type == RS::INSTANCE_MESH) {
+							mesh_visible = true;
+						} else if (base_type == RS::INSTANCE_PARTICLES) {
+							//particles visible? process them
+							if (RSG::storage->particles_is_inactive(idata.base_rid)) {
+								//but if nothing is going on, don't do it.
+								keep = false;
+							} else {
+								cull_data.cull->lock.lock();
+								RSG::storage->particles_request_process(idata.base_rid);
+								cull_data.cull->lock.unlock();
+								RSG::storage->particles_set_view_axis(idata.base_rid, -cull_data.cam_transform.basis.get_axis(2).normalized(), cull_data.cam_transform.basis.get_axis(1).normalized());
+								//particles visible? request redraw
+								RenderingServerDefault::redraw_request();
 							}
 						}
 
-						scene_render->geometry_instance_pair_light_instances(geom->geometry_instance, instance_pair_buffer, idx);
-						idata.flags &= ~uint32_t(InstanceData::FLAG_GEOM_LIGHTING_DIRTY);
-					}
+						if (geometry_instance_pair_mask & (1 << RS::INSTANCE_LIGHT) && (idata.flags & InstanceData::FLAG_GEOM_LIGHTING_DIRTY)) {
+							InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(idata.instance->base_data);
+							uint32_t idx = 0;
+
+							for (Set<Instance *>::Element *E = geom->lights.front(); E; E = E->next()) {
+								InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
+								instance_pair_buffer[idx++] = light->instance;
+								if (idx == MAX_INSTANCE_PAIRS) {
+									break;
+								}
+							}
 
-					if (idata.flags & InstanceData::FLAG_GEOM_PROJECTOR_SOFTSHADOW_DIRTY) {
-						InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(idata.instance->base_data);
+							scene_render->geometry_instance_pair_light_instances(geom->geometry_instance, instance_pair_buffer, idx);
+							idata.flags &= ~uint32_t(InstanceData::FLAG_GEOM_LIGHTING_DIRTY);
+						}
 
-						scene_render->geometry_instance_set_softshadow_projector_pairing(geom->geometry_instance, geom->softshadow_count > 0, geom->projector_count > 0);
-						idata.flags &= ~uint32_t(InstanceData::FLAG_GEOM_PROJECTOR_SOFTSHADOW_DIRTY);
-					}
+						if (idata.flags & InstanceData::FLAG_GEOM_PROJECTOR_SOFTSHADOW_DIRTY) {
+							InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(idata.instance->base_data);
+
+							scene_render->geometry_instance_set_softshadow_projector_pairing(geom->geometry_instance, geom->softshadow_count > 0, geom->projector_count > 0);
+							idata.flags &= ~uint32_t(InstanceData::FLAG_GEOM_PROJECTOR_SOFTSHADOW_DIRTY);
+						}
 
-					if (geometry_instance_pair_mask & (1 << RS::INSTANCE_REFLECTION_PROBE) && (idata.flags & InstanceData::FLAG_GEOM_REFLECTION_DIRTY)) {
-						InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(idata.instance->base_data);
-						uint32_t idx = 0;
+						if (geometry_instance_pair_mask & (1 << RS::INSTANCE_REFLECTION_PROBE) && (idata.flags & InstanceData::FLAG_GEOM_REFLECTION_DIRTY)) {
+							InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(idata.instance->base_data);
+							uint32_t idx = 0;
 
-						for (Set<Instance *>::Element *E = geom->reflection_probes.front(); E; E = E->next()) {
-							InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(E->get()->base_data);
+							for (Set<Instance *>::Element *E = geom->reflection_probes.front(); E; E = E->next()) {
+								InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(E->get()->base_data);
 
-							instance_pair_buffer[idx++] = reflection_probe->instance;
-							if (idx == MAX_INSTANCE_PAIRS) {
-								break;
+								instance_pair_buffer[idx++] = reflection_probe->instance;
+								if (idx == MAX_INSTANCE_PAIRS) {
+									break;
+								}
 							}
-						}
 
-						scene_render->geometry_instance_pair_reflection_probe_instances(geom->geometry_instance, instance_pair_buffer, idx);
-						idata.flags &= ~uint32_t(InstanceData::FLAG_GEOM_REFLECTION_DIRTY);
-					}
+							scene_render->geometry_instance_pair_reflection_probe_instances(geom->geometry_instance, instance_pair_buffer, idx);
+							idata.flags &= ~uint32_t(InstanceData::FLAG_GEOM_REFLECTION_DIRTY);
+						}
 
-					if (geometry_instance_pair_mask & (1 << RS::INSTANCE_DECAL) && (idata.flags & InstanceData::FLAG_GEOM_DECAL_DIRTY)) {
-						InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(idata.instance->base_data);
-						uint32_t idx = 0;
+						if (geometry_instance_pair_mask & (1 << RS::INSTANCE_DECAL) && (idata.flags & InstanceData::FLAG_GEOM_DECAL_DIRTY)) {
+							InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(idata.instance->base_data);
+							uint32_t idx = 0;
 
-						for (Set<Instance *>::Element *E = geom->decals.front(); E; E = E->next()) {
-							InstanceDecalData *decal = static_cast<InstanceDecalData *>(E->get()->base_data);
+							for (Set<Instance *>::Element *E = geom->decals.front(); E; E = E->next()) {
+								InstanceDecalData *decal = static_cast<InstanceDecalData *>(E->get()->base_data);
 
-							instance_pair_buffer[idx++] = decal->instance;
-							if (idx == MAX_INSTANCE_PAIRS) {
-								break;
+								instance_pair_buffer[idx++] = decal->instance;
+								if (idx == MAX_INSTANCE_PAIRS) {
+									break;
+								}
 							}
+							scene_render->geometry_instance_pair_decal_instances(geom->geometry_instance, instance_pair_buffer, idx);
+							idata.flags &= ~uint32_t(InstanceData::FLAG_GEOM_DECAL_DIRTY);
 						}
-						scene_render->geometry_instance_pair_decal_instances(geom->geometry_instance, instance_pair_buffer, idx);
-						idata.flags &= ~uint32_t(InstanceData::FLAG_GEOM_DECAL_DIRTY);
-					}
 
-					if (idata.flags & InstanceData::FLAG_GEOM_VOXEL_GI_DIRTY) {
-						InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(idata.instance->base_data);
-						uint32_t idx = 0;
-						for (Set<Instance *>::Element *E = geom->voxel_gi_instances.front(); E; E = E->next()) {
-							InstanceVoxelGIData *voxel_gi = static_cast<InstanceVoxelGIData *>(E->get()->base_data);
+						if (idata.flags & InstanceData::FLAG_GEOM_VOXEL_GI_DIRTY) {
+							InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(idata.instance->base_data);
+							uint32_t idx = 0;
+							for (Set<Instance *>::Element *E = geom->voxel_gi_instances.front(); E; E = E->next()) {
+								InstanceVoxelGIData *voxel_gi = static_cast<InstanceVoxelGIData *>(E->get()->base_data);
 
-							instance_pair_buffer[idx++] = voxel_gi->probe_instance;
-							if (idx == MAX_INSTANCE_PAIRS) {
-								break;
+								instance_pair_buffer[idx++] = voxel_gi->probe_instance;
+								if (idx == MAX_INSTANCE_PAIRS) {
+									break;
+								}
 							}
-						}
 
-						scene_render->geometry_instance_pair_voxel_gi_instances(geom->geometry_instance, instance_pair_buffer, idx);
-						idata.flags &= ~uint32_t(InstanceData::FLAG_GEOM_VOXEL_GI_DIRTY);
-					}
+							scene_render->geometry_instance_pair_voxel_gi_instances(geom->geometry_instance, instance_pair_buffer, idx);
+							idata.flags &= ~uint32_t(InstanceData::FLAG_GEOM_VOXEL_GI_DIRTY);
+						}
 
-					if ((idata.flags & InstanceData::FLAG_LIGHTMAP_CAPTURE) && idata.instance->last_frame_pass != frame_number && !idata.instance->lightmap_target_sh.is_empty() && !idata.instance->lightmap_sh.is_empty()) {
-						InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(idata.instance->base_data);
-						Color *sh = idata.instance->lightmap_sh.ptrw();
-						const Color *target_sh = idata.instance->lightmap_target_sh.ptr();
-						for (uint32_t j = 0; j < 9; j++) {
-							sh[j] = sh[j].lerp(target_sh[j], MIN(1.0, lightmap_probe_update_speed));
+						if ((idata.flags & InstanceData::FLAG_LIGHTMAP_CAPTURE) && idata.instance->last_frame_pass != frame_number && !idata.instance->lightmap_target_sh.is_empty() && !idata.instance->lightmap_sh.is_empty()) {
+							InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(idata.instance->base_data);
+							Color *sh = idata.instance->lightmap_sh.ptrw();
+							const Color *target_sh = idata.instance->lightmap_target_sh.ptr();
+							for (uint32_t j = 0; j < 9; j++) {
+								sh[j] = sh[j].lerp(target_sh[j], MIN(1.0, lightmap_probe_update_speed));
+							}
+							scene_render->geometry_instance_set_lightmap_capture(geom->geometry_instance, sh);
+							idata.instance->last_frame_pass = frame_number;
 						}
-						scene_render->geometry_instance_set_lightmap_capture(geom->geometry_instance, sh);
-						idata.instance->last_frame_pass = frame_number;
-					}
 
-					if (keep) {
-						cull_result.geometry_instances.push_back(idata.instance_geometry);
+						if (keep) {
+							cull_result.geometry_instances.push_back(idata.instance_geometry);
+						}
 					}
 				}
-			}
 
-			for (uint32_t j = 0; j < cull_data.cull->shadow_count; j++) {
-				for (uint32_t k = 0; k < cull_data.cull->shadows[j].cascade_count; k++) {
-					if (IN_FRUSTUM(cull_data.cull->shadows[j].cascades[k].frustum) && VIS_CHECK) {
-						uint32_t base_type = idata.flags & InstanceData::FLAG_BASE_TYPE_MASK;
+				for (uint32_t j = 0; j < cull_data.cull->shadow_count; j++) {
+					for (uint32_t k = 0; k < cull_data.cull->shadows[j].cascade_count; k++) {
+						if (IN_FRUSTUM(cull_data.cull->shadows[j].cascades[k].frustum) && VIS_CHECK) {
+							uint32_t base_type = idata.flags & InstanceData::FLAG_BASE_TYPE_MASK;
 
-						if (((1 << base_type) & RS::INSTANCE_GEOMETRY_MASK) && idata.flags & InstanceData::FLAG_CAST_SHADOWS) {
-							cull_result.directional_shadows[j].cascade_geometry_instances[k].push_back(idata.instance_geometry);
-							mesh_visible = true;
+							if (((1 << base_type) & RS::INSTANCE_GEOMETRY_MASK) && idata.flags & InstanceData::FLAG_CAST_SHADOWS) {
+								cull_result.directional_shadows[j].cascade_geometry_instances[k].push_back(idata.instance_geometry);
+								mesh_visible = true;
+							}
 						}
 					}
 				}
 			}
-		}
 
 #undef HIDDEN_BY_VISIBILITY_CHECKS
-#undef LAYER_CHECK
 #undef IN_FRUSTUM
 #undef VIS_RANGE_CHECK
 #undef VIS_PARENT_CHECK
 #undef VIS_CHECK
 #undef OCCLUSION_CULLED
 
-		for (uint32_t j = 0; j < cull_data.cull->sdfgi.region_count; j++) {
-			if (cull_data.scenario->instance_aabbs[i].in_aabb(cull_data.cull->sdfgi.region_aabb[j])) {
-				uint32_t base_type = idata.flags & InstanceData::FLAG_BASE_TYPE_MASK;
-
-				if (base_type == RS::INSTANCE_LIGHT) {
-					InstanceLightData *instance_light = (InstanceLightData *)idata.instance->base_data;
-					if (instance_light->bake_mode == RS::LIGHT_BAKE_STATIC && cull_data.cull->sdfgi.region_cascade[j] <= instance_light->max_sdfgi_cascade) {
-						if (sdfgi_last_light_index != i || sdfgi_last_light_cascade != cull_data.cull->sdfgi.region_cascade[j]) {
-							sdfgi_last_light_index = i;
-							sdfgi_last_light_cascade = cull_data.cull->sdfgi.region_cascade[j];
-							cull_result.sdfgi_cascade_lights[sdfgi_last_light_cascade].push_back(instance_light->instance);
+			for (uint32_t j = 0; j < cull_data.cull->sdfgi.region_count; j++) {
+				if (cull_data.scenario->instance_aabbs[i].in_aabb(cull_data.cull->sdfgi.region_aabb[j])) {
+					uint32_t base_type = idata.flags & InstanceData::FLAG_BASE_TYPE_MASK;
+
+					if (base_type == RS::INSTANCE_LIGHT) {
+						InstanceLightData *instance_light = (InstanceLightData *)idata.instance->base_data;
+						if (instance_light->bake_mode == RS::LIGHT_BAKE_STATIC && cull_data.cull->sdfgi.region_cascade[j] <= instance_light->max_sdfgi_cascade) {
+							if (sdfgi_last_light_index != i || sdfgi_last_light_cascade != cull_data.cull->sdfgi.region_cascade[j]) {
+								sdfgi_last_light_index = i;
+								sdfgi_last_light_cascade = cull_data.cull->sdfgi.region_cascade[j];
+								cull_result.sdfgi_cascade_lights[sdfgi_last_light_cascade].push_back(instance_light->instance);
+							}
+						}
+					} else if ((1 << base_type) & RS::INSTANCE_GEOMETRY_MASK) {
+						if (idata.flags & InstanceData::FLAG_USES_BAKED_LIGHT) {
+							cull_result.sdfgi_region_geometry_instances[j].push_back(idata.instance_geometry);
+							mesh_visible = true;
 						}
-					}
-				} else if ((1 << base_type) & RS::INSTANCE_GEOMETRY_MASK) {
-					if (idata.flags & InstanceData::FLAG_USES_BAKED_LIGHT) {
-						cull_result.sdfgi_region_geometry_instances[j].push_back(idata.instance_geometry);
-						mesh_visible = true;
 					}
 				}
 			}
-		}
 
-		if (mesh_visible && cull_data.scenario->instance_data[i].flags & InstanceData::FLAG_USES_MESH_INSTANCE) {
-			cull_result.mesh_instances.push_back(cull_data.scenario->instance_data[i].instance->mesh_instance);
+			if (mesh_visible && cull_data.scenario->instance_data[i].flags & InstanceData::FLAG_USES_MESH_INSTANCE) {
+				cull_result.mesh_instances.push_back(cull_data.scenario->instance_data[i].instance->mesh_instance);
+			}
 		}
 	}
 }
@@ -1028,6 +1028,25 @@ public:
 		uint64_t visibility_viewport_mask;
 	};
 
+	// Instances are first tested against the frustums in batches, SIMD where available,
+	// and only the ones that may be visible go through the rest of _scene_cull().
+	enum {
+		CULL_BATCH_SIZE = 256,
+	};
+
+	struct CullBatch {
+		alignas(16) real_t bounds[6][CULL_BATCH_SIZE];
+		alignas(16) uint32_t outside[CULL_BATCH_SIZE];
+		alignas(16) uint32_t hidden[CULL_BATCH_SIZE]; // By visibility dependencies, hidden from shadows too.
+		alignas(16) uint32_t shadow_outside[CULL_BATCH_SIZE];
+		alignas(16) uint32_t cascade_outside[CULL_BATCH_SIZE];
+		uint32_t survivors[CULL_BATCH_SIZE];
+		bool survivor_visible[CULL_BATCH_SIZE]; // In the camera frustum and layers, not just in a shadow cascade.
+	};
+
+	static void _cull_batch_frustum(const Frustum &p_frustum, const CullBatch &p_batch, uint32_t p_count, uint32_t *r_outside);
+	static void _cull_batch_shadows(const Cull &p_cull, CullBatch &r_batch, uint32_t p_count);
+	uint32_t _scene_cull_batch(const CullData &cull_data, uint64_t p_from, uint32_t p_count, CullBatch &r_batch);
 	void _scene_cull_threaded(uint32_t p_thread, CullData *cull_data);
 	void _scene_cull(CullData &cull_data, InstanceCullResult &cull_result, uint64_t p_from, uint64_t p_to);
 
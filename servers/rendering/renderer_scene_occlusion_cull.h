@@ -188,6 +188,7 @@ public:
 	}
 
 	virtual void set_build_quality(RS::ViewportOcclusionCullingBuildQuality p_quality) {}
+	virtual uint64_t get_rendering_info(RS::RenderingInfo p_info) { return 0; }
 
 	RendererSceneOcclusionCull() {
 		singleton = this;
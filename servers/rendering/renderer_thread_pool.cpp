@@ -34,7 +34,7 @@ RendererThreadPool *RendererThreadPool::singleton = nullptr;
 
 RendererThreadPool::RendererThreadPool() {
 	singleton = this;
-	thread_work_pool.init();
+	thread_work_pool.init(-1, WorkerThreadPool::PRIORITY_HIGH);
 }
 
 RendererThreadPool::~RendererThreadPool() {
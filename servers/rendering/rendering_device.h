@@ -636,7 +636,8 @@ public:
 
 	// This ID is warranted to be unique for the same formats, does not need to be freed
 	virtual VertexFormatID vertex_format_create(const Vector<VertexAttribute> &p_vertex_formats) = 0;
-	virtual RID vertex_array_create(uint32_t p_vertex_count, VertexFormatID p_vertex_format, const Vector<RID> &p_src_buffers) = 0;
+	// Offsets are in bytes, one per source buffer; when empty, all buffers are read from the start.
+	virtual RID vertex_array_create(uint32_t p_vertex_count, VertexFormatID p_vertex_format, const Vector<RID> &p_src_buffers, const Vector<uint64_t> &p_offsets = Vector<uint64_t>()) = 0;
 
 	enum IndexBufferFormat {
 		INDEX_BUFFER_FORMAT_UINT16,
@@ -1171,6 +1172,10 @@ public:
 
 	virtual uint64_t get_memory_usage(MemoryType p_type) const = 0;
 
+	// Pipelines found in the pipeline cache or not, only counted when the driver reports it.
+	virtual uint64_t get_pipeline_cache_hits() const = 0;
+	virtual uint64_t get_pipeline_cache_misses() const = 0;
+
 	virtual RenderingDevice *create_local_device() = 0;
 
 	virtual void set_resource_name(RID p_id, const String p_name) = 0;
@@ -248,6 +248,10 @@ uint64_t RenderingServerDefault::get_rendering_info(RenderingInfo p_info) {
 		return RSG::viewport->get_total_vertices_drawn();
 	} else if (p_info == RENDERING_INFO_TOTAL_DRAW_CALLS_IN_FRAME) {
 		return RSG::viewport->get_total_draw_calls_used();
+	} else if (p_info == RENDERING_INFO_2D_ITEMS_IN_FRAME || p_info == RENDERING_INFO_2D_BATCHES_IN_FRAME) {
+		return RSG::canvas_render->get_rendering_info(p_info);
+	} else if (p_info == RENDERING_INFO_OCCLUSION_RAYS_IN_FRAME) {
+		return RendererSceneOcclusionCull::get_singleton()->get_rendering_info(p_info);
 	}
 	return RSG::storage->get_rendering_info(p_info);
 }
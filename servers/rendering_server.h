@@ -1438,6 +1438,11 @@ public:
 		RENDERING_INFO_TEXTURE_MEM_USED,
 		RENDERING_INFO_BUFFER_MEM_USED,
 		RENDERING_INFO_VIDEO_MEM_USED,
+		RENDERING_INFO_PIPELINE_CACHE_HITS,
+		RENDERING_INFO_PIPELINE_CACHE_MISSES,
+		RENDERING_INFO_2D_ITEMS_IN_FRAME,
+		RENDERING_INFO_2D_BATCHES_IN_FRAME,
+		RENDERING_INFO_OCCLUSION_RAYS_IN_FRAME,
 		RENDERING_INFO_MAX
 	};
 
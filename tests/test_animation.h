@@ -0,0 +1,228 @@
+/*************************************************************************/
+/*  test_animation.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_ANIMATION_H
+#define TEST_ANIMATION_H
+
+#include "scene/resources/animation.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAnimation {
+
+static const double KEY_RATE = 30.0;
+
+// A looping transform track over two compressed pages, turning more than a
+// full revolution so the keys cross between hemispheres.
+static Ref<Animation> create_animation(Animation::InterpolationType p_interpolation = Animation::INTERPOLATION_LINEAR) {
+	Ref<Animation> animation;
+	animation.instantiate();
+	animation->set_length(6.0);
+	animation->set_loop(true);
+	animation->add_track(Animation::TYPE_TRANSFORM3D);
+	animation->track_set_interpolation_type(0, p_interpolation);
+
+	const Vector3 axis = Vector3(0.3, 1.0, -0.5).normalized();
+	for (int i = 0; i < 6.0 * KEY_RATE; i++) {
+		const real_t t = i / KEY_RATE;
+		const Vector3 loc(Math::sin(t) * 2.0, Math::cos(t * 0.7), t * 0.1);
+		const Quaternion rot(axis, t * 2.5);
+		const Vector3 scale = Vector3(1, 1, 1) * (1.0 + 0.2 * Math::sin(t * 3.0));
+		animation->transform_track_insert_key(0, t, loc, rot, scale);
+	}
+	return animation;
+}
+
+// The last key at or before p_time, the way a key search would find it.
+static int find_key(const Ref<Animation> &p_animation, double p_time) {
+	int key = -1;
+	for (int i = 0; i < p_animation->track_get_key_count(0); i++) {
+		const double time = p_animation->track_get_key_time(0, i);
+		if (time <= p_time || Math::is_equal_approx(time, p_time)) {
+			key = i;
+		}
+	}
+	return key;
+}
+
+// Samples the track at each time with and without a cursor, which must agree.
+static void check_cursor(const Ref<Animation> &p_animation, const Vector<double> &p_times) {
+	int cursor = -1;
+	int wrong_keys = 0;
+	int wrong_values = 0;
+	for (int i = 0; i < p_times.size(); i++) {
+		Vector3 loc_a, loc_b;
+		Quaternion rot_a, rot_b;
+		p_animation->transform_track_interpolate(0, p_times[i], &loc_a, &rot_a, nullptr, &cursor);
+		p_animation->transform_track_interpolate(0, p_times[i], &loc_b, &rot_b, nullptr);
+		if (cursor != find_key(p_animation, p_times[i])) {
+			wrong_keys++;
+		}
+		if (loc_a != loc_b || rot_a != rot_b) {
+			wrong_values++;
+		}
+	}
+	CHECK(wrong_keys == 0);
+	CHECK(wrong_values == 0);
+}
+
+TEST_CASE("[Animation] Compressed transform keys stay within the quantization error") {
+	Ref<Animation> reference = create_animation();
+	Ref<Animation> animation = create_animation();
+	animation->compress();
+	REQUIRE(animation->track_is_compressed(0));
+	REQUIRE(animation->track_get_key_count(0) == reference->track_get_key_count(0));
+
+	real_t max_time_error = 0.0;
+	real_t max_loc_error = 0.0;
+	real_t max_rot_error = 0.0;
+	real_t max_scale_error = 0.0;
+	for (int i = 0; i < reference->track_get_key_count(0); i++) {
+		Vector3 loc_a, loc_b, scale_a, scale_b;
+		Quaternion rot_a, rot_b;
+		reference->transform_track_get_key(0, i, &loc_a, &rot_a, &scale_a);
+		animation->transform_track_get_key(0, i, &loc_b, &rot_b, &scale_b);
+		max_time_error = MAX(max_time_error, Math::abs(reference->track_get_key_time(0, i) - animation->track_get_key_time(0, i)));
+		max_loc_error = MAX(max_loc_error, loc_a.distance_to(loc_b));
+		max_rot_error = MAX(max_rot_error, rot_a.angle_to(rot_b));
+		max_scale_error = MAX(max_scale_error, scale_a.distance_to(scale_b));
+	}
+
+	// 16 bits over the page bounds, and 15 bits for each of the smallest three rotation components.
+	CHECK(max_time_error < 0.0001);
+	CHECK(max_loc_error < 0.0001);
+	CHECK(max_rot_error < 0.002);
+	CHECK(max_scale_error < 0.0001);
+}
+
+TEST_CASE("[Animation] Compressed transform tracks interpolate like the original ones") {
+	const Animation::InterpolationType interpolations[] = { Animation::INTERPOLATION_LINEAR, Animation::INTERPOLATION_CUBIC };
+	for (const Animation::InterpolationType interpolation : interpolations) {
+		Ref<Animation> reference = create_animation(interpolation);
+		Ref<Animation> animation = create_animation(interpolation);
+		animation->compress();
+
+		// Halfway between keys, where taking the long way around shows the most.
+		real_t max_loc_error = 0.0;
+		real_t max_rot_error = 0.0;
+		for (int i = 0; i < reference->track_get_key_count(0) - 1; i++) {
+			const double time = (i + 0.5) / KEY_RATE;
+			Vector3 loc_a, loc_b;
+			Quaternion rot_a, rot_b;
+			reference->transform_track_interpolate(0, time, &loc_a, &rot_a, nullptr);
+			animation->transform_track_interpolate(0, time, &loc_b, &rot_b, nullptr);
+			max_loc_error = MAX(max_loc_error, loc_a.distance_to(loc_b));
+			max_rot_error = MAX(max_rot_error, rot_a.angle_to(rot_b));
+		}
+		CHECK(max_loc_error < 0.001);
+		CHECK(max_rot_error < 0.01);
+	}
+}
+
+TEST_CASE("[Animation] Compressed transform tracks are saved and loaded as is") {
+	Ref<Animation> animation = create_animation();
+	animation->compress();
+
+	const Dictionary saved = animation->get("tracks/0/keys");
+	REQUIRE(saved.has("pages"));
+	REQUIRE(saved.has("keys"));
+
+	Ref<Animation> loaded;
+	loaded.instantiate();
+	loaded->set_length(animation->get_length());
+	loaded->add_track(Animation::TYPE_TRANSFORM3D);
+	loaded->set("tracks/0/keys", saved);
+	REQUIRE(loaded->track_is_compressed(0));
+	REQUIRE(loaded->track_get_key_count(0) == animation->track_get_key_count(0));
+
+	const Dictionary resaved = loaded->get("tracks/0/keys");
+	const Vector<real_t> saved_pages = saved["pages"];
+	const Vector<real_t> resaved_pages = resaved["pages"];
+	const Vector<uint8_t> saved_keys = saved["keys"];
+	const Vector<uint8_t> resaved_keys = resaved["keys"];
+	CHECK(resaved_pages == saved_pages);
+	CHECK(resaved_keys == saved_keys);
+
+	int different = 0;
+	for (int i = 0; i < animation->track_get_key_count(0); i++) {
+		Vector3 loc_a, loc_b, scale_a, scale_b;
+		Quaternion rot_a, rot_b;
+		animation->transform_track_get_key(0, i, &loc_a, &rot_a, &scale_a);
+		loaded->transform_track_get_key(0, i, &loc_b, &rot_b, &scale_b);
+		if (animation->track_get_key_time(0, i) != loaded->track_get_key_time(0, i) || loc_a != loc_b || rot_a != rot_b || scale_a != scale_b) {
+			different++;
+		}
+	}
+	CHECK(different == 0);
+
+	// Incomplete data is rejected.
+	Dictionary truncated;
+	truncated["pages"] = saved["pages"];
+	Vector<uint8_t> keys = saved_keys;
+	keys.resize(keys.size() - 1);
+	truncated["keys"] = keys;
+	ERR_PRINT_OFF;
+	loaded->set("tracks/0/keys", truncated);
+	ERR_PRINT_ON;
+	CHECK(loaded->track_get_key_count(0) == animation->track_get_key_count(0));
+}
+
+TEST_CASE("[Animation] Playback cursors find the same keys as a search") {
+	Ref<Animation> compressed = create_animation();
+	compressed->compress();
+	const Ref<Animation> animations[] = { create_animation(), compressed };
+
+	for (const Ref<Animation> &animation : animations) {
+		const double length = animation->get_length();
+
+		Vector<double> forward;
+		for (double time = 0.0; time < length; time += 1.0 / 60.0) {
+			forward.push_back(time);
+		}
+		check_cursor(animation, forward);
+
+		Vector<double> backward;
+		for (double time = length; time > 0.0; time -= 1.0 / 60.0) {
+			backward.push_back(time);
+		}
+		check_cursor(animation, backward);
+
+		// Faster than the keys so some are skipped, and wrapping around the end.
+		Vector<double> wrapping;
+		for (int i = 0; i < 3 * 60 * length; i++) {
+			wrapping.push_back(Math::fposmod(i * 2.7 / 60.0, length));
+		}
+		check_cursor(animation, wrapping);
+	}
+}
+
+} // namespace TestAnimation
+
+#endif // TEST_ANIMATION_H
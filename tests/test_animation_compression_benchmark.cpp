@@ -0,0 +1,148 @@
+/*************************************************************************/
+/*  test_animation_compression_benchmark.cpp                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "core/os/memory.h"
+#include "scene/resources/animation.h"
+
+#include "tests/test_benchmark.h"
+#include "tests/test_macros.h"
+
+// Samples many characters worth of bone tracks the way AnimationPlayer does,
+// with the plain and the compressed track format, and prints the memory used
+// and the sampling throughput of each. Memory is only tracked in debug builds.
+// Usage: `godot --test animation-compression-benchmark`.
+
+namespace TestAnimationCompressionBenchmark {
+
+static const int ANIMATION_COUNT = 8;
+static const int TRACK_COUNT = 100;
+static const double ANIMATION_LENGTH = 10.0;
+static const double KEY_RATE = 30.0;
+static const int CHARACTER_COUNT = 100;
+static const int FRAME_COUNT = 300;
+static const double FRAME_TIME = 1.0 / 60.0;
+
+static Ref<Animation> create_animation(int p_seed) {
+	Ref<Animation> animation;
+	animation.instantiate();
+	animation->set_length(ANIMATION_LENGTH);
+	animation->set_loop(true);
+
+	const int key_count = ANIMATION_LENGTH * KEY_RATE;
+	for (int i = 0; i < TRACK_COUNT; i++) {
+		animation->add_track(Animation::TYPE_TRANSFORM3D);
+		const real_t phase = (p_seed * TRACK_COUNT + i) * 0.37;
+		const Vector3 axis = Vector3(Math::sin(phase), 1.0, Math::cos(phase)).normalized();
+		for (int j = 0; j < key_count; j++) {
+			const real_t t = j / KEY_RATE;
+			Vector3 loc(Math::sin(t + phase), Math::cos(t * 0.5 + phase) * 0.2, i * 0.1);
+			Quaternion rot(axis, Math::sin(t * 2.0 + phase) * Math_PI);
+			Vector3 scale = Vector3(1, 1, 1) * (1.0 + 0.1 * Math::sin(t * 3.0));
+			animation->transform_track_insert_key(i, t, loc, rot, scale);
+		}
+	}
+
+	return animation;
+}
+
+static uint64_t run_playback(const Vector<Ref<Animation>> &p_animations, bool p_use_cursors) {
+	Vector<int> cursors;
+	cursors.resize(CHARACTER_COUNT * TRACK_COUNT);
+	cursors.fill(-1);
+	int *cursor = cursors.ptrw();
+
+	return TestBenchmark::time_usec([&]() {
+		for (int frame = 0; frame < FRAME_COUNT; frame++) {
+			for (int c = 0; c < CHARACTER_COUNT; c++) {
+				const Ref<Animation> &animation = p_animations[c % ANIMATION_COUNT];
+				const double time = Math::fposmod(frame * FRAME_TIME + c * 0.13, ANIMATION_LENGTH);
+				for (int i = 0; i < TRACK_COUNT; i++) {
+					Vector3 loc;
+					Quaternion rot;
+					Vector3 scale;
+					animation->transform_track_interpolate(i, time, &loc, &rot, &scale, p_use_cursors ? &cursor[c * TRACK_COUNT + i] : nullptr);
+				}
+			}
+		}
+	});
+}
+
+void benchmark() {
+	const int key_count = TRACK_COUNT * ANIMATION_LENGTH * KEY_RATE * ANIMATION_COUNT;
+	print_line(vformat("%d animations of %d tracks, %d keys in total, sampled by %d characters for %d frames.", ANIMATION_COUNT, TRACK_COUNT, key_count, CHARACTER_COUNT, FRAME_COUNT));
+
+	Vector<Ref<Animation>> animations;
+	uint64_t mem_before = Memory::get_mem_usage();
+	for (int i = 0; i < ANIMATION_COUNT; i++) {
+		animations.push_back(create_animation(i));
+	}
+	uint64_t plain_mem = Memory::get_mem_usage() - mem_before;
+
+	uint64_t plain = run_playback(animations, false);
+	uint64_t plain_cursors = run_playback(animations, true);
+
+	for (int i = 0; i < ANIMATION_COUNT; i++) {
+		animations.write[i]->compress();
+	}
+	uint64_t compressed_mem = Memory::get_mem_usage() - mem_before;
+
+	uint64_t compressed = run_playback(animations, false);
+	uint64_t compressed_cursors = run_playback(animations, true);
+
+	// Animations are generated deterministically, so a new one can serve as reference.
+	Ref<Animation> reference = create_animation(0);
+	real_t max_loc_error = 0.0;
+	real_t max_rot_error = 0.0;
+	for (int i = 0; i < TRACK_COUNT; i++) {
+		for (int j = 0; j < reference->track_get_key_count(i); j++) {
+			Vector3 loc_a, loc_b;
+			Quaternion rot_a, rot_b;
+			reference->transform_track_get_key(i, j, &loc_a, &rot_a, nullptr);
+			animations[0]->transform_track_get_key(i, j, &loc_b, &rot_b, nullptr);
+			max_loc_error = MAX(max_loc_error, loc_a.distance_to(loc_b));
+			max_rot_error = MAX(max_rot_error, rot_a.angle_to(rot_b));
+		}
+	}
+
+	print_line(vformat("Memory: %d KiB plain, %d KiB compressed, %.2f bytes/key compressed.", int(plain_mem / 1024), int(compressed_mem / 1024), double(compressed_mem) / key_count));
+	print_line(vformat("Max error: %.5f location, %.4f degrees rotation.", max_loc_error, Math::rad2deg(max_rot_error)));
+
+	const double samples = double(CHARACTER_COUNT) * TRACK_COUNT * FRAME_COUNT;
+	TestBenchmark::Table table("samples");
+	table.add_row("Plain", plain, samples);
+	table.add_row("Plain, cursors", plain_cursors, samples);
+	table.add_row("Compressed", compressed, samples);
+	table.add_row("Compressed, cursors", compressed_cursors, samples);
+	table.print();
+}
+
+REGISTER_TEST_COMMAND("animation-compression-benchmark", &benchmark);
+
+} // namespace TestAnimationCompressionBenchmark
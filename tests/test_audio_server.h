@@ -0,0 +1,307 @@
+/*************************************************************************/
+/*  test_audio_server.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_AUDIO_SERVER_H
+#define TEST_AUDIO_SERVER_H
+
+#include "core/os/mutex.h"
+#include "servers/audio/audio_stream.h"
+#include "servers/audio/effects/audio_effect_compressor.h"
+#include "servers/audio_server.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAudioServer {
+
+// Mixes only when asked to, so tests control every mix step.
+class TestAudioDriver : public AudioDriver {
+	LocalVector<int32_t> samples;
+
+public:
+	virtual const char *get_name() const override { return "Test"; }
+	virtual Error init() override { return OK; }
+	virtual void start() override {}
+	virtual int get_mix_rate() const override { return 44100; }
+	virtual SpeakerMode get_speaker_mode() const override { return SPEAKER_MODE_STEREO; }
+	virtual void lock() override {}
+	virtual void unlock() override {}
+	virtual void finish() override {}
+
+	// One mix step of the server.
+	void mix() {
+		const int frames = AudioServer::get_singleton()->thread_get_mix_buffer_size();
+		samples.resize(frames * 2);
+		audio_server_process(frames, samples.ptr());
+	}
+};
+
+class TestServer {
+	AudioDriver *previous_driver = nullptr;
+
+public:
+	TestAudioDriver driver;
+	AudioServer *server = nullptr;
+
+	TestServer() {
+		previous_driver = AudioDriver::get_singleton();
+		driver.set_singleton();
+		server = memnew(AudioServer);
+		server->init();
+	}
+
+	~TestServer() {
+		server->finish();
+		memdelete(server);
+		if (previous_driver) {
+			previous_driver->set_singleton();
+		}
+	}
+};
+
+// Plays a constant signal for a given length, optionally looping over part of it.
+class TestPlayback : public AudioStreamPlayback {
+public:
+	float length = 0;
+	bool loop = false;
+	float loop_begin = 0;
+	float loop_end = 0;
+
+	int64_t frame = 0;
+	int mixes = 0;
+	float last_seek = -1;
+
+	virtual void start(float p_from_pos = 0.0) override { frame = p_from_pos * 44100; }
+	virtual void stop() override {}
+	virtual bool is_playing() const override { return true; }
+	virtual float get_playback_position() const override { return float(frame) / 44100; }
+	virtual void seek(float p_time) override {
+		last_seek = p_time;
+		frame = p_time * 44100;
+	}
+
+	virtual float get_length() const override { return length; }
+	virtual bool get_loop_range(float &r_begin, float &r_end) const override {
+		r_begin = loop_begin;
+		r_end = loop_end;
+		return loop;
+	}
+
+	virtual int mix(AudioFrame *p_buffer, float p_rate_scale, int p_frames) override {
+		mixes++;
+		int mixed = p_frames;
+		if (!loop) {
+			mixed = CLAMP(int64_t(length * 44100) - frame, 0, p_frames);
+		}
+		for (int i = 0; i < mixed; i++) {
+			p_buffer[i] = AudioFrame(1, 1);
+		}
+		frame += mixed;
+		return mixed;
+	}
+};
+
+static Vector<AudioFrame> volumes(float p_volume) {
+	Vector<AudioFrame> volume;
+	volume.resize(AudioServer::MAX_CHANNELS_PER_BUS);
+	for (int i = 0; i < volume.size(); i++) {
+		volume.write[i] = AudioFrame(p_volume, p_volume);
+	}
+	return volume;
+}
+
+static float mix_time(const TestServer &p_test_server) {
+	return float(p_test_server.server->thread_get_mix_buffer_size()) / 44100;
+}
+
+TEST_CASE("[AudioServer] Inaudible voices are virtual and end with their stream") {
+	TestServer test_server;
+	AudioServer *server = test_server.server;
+
+	Ref<TestPlayback> playback;
+	playback.instantiate();
+	playback->length = 0.1;
+	server->start_playback_stream(playback, SNAME("Master"), volumes(0));
+
+	// Fully silent from the start, so it's never mixed.
+	const int mixes_to_end = Math::ceil(playback->length / mix_time(test_server));
+	for (int i = 0; i < mixes_to_end - 1; i++) {
+		test_server.driver.mix();
+	}
+	CHECK(server->get_virtual_voice_count() == 1);
+	CHECK(server->get_real_voice_count() == 0);
+	CHECK(playback->mixes == 0);
+	CHECK(server->is_playback_active(playback));
+
+	test_server.driver.mix();
+	CHECK_MESSAGE(!server->is_playback_active(playback), "The stream would have ended while it was virtual.");
+	CHECK(playback->mixes == 0);
+}
+
+TEST_CASE("[AudioServer] Looping virtual voices resume within the loop") {
+	TestServer test_server;
+	AudioServer *server = test_server.server;
+
+	Ref<TestPlayback> playback;
+	playback.instantiate();
+	playback->length = 0.2;
+	playback->loop = true;
+	playback->loop_begin = 0.05;
+	playback->loop_end = 0.15;
+	server->start_playback_stream(playback, SNAME("Master"), volumes(0));
+
+	const int mixes = 40;
+	for (int i = 0; i < mixes; i++) {
+		test_server.driver.mix();
+	}
+	CHECK(server->is_playback_active(playback));
+	CHECK(playback->mixes == 0);
+
+	Map<StringName, Vector<AudioFrame>> bus_volumes;
+	bus_volumes[SNAME("Master")] = volumes(1);
+	server->set_playback_bus_volumes_linear(playback, bus_volumes);
+	test_server.driver.mix();
+
+	CHECK(server->get_real_voice_count() == 1);
+	CHECK(playback->mixes == 1);
+	const float expected = 0.05 + Math::fposmod(mixes * mix_time(test_server) - 0.05f, 0.1f);
+	CHECK(playback->last_seek == doctest::Approx(expected).epsilon(0.001));
+
+	server->stop_playback_stream(playback);
+	test_server.driver.mix();
+}
+
+// Logs the bus it's on every time it runs.
+class OrderLog {
+	Mutex mutex;
+
+public:
+	LocalVector<int> buses;
+
+	void add(int p_bus) {
+		MutexLock lock(mutex);
+		buses.push_back(p_bus);
+	}
+
+	int find(int p_bus) const {
+		for (uint32_t i = 0; i < buses.size(); i++) {
+			if (buses[i] == p_bus) {
+				return i;
+			}
+		}
+		return -1;
+	}
+};
+
+class OrderEffectInstance : public AudioEffectInstance {
+public:
+	OrderLog *log = nullptr;
+	int bus = 0;
+
+	virtual void process(const AudioFrame *p_src_frames, AudioFrame *p_dst_frames, int p_frame_count) override {
+		log->add(bus);
+		for (int i = 0; i < p_frame_count; i++) {
+			p_dst_frames[i] = p_src_frames[i];
+		}
+	}
+
+	// Buses without audio are logged too.
+	virtual bool process_silence() const override { return true; }
+};
+
+class OrderEffect : public AudioEffect {
+public:
+	OrderLog *log = nullptr;
+	int bus = 0;
+
+	virtual Ref<AudioEffectInstance> instantiate() override {
+		Ref<OrderEffectInstance> instance;
+		instance.instantiate();
+		instance->log = log;
+		instance->bus = bus;
+		return instance;
+	}
+};
+
+TEST_CASE("[AudioServer] Buses are processed after the buses they read") {
+	TestServer test_server;
+	AudioServer *server = test_server.server;
+
+	// Master <- A <- B, Master <- C, Master <- D. B, C and D are at the same
+	// depth, and C sidechains B.
+	OrderLog log;
+	server->set_bus_count(5);
+	server->set_bus_name(1, "A");
+	server->set_bus_name(2, "B");
+	server->set_bus_name(3, "C");
+	server->set_bus_name(4, "D");
+	server->set_bus_send(2, "A");
+
+	Ref<AudioEffectCompressor> compressor;
+	compressor.instantiate();
+	compressor->set_sidechain("B");
+	server->add_bus_effect(3, compressor);
+
+	for (int i = 0; i < 5; i++) {
+		Ref<OrderEffect> effect;
+		effect.instantiate();
+		effect->log = &log;
+		effect->bus = i;
+		server->add_bus_effect(i, effect);
+	}
+
+	Ref<TestPlayback> playback;
+	playback.instantiate();
+	playback->loop = true;
+	playback->loop_end = 1;
+	playback->length = 1;
+	server->start_playback_stream(playback, SNAME("B"), volumes(1));
+
+	for (int i = 0; i < 4; i++) {
+		log.buses.clear();
+		test_server.driver.mix();
+
+		REQUIRE(log.buses.size() == 5);
+		CHECK(log.find(2) < log.find(1));
+		CHECK(log.find(1) < log.find(0));
+		CHECK(log.find(3) < log.find(0));
+		CHECK(log.find(4) < log.find(0));
+		CHECK_MESSAGE(log.find(2) < log.find(3), "The sidechain must see its source processed.");
+	}
+
+	// B reaches the master bus through A, at full volume once the ramp is done.
+	CHECK(server->get_bus_peak_volume_left_db(0, 0) == doctest::Approx(0).epsilon(0.001));
+
+	server->stop_playback_stream(playback);
+	test_server.driver.mix();
+}
+
+} // namespace TestAudioServer
+
+#endif // TEST_AUDIO_SERVER_H
@@ -0,0 +1,251 @@
+/*************************************************************************/
+/*  test_audio_stream.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_AUDIO_STREAM_H
+#define TEST_AUDIO_STREAM_H
+
+#include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
+#include "servers/audio/audio_stream.h"
+
+#include "tests/test_audio_server.h"
+#include "tests/test_macros.h"
+
+namespace TestAudioStream {
+
+// Decodes each frame as its own index, so the mixed frames tell where they came from.
+class TestDecoder : public AudioStreamPlaybackResampled {
+public:
+	int length = 44100;
+	bool loop = false;
+	int loop_begin = 0;
+
+	bool active = false;
+	int frame = 0;
+	int loops = 0;
+
+	virtual int _mix_internal(AudioFrame *p_buffer, int p_frames) override {
+		int mixed = 0;
+		while (mixed < p_frames && active) {
+			if (frame == length) {
+				if (!loop) {
+					active = false;
+					break;
+				}
+				frame = loop_begin;
+				loops++;
+				_mark_position(float(frame) / 44100, mixed);
+			}
+			p_buffer[mixed++] = AudioFrame(frame, frame);
+			frame++;
+		}
+		for (int i = mixed; i < p_frames; i++) {
+			p_buffer[i] = AudioFrame(0, 0);
+		}
+		return mixed;
+	}
+	virtual float get_stream_sampling_rate() override { return 44100; }
+	virtual bool _can_predecode() const override { return true; }
+
+	virtual void start(float p_from_pos = 0.0) override {
+		_finish_predecode();
+		active = true;
+		frame = p_from_pos * 44100;
+		_mark_position(float(frame) / 44100);
+		loops = 0;
+		_begin_resample();
+	}
+	virtual void stop() override {
+		MutexLock lock(decoder_mutex);
+		active = false;
+		_discard_predecoded();
+	}
+	virtual bool is_playing() const override { return active; }
+	virtual int get_loop_count() const override { return loops; }
+	virtual float get_playback_position() const override { return _get_mixed_position(float(frame) / 44100); }
+	virtual void seek(float p_time) override {
+		MutexLock lock(decoder_mutex);
+		frame = p_time * 44100;
+		_discard_predecoded();
+		_mark_position(float(frame) / 44100);
+	}
+
+	float get_buffered_time() const { return _get_predecoded_time(); }
+
+	~TestDecoder() {
+		_finish_predecode();
+	}
+};
+
+// Keeps a worker busy for a moment, like the tasks of a physics step.
+class BusyTask : public WorkerThreadPool::Task {
+public:
+	virtual void run() override {
+		const uint64_t end = OS::get_singleton()->get_ticks_usec() + 100;
+		while (OS::get_singleton()->get_ticks_usec() < end) {
+		}
+	}
+};
+
+// Mixes at the stream rate, where the resampler only delays the frames by its history.
+static int mix(TestDecoder &p_decoder, LocalVector<float> &r_values) {
+	AudioFrame buffer[512];
+	int mixed = p_decoder.mix(buffer, 1.0, 512);
+	for (int i = 0; i < 512; i++) {
+		r_values.push_back(buffer[i].l);
+	}
+	return mixed;
+}
+
+TEST_CASE("[AudioStream] Frames decoded before a seek are discarded") {
+	TestAudioServer::TestServer test_server;
+	Ref<TestDecoder> decoder;
+	decoder.instantiate();
+	decoder->length = 88200;
+	decoder->start(0);
+
+	LocalVector<float> values;
+	for (int i = 0; i < 4; i++) {
+		mix(**decoder, values);
+	}
+	const uint32_t seek_at = values.size();
+	decoder->seek(1.0);
+	CHECK(decoder->get_playback_position() == doctest::Approx(1.0));
+	for (int i = 0; i < 4; i++) {
+		mix(**decoder, values);
+	}
+
+	// The two frames of history are silent, then the frames follow each other
+	// up to a single jump to where it seeked, past what the mix already pulled.
+	CHECK(values[0] == 0);
+	CHECK(values[1] == 0);
+	int jumps = 0;
+	for (uint32_t i = 3; i < values.size(); i++) {
+		if (values[i] == values[i - 1] + 1) {
+			continue;
+		}
+		jumps++;
+		CHECK(values[i] == 44100);
+		CHECK(i >= seek_at);
+		CHECK(i <= seek_at + 258);
+	}
+	CHECK(jumps == 1);
+}
+
+TEST_CASE("[AudioStream] Frames decoded ahead are mixed after the end") {
+	TestAudioServer::TestServer test_server;
+	Ref<TestDecoder> decoder;
+	decoder.instantiate();
+	decoder->length = 10000; // Doesn't end on a full internal buffer.
+	decoder->start(0);
+
+	LocalVector<float> values;
+	bool ended = false;
+	for (int i = 0; i < 100 && !ended; i++) {
+		ended = mix(**decoder, values) < 512;
+	}
+	CHECK(ended);
+	CHECK_FALSE(decoder->is_playing());
+
+	// Every frame was mixed once and in order, followed by silence.
+	REQUIRE(values.size() > 10002);
+	int wrong = 0;
+	for (uint32_t i = 2; i < values.size(); i++) {
+		if (values[i] != (i < 10002 ? float(i - 2) : 0.0f)) {
+			wrong++;
+		}
+	}
+	CHECK(wrong == 0);
+	CHECK(decoder->get_playback_position() == doctest::Approx(10000 / 44100.0));
+}
+
+TEST_CASE("[AudioStream] Playback position follows the mix across loops") {
+	TestAudioServer::TestServer test_server;
+	Ref<TestDecoder> decoder;
+	decoder.instantiate();
+	decoder->length = 22050;
+	decoder->loop = true;
+	decoder->loop_begin = 11025;
+	decoder->start(0);
+
+	const int loop_length = decoder->length - decoder->loop_begin;
+	LocalVector<float> values;
+	for (int i = 0; i < 256; i++) {
+		mix(**decoder, values);
+
+		const float position = decoder->get_playback_position();
+		CHECK(position >= 0);
+		CHECK(position < 0.5);
+
+		// The position is where the mix pulls frames from, at most the
+		// internal buffer and its history ahead of the last mixed frame.
+		float ahead = position * 44100 - (values[values.size() - 1] + 1);
+		if (ahead < -1) {
+			ahead += loop_length;
+		}
+		CHECK(ahead > -1);
+		CHECK(ahead < 260);
+	}
+	CHECK(decoder->get_loop_count() > 5);
+}
+
+TEST_CASE("[AudioStream] Frames are decoded ahead while the workers are busy") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (pool->get_thread_count() == 0) {
+		return; // Nothing is decoded ahead without workers.
+	}
+
+	TestAudioServer::TestServer test_server;
+	Ref<TestDecoder> decoder;
+	decoder.instantiate();
+	decoder->length = 441000;
+
+	// About a second of foreground work queued on every worker.
+	BusyTask busy;
+	WorkerThreadPool::Group group;
+	pool->add_task(&busy, WorkerThreadPool::PRIORITY_NORMAL, &group, nullptr, pool->get_thread_count() * 10000);
+
+	// Starting decodes what the mix needs right away and queues the rest.
+	decoder->start(0);
+	const uint64_t timeout = OS::get_singleton()->get_ticks_usec() + 1000000;
+	while (decoder->get_buffered_time() < 0.099 && OS::get_singleton()->get_ticks_usec() < timeout) {
+		OS::get_singleton()->delay_usec(1000);
+	}
+	const uint32_t pending = group.get_pending();
+
+	CHECK(decoder->get_buffered_time() >= 0.099);
+	CHECK_MESSAGE(pending > 0, "The ring should fill before the foreground work is done.");
+
+	pool->wait(&group);
+}
+
+} // namespace TestAudioStream
+
+#endif // TEST_AUDIO_STREAM_H
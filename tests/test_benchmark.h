@@ -0,0 +1,97 @@
+/*************************************************************************/
+/*  test_benchmark.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_BENCHMARK_H
+#define TEST_BENCHMARK_H
+
+#include "core/os/os.h"
+#include "core/string/print_string.h"
+#include "core/templates/local_vector.h"
+
+// Shared timing and reporting of the `godot --test <name>-benchmark` commands.
+
+namespace TestBenchmark {
+
+template <class F>
+uint64_t time_usec(F p_function) {
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	p_function();
+	return MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+}
+
+// 1, 2, 4... up to the processor count, which is always included.
+inline LocalVector<int> get_thread_counts() {
+	LocalVector<int> counts;
+	const int max_count = OS::get_singleton()->get_processor_count();
+	for (int count = 1; count < max_count; count *= 2) {
+		counts.push_back(count);
+	}
+	counts.push_back(max_count);
+	return counts;
+}
+
+// Prints one line per measurement, with the time, the throughput and the
+// speedup over the first measurement.
+class Table {
+	struct Row {
+		String name;
+		uint64_t usec = 0;
+		double work = 0.0;
+	};
+
+	String unit;
+	LocalVector<Row> rows;
+
+public:
+	Table(const String &p_unit) {
+		unit = p_unit;
+	}
+
+	void add_row(const String &p_name, uint64_t p_usec, double p_work) {
+		Row row;
+		row.name = p_name;
+		row.usec = MAX(p_usec, (uint64_t)1);
+		row.work = p_work;
+		rows.push_back(row);
+	}
+
+	void print() const {
+		for (uint32_t i = 0; i < rows.size(); i++) {
+			const Row &row = rows[i];
+			const double rate = row.work / (row.usec / 1000000.0);
+			const double baseline = rows[0].work / (rows[0].usec / 1000000.0);
+			print_line(vformat("%s: %.2f ms, %.1f %s/s, %.2fx", row.name, row.usec / 1000.0, rate, unit, rate / baseline));
+		}
+	}
+};
+
+} // namespace TestBenchmark
+
+#endif // TEST_BENCHMARK_H
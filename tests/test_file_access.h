@@ -32,6 +32,8 @@
 #define TEST_FILE_ACCESS_H
 
 #include "core/io/file_access.h"
+#include "core/io/file_access_compressed.h"
+#include "core/os/os.h"
 #include "test_utils.h"
 
 namespace TestFileAccess {
@@ -79,6 +81,72 @@ TEST_CASE("[FileAccess] CSV read") {
 
 	f->close();
 }
+
+TEST_CASE("[FileAccess] Compressed read with read-ahead") {
+	const String path = OS::get_singleton()->get_cache_path().plus_file("compressed_read_ahead.bin");
+	const uint32_t block_size = 1024;
+	Vector<uint8_t> data;
+	data.resize(block_size * 10 + 100);
+	for (int i = 0; i < data.size(); i++) {
+		data.write[i] = (i * 31 + i / 7) & 0xFF;
+	}
+
+	FileAccessCompressed *fw = memnew(FileAccessCompressed);
+	fw->configure("TEST", Compression::MODE_ZSTD, block_size);
+	REQUIRE(fw->_open(path, FileAccess::WRITE) == OK);
+	fw->store_buffer(data.ptr(), data.size());
+	fw->close();
+	memdelete(fw);
+
+	for (uint32_t read_ahead = 0; read_ahead <= 3; read_ahead += 3) {
+		FileAccessCompressed *fr = memnew(FileAccessCompressed);
+		fr->configure("TEST");
+		fr->set_read_ahead(read_ahead);
+		REQUIRE(fr->_open(path, FileAccess::READ) == OK);
+		CHECK(fr->get_length() == (uint64_t)data.size());
+
+		Vector<uint8_t> read;
+		read.resize(data.size());
+		CHECK(fr->get_buffer(read.ptrw(), 3000) == 3000);
+		CHECK(fr->get_buffer(read.ptrw() + 3000, read.size() - 3000) == (uint64_t)read.size() - 3000);
+		CHECK_MESSAGE(
+				read == data,
+				"Sequential reads across blocks should return the stored data.");
+		CHECK_FALSE(fr->eof_reached());
+		CHECK(fr->get_buffer(read.ptrw(), 1) == 0);
+		CHECK(fr->eof_reached());
+
+		// Seeking back discards blocks decompressed ahead.
+		fr->seek(block_size * 2 + 5);
+		CHECK(fr->get_8() == data[block_size * 2 + 5]);
+		fr->seek(block_size * 8 - 1);
+		uint8_t bytes[2];
+		CHECK(fr->get_buffer(bytes, 2) == 2);
+		CHECK(bytes[0] == data[block_size * 8 - 1]);
+		CHECK(bytes[1] == data[block_size * 8]);
+		CHECK(fr->get_position() == block_size * 8 + 1);
+
+		fr->close();
+		memdelete(fr);
+	}
+
+	// Reads smaller than a block never start reading ahead, the data must be
+	// the same either way.
+	FileAccessCompressed *fr = memnew(FileAccessCompressed);
+	fr->configure("TEST");
+	REQUIRE(fr->_open(path, FileAccess::READ) == OK);
+	Vector<uint8_t> read;
+	read.resize(data.size());
+	uint64_t total = 0;
+	while (total < (uint64_t)data.size()) {
+		const uint64_t got = fr->get_buffer(read.ptrw() + total, MIN((uint64_t)300, data.size() - total));
+		REQUIRE(got > 0);
+		total += got;
+	}
+	CHECK(read == data);
+	fr->close();
+	memdelete(fr);
+}
 } // namespace TestFileAccess
 
 #endif // TEST_FILE_ACCESS_H
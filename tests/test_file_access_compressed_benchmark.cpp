@@ -0,0 +1,123 @@
+/*************************************************************************/
+/*  test_file_access_compressed_benchmark.cpp                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access_compressed.h"
+
+#include "tests/test_benchmark.h"
+#include "tests/test_macros.h"
+
+// Writes a compressible file with each compression mode and block size, then
+// reads it back sequentially in chunks smaller than a block, which read on the
+// calling thread, and in chunks of several blocks, which read ahead on the
+// worker threads, and prints the throughput.
+// Usage: `godot --test file-access-compressed-benchmark`.
+
+namespace TestFileAccessCompressedBenchmark {
+
+static const int DATA_SIZE = 64 * 1024 * 1024;
+
+static Vector<uint8_t> make_data() {
+	// Repeating runs with some noise, roughly like vertex and index buffers.
+	Vector<uint8_t> data;
+	data.resize(DATA_SIZE);
+	uint8_t *w = data.ptrw();
+	uint32_t seed = 12345;
+	for (int i = 0; i < DATA_SIZE; i += 4) {
+		seed = seed * 1103515245 + 12345;
+		uint32_t v = (i / 4) % 4096 + ((seed >> 16) & 0x3);
+		memcpy(w + i, &v, 4);
+	}
+	return data;
+}
+
+static uint64_t read_file(const String &p_path, uint32_t p_chunk, Vector<uint8_t> &r_buffer) {
+	FileAccessCompressed *f = memnew(FileAccessCompressed);
+	f->configure("BNCH");
+	if (f->_open(p_path, FileAccess::READ) != OK) {
+		memdelete(f);
+		return 0;
+	}
+
+	r_buffer.resize(p_chunk);
+	const uint64_t elapsed = TestBenchmark::time_usec([&]() {
+		while (!f->eof_reached()) {
+			if (f->get_buffer(r_buffer.ptrw(), p_chunk) == 0) {
+				break;
+			}
+		}
+	});
+
+	f->close();
+	memdelete(f);
+	return elapsed;
+}
+
+void benchmark() {
+	const char *mode_names[] = { "FastLZ", "Deflate", "Zstd", "GZip" };
+	const Compression::Mode modes[] = { Compression::MODE_FASTLZ, Compression::MODE_DEFLATE, Compression::MODE_ZSTD, Compression::MODE_GZIP };
+	const uint32_t block_sizes[] = { 4096, 64 * 1024, 256 * 1024 };
+
+	const String path = OS::get_singleton()->get_cache_path().plus_file("file_access_compressed_benchmark.bin");
+	Vector<uint8_t> data = make_data();
+	Vector<uint8_t> buffer;
+	const double mib = DATA_SIZE / (1024.0 * 1024.0);
+
+	print_line(vformat("Reading %d MiB sequentially.", DATA_SIZE / (1024 * 1024)));
+
+	for (int m = 0; m < 4; m++) {
+		for (int b = 0; b < 3; b++) {
+			FileAccessCompressed *f = memnew(FileAccessCompressed);
+			f->configure("BNCH", modes[m], block_sizes[b]);
+			if (f->_open(path, FileAccess::WRITE) != OK) {
+				memdelete(f);
+				ERR_FAIL_MSG("Can't write benchmark file: " + path + ".");
+			}
+			f->store_buffer(data.ptr(), data.size());
+			f->close();
+			memdelete(f);
+
+			FileAccessRef fa = FileAccess::open(path, FileAccess::READ);
+			double ratio = fa ? double(fa->get_length()) / DATA_SIZE : 0.0;
+			print_line(vformat("%s, %d KiB blocks, ratio %.3f:", mode_names[m], block_sizes[b] / 1024, ratio));
+
+			TestBenchmark::Table table("MiB");
+			table.add_row("  Half block reads", read_file(path, block_sizes[b] / 2, buffer), mib);
+			table.add_row("  Four block reads", read_file(path, block_sizes[b] * 4, buffer), mib);
+			table.print();
+		}
+	}
+
+	DirAccess::remove_file_or_error(path);
+}
+
+REGISTER_TEST_COMMAND("file-access-compressed-benchmark", &benchmark);
+
+} // namespace TestFileAccessCompressedBenchmark
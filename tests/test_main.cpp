@@ -33,8 +33,11 @@
 #include "core/templates/list.h"
 
 #include "test_aabb.h"
+#include "test_animation.h"
 #include "test_array.h"
 #include "test_astar.h"
+#include "test_audio_server.h"
+#include "test_audio_stream.h"
 #include "test_basis.h"
 #include "test_class_db.h"
 #include "test_color.h"
@@ -57,6 +60,7 @@
 #include "test_lru.h"
 #include "test_marshalls.h"
 #include "test_math.h"
+#include "test_message_queue.h"
 #include "test_method_bind.h"
 #include "test_node_path.h"
 #include "test_oa_hash_map.h"
@@ -67,18 +71,24 @@
 #include "test_pck_packer.h"
 #include "test_physics_2d.h"
 #include "test_physics_3d.h"
+#include "test_physics_3d_queries.h"
+#include "test_physics_3d_step.h"
 #include "test_random_number_generator.h"
 #include "test_rect2.h"
 #include "test_render.h"
+#include "test_renderer_scene_cull.h"
 #include "test_resource.h"
+#include "test_scene_tree.h"
 #include "test_shader_lang.h"
 #include "test_string.h"
+#include "test_string_name.h"
 #include "test_text_server.h"
 #include "test_time.h"
 #include "test_translation.h"
 #include "test_validate_testing.h"
 #include "test_variant.h"
 #include "test_vector.h"
+#include "test_worker_thread_pool.h"
 #include "test_xml_parser.h"
 
 #include "modules/modules_tests.gen.h"
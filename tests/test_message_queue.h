@@ -0,0 +1,247 @@
+/*************************************************************************/
+/*  test_message_queue.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MESSAGE_QUEUE_H
+#define TEST_MESSAGE_QUEUE_H
+
+#include "core/object/message_queue.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMessageQueue {
+
+class Receiver : public Object {
+public:
+	MessageQueue *queue = nullptr;
+	LocalVector<int> values;
+	bool flushing = false;
+
+	void record(int p_value) {
+		values.push_back(p_value);
+		flushing = queue && queue->is_flushing();
+	}
+
+	void record_and_post(int p_value) {
+		record(p_value);
+		if (p_value < 4) {
+			queue->push_callable(callable_mp(this, &Receiver::record_and_post), p_value + 1);
+		}
+	}
+};
+
+// Posts `count` calls starting at `first` from its own thread, then
+// optionally waits before exiting.
+struct Poster {
+	MessageQueue *queue = nullptr;
+	Receiver *receiver = nullptr;
+	int first = 0;
+	int count = 0;
+	Semaphore posted;
+	Semaphore *exit = nullptr;
+
+	static void run(void *p_userdata) {
+		Poster *self = (Poster *)p_userdata;
+		for (int i = 0; i < self->count; i++) {
+			self->queue->push_callable(callable_mp(self->receiver, &Receiver::record), self->first + i);
+		}
+		self->posted.post();
+		if (self->exit) {
+			self->exit->wait();
+		}
+	}
+};
+
+TEST_CASE("[MessageQueue] Deferred calls run in posting order") {
+	MessageQueue *queue = memnew(MessageQueue);
+	Object *object = memnew(Object);
+
+	for (int i = 0; i < 10; i++) {
+		queue->push_call(object->get_instance_id(), "set_meta", "value", i);
+	}
+	CHECK(!object->has_meta("value"));
+
+	queue->flush();
+	CHECK(int(object->get_meta("value")) == 9);
+	CHECK(queue->get_last_flush_message_count() == 10);
+
+	memdelete(object);
+	memdelete(queue);
+}
+
+TEST_CASE("[MessageQueue] Queues grow instead of failing") {
+	MessageQueue *queue = memnew(MessageQueue);
+	Object *object = memnew(Object);
+
+	// Well past the default size of the main thread queue.
+	const int message_count = 200000;
+	const String payload = "payload";
+	for (int i = 0; i < message_count; i++) {
+		CHECK_MESSAGE(queue->push_call(object->get_instance_id(), "set_meta", payload, i) == OK, "Pushing should never run out of memory.");
+	}
+
+	queue->flush();
+	CHECK(int(object->get_meta(payload)) == message_count - 1);
+	CHECK(queue->get_last_flush_message_count() == message_count);
+	CHECK(queue->get_max_buffer_usage() > 0);
+
+	memdelete(object);
+	memdelete(queue);
+}
+
+TEST_CASE("[MessageQueue] Calls posted while flushing run in the same flush") {
+	MessageQueue *queue = memnew(MessageQueue);
+	Receiver receiver;
+	receiver.queue = queue;
+
+	CHECK(!queue->is_flushing());
+	queue->push_callable(callable_mp(&receiver, &Receiver::record_and_post), 0);
+	queue->flush();
+	CHECK(!queue->is_flushing());
+	CHECK(receiver.flushing);
+
+	REQUIRE(receiver.values.size() == 5);
+	for (int i = 0; i < 5; i++) {
+		CHECK(receiver.values[i] == i);
+	}
+	CHECK(queue->get_last_flush_message_count() == 5);
+
+	memdelete(queue);
+}
+
+TEST_CASE("[MessageQueue] Calls from all threads run in the order they were posted") {
+	MessageQueue *queue = memnew(MessageQueue);
+	Receiver receiver;
+
+	// One thread after the other, the main thread in between.
+	Poster posters[2];
+	for (int i = 0; i < 2; i++) {
+		posters[i].queue = queue;
+		posters[i].receiver = &receiver;
+		posters[i].first = (i + 1) * 1000;
+		posters[i].count = 100;
+
+		Thread thread;
+		thread.start(&Poster::run, &posters[i]);
+		thread.wait_to_finish();
+		queue->push_callable(callable_mp(&receiver, &Receiver::record), i);
+	}
+
+	queue->flush();
+	REQUIRE(receiver.values.size() == 202);
+	bool ordered = true;
+	for (int i = 0; i < 2; i++) {
+		const int offset = i * 101;
+		for (int j = 0; j < 100; j++) {
+			ordered = ordered && receiver.values[offset + j] == (i + 1) * 1000 + j;
+		}
+		ordered = ordered && receiver.values[offset + 100] == i;
+	}
+	CHECK_MESSAGE(ordered, "Calls should run in the order they were posted, whichever thread posted them.");
+
+	memdelete(queue);
+}
+
+TEST_CASE("[MessageQueue] Calls from concurrent threads keep their order") {
+	MessageQueue *queue = memnew(MessageQueue);
+	Receiver receiver;
+
+	Poster posters[2];
+	Thread threads[2];
+	for (int i = 0; i < 2; i++) {
+		posters[i].queue = queue;
+		posters[i].receiver = &receiver;
+		posters[i].first = (i + 1) * 1000;
+		posters[i].count = 500;
+		threads[i].start(&Poster::run, &posters[i]);
+	}
+	for (int i = 0; i < 2; i++) {
+		threads[i].wait_to_finish();
+	}
+	queue->push_callable(callable_mp(&receiver, &Receiver::record), 0);
+
+	queue->flush();
+	REQUIRE(receiver.values.size() == 1001);
+
+	// Each thread's calls in order, whatever the interleaving of threads.
+	int next[2] = { 1000, 2000 };
+	bool ordered = true;
+	for (uint32_t i = 0; i < 1000; i++) {
+		const int thread = receiver.values[i] / 1000 - 1;
+		ordered = ordered && thread >= 0 && thread < 2 && receiver.values[i] == next[thread];
+		if (ordered) {
+			next[thread]++;
+		}
+	}
+	CHECK_MESSAGE(ordered, "Calls posted by a thread should run in the order they were posted.");
+	// Posted once both threads were done.
+	CHECK(receiver.values[1000] == 0);
+
+	// The threads have exited, their queues are dropped once drained.
+	queue->flush();
+	CHECK(queue->get_last_flush_message_count() == 0);
+
+	memdelete(queue);
+}
+
+TEST_CASE("[MessageQueue] Threads can outlive the message queue") {
+	MessageQueue *queue = memnew(MessageQueue);
+	Receiver receiver;
+
+	Semaphore exit;
+	Poster poster;
+	poster.queue = queue;
+	poster.receiver = &receiver;
+	poster.count = 10;
+	poster.exit = &exit;
+	Thread thread;
+	thread.start(&Poster::run, &poster);
+	poster.posted.wait();
+
+	// Deleted with the thread's queue still registered and holding calls,
+	// the thread only lets go of it when it exits.
+	memdelete(queue);
+	exit.post();
+	thread.wait_to_finish();
+	CHECK(receiver.values.is_empty());
+
+	// The main thread's queue from the deleted message queue is replaced.
+	queue = memnew(MessageQueue);
+	queue->push_callable(callable_mp(&receiver, &Receiver::record), 1);
+	queue->flush();
+	REQUIRE(receiver.values.size() == 1);
+	CHECK(receiver.values[0] == 1);
+	memdelete(queue);
+}
+
+} // namespace TestMessageQueue
+
+#endif // TEST_MESSAGE_QUEUE_H
@@ -32,6 +32,7 @@
 #define TEST_OBJECT_H
 
 #include "core/core_string_names.h"
+#include "core/object/callable_method_pointer.h"
 #include "core/object/object.h"
 
 #include "thirdparty/doctest/doctest.h"
@@ -273,6 +274,83 @@ TEST_CASE("[Object] Absent name getter") {
 			actual_value == Variant(),
 			"The returned value should equal nil variant.");
 }
+
+class _SignalReceiver : public Object {
+public:
+	Object *emitter = nullptr;
+	_SignalReceiver *connect_on_emit = nullptr;
+	bool disconnect_on_emit = false;
+	int calls = 0;
+	int last_arg = 0;
+	int last_bind = 0;
+
+	void _on_signal() {
+		calls++;
+		if (disconnect_on_emit) {
+			emitter->disconnect("test_signal", callable_mp(this, &_SignalReceiver::_on_signal));
+		}
+		if (connect_on_emit) {
+			emitter->connect("test_signal", callable_mp(connect_on_emit, &_SignalReceiver::_on_signal));
+			connect_on_emit = nullptr;
+		}
+	}
+
+	void _on_signal_bound(int p_arg, int p_bind) {
+		calls++;
+		last_arg = p_arg;
+		last_bind = p_bind;
+	}
+};
+
+TEST_CASE("[Object] Signal connections changed while emitting") {
+	Object emitter;
+	emitter.add_user_signal(MethodInfo("test_signal"));
+
+	_SignalReceiver first;
+	_SignalReceiver second;
+	_SignalReceiver late;
+	first.emitter = &emitter;
+	first.disconnect_on_emit = true;
+	first.connect_on_emit = &late;
+
+	emitter.connect("test_signal", callable_mp(&first, &_SignalReceiver::_on_signal));
+	emitter.connect("test_signal", callable_mp(&second, &_SignalReceiver::_on_signal));
+
+	emitter.emit_signal("test_signal");
+	CHECK(first.calls == 1);
+	CHECK_MESSAGE(second.calls == 1, "Slots shifted by a connection made while emitting should be called exactly once.");
+	CHECK_MESSAGE(late.calls == 0, "Slots connected while emitting should wait for the next emission.");
+	CHECK(!emitter.is_connected("test_signal", callable_mp(&first, &_SignalReceiver::_on_signal)));
+	CHECK(emitter.is_connected("test_signal", callable_mp(&late, &_SignalReceiver::_on_signal)));
+
+	emitter.emit_signal("test_signal");
+	CHECK(first.calls == 1);
+	CHECK(second.calls == 2);
+	CHECK(late.calls == 1);
+
+	List<Object::Connection> connections;
+	emitter.get_signal_connection_list("test_signal", &connections);
+	CHECK(connections.size() == 2);
+}
+
+TEST_CASE("[Object] Signal binds and one-shot connections") {
+	Object emitter;
+	emitter.add_user_signal(MethodInfo("test_signal"));
+
+	_SignalReceiver receiver;
+	Vector<Variant> binds;
+	binds.push_back(42);
+	emitter.connect("test_signal", callable_mp(&receiver, &_SignalReceiver::_on_signal_bound), binds, Object::CONNECT_ONESHOT);
+
+	emitter.emit_signal("test_signal", 7);
+	CHECK(receiver.calls == 1);
+	CHECK(receiver.last_arg == 7);
+	CHECK(receiver.last_bind == 42);
+	CHECK(!emitter.is_connected("test_signal", callable_mp(&receiver, &_SignalReceiver::_on_signal_bound)));
+
+	emitter.emit_signal("test_signal", 8);
+	CHECK(receiver.calls == 1);
+}
 } // namespace TestObject
 
 #endif // TEST_OBJECT_H
@@ -109,6 +109,120 @@ TEST_CASE("[PCKPacker] Pack a PCK file with some files and directories") {
 			f->get_length() <= 35000,
 			"The generated non-empty PCK file shouldn't be too large.");
 }
+
+TEST_CASE("[PCKPacker] Read a file back from a loaded PCK") {
+	const String source_path = OS::get_singleton()->get_cache_path().plus_file("pck_source.bin");
+	Vector<uint8_t> source_data;
+	source_data.resize(1000);
+	for (int i = 0; i < source_data.size(); i++) {
+		source_data.write[i] = (i * 7) & 0xFF;
+	}
+	{
+		FileAccessRef f = FileAccess::open(source_path, FileAccess::WRITE);
+		REQUIRE(f);
+		f->store_buffer(source_data.ptr(), source_data.size());
+	}
+
+	PCKPacker pck_packer;
+	const String output_pck_path = OS::get_singleton()->get_cache_path().plus_file("output_read_back.pck");
+	CHECK(pck_packer.pck_start(output_pck_path, 32, ENCRYPTION_KEY) == OK);
+	CHECK(pck_packer.add_file("res://pck_read_back/source.bin", source_path) == OK);
+	CHECK(pck_packer.flush() == OK);
+
+	CHECK_MESSAGE(
+			PackedData::get_singleton()->add_pack(output_pck_path, false, 0) == OK,
+			"The generated PCK file should be loaded successfully.");
+
+	FileAccess *f = PackedData::get_singleton()->try_open_path("res://pck_read_back/source.bin");
+	REQUIRE(f);
+	CHECK(f->get_length() == 1000);
+
+	Vector<uint8_t> read_data;
+	read_data.resize(1000);
+	CHECK(f->get_buffer(read_data.ptrw(), 1000) == 1000);
+	CHECK_MESSAGE(
+			read_data == source_data,
+			"The file read from the PCK should match the packed one.");
+
+	f->seek(10);
+	const uint8_t *mapped = f->get_mapped_buffer(100);
+#ifdef UNIX_ENABLED
+	CHECK_MESSAGE(
+			mapped != nullptr,
+			"The PCK should be memory mapped.");
+#endif
+	if (mapped) {
+		CHECK_MESSAGE(
+				memcmp(mapped, source_data.ptr() + 10, 100) == 0,
+				"The mapped range should match the packed file.");
+		CHECK(f->get_position() == 110);
+	}
+	CHECK_MESSAGE(
+			f->get_mapped_buffer(1000) == nullptr,
+			"Ranges past the end of the file should not be mapped.");
+	CHECK(f->get_position() == (mapped ? 110 : 10));
+
+	memdelete(f);
+}
+
+TEST_CASE("[PCKPacker] Look files up in the index of loaded PCKs") {
+	const String cache_path = OS::get_singleton()->get_cache_path();
+	for (int i = 0; i < 2; i++) {
+		FileAccessRef f = FileAccess::open(cache_path.plus_file("pck_index_" + itos(i) + ".txt"), FileAccess::WRITE);
+		REQUIRE(f);
+		f->store_string("pack " + itos(i));
+	}
+
+	// The second pack overrides a file of the first one and adds another.
+	for (int i = 0; i < 2; i++) {
+		PCKPacker pck_packer;
+		const String pck_path = cache_path.plus_file("output_index_" + itos(i) + ".pck");
+		const String source_path = cache_path.plus_file("pck_index_" + itos(i) + ".txt");
+		CHECK(pck_packer.pck_start(pck_path, 32, ENCRYPTION_KEY) == OK);
+		for (int j = 0; j < 50; j++) {
+			CHECK(pck_packer.add_file(vformat("res://pck_index/dir_%d/file_%d.txt", j % 5, j), source_path) == OK);
+		}
+		CHECK(pck_packer.add_file("res://pck_index/pack_" + itos(i) + ".txt", source_path) == OK);
+		CHECK(pck_packer.flush() == OK);
+
+		FileAccessRef f = FileAccess::open(pck_path, FileAccess::READ);
+		REQUIRE(f);
+		f->seek(5 * 4);
+		CHECK_MESSAGE(
+				(f->get_32() & PACK_INDEXED),
+				"PCK files without an encrypted directory should be indexed.");
+
+		CHECK(PackedData::get_singleton()->add_pack(pck_path, i == 1, 0) == OK);
+	}
+
+	PackedData *pd = PackedData::get_singleton();
+	CHECK(pd->has_path("res://pck_index/pack_0.txt"));
+	CHECK(pd->has_path("res://pck_index/pack_1.txt"));
+	CHECK_FALSE(pd->has_path("res://pck_index/missing.txt"));
+	CHECK(pd->try_open_path("res://pck_index/missing.txt") == nullptr);
+
+	for (int j = 0; j < 50; j++) {
+		FileAccess *f = pd->try_open_path(vformat("res://pck_index/dir_%d/file_%d.txt", j % 5, j));
+		REQUIRE(f);
+		CHECK_MESSAGE(
+				f->get_line() == "pack 1",
+				"Files of a pack loaded with replace_files should take precedence.");
+		memdelete(f);
+	}
+
+	DirAccessPack da;
+	CHECK(da.change_dir("res://pck_index/dir_3") == OK);
+	CHECK(da.list_dir_begin() == OK);
+	int file_count = 0;
+	for (String name = da.get_next(); !name.is_empty(); name = da.get_next()) {
+		CHECK_FALSE(da.current_is_dir());
+		file_count++;
+	}
+	da.list_dir_end();
+	CHECK_MESSAGE(
+			file_count == 10,
+			"The directories of indexed packs should be listed.");
+}
 } // namespace TestPCKPacker
 
 #endif // TEST_PCK_PACKER_H
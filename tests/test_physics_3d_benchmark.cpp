@@ -0,0 +1,132 @@
+/*************************************************************************/
+/*  test_physics_3d_benchmark.cpp                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "core/os/worker_thread_pool.h"
+#include "servers/physics_3d/physics_server_3d_sw.h"
+
+#include "tests/test_benchmark.h"
+#include "tests/test_macros.h"
+
+// Steps a single pile of touching boxes, which the solver sees as one big
+// island, with an increasing number of cores and prints the throughput.
+// Usage: `godot --test physics-3d-benchmark`.
+
+namespace TestPhysics3DBenchmark {
+
+static const int PILE_WIDTH = 12;
+static const int PILE_HEIGHT = 8;
+static const int WARMUP_STEPS = 60;
+static const int MEASURED_STEPS = 120;
+static const real_t STEP_TIME = 1.0 / 60.0;
+
+static uint64_t run_pile(int p_worker_count) {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	pool->finish();
+	pool->init(p_worker_count);
+
+	// The solver picks its thread count when initialized.
+	PhysicsServer3DSW *ps = memnew(PhysicsServer3DSW);
+	ps->init();
+
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+
+	RID plane_shape = ps->shape_create(PhysicsServer3D::SHAPE_PLANE);
+	ps->shape_set_data(plane_shape, Plane(Vector3(0, 1, 0), 0));
+	RID ground = ps->body_create();
+	ps->body_set_mode(ground, PhysicsServer3D::BODY_MODE_STATIC);
+	ps->body_add_shape(ground, plane_shape);
+	ps->body_set_space(ground, space);
+
+	RID box_shape = ps->shape_create(PhysicsServer3D::SHAPE_BOX);
+	ps->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+
+	Vector<RID> boxes;
+	for (int y = 0; y < PILE_HEIGHT; y++) {
+		for (int x = 0; x < PILE_WIDTH; x++) {
+			for (int z = 0; z < PILE_WIDTH; z++) {
+				RID box = ps->body_create();
+				ps->body_set_mode(box, PhysicsServer3D::BODY_MODE_DYNAMIC);
+				ps->body_add_shape(box, box_shape);
+				ps->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(x, 0.5 + y * 1.01, z)));
+				ps->body_set_space(box, space);
+				boxes.push_back(box);
+			}
+		}
+	}
+
+	auto step = [ps]() {
+		ps->sync();
+		ps->flush_queries();
+		ps->end_sync();
+		ps->step(STEP_TIME);
+	};
+	for (int i = 0; i < WARMUP_STEPS; i++) {
+		step();
+	}
+	const uint64_t elapsed = TestBenchmark::time_usec([&]() {
+		for (int i = 0; i < MEASURED_STEPS; i++) {
+			step();
+		}
+	});
+
+	for (int i = 0; i < boxes.size(); i++) {
+		ps->free(boxes[i]);
+	}
+	ps->free(ground);
+	ps->free(box_shape);
+	ps->free(plane_shape);
+	ps->free(space);
+	ps->finish();
+	memdelete(ps);
+
+	return elapsed;
+}
+
+void benchmark() {
+	const int body_count = PILE_WIDTH * PILE_WIDTH * PILE_HEIGHT;
+	print_line(vformat("Stepping %d boxes in a single pile, %d steps.", body_count, MEASURED_STEPS));
+
+	TestBenchmark::Table table("body steps");
+	const LocalVector<int> core_counts = TestBenchmark::get_thread_counts();
+	for (uint32_t i = 0; i < core_counts.size(); i++) {
+		// The stepping thread takes part in the work, so one core less is needed in the pool.
+		const uint64_t elapsed = run_pile(core_counts[i] - 1);
+		table.add_row(vformat("%d core(s)", core_counts[i]), elapsed, double(body_count) * MEASURED_STEPS);
+	}
+	table.print();
+
+	WorkerThreadPool::get_singleton()->finish();
+	WorkerThreadPool::get_singleton()->init();
+}
+
+REGISTER_TEST_COMMAND("physics-3d-benchmark", &benchmark);
+
+} // namespace TestPhysics3DBenchmark
@@ -0,0 +1,155 @@
+/*************************************************************************/
+/*  test_physics_3d_queries.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PHYSICS_3D_QUERIES_H
+#define TEST_PHYSICS_3D_QUERIES_H
+
+#include "core/templates/thread_work_pool.h"
+#include "servers/physics_3d/physics_server_3d_sw.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysics3DQueries {
+
+typedef PhysicsDirectSpaceState3D::RayResult RayResult;
+
+class RayCaster {
+public:
+	PhysicsDirectSpaceState3D *state = nullptr;
+	Vector<Vector3> from;
+	Vector<Vector3> to;
+	LocalVector<RayResult> results;
+	LocalVector<bool> hits;
+
+	void cast(uint32_t p_index, int p_unused) {
+		hits[p_index] = state->intersect_ray(from[p_index], to[p_index], results[p_index]);
+	}
+};
+
+// A row of static boxes, with rays shot through and next to them.
+static void create_scene(PhysicsServer3DSW *p_server, RID &r_space, RID &r_shape, Vector<RID> &r_bodies, RayCaster &r_caster) {
+	r_space = p_server->space_create();
+	p_server->space_set_active(r_space, true);
+
+	r_shape = p_server->shape_create(PhysicsServer3D::SHAPE_BOX);
+	p_server->shape_set_data(r_shape, Vector3(0.5, 0.5, 0.5));
+
+	for (int i = 0; i < 16; i++) {
+		RID body = p_server->body_create();
+		p_server->body_set_mode(body, PhysicsServer3D::BODY_MODE_STATIC);
+		p_server->body_add_shape(body, r_shape);
+		p_server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(i * 2, 0, 0)));
+		p_server->body_set_space(body, r_space);
+		r_bodies.push_back(body);
+	}
+
+	// Step once, so the broadphase is up to date.
+	p_server->sync();
+	p_server->flush_queries();
+	p_server->end_sync();
+	p_server->step(1.0 / 60.0);
+
+	for (int i = 0; i < 4000; i++) {
+		real_t x = (i % 200) * 0.17 - 1.0;
+		real_t y = (i / 200) * 0.1 - 1.0;
+		r_caster.from.push_back(Vector3(x, y, 10));
+		r_caster.to.push_back(Vector3(x, y, -10));
+	}
+	r_caster.results.resize(r_caster.from.size());
+	r_caster.hits.resize(r_caster.from.size());
+}
+
+static void free_scene(PhysicsServer3DSW *p_server, RID p_space, RID p_shape, const Vector<RID> &p_bodies) {
+	for (int i = 0; i < p_bodies.size(); i++) {
+		p_server->free(p_bodies[i]);
+	}
+	p_server->free(p_shape);
+	p_server->free(p_space);
+}
+
+TEST_CASE("[Physics3D] Batched and concurrent ray queries match single ones") {
+	PhysicsServer3DSW *server = memnew(PhysicsServer3DSW);
+	server->init();
+
+	RID space;
+	RID shape;
+	Vector<RID> bodies;
+	RayCaster caster;
+	create_scene(server, space, shape, bodies, caster);
+
+	PhysicsDirectSpaceState3D *state = server->space_get_direct_state(space);
+	REQUIRE(state);
+	caster.state = state;
+
+	// Reference results, one ray at a time on this thread.
+	LocalVector<RayResult> expected;
+	expected.resize(caster.from.size());
+	int expected_hits = 0;
+	for (int i = 0; i < caster.from.size(); i++) {
+		if (state->intersect_ray(caster.from[i], caster.to[i], expected[i])) {
+			expected_hits++;
+		} else {
+			expected[i] = RayResult();
+		}
+	}
+	CHECK_MESSAGE(expected_hits > 0, "Some rays should hit the boxes.");
+	CHECK_MESSAGE(expected_hits < caster.from.size(), "Some rays should miss the boxes.");
+
+	LocalVector<RayResult> batched;
+	batched.resize(caster.from.size());
+	int batched_hits = state->intersect_rays(caster.from.ptr(), caster.to.ptr(), caster.from.size(), batched.ptr());
+	CHECK(batched_hits == expected_hits);
+
+	// Single queries issued from several threads at once.
+	ThreadWorkPool work_pool;
+	work_pool.init();
+	work_pool.do_work(caster.from.size(), &caster, &RayCaster::cast, 0);
+	work_pool.finish();
+
+	bool batched_match = true;
+	bool concurrent_match = true;
+	for (uint32_t i = 0; i < expected.size(); i++) {
+		batched_match = batched_match && batched[i].rid == expected[i].rid && batched[i].position.is_equal_approx(expected[i].position);
+		concurrent_match = concurrent_match && caster.hits[i] == expected[i].rid.is_valid();
+		if (caster.hits[i]) {
+			concurrent_match = concurrent_match && caster.results[i].rid == expected[i].rid && caster.results[i].position.is_equal_approx(expected[i].position);
+		}
+	}
+	CHECK_MESSAGE(batched_match, "Batched rays should hit the same objects at the same points.");
+	CHECK_MESSAGE(concurrent_match, "Concurrent rays should hit the same objects at the same points.");
+
+	free_scene(server, space, shape, bodies);
+	server->finish();
+	memdelete(server);
+}
+
+} // namespace TestPhysics3DQueries
+
+#endif // TEST_PHYSICS_3D_QUERIES_H
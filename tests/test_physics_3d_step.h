@@ -0,0 +1,117 @@
+/*************************************************************************/
+/*  test_physics_3d_step.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PHYSICS_3D_STEP_H
+#define TEST_PHYSICS_3D_STEP_H
+
+#include "servers/physics_3d/physics_server_3d_sw.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysics3DStep {
+
+static const int PILE_WIDTH = 8;
+static const int PILE_HEIGHT = 4;
+
+TEST_CASE("[Physics3D] Joints of any priority are solved in colored islands") {
+	PhysicsServer3DSW *ps = memnew(PhysicsServer3DSW);
+	ps->init();
+
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+
+	RID plane_shape = ps->shape_create(PhysicsServer3D::SHAPE_PLANE);
+	ps->shape_set_data(plane_shape, Plane(Vector3(0, 1, 0), 0));
+	RID ground = ps->body_create();
+	ps->body_set_mode(ground, PhysicsServer3D::BODY_MODE_STATIC);
+	ps->body_add_shape(ground, plane_shape);
+	ps->body_set_space(ground, space);
+
+	RID box_shape = ps->shape_create(PhysicsServer3D::SHAPE_BOX);
+	ps->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+
+	// Touching boxes, enough constraints for the island to be colored when there are workers.
+	Vector<RID> bodies;
+	RID corner;
+	for (int y = 0; y < PILE_HEIGHT; y++) {
+		for (int x = 0; x < PILE_WIDTH; x++) {
+			for (int z = 0; z < PILE_WIDTH; z++) {
+				RID box = ps->body_create();
+				ps->body_set_mode(box, PhysicsServer3D::BODY_MODE_DYNAMIC);
+				ps->body_add_shape(box, box_shape);
+				ps->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(x, 0.5 + y * 1.01, z)));
+				ps->body_set_space(box, space);
+				bodies.push_back(box);
+				corner = box;
+			}
+		}
+	}
+
+	// A box hanging off the top corner, which falls if its joint isn't solved.
+	const Vector3 corner_position(PILE_WIDTH - 1, 0.5 + (PILE_HEIGHT - 1) * 1.01, PILE_WIDTH - 1);
+	RID hanging = ps->body_create();
+	ps->body_set_mode(hanging, PhysicsServer3D::BODY_MODE_DYNAMIC);
+	ps->body_add_shape(hanging, box_shape);
+	ps->body_set_state(hanging, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), corner_position + Vector3(2, 0, 0)));
+	ps->body_set_space(hanging, space);
+	bodies.push_back(hanging);
+
+	RID joint = ps->joint_create();
+	ps->joint_make_pin(joint, corner, Vector3(1, 0, 0), hanging, Vector3(-1, 0, 0));
+	// Below the editor range, but nothing clamps it.
+	ps->joint_set_solver_priority(joint, 0);
+	CHECK(ps->joint_get_solver_priority(joint) == 0);
+
+	for (int i = 0; i < 60; i++) {
+		ps->sync();
+		ps->flush_queries();
+		ps->end_sync();
+		ps->step(1.0 / 60.0);
+	}
+
+	const Transform3D corner_transform = ps->body_get_state(corner, PhysicsServer3D::BODY_STATE_TRANSFORM);
+	const Transform3D hanging_transform = ps->body_get_state(hanging, PhysicsServer3D::BODY_STATE_TRANSFORM);
+	CHECK(corner_transform.xform(Vector3(1, 0, 0)).distance_to(hanging_transform.xform(Vector3(-1, 0, 0))) < 0.25);
+
+	ps->free(joint);
+	for (int i = 0; i < bodies.size(); i++) {
+		ps->free(bodies[i]);
+	}
+	ps->free(ground);
+	ps->free(box_shape);
+	ps->free(plane_shape);
+	ps->free(space);
+	ps->finish();
+	memdelete(ps);
+}
+
+} // namespace TestPhysics3DStep
+
+#endif // TEST_PHYSICS_3D_STEP_H
@@ -0,0 +1,129 @@
+/*************************************************************************/
+/*  test_renderer_scene_cull.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RENDERER_SCENE_CULL_H
+#define TEST_RENDERER_SCENE_CULL_H
+
+#include "servers/rendering/renderer_scene_cull.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRendererSceneCull {
+
+// The planes of a box, facing out.
+static RendererSceneCull::Frustum box_frustum(const AABB &p_box) {
+	const Vector3 end = p_box.position + p_box.size;
+	Vector<Plane> planes;
+	planes.push_back(Plane(Vector3(1, 0, 0), end.x));
+	planes.push_back(Plane(Vector3(-1, 0, 0), -p_box.position.x));
+	planes.push_back(Plane(Vector3(0, 1, 0), end.y));
+	planes.push_back(Plane(Vector3(0, -1, 0), -p_box.position.y));
+	planes.push_back(Plane(Vector3(0, 0, 1), end.z));
+	planes.push_back(Plane(Vector3(0, 0, -1), -p_box.position.z));
+	return RendererSceneCull::Frustum(planes);
+}
+
+static void fill_batch(RendererSceneCull::CullBatch &r_batch, const Vector<AABB> &p_boxes) {
+	for (int i = 0; i < p_boxes.size(); i++) {
+		const RendererSceneCull::InstanceBounds bounds(p_boxes[i]);
+		for (int j = 0; j < 6; j++) {
+			r_batch.bounds[j][i] = bounds.bounds[j];
+		}
+		r_batch.hidden[i] = 0;
+	}
+}
+
+TEST_CASE("[RendererSceneCull] Batched frustum test matches InstanceBounds") {
+	RendererSceneCull::CullBatch *batch = memnew(RendererSceneCull::CullBatch);
+	const RendererSceneCull::Frustum frustum = box_frustum(AABB(Vector3(-1, -1, -1), Vector3(2, 2, 2)));
+
+	Vector<AABB> boxes;
+	for (int i = 0; i < 64; i++) {
+		// Boxes sliding through the frustum along each axis.
+		Vector3 position;
+		position[i % 3] = -4.0 + i * 0.125;
+		boxes.push_back(AABB(position, Vector3(0.5, 0.5, 0.5)));
+	}
+	fill_batch(*batch, boxes);
+
+	for (int i = 0; i < boxes.size(); i++) {
+		batch->outside[i] = 0;
+	}
+	RendererSceneCull::_cull_batch_frustum(frustum, *batch, boxes.size(), batch->outside);
+
+	for (int i = 0; i < boxes.size(); i++) {
+		CHECK((batch->outside[i] == 0) == RendererSceneCull::InstanceBounds(boxes[i]).in_frustum(frustum));
+	}
+
+	memdelete(batch);
+}
+
+TEST_CASE("[RendererSceneCull] Shadow casters go through when in any cascade") {
+	RendererSceneCull::CullBatch *batch = memnew(RendererSceneCull::CullBatch);
+	RendererSceneCull::Cull *cull = memnew(RendererSceneCull::Cull);
+
+	// Two lights, the second one with two cascades that don't overlap.
+	cull->shadow_count = 2;
+	cull->shadows[0].cascade_count = 1;
+	cull->shadows[0].cascades[0].frustum = box_frustum(AABB(Vector3(-10, -10, -10), Vector3(5, 20, 20)));
+	cull->shadows[1].cascade_count = 2;
+	cull->shadows[1].cascades[0].frustum = box_frustum(AABB(Vector3(0, -10, -10), Vector3(4, 20, 20)));
+	cull->shadows[1].cascades[1].frustum = box_frustum(AABB(Vector3(5, -10, -10), Vector3(5, 20, 20)));
+
+	Vector<AABB> boxes;
+	boxes.push_back(AABB(Vector3(-8, 0, 0), Vector3(1, 1, 1))); // First light.
+	boxes.push_back(AABB(Vector3(1, 0, 0), Vector3(1, 1, 1))); // First cascade of the second light.
+	boxes.push_back(AABB(Vector3(7, 0, 0), Vector3(1, 1, 1))); // Second cascade of the second light.
+	boxes.push_back(AABB(Vector3(20, 0, 0), Vector3(1, 1, 1))); // None.
+	boxes.push_back(AABB(Vector3(7, 0, 0), Vector3(1, 1, 1))); // Second cascade, but hidden.
+	fill_batch(*batch, boxes);
+	batch->hidden[4] = 0xFFFFFFFF;
+
+	RendererSceneCull::_cull_batch_shadows(*cull, *batch, boxes.size());
+	CHECK(batch->shadow_outside[0] == 0);
+	CHECK(batch->shadow_outside[1] == 0);
+	CHECK(batch->shadow_outside[2] == 0);
+	CHECK(batch->shadow_outside[3] != 0);
+	CHECK(batch->shadow_outside[4] != 0);
+
+	// Without cascades every instance is outside.
+	cull->shadow_count = 0;
+	RendererSceneCull::_cull_batch_shadows(*cull, *batch, boxes.size());
+	for (int i = 0; i < boxes.size(); i++) {
+		CHECK(batch->shadow_outside[i] != 0);
+	}
+
+	memdelete(cull);
+	memdelete(batch);
+}
+
+} // namespace TestRendererSceneCull
+
+#endif // TEST_RENDERER_SCENE_CULL_H
@@ -109,6 +109,93 @@ TEST_CASE("[Resource] Saving and loading") {
 			loaded_child_resource_text->get_name() == "I'm a child resource",
 			"The loaded child resource name should be equal to the expected value.");
 }
+
+TEST_CASE("[Resource] Threaded loading with dependencies") {
+	const int child_count = 16;
+	const String save_path = OS::get_singleton()->get_cache_path().plus_file("resource_threaded.res");
+	{
+		Ref<Resource> resource = memnew(Resource);
+		for (int i = 0; i < child_count; i++) {
+			Ref<Resource> child_resource = memnew(Resource);
+			child_resource->set_name(itos(i));
+			// Saved in their own files, so they are loaded as dependencies.
+			ResourceSaver::save(OS::get_singleton()->get_cache_path().plus_file(vformat("resource_threaded_%d.res", i)), child_resource, ResourceSaver::FLAG_CHANGE_PATH);
+			resource->set_meta(vformat("child_%d", i), child_resource);
+		}
+		ResourceSaver::save(save_path, resource);
+	}
+
+	for (int use_sub_threads = 0; use_sub_threads < 2; use_sub_threads++) {
+		CHECK(ResourceLoader::load_threaded_request(save_path, "", use_sub_threads) == OK);
+		// Requesting the same path again shares the load.
+		CHECK(ResourceLoader::load_threaded_request(save_path, "", use_sub_threads) == OK);
+
+		Error err = FAILED;
+		Ref<Resource> loaded_resource = ResourceLoader::load_threaded_get(save_path, &err);
+		CHECK_MESSAGE(
+				err == OK,
+				"Threaded load should succeed.");
+		CHECK_MESSAGE(
+				ResourceLoader::load_threaded_get(save_path) == loaded_resource,
+				"Every request should get the same resource.");
+		CHECK_MESSAGE(
+				ResourceLoader::load_threaded_get_status(save_path) == ResourceLoader::THREAD_LOAD_INVALID_RESOURCE,
+				"The load should be released once every request got its result.");
+
+		REQUIRE(loaded_resource.is_valid());
+		for (int i = 0; i < child_count; i++) {
+			Ref<Resource> child_resource = loaded_resource->get_meta(vformat("child_%d", i));
+			REQUIRE(child_resource.is_valid());
+			CHECK_MESSAGE(
+					child_resource->get_name() == itos(i),
+					"Dependencies should be loaded before the resource using them.");
+		}
+	}
+}
+
+TEST_CASE("[Resource] Loading a single sub-resource") {
+	const String save_path = OS::get_singleton()->get_cache_path().plus_file("resource_sub_resources.res");
+	{
+		Ref<Resource> resource = memnew(Resource);
+		for (int i = 0; i < 4; i++) {
+			Ref<Resource> child_resource = memnew(Resource);
+			child_resource->set_name(itos(i));
+			child_resource->set_scene_unique_id(vformat("child_%d", i));
+			Ref<Resource> inner_resource = memnew(Resource);
+			inner_resource->set_name(vformat("inner_%d", i));
+			child_resource->set_meta("inner", inner_resource);
+			resource->set_meta(vformat("child_%d", i), child_resource);
+		}
+		ResourceSaver::save(save_path, resource);
+	}
+
+	Ref<Resource> child_resource = ResourceLoader::load(save_path + "::child_2");
+	REQUIRE(child_resource.is_valid());
+	CHECK(child_resource->get_name() == "2");
+	CHECK(child_resource->get_path() == save_path + "::child_2");
+	Ref<Resource> inner_resource = child_resource->get_meta("inner");
+	REQUIRE(inner_resource.is_valid());
+	CHECK_MESSAGE(
+			inner_resource->get_name() == "inner_2",
+			"The sub-resources used by the loaded one should be loaded too.");
+	CHECK_MESSAGE(
+			!ResourceCache::has(save_path),
+			"The main resource should not be loaded.");
+	CHECK_MESSAGE(
+			!ResourceCache::has(save_path + "::child_1"),
+			"Sub-resources that aren't used should not be loaded.");
+
+	Ref<Resource> resource = ResourceLoader::load(save_path);
+	REQUIRE(resource.is_valid());
+	CHECK_MESSAGE(
+			Ref<Resource>(resource->get_meta("child_2")) == child_resource,
+			"Loading the whole file should reuse the sub-resource loaded before.");
+	CHECK(Ref<Resource>(resource->get_meta("child_1"))->get_name() == "1");
+
+	ERR_PRINT_OFF;
+	CHECK(ResourceLoader::load(save_path + "::missing", "", ResourceFormatLoader::CACHE_MODE_IGNORE).is_null());
+	ERR_PRINT_ON;
+}
 } // namespace TestResource
 
 #endif // TEST_RESOURCE
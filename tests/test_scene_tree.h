@@ -0,0 +1,236 @@
+/*************************************************************************/
+/*  test_scene_tree.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_SCENE_TREE_H
+#define TEST_SCENE_TREE_H
+
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
+#include "servers/display_server.h"
+#include "servers/navigation_server_2d.h"
+#include "servers/navigation_server_3d.h"
+#include "servers/physics_server_2d.h"
+#include "servers/physics_server_3d.h"
+#include "servers/rendering/rendering_server_default.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSceneTree {
+
+// A SceneTree with the headless display server and the servers its root viewport talks to.
+class TestTree {
+	DisplayServer *display_server = nullptr;
+	RenderingServer *rendering_server = nullptr;
+	PhysicsServer3D *physics_server = nullptr;
+	PhysicsServer2D *physics_2d_server = nullptr;
+	NavigationServer3D *navigation_server = nullptr;
+	NavigationServer2D *navigation_2d_server = nullptr;
+
+public:
+	SceneTree *tree = nullptr;
+
+	TestTree() {
+		for (int i = 0; i < DisplayServer::get_create_function_count(); i++) {
+			if (String(DisplayServer::get_create_function_name(i)) == "headless") {
+				Error err;
+				display_server = DisplayServer::create(i, "dummy", DisplayServer::WINDOW_MODE_MINIMIZED, DisplayServer::VSYNC_ENABLED, 0, Vector2i(), err);
+				break;
+			}
+		}
+		rendering_server = memnew(RenderingServerDefault(false));
+		rendering_server->init();
+
+		physics_server = PhysicsServer3DManager::new_default_server();
+		physics_server->init();
+		physics_2d_server = PhysicsServer2DManager::new_default_server();
+		physics_2d_server->init();
+
+		navigation_server = NavigationServer3DManager::new_default_server();
+		navigation_2d_server = memnew(NavigationServer2D);
+
+		tree = memnew(SceneTree);
+		tree->initialize();
+	}
+
+	~TestTree() {
+		tree->finalize();
+		memdelete(tree);
+
+		physics_server->finish();
+		memdelete(physics_server);
+		physics_2d_server->finish();
+		memdelete(physics_2d_server);
+
+		memdelete(navigation_2d_server);
+		memdelete(navigation_server);
+
+		rendering_server->finish();
+		memdelete(rendering_server);
+		memdelete(display_server);
+	}
+};
+
+// Records the order it is processed in, and can add or remove a node while it is.
+class ProcessRecorder : public Node {
+	GDCLASS(ProcessRecorder, Node);
+
+protected:
+	void _notification(int p_what) {
+		if (p_what != NOTIFICATION_PROCESS) {
+			return;
+		}
+		order->push_back(this);
+		if (add_on_process) {
+			get_parent()->add_child(add_on_process);
+			add_on_process = nullptr;
+		}
+		if (remove_on_process) {
+			remove_on_process->get_parent()->remove_child(remove_on_process);
+			remove_on_process = nullptr;
+		}
+	}
+
+public:
+	LocalVector<Node *> *order = nullptr;
+	Node *add_on_process = nullptr;
+	Node *remove_on_process = nullptr;
+
+	ProcessRecorder(LocalVector<Node *> *p_order, int p_priority = 0) {
+		order = p_order;
+		set_process_priority(p_priority);
+		set_process(true);
+	}
+};
+
+static const LocalVector<Node *> &process_frame(SceneTree *p_tree, LocalVector<Node *> &r_order) {
+	r_order.clear();
+	p_tree->process(0.1);
+	return r_order;
+}
+
+static bool is_order(const LocalVector<Node *> &p_order, Node *p_a, Node *p_b = nullptr, Node *p_c = nullptr, Node *p_d = nullptr) {
+	LocalVector<Node *> expected;
+	Node *nodes[4] = { p_a, p_b, p_c, p_d };
+	for (int i = 0; i < 4 && nodes[i]; i++) {
+		expected.push_back(nodes[i]);
+	}
+	if (expected.size() != p_order.size()) {
+		return false;
+	}
+	for (uint32_t i = 0; i < expected.size(); i++) {
+		if (expected[i] != p_order[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("[SceneTree] Process order follows process priority, then tree order") {
+	TestTree test_tree;
+	LocalVector<Node *> order;
+
+	Node *a = memnew(ProcessRecorder(&order));
+	Node *b = memnew(ProcessRecorder(&order));
+	Node *c = memnew(ProcessRecorder(&order, -1));
+	test_tree.tree->get_root()->add_child(a);
+	test_tree.tree->get_root()->add_child(b);
+	test_tree.tree->get_root()->add_child(c);
+
+	CHECK(is_order(process_frame(test_tree.tree, order), c, a, b));
+
+	b->set_process_priority(-2);
+	CHECK(is_order(process_frame(test_tree.tree, order), b, c, a));
+
+	b->set_process_priority(1);
+	c->set_process_priority(0);
+	CHECK(is_order(process_frame(test_tree.tree, order), a, c, b));
+}
+
+TEST_CASE("[SceneTree] Process order follows move_child") {
+	TestTree test_tree;
+	LocalVector<Node *> order;
+
+	// Only the leaves process, so moving a branch reorders nodes whose own groups didn't change.
+	Node *first = memnew(Node);
+	Node *second = memnew(Node);
+	Node *a = memnew(ProcessRecorder(&order));
+	Node *b = memnew(ProcessRecorder(&order));
+	Node *c = memnew(ProcessRecorder(&order));
+	first->add_child(a);
+	first->add_child(b);
+	second->add_child(c);
+	test_tree.tree->get_root()->add_child(first);
+	test_tree.tree->get_root()->add_child(second);
+
+	CHECK(is_order(process_frame(test_tree.tree, order), a, b, c));
+
+	test_tree.tree->get_root()->move_child(second, 0);
+	CHECK(is_order(process_frame(test_tree.tree, order), c, a, b));
+
+	first->move_child(b, 0);
+	CHECK(is_order(process_frame(test_tree.tree, order), c, b, a));
+
+	// Priority still comes before tree order.
+	a->set_process_priority(-1);
+	CHECK(is_order(process_frame(test_tree.tree, order), a, c, b));
+}
+
+TEST_CASE("[SceneTree] Nodes added or removed during a process pass") {
+	TestTree test_tree;
+	LocalVector<Node *> order;
+
+	ProcessRecorder *a = memnew(ProcessRecorder(&order, -1));
+	Node *b = memnew(ProcessRecorder(&order));
+	Node *c = memnew(ProcessRecorder(&order, -2));
+	test_tree.tree->get_root()->add_child(a);
+	test_tree.tree->get_root()->add_child(b);
+
+	// Removed nodes are skipped right away, added ones wait for the next pass.
+	a->remove_on_process = b;
+	a->add_on_process = c;
+	CHECK(is_order(process_frame(test_tree.tree, order), a));
+	CHECK(is_order(process_frame(test_tree.tree, order), c, a));
+
+	// Adding back a node removed earlier in the same pass.
+	ProcessRecorder *d = memnew(ProcessRecorder(&order, -3));
+	test_tree.tree->get_root()->add_child(d);
+	CHECK(is_order(process_frame(test_tree.tree, order), d, c, a));
+
+	d->remove_on_process = c;
+	a->add_on_process = c;
+	CHECK(is_order(process_frame(test_tree.tree, order), d, a));
+	CHECK(is_order(process_frame(test_tree.tree, order), d, c, a));
+
+	memdelete(b);
+}
+
+} // namespace TestSceneTree
+
+#endif // TEST_SCENE_TREE_H
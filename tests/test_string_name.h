@@ -0,0 +1,155 @@
+/*************************************************************************/
+/*  test_string_name.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_STRING_NAME_H
+#define TEST_STRING_NAME_H
+
+#include "core/os/thread.h"
+#include "core/string/string_name.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStringName {
+
+// Returns a name different from `p_name` that uses the same slot of the
+// per thread name cache.
+static String find_cache_collision(const String &p_name) {
+	const uint32_t slot = p_name.hash() & 0xFF;
+	for (int i = 0;; i++) {
+		const String candidate = p_name + "_collision_" + itos(i);
+		if ((candidate.hash() & 0xFF) == slot) {
+			return candidate;
+		}
+	}
+}
+
+TEST_CASE("[StringName] All constructors return the same name") {
+	const StringName from_cstring("test_string_name_ctor");
+	const StringName from_string(String("test_string_name_ctor"));
+	const StringName from_static(StaticCString::create("test_string_name_ctor"));
+
+	CHECK(from_cstring == from_string);
+	CHECK(from_cstring == from_static);
+	CHECK(from_cstring.data_unique_pointer() == from_static.data_unique_pointer());
+	CHECK(from_cstring.hash() == String("test_string_name_ctor").hash());
+	CHECK(StringName::search("test_string_name_ctor") == from_cstring);
+	CHECK(StringName::search(String("test_string_name_ctor")) == from_cstring);
+	CHECK(from_cstring != StringName("test_string_name_other"));
+	CHECK(String(from_static) == "test_string_name_ctor");
+}
+
+TEST_CASE("[StringName] Empty names") {
+	CHECK(StringName("") == StringName());
+	CHECK(StringName(String()) == StringName());
+	CHECK(StringName().hash() == 0);
+	CHECK(String(StringName()).is_empty());
+	CHECK(!StringName());
+	CHECK(StringName("test_string_name_not_empty"));
+}
+
+TEST_CASE("[StringName] Search doesn't create names") {
+	CHECK(StringName::search("test_string_name_never_created") == StringName());
+	CHECK(StringName::search("test_string_name_never_created") == StringName());
+}
+
+TEST_CASE("[StringName] Names stay unique past the thread cache size") {
+	// More names than the cache holds, so most lookups miss it and later
+	// ones evict earlier ones.
+	const int name_count = 1000;
+	Vector<StringName> first;
+	for (int i = 0; i < name_count; i++) {
+		first.push_back(StringName("test_string_name_many_" + itos(i)));
+	}
+
+	for (int i = 0; i < name_count; i++) {
+		const StringName again("test_string_name_many_" + itos(i));
+		CHECK(again == first[i]);
+		CHECK(String(again) == "test_string_name_many_" + itos(i));
+	}
+}
+
+TEST_CASE("[StringName] Evicted names are kept while referenced and freed afterwards") {
+	const String name = "test_string_name_evicted";
+	const String collision = find_cache_collision(name);
+
+	{
+		StringName held(name);
+		const void *pointer = held.data_unique_pointer();
+
+		// Evicts `held` from the cache, its own reference must keep it alive.
+		StringName other(collision);
+		CHECK(StringName(name).data_unique_pointer() == pointer);
+		CHECK(String(held) == name);
+	}
+
+	// Cache `name` again, then evict it while nothing else references it.
+	{
+		StringName held(name);
+	}
+	{
+		StringName other(collision);
+	}
+	CHECK_MESSAGE(StringName::search(name) == StringName(), "A name without references must be freed once it leaves the cache.");
+}
+
+struct OtherThreadNames {
+	Vector<const void *> pointers;
+
+	static void run(void *p_userdata) {
+		OtherThreadNames *self = (OtherThreadNames *)p_userdata;
+		for (int i = 0; i < 100; i++) {
+			StringName name("test_string_name_thread_" + itos(i));
+			self->pointers.push_back(name.data_unique_pointer());
+		}
+	}
+};
+
+TEST_CASE("[StringName] Every thread gets the same instance for the same name") {
+	// Referenced here, so the other thread must find these instead of
+	// making its own through its separate cache.
+	Vector<StringName> names;
+	for (int i = 0; i < 100; i++) {
+		names.push_back(StringName("test_string_name_thread_" + itos(i)));
+	}
+
+	OtherThreadNames other;
+	Thread thread;
+	thread.start(&OtherThreadNames::run, &other);
+	thread.wait_to_finish();
+
+	REQUIRE(other.pointers.size() == names.size());
+	for (int i = 0; i < names.size(); i++) {
+		CHECK(other.pointers[i] == names[i].data_unique_pointer());
+	}
+}
+
+} // namespace TestStringName
+
+#endif // TEST_STRING_NAME_H
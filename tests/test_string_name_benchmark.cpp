@@ -0,0 +1,107 @@
+/*************************************************************************/
+/*  test_string_name_benchmark.cpp                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "core/os/thread.h"
+#include "core/string/string_name.h"
+
+#include "tests/test_benchmark.h"
+#include "tests/test_macros.h"
+
+// Builds StringNames from a growing number of threads at once, the way
+// scripts and scene loading do, and prints how lookups scale.
+// Usage: `godot --test string-name-benchmark`.
+
+namespace TestStringNameBenchmark {
+
+static const int NAME_COUNT = 1024;
+static const int LOOKUPS_PER_THREAD = 400000;
+
+static Vector<String> names;
+static Vector<CharString> cnames;
+
+static void lookup_thread(void *p_userdata) {
+	const int offset = *(int *)p_userdata;
+	for (int i = 0; i < LOOKUPS_PER_THREAD; i++) {
+		// Mix the String and C string paths, and hop around the name set so
+		// every thread sees a working set larger than its cache.
+		int index = (i * 7 + offset) % NAME_COUNT;
+		if (i & 1) {
+			StringName name(names[index]);
+		} else {
+			StringName name(cnames[index].get_data());
+		}
+	}
+}
+
+static uint64_t run_threads(int p_thread_count) {
+	Thread *threads = memnew_arr(Thread, p_thread_count);
+	Vector<int> offsets;
+	offsets.resize(p_thread_count);
+
+	const uint64_t elapsed = TestBenchmark::time_usec([&]() {
+		for (int i = 0; i < p_thread_count; i++) {
+			offsets.write[i] = i * 131;
+			threads[i].start(&lookup_thread, &offsets.write[i]);
+		}
+		for (int i = 0; i < p_thread_count; i++) {
+			threads[i].wait_to_finish();
+		}
+	});
+
+	memdelete_arr(threads);
+	return elapsed;
+}
+
+void benchmark() {
+	// Keep every name alive so the benchmark measures lookups, not inserts.
+	Vector<StringName> interned;
+	for (int i = 0; i < NAME_COUNT; i++) {
+		names.push_back("benchmark_name_" + itos(i));
+		cnames.push_back(names[i].ascii());
+		interned.push_back(names[i]);
+	}
+
+	print_line(vformat("%d lookups per thread over %d names.", LOOKUPS_PER_THREAD, NAME_COUNT));
+
+	TestBenchmark::Table table("lookups");
+	const LocalVector<int> thread_counts = TestBenchmark::get_thread_counts();
+	for (uint32_t i = 0; i < thread_counts.size(); i++) {
+		const uint64_t elapsed = run_threads(thread_counts[i]);
+		table.add_row(vformat("%d thread(s)", thread_counts[i]), elapsed, double(LOOKUPS_PER_THREAD) * thread_counts[i]);
+	}
+	table.print();
+
+	names.clear();
+	cnames.clear();
+}
+
+REGISTER_TEST_COMMAND("string-name-benchmark", &benchmark);
+
+} // namespace TestStringNameBenchmark
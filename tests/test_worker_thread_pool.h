@@ -0,0 +1,218 @@
+/*************************************************************************/
+/*  test_worker_thread_pool.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_WORKER_THREAD_POOL_H
+#define TEST_WORKER_THREAD_POOL_H
+
+#include "core/os/threaded_array_processor.h"
+#include "core/os/worker_thread_pool.h"
+#include "core/templates/thread_work_pool.h"
+
+#include "tests/test_macros.h"
+
+namespace TestWorkerThreadPool {
+
+class Counter : public WorkerThreadPool::Task {
+public:
+	SafeNumeric<uint32_t> runs;
+	SafeNumeric<uint32_t> *sequence = nullptr;
+	uint32_t order = 0;
+
+	virtual void run() override {
+		runs.increment();
+		if (sequence) {
+			order = sequence->increment();
+		}
+	}
+};
+
+class CallerCounter : public WorkerThreadPool::Task {
+public:
+	SafeNumeric<uint32_t> runs;
+	SafeNumeric<uint32_t> runs_on_caller;
+	Thread::ID caller_id = 0;
+
+	virtual void run() override {
+		runs.increment();
+		if (Thread::get_caller_id() == caller_id) {
+			runs_on_caller.increment();
+		}
+	}
+};
+
+class BackgroundCounter : public CallerCounter {
+public:
+	BackgroundCounter() {
+		background = true;
+	}
+};
+
+class ArrayFiller {
+public:
+	LocalVector<uint32_t> values;
+
+	void fill(uint32_t p_index, uint32_t p_add) {
+		values[p_index] += p_index + p_add;
+	}
+};
+
+TEST_CASE("[WorkerThreadPool] Task instances all run") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	REQUIRE(pool);
+
+	Counter counter;
+	WorkerThreadPool::Group group;
+	pool->add_task(&counter, WorkerThreadPool::PRIORITY_NORMAL, &group, nullptr, 100);
+	pool->wait(&group);
+
+	CHECK(group.get_pending() == 0);
+	CHECK(counter.runs.get() == 100);
+}
+
+TEST_CASE("[WorkerThreadPool] Dependent tasks run after their dependency") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	REQUIRE(pool);
+
+	SafeNumeric<uint32_t> sequence;
+	Counter first;
+	first.sequence = &sequence;
+	Counter second;
+	second.sequence = &sequence;
+
+	WorkerThreadPool::Group first_group;
+	WorkerThreadPool::Group second_group;
+	pool->add_task(&first, WorkerThreadPool::PRIORITY_LOW, &first_group);
+	pool->add_task(&second, WorkerThreadPool::PRIORITY_HIGH, &second_group, &first_group);
+	pool->wait(&second_group);
+
+	CHECK(first.runs.get() == 1);
+	CHECK(second.runs.get() == 1);
+	CHECK_MESSAGE(first.order < second.order, "The dependent task must run last.");
+	pool->wait(&first_group);
+}
+
+TEST_CASE("[WorkerThreadPool] Background tasks never run inline in wait()") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	REQUIRE(pool);
+	if (pool->get_thread_count() == 0) {
+		// Without workers, every task runs on the thread adding it.
+		return;
+	}
+
+	BackgroundCounter background;
+	background.caller_id = Thread::get_caller_id();
+	Counter foreground;
+	WorkerThreadPool::Group background_group;
+	WorkerThreadPool::Group foreground_group;
+	pool->add_task(&background, WorkerThreadPool::PRIORITY_HIGH, &background_group, nullptr, 100);
+	pool->add_task(&foreground, WorkerThreadPool::PRIORITY_LOW, &foreground_group, nullptr, 100);
+	pool->wait(&foreground_group);
+	pool->wait(&background_group);
+
+	CHECK(foreground.runs.get() == 100);
+	CHECK(background.runs.get() == 100);
+	CHECK(background.runs_on_caller.get() == 0);
+}
+
+TEST_CASE("[WorkerThreadPool] Waiting on the group's own tasks leaves other tasks to the workers") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	REQUIRE(pool);
+	if (pool->get_thread_count() == 0) {
+		return;
+	}
+
+	CallerCounter other;
+	other.caller_id = Thread::get_caller_id();
+	CallerCounter own;
+	own.caller_id = Thread::get_caller_id();
+	WorkerThreadPool::Group other_group;
+	WorkerThreadPool::Group own_group;
+	// Queued first and at the same priority, a plain wait() would run them inline too.
+	pool->add_task(&other, WorkerThreadPool::PRIORITY_HIGH, &other_group, nullptr, 100);
+	pool->add_task(&own, WorkerThreadPool::PRIORITY_HIGH, &own_group, nullptr, 100);
+	pool->wait(&own_group, true);
+	const uint32_t other_runs_on_caller = other.runs_on_caller.get();
+	pool->wait(&other_group);
+
+	CHECK(own.runs.get() == 100);
+	CHECK(other.runs.get() == 100);
+	CHECK(other_runs_on_caller == 0);
+}
+
+TEST_CASE("[ThreadWorkPool] Every element is processed exactly once") {
+	ArrayFiller filler;
+	filler.values.resize(10000);
+	for (uint32_t i = 0; i < filler.values.size(); i++) {
+		filler.values[i] = 0;
+	}
+
+	ThreadWorkPool work_pool;
+	work_pool.init();
+	CHECK(work_pool.get_thread_count() > 0);
+
+	work_pool.do_work(filler.values.size(), &filler, &ArrayFiller::fill, 1);
+	// A second batch on the same instance must work as well.
+	work_pool.do_work(filler.values.size(), &filler, &ArrayFiller::fill, 1);
+	work_pool.finish();
+
+	bool all_match = true;
+	for (uint32_t i = 0; i < filler.values.size(); i++) {
+		if (filler.values[i] != (i + 1) * 2) {
+			all_match = false;
+			break;
+		}
+	}
+	CHECK_MESSAGE(all_match, "Each element should have been processed once per batch.");
+}
+
+TEST_CASE("[ThreadedArrayProcessor] Batched processing covers every element once") {
+	ArrayFiller filler;
+	filler.values.resize(1001);
+	for (uint32_t i = 0; i < filler.values.size(); i++) {
+		filler.values[i] = 0;
+	}
+
+	// Batch size not dividing the element count, to cover the last partial batch.
+	thread_process_array(filler.values.size(), &filler, &ArrayFiller::fill, 0u, 16);
+	thread_process_array(filler.values.size(), &filler, &ArrayFiller::fill, 0u);
+
+	bool all_match = true;
+	for (uint32_t i = 0; i < filler.values.size(); i++) {
+		if (filler.values[i] != i * 2) {
+			all_match = false;
+			break;
+		}
+	}
+	CHECK_MESSAGE(all_match, "Each element should have been processed once per call.");
+}
+
+} // namespace TestWorkerThreadPool
+
+#endif // TEST_WORKER_THREAD_POOL_H